@@ -338,6 +338,28 @@ bool CmdLineParser::ParseFromArgs(int argc, const char* const argv[])
             }
         }
 
+        // Directory for cached results
+        else if (std::strncmp(argv[i], "--cache-dir=", 12) == 0) {
+            _settings->cacheDir = Path::fromNativeSeparators(argv[i] + 12);
+            if (_settings->cacheDir.empty()) {
+                PrintMessage("cppcheck: No directory given to '--cache-dir' option.");
+                return false;
+            }
+        }
+
+        // Executor used for -j: threads or processes
+        else if (std::strncmp(argv[i], "--executor=", 11) == 0) {
+            const std::string executor = argv[i] + 11;
+            if (executor == "thread")
+                _settings->useProcesses = false;
+            else if (executor == "process")
+                _settings->useProcesses = true;
+            else {
+                PrintMessage("cppcheck: unknown executor '" + executor + "'. Valid values are 'thread' and 'process'.");
+                return false;
+            }
+        }
+
         // --error-exitcode=1
         else if (std::strncmp(argv[i], "--error-exitcode=", 17) == 0) {
             std::string temp = argv[i]+17;
@@ -563,6 +585,20 @@ bool CmdLineParser::ParseFromArgs(int argc, const char* const argv[])
             }
         }
 
+        // Number of threads that run the checks of a file
+        else if (std::strncmp(argv[i], "--check-threads=", 16) == 0) {
+            std::istringstream iss(16+argv[i]);
+            if (!(iss >> _settings->_checkThreads)) {
+                PrintMessage("cppcheck: argument to '--check-threads=' is not a number.");
+                return false;
+            }
+
+            if (_settings->_checkThreads < 1 || _settings->_checkThreads > 1000) {
+                PrintMessage("cppcheck: argument to '--check-threads=' must be between 1 and 1000.");
+                return false;
+            }
+        }
+
         // print all possible error messages..
         else if (std::strcmp(argv[i], "--errorlist") == 0) {
             _showErrorMessages = true;
@@ -596,6 +632,10 @@ bool CmdLineParser::ParseFromArgs(int argc, const char* const argv[])
                 _settings->_showtime = SHOWTIME_SUMMARY;
             else if (showtimeMode == "top5")
                 _settings->_showtime = SHOWTIME_TOP5;
+            else if (showtimeMode == "json")
+                _settings->_showtime = SHOWTIME_JSON;
+            else if (showtimeMode == "csv")
+                _settings->_showtime = SHOWTIME_CSV;
             else
                 _settings->_showtime = SHOWTIME_NONE;
         }
@@ -647,6 +687,15 @@ bool CmdLineParser::ParseFromArgs(int argc, const char* const argv[])
         }
 #endif
 
+        // Write a profile of the checked files
+        else if (std::strncmp(argv[i], "--profile-out=", 14) == 0) {
+            _settings->profileOut = argv[i] + 14;
+            if (_settings->profileOut.empty()) {
+                PrintMessage("cppcheck: No file name given to '--profile-out' option.");
+                return false;
+            }
+        }
+
         // Specify platform
         else if (std::strncmp(argv[i], "--platform=", 11) == 0) {
             std::string platform(11+argv[i]);
@@ -688,6 +737,19 @@ bool CmdLineParser::ParseFromArgs(int argc, const char* const argv[])
             maxconfigs = true;
         }
 
+        else if (std::strncmp(argv[i], "--max-execution-paths=", 22) == 0) {
+            std::istringstream iss(22+argv[i]);
+            if (!(iss >> _settings->maxExecutionPaths)) {
+                PrintMessage("cppcheck: argument to '--max-execution-paths=' is not a number.");
+                return false;
+            }
+
+            if (_settings->maxExecutionPaths < 1) {
+                PrintMessage("cppcheck: argument to '--max-execution-paths=' must be greater than 0.");
+                return false;
+            }
+        }
+
         // Print help
         else if (std::strcmp(argv[i], "-h") == 0 || std::strcmp(argv[i], "--help") == 0) {
             _pathnames.clear();
@@ -717,10 +779,6 @@ bool CmdLineParser::ParseFromArgs(int argc, const char* const argv[])
     if (_settings->_force)
         _settings->_maxConfigs = ~0U;
 
-    if (_settings->isEnabled("unusedFunction") && _settings->_jobs > 1) {
-        PrintMessage("cppcheck: unusedFunction check can't be used with '-j' option, so it's disabled.");
-    }
-
     if (_settings->inconclusive && _settings->_xml && _settings->_xml_version == 1U) {
         PrintMessage("cppcheck: inconclusive messages will not be shown, because the old xml format is not compatible. It's recommended to use the new xml format (use --xml-version=2).");
     }
@@ -758,10 +816,20 @@ void CmdLineParser::PrintHelp()
               "Options:\n"
               "    --append=<file>      This allows you to provide information about functions\n"
               "                         by providing an implementation for them.\n"
+              "    --cache-dir=<dir>    Save the results in the given directory. When the same\n"
+              "                         code is checked again with the same settings, the\n"
+              "                         saved results are reported and the code is not\n"
+              "                         checked. The directory must exist. The whole\n"
+              "                         program analysis data is saved there too, the\n"
+              "                         checks use the data of all files of the previous\n"
+              "                         run.\n"
               "    --check-config       Check cppcheck configuration. The normal code\n"
               "                         analysis is disabled by this flag.\n"
               "    --check-library      Show information messages when library files have\n"
               "                         incomplete info.\n"
+              "    --check-threads=<n>  Run the checks of each file on <n> threads. This helps\n"
+              "                         when a few big files take most of the time. The\n"
+              "                         results are the same as with one thread.\n"
               "    -D<ID>               Define preprocessor symbol. Unless --max-configs or\n"
               "                         --force is used, Cppcheck will only check the given\n"
               "                         configuration when -D is used.\n"
@@ -801,6 +869,11 @@ void CmdLineParser::PrintHelp()
               "                         provided. Note that your operating system can modify\n"
               "                         this value, e.g. '256' can become '0'.\n"
               "    --errorlist          Print a list of all the error messages in XML format.\n"
+              "    --executor=<type>    Executor used when -j is used: 'thread' (default) checks\n"
+              "                         the files in threads, 'process' checks each file in\n"
+              "                         a separate process (not available on Windows).\n"
+              "                         A crash in one file stops the whole run with\n"
+              "                         'thread', with 'process' only that file is lost.\n"
               "    --exitcode-suppressions=<file>\n"
               "                         Used when certain messages should be displayed but\n"
               "                         should not cause a non-zero exitcode.\n"
@@ -850,6 +923,12 @@ void CmdLineParser::PrintHelp()
               "                         before skipping it. Default is '12'. If used together\n"
               "                         with '--force', the last option is the one that is\n"
               "                         effective.\n"
+              "    --max-execution-paths=<limit>\n"
+              "                         Maximum number of execution paths that the execution\n"
+              "                         path checks (uninitialized variables, null pointers and\n"
+              "                         buffer overruns) follow at a condition. When there are\n"
+              "                         more, the rest of the function is skipped. Default is\n"
+              "                         '10'.\n"
               "    --platform=<type>    Specifies platform specific types and sizes. The\n"
               "                         available platforms are:\n"
               "                          * unix32\n"
@@ -862,6 +941,11 @@ void CmdLineParser::PrintHelp()
               "                                 32 bit Windows UNICODE character encoding\n"
               "                          * win64\n"
               "                                 64 bit Windows\n"
+              "    --profile-out=<file>\n"
+              "                         Write the time spent in each file, configuration and\n"
+              "                         check to the given file. The file is in the trace\n"
+              "                         event format of Chrome and can be opened in\n"
+              "                         chrome://tracing or Perfetto.\n"
               "    -q, --quiet          Only print error messages.\n"
               "    -rp, --relative-paths\n"
               "    -rp=<paths>, --relative-paths=<paths>\n"
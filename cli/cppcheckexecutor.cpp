@@ -32,6 +32,8 @@
 #include "filelister.h"
 #include "path.h"
 #include "pathmatch.h"
+#include "summarydatabase.h"
+#include "timer.h"
 
 CppCheckExecutor::CppCheckExecutor()
     : _settings(0), time1(0), errorlist(false)
@@ -71,6 +73,12 @@ bool CppCheckExecutor::parseFromArgs(CppCheck *cppcheck, int argc, const char* c
         std::exit(EXIT_FAILURE);
     }
 
+    // Check that the cache directory exists
+    if (!settings.cacheDir.empty() && !FileLister::isDirectory(settings.cacheDir)) {
+        std::cout << "cppcheck: error: couldn't find cache directory given by --cache-dir '" << Path::toNativeSeparators(settings.cacheDir) << '\'' << std::endl;
+        return false;
+    }
+
     // Check that all include paths exist
     {
         std::list<std::string>::iterator iter;
@@ -146,6 +154,7 @@ bool CppCheckExecutor::parseFromArgs(CppCheck *cppcheck, int argc, const char* c
 int CppCheckExecutor::check(int argc, const char* const argv[])
 {
     Preprocessor::missingIncludeFlag = false;
+    Preprocessor::clearHeaderCache();
 
     CppCheck cppCheck(*this, true);
 
@@ -165,7 +174,32 @@ int CppCheckExecutor::check(int argc, const char* const argv[])
         reportErr(ErrorLogger::ErrorMessage::getXMLHeader(settings._xml_version));
     }
 
+    // Whole program analysis: a file is analysed when it is checked and the
+    // checks use the data of the files checked before. With --cache-dir the
+    // data is saved and the checks use the data of the previous run too.
+    SummaryDatabase summaries;
+    std::string summaryFile;
+    if (!settings.checkConfiguration && (!settings.cacheDir.empty() || (settings._jobs == 1 && _files.size() > 1))) {
+        if (!settings.cacheDir.empty()) {
+            summaryFile = settings.cacheDir;
+            if (summaryFile[summaryFile.size() - 1] != '/')
+                summaryFile += '/';
+            summaryFile += "summaries";
+            summaries.load(summaryFile);
+
+            // The data of files that are not checked any more is dropped
+            std::set<std::string> files;
+            for (std::map<std::string, std::size_t>::const_iterator i = _files.begin(); i != _files.end(); ++i)
+                files.insert(i->first);
+            summaries.keepFiles(files);
+        }
+        summaries.merge();
+        settings.summaries = &summaries;
+    }
+
     unsigned int returnValue = 0;
+    unsigned int cacheHits = 0, cacheMisses = 0;
+    std::string profile;
     if (settings._jobs == 1) {
         // Single process
 
@@ -178,6 +212,8 @@ int CppCheckExecutor::check(int argc, const char* const argv[])
         unsigned int c = 0;
         for (std::map<std::string, std::size_t>::const_iterator i = _files.begin(); i != _files.end(); ++i) {
             returnValue += cppCheck.check(i->first);
+            if (settings.summaries)
+                summaries.addRecord(i->first, SummaryDatabase::deserialize(cppCheck.takeSummary()));
             processedsize += i->second;
             if (!settings._errorsOnly)
                 reportStatus(c + 1, _files.size(), processedsize, totalfilesize);
@@ -185,12 +221,30 @@ int CppCheckExecutor::check(int argc, const char* const argv[])
         }
 
         cppCheck.checkFunctionUsage();
+        cacheHits = cppCheck.cacheHits();
+        cacheMisses = cppCheck.cacheMisses();
+        profile = cppCheck.takeProfile();
     } else if (!ThreadExecutor::isEnabled()) {
         std::cout << "No thread support yet implemented for this platform." << std::endl;
     } else {
         // Multiple processes
         ThreadExecutor executor(_files, settings, *this);
         returnValue = executor.check();
+
+        // Merge the function usage in the same order as the files are checked by a single process
+        const std::map<std::string, std::string> &functionUsage = executor.functionUsage();
+        for (std::map<std::string, std::string>::const_iterator i = functionUsage.begin(); i != functionUsage.end(); ++i)
+            cppCheck.addFunctionUsage(i->second);
+        cppCheck.checkFunctionUsage();
+
+        // The data is added when all threads are done, the checks read it
+        const std::map<std::string, std::string> &fileSummaries = executor.summaries();
+        for (std::map<std::string, std::string>::const_iterator i = fileSummaries.begin(); i != fileSummaries.end(); ++i)
+            summaries.addRecord(i->first, SummaryDatabase::deserialize(i->second));
+
+        cacheHits = executor.cacheHits();
+        cacheMisses = executor.cacheMisses();
+        profile = executor.profile();
     }
 
     if (settings.isEnabled("information") || settings.checkConfiguration)
@@ -219,6 +273,23 @@ int CppCheckExecutor::check(int argc, const char* const argv[])
         reportErr(ErrorLogger::ErrorMessage::getXMLFooter(settings._xml_version));
     }
 
+    if (!summaryFile.empty() && !summaries.save(summaryFile))
+        std::cerr << "cppcheck: failed to write " << Path::toNativeSeparators(summaryFile) << std::endl;
+    settings.summaries = 0;
+
+    if (!settings.profileOut.empty() && !TraceEvents::write(settings.profileOut, profile))
+        std::cerr << "cppcheck: failed to write " << Path::toNativeSeparators(settings.profileOut) << std::endl;
+
+    if (!settings.cacheDir.empty() && !settings._errorsOnly)
+        std::cout << "Cache: " << cacheHits << " hits, " << cacheMisses << " misses" << std::endl;
+
+    if (settings._showtime == SHOWTIME_FILE || settings._showtime == SHOWTIME_SUMMARY || settings._showtime == SHOWTIME_TOP5) {
+        std::cout << "Duplicate errors filtered in output: " << _errorList.hits() << std::endl;
+        const unsigned long peakKiB = TraceEvents::peakMemoryKiB();
+        if (peakKiB > 0)
+            std::cout << "Peak memory usage: " << peakKiB << " KiB" << std::endl;
+    }
+
     _settings = 0;
     if (returnValue)
         return settings._exitCode;
@@ -228,11 +299,6 @@ int CppCheckExecutor::check(int argc, const char* const argv[])
 
 void CppCheckExecutor::reportErr(const std::string &errmsg)
 {
-    // Alert only about unique errors
-    if (_errorList.find(errmsg) != _errorList.end())
-        return;
-
-    _errorList.insert(errmsg);
     std::cerr << errmsg << std::endl;
 }
 
@@ -285,6 +351,9 @@ void CppCheckExecutor::reportErr(const ErrorLogger::ErrorMessage &msg)
 {
     if (errorlist) {
         reportOut(msg.toXML(false, _settings->_xml_version));
+    } else if (!_errorList.insert(msg, _settings->_verbose)) {
+        // Alert only about unique errors
+        return;
     } else if (_settings->_xml) {
         reportErr(msg.toXML(_settings->_verbose, _settings->_xml_version));
     } else {
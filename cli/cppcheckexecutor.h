@@ -116,7 +116,7 @@ private:
     /**
      * Used to filter out duplicate error messages.
      */
-    std::set<std::string> _errorList;
+    UniqueErrorFilter _errorList;
 
     /**
      * Filename associated with size of file
@@ -32,6 +32,7 @@
 #include <time.h>
 #include <cstring>
 #include <sstream>
+#include "timer.h"
 #endif
 #ifdef THREADING_MODEL_WIN
 #include <process.h>
@@ -45,10 +46,12 @@
 using std::memset;
 
 ThreadExecutor::ThreadExecutor(const std::map<std::string, std::size_t> &files, Settings &settings, ErrorLogger &errorLogger)
-    : _files(files), _settings(settings), _errorLogger(errorLogger), _fileCount(0)
+    : _files(files), _settings(settings), _errorLogger(errorLogger), _fileCount(0), _cacheHits(0), _cacheMisses(0), _workers(0)
 {
 #if defined(THREADING_MODEL_FORK)
     _wpipe = 0;
+    _nextFile = 0;
+    _useThreads = false;
 #elif defined(THREADING_MODEL_WIN)
     _processedFiles = 0;
     _totalFiles = 0;
@@ -69,6 +72,11 @@ ThreadExecutor::~ThreadExecutor()
 
 #if defined(THREADING_MODEL_FORK)
 
+static bool biggerFile(const std::pair<std::size_t, std::string> &a, const std::pair<std::size_t, std::string> &b)
+{
+    return a.first > b.first;
+}
+
 void ThreadExecutor::addFileContent(const std::string &path, const std::string &content)
 {
     _fileContents[ path ] = content;
@@ -84,7 +92,7 @@ int ThreadExecutor::handleRead(int rpipe, unsigned int &result)
         return -1;
     }
 
-    if (type != REPORT_OUT && type != REPORT_ERROR && type != REPORT_INFO && type != CHILD_END) {
+    if (type != REPORT_OUT && type != REPORT_ERROR && type != REPORT_INFO && type != CHILD_END && type != FUNCTION_USAGE && type != SUMMARY && type != PROFILE) {
         std::cerr << "#### You found a bug from cppcheck.\nThreadExecutor::handleRead error, type was:" << type << std::endl;
         std::exit(0);
     }
@@ -95,10 +103,22 @@ int ThreadExecutor::handleRead(int rpipe, unsigned int &result)
         std::exit(0);
     }
 
+    // Messages that are bigger than the pipe buffer are written in parts
     char *buf = new char[len];
-    if (read(rpipe, buf, len) <= 0) {
-        std::cerr << "#### You found a bug from cppcheck.\nThreadExecutor::handleRead error, type was:" << type << std::endl;
-        std::exit(0);
+    unsigned int bytesRead = 0;
+    while (bytesRead < len) {
+        const ssize_t n = read(rpipe, buf + bytesRead, len - bytesRead);
+        if (n > 0) {
+            bytesRead += static_cast<unsigned int>(n);
+        } else if (n < 0 && errno == EAGAIN) {
+            fd_set rfds;
+            FD_ZERO(&rfds);
+            FD_SET(rpipe, &rfds);
+            select(rpipe + 1, &rfds, NULL, NULL, NULL);
+        } else {
+            std::cerr << "#### You found a bug from cppcheck.\nThreadExecutor::handleRead error, type was:" << type << std::endl;
+            std::exit(0);
+        }
     }
 
     if (type == REPORT_OUT) {
@@ -106,30 +126,20 @@ int ThreadExecutor::handleRead(int rpipe, unsigned int &result)
     } else if (type == REPORT_ERROR || type == REPORT_INFO) {
         ErrorLogger::ErrorMessage msg;
         msg.deserialize(buf);
-
-        std::string file;
-        unsigned int line(0);
-        if (!msg._callStack.empty()) {
-            file = msg._callStack.back().getfile(false);
-            line = msg._callStack.back().line;
-        }
-
-        if (!_settings.nomsg.isSuppressed(msg._id, file, line)) {
-            // Alert only about unique errors
-            std::string errmsg = msg.toString(_settings._verbose);
-            if (std::find(_errorList.begin(), _errorList.end(), errmsg) == _errorList.end()) {
-                _errorList.push_back(errmsg);
-                if (type == REPORT_ERROR)
-                    _errorLogger.reportErr(msg);
-                else
-                    _errorLogger.reportInfo(msg);
-            }
-        }
+        reportMessage(msg, static_cast<PipeSignal>(type));
+    } else if (type == FUNCTION_USAGE) {
+        addFileData(_functionUsage, buf);
+    } else if (type == SUMMARY) {
+        addFileData(_summaries, buf);
+    } else if (type == PROFILE) {
+        _profile += buf;
     } else if (type == CHILD_END) {
         std::istringstream iss(buf);
-        unsigned int fileResult = 0;
-        iss >> fileResult;
+        unsigned int fileResult = 0, hits = 0, misses = 0;
+        iss >> fileResult >> hits >> misses;
         result += fileResult;
+        _cacheHits += hits;
+        _cacheMisses += misses;
         delete [] buf;
         return -1;
     }
@@ -138,7 +148,200 @@ int ThreadExecutor::handleRead(int rpipe, unsigned int &result)
     return 1;
 }
 
+void ThreadExecutor::reportMessage(const ErrorLogger::ErrorMessage &msg, PipeSignal type)
+{
+    std::string file;
+    unsigned int line(0);
+    if (!msg._callStack.empty()) {
+        file = msg._callStack.back().getfile(false);
+        line = msg._callStack.back().line;
+    }
+
+    if (!_settings.nomsg.isSuppressed(msg._id, file, line)) {
+        // Alert only about unique errors
+        if (_errorList.insert(msg, _settings._verbose)) {
+            if (type == REPORT_ERROR)
+                _errorLogger.reportErr(msg);
+            else
+                _errorLogger.reportInfo(msg);
+        }
+    }
+}
+
+void ThreadExecutor::addFileData(std::map<std::string, std::string> &fileData, const std::string &data)
+{
+    const std::string::size_type newline = data.find('\n');
+    if (newline != std::string::npos)
+        fileData[data.substr(0, newline)] = data.substr(newline + 1);
+}
+
 unsigned int ThreadExecutor::check()
+{
+    if (_settings.useProcesses)
+        return checkProcesses();
+    return checkThreads();
+}
+
+void *ThreadExecutor::threadProc(void *args)
+{
+    ThreadExecutor *threadExecutor = static_cast<ThreadExecutor*>(args);
+
+    // guard static members of CppCheck against concurrent access
+    pthread_mutex_lock(&threadExecutor->_fileSync);
+    CppCheck fileChecker(*threadExecutor, false);
+    fileChecker.settings() = threadExecutor->_settings;
+    // The timers are written with the results of the other threads
+    fileChecker.showStatistics(false);
+    fileChecker.setProfilePid(++threadExecutor->_workers);
+    pthread_mutex_unlock(&threadExecutor->_fileSync);
+
+    for (;;) {
+        pthread_mutex_lock(&threadExecutor->_fileSync);
+        if (threadExecutor->_nextFile >= threadExecutor->_workList.size()) {
+            pthread_mutex_unlock(&threadExecutor->_fileSync);
+            break;
+        }
+        const std::string file = threadExecutor->_workList[threadExecutor->_nextFile++].second;
+        pthread_mutex_unlock(&threadExecutor->_fileSync);
+
+        QueuedMessage end;
+        end.type = CHILD_END;
+        end.text = file;
+
+        std::map<std::string, std::string>::const_iterator fileContent = threadExecutor->_fileContents.find(file);
+        if (fileContent != threadExecutor->_fileContents.end()) {
+            // File content was given as a string
+            end.result = fileChecker.check(file, fileContent->second);
+        } else {
+            // Read file from a file
+            end.result = fileChecker.check(file);
+        }
+
+        if (threadExecutor->_settings.isEnabled("unusedFunction")) {
+            QueuedMessage usage;
+            usage.type = FUNCTION_USAGE;
+            usage.text = file + '\n' + fileChecker.takeFunctionUsage();
+            usage.result = 0;
+            threadExecutor->queueMessage(usage);
+        }
+
+        if (threadExecutor->_settings.summaries) {
+            QueuedMessage summary;
+            summary.type = SUMMARY;
+            summary.text = file + '\n' + fileChecker.takeSummary();
+            summary.result = 0;
+            threadExecutor->queueMessage(summary);
+        }
+
+        if (!threadExecutor->_settings.profileOut.empty()) {
+            QueuedMessage profile;
+            profile.type = PROFILE;
+            profile.text = fileChecker.takeProfile();
+            profile.result = 0;
+            threadExecutor->queueMessage(profile);
+        }
+
+        threadExecutor->queueMessage(end);
+    }
+
+    pthread_mutex_lock(&threadExecutor->_fileSync);
+    threadExecutor->_cacheHits += fileChecker.cacheHits();
+    threadExecutor->_cacheMisses += fileChecker.cacheMisses();
+    pthread_mutex_unlock(&threadExecutor->_fileSync);
+
+    return NULL;
+}
+
+void ThreadExecutor::queueMessage(const QueuedMessage &message)
+{
+    pthread_mutex_lock(&_messageSync);
+    _messageQueue.push_back(message);
+    pthread_cond_signal(&_messageCond);
+    pthread_mutex_unlock(&_messageSync);
+}
+
+unsigned int ThreadExecutor::checkThreads()
+{
+    _fileCount = 0;
+    _useThreads = true;
+    unsigned int result = 0;
+
+    // Check the biggest files first so one big file is not left
+    // for the end when the other threads are idle.
+    std::size_t totalfilesize = 0;
+    _workList.clear();
+    for (std::map<std::string, std::size_t>::const_iterator i = _files.begin(); i != _files.end(); ++i) {
+        totalfilesize += i->second;
+        _workList.push_back(std::make_pair(i->second, i->first));
+    }
+    std::stable_sort(_workList.begin(), _workList.end(), biggerFile);
+    _nextFile = 0;
+
+    pthread_mutex_init(&_fileSync, NULL);
+    pthread_mutex_init(&_messageSync, NULL);
+    pthread_cond_init(&_messageCond, NULL);
+
+    const std::size_t numberOfThreads = std::min<std::size_t>(_settings._jobs, _workList.size());
+    std::vector<pthread_t> threads(numberOfThreads);
+    for (std::size_t i = 0; i < numberOfThreads; ++i) {
+        const int err = pthread_create(&threads[i], NULL, threadProc, this);
+        if (err != 0) {
+            std::cerr << "Failed to create thread: " << std::strerror(err) << std::endl;
+            std::exit(EXIT_FAILURE);
+        }
+    }
+
+    // Report the messages from the worker threads
+    std::size_t processedsize = 0;
+    pthread_mutex_lock(&_messageSync);
+    while (_fileCount < _workList.size()) {
+        while (_messageQueue.empty())
+            pthread_cond_wait(&_messageCond, &_messageSync);
+
+        std::list<QueuedMessage> messages;
+        messages.swap(_messageQueue);
+        pthread_mutex_unlock(&_messageSync);
+
+        for (std::list<QueuedMessage>::const_iterator message = messages.begin(); message != messages.end(); ++message) {
+            if (message->type == REPORT_OUT) {
+                _errorLogger.reportOut(message->text);
+            } else if (message->type == REPORT_ERROR || message->type == REPORT_INFO) {
+                reportMessage(message->msg, message->type);
+            } else if (message->type == FUNCTION_USAGE) {
+                addFileData(_functionUsage, message->text);
+            } else if (message->type == SUMMARY) {
+                addFileData(_summaries, message->text);
+            } else if (message->type == PROFILE) {
+                _profile += message->text;
+            } else if (message->type == CHILD_END) {
+                result += message->result;
+
+                std::map<std::string, std::size_t>::const_iterator fs = _files.find(message->text);
+                if (fs != _files.end())
+                    processedsize += fs->second;
+
+                _fileCount++;
+                if (!_settings._errorsOnly)
+                    CppCheckExecutor::reportStatus(_fileCount, _files.size(), processedsize, totalfilesize);
+            }
+        }
+
+        pthread_mutex_lock(&_messageSync);
+    }
+    pthread_mutex_unlock(&_messageSync);
+
+    for (std::size_t i = 0; i < numberOfThreads; ++i)
+        pthread_join(threads[i], NULL);
+
+    pthread_cond_destroy(&_messageCond);
+    pthread_mutex_destroy(&_messageSync);
+    pthread_mutex_destroy(&_fileSync);
+
+    _useThreads = false;
+    return result;
+}
+
+unsigned int ThreadExecutor::checkProcesses()
 {
     _fileCount = 0;
     unsigned int result = 0;
@@ -184,6 +387,7 @@ unsigned int ThreadExecutor::check()
 
                 CppCheck fileChecker(*this, false);
                 fileChecker.settings() = _settings;
+                fileChecker.setProfilePid((unsigned int)getpid());
                 unsigned int resultOfCheck = 0;
 
                 if (!_fileContents.empty() && _fileContents.find(i->first) != _fileContents.end()) {
@@ -194,8 +398,17 @@ unsigned int ThreadExecutor::check()
                     resultOfCheck = fileChecker.check(i->first);
                 }
 
+                if (_settings.isEnabled("unusedFunction"))
+                    writeToPipe(FUNCTION_USAGE, i->first + '\n' + fileChecker.takeFunctionUsage());
+
+                if (_settings.summaries)
+                    writeToPipe(SUMMARY, i->first + '\n' + fileChecker.takeSummary());
+
+                if (!_settings.profileOut.empty())
+                    writeToPipe(PROFILE, fileChecker.takeProfile());
+
                 std::ostringstream oss;
-                oss << resultOfCheck;
+                oss << resultOfCheck << ' ' << fileChecker.cacheHits() << ' ' << fileChecker.cacheMisses();
                 writeToPipe(CHILD_END, oss.str());
                 std::exit(0);
             }
@@ -300,17 +513,41 @@ void ThreadExecutor::writeToPipe(PipeSignal type, const std::string &data)
 
 void ThreadExecutor::reportOut(const std::string &outmsg)
 {
-    writeToPipe(REPORT_OUT, outmsg);
+    if (_useThreads) {
+        QueuedMessage message;
+        message.type = REPORT_OUT;
+        message.text = outmsg;
+        message.result = 0;
+        queueMessage(message);
+    } else {
+        writeToPipe(REPORT_OUT, outmsg);
+    }
 }
 
 void ThreadExecutor::reportErr(const ErrorLogger::ErrorMessage &msg)
 {
-    writeToPipe(REPORT_ERROR, msg.serialize());
+    if (_useThreads) {
+        QueuedMessage message;
+        message.type = REPORT_ERROR;
+        message.msg = msg;
+        message.result = 0;
+        queueMessage(message);
+    } else {
+        writeToPipe(REPORT_ERROR, msg.serialize());
+    }
 }
 
 void ThreadExecutor::reportInfo(const ErrorLogger::ErrorMessage &msg)
 {
-    writeToPipe(REPORT_INFO, msg.serialize());
+    if (_useThreads) {
+        QueuedMessage message;
+        message.type = REPORT_INFO;
+        message.msg = msg;
+        message.result = 0;
+        queueMessage(message);
+    } else {
+        writeToPipe(REPORT_INFO, msg.serialize());
+    }
 }
 
 #elif defined(THREADING_MODEL_WIN)
@@ -395,6 +632,7 @@ unsigned int __stdcall ThreadExecutor::threadProc(void *args)
 
     CppCheck fileChecker(*threadExecutor, false);
     fileChecker.settings() = threadExecutor->_settings;
+    fileChecker.setProfilePid(++threadExecutor->_workers);
 
     LeaveCriticalSection(&threadExecutor->_fileSync);
 
@@ -403,6 +641,8 @@ unsigned int __stdcall ThreadExecutor::threadProc(void *args)
         EnterCriticalSection(&threadExecutor->_fileSync);
 
         if (it == threadExecutor->_files.end()) {
+            threadExecutor->_cacheHits += fileChecker.cacheHits();
+            threadExecutor->_cacheMisses += fileChecker.cacheMisses();
             LeaveCriticalSection(&threadExecutor->_fileSync);
             return result;
 
@@ -422,8 +662,19 @@ unsigned int __stdcall ThreadExecutor::threadProc(void *args)
             result += fileChecker.check(file);
         }
 
+        const std::string functionUsage = threadExecutor->_settings.isEnabled("unusedFunction") ? fileChecker.takeFunctionUsage() : std::string();
+        const std::string summary = threadExecutor->_settings.summaries ? fileChecker.takeSummary() : std::string();
+        const std::string profile = fileChecker.takeProfile();
+
         EnterCriticalSection(&threadExecutor->_fileSync);
 
+        threadExecutor->_profile += profile;
+
+        if (!functionUsage.empty())
+            threadExecutor->_functionUsage[file] = functionUsage;
+        if (threadExecutor->_settings.summaries)
+            threadExecutor->_summaries[file] = summary;
+
         threadExecutor->_processedSize += fileSize;
         threadExecutor->_processedFiles++;
         if (!threadExecutor->_settings._errorsOnly) {
@@ -469,14 +720,8 @@ void ThreadExecutor::report(const ErrorLogger::ErrorMessage &msg, MessageType ms
         return;
 
     // Alert only about unique errors
-    bool reportError = false;
-    std::string errmsg = msg.toString(_settings._verbose);
-
     EnterCriticalSection(&_errorSync);
-    if (std::find(_errorList.begin(), _errorList.end(), errmsg) == _errorList.end()) {
-        _errorList.push_back(errmsg);
-        reportError = true;
-    }
+    const bool reportError = _errorList.insert(msg, _settings._verbose);
     LeaveCriticalSection(&_errorSync);
 
     if (reportError) {
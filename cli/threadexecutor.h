@@ -26,6 +26,8 @@
 
 #if (defined(__GNUC__) || defined(__sun)) && !defined(__MINGW32__)
 #define THREADING_MODEL_FORK
+#include <pthread.h>
+#include <vector>
 #elif defined(_WIN32)
 #define THREADING_MODEL_WIN
 #include <windows.h>
@@ -59,18 +61,63 @@ public:
      */
     void addFileContent(const std::string &path, const std::string &content);
 
+    /** @brief Number of configurations whose results were read from the cache (--cache-dir) */
+    unsigned int cacheHits() const {
+        return _cacheHits;
+    }
+
+    /** @brief Number of configurations that were checked and written to the cache (--cache-dir) */
+    unsigned int cacheMisses() const {
+        return _cacheMisses;
+    }
+
+    /**
+     * @brief Function usage of each checked file (unusedFunction), key is
+     * the file name. See CppCheck::takeFunctionUsage().
+     */
+    const std::map<std::string, std::string> &functionUsage() const {
+        return _functionUsage;
+    }
+
+    /**
+     * @brief Whole program analysis data of each checked file, key is the
+     * file name. See CppCheck::takeSummary().
+     */
+    const std::map<std::string, std::string> &summaries() const {
+        return _summaries;
+    }
+
+    /** @brief Profile events of all workers (--profile-out), see CppCheck::takeProfile() */
+    const std::string &profile() const {
+        return _profile;
+    }
+
 private:
     const std::map<std::string, std::size_t> &_files;
     Settings &_settings;
     ErrorLogger &_errorLogger;
     unsigned int _fileCount;
+    unsigned int _cacheHits;
+    unsigned int _cacheMisses;
+    std::map<std::string, std::string> _functionUsage;
+    std::map<std::string, std::string> _summaries;
+    std::string _profile;
+
+    /** @brief Number of started worker threads, the workers are numbered in the profile */
+    unsigned int _workers;
 
 #if defined(THREADING_MODEL_FORK)
 
     /** @brief Key is file name, and value is the content of the file */
     std::map<std::string, std::string> _fileContents;
 private:
-    enum PipeSignal {REPORT_OUT='1',REPORT_ERROR='2', REPORT_INFO='3', CHILD_END='4'};
+    enum PipeSignal {REPORT_OUT='1',REPORT_ERROR='2', REPORT_INFO='3', CHILD_END='4', FUNCTION_USAGE='5', SUMMARY='6', PROFILE='7'};
+
+    /** @brief Check the files in a pool of threads (default) */
+    unsigned int checkThreads();
+
+    /** @brief Check each file in a fork()ed child process (--executor=process) */
+    unsigned int checkProcesses();
 
     /**
      * Read from the pipe, parse and handle what ever is in there.
@@ -80,13 +127,50 @@ private:
      */
     int handleRead(int rpipe, unsigned int &result);
     void writeToPipe(PipeSignal type, const std::string &data);
+
+    /**
+     * @brief Store a FUNCTION_USAGE or SUMMARY message, the file name and
+     * the data are on separate lines
+     */
+    static void addFileData(std::map<std::string, std::string> &fileData, const std::string &data);
+
+    /** @brief Report error or information message unless it is suppressed or a duplicate */
+    void reportMessage(const ErrorLogger::ErrorMessage &msg, PipeSignal type);
+
+    UniqueErrorFilter _errorList;
+
     /**
      * Write end of status pipe, different for each child.
      * Not used in master process.
      */
-    std::list<std::string> _errorList;
     int _wpipe;
 
+    /** @brief Message sent from a worker thread to the main thread */
+    struct QueuedMessage {
+        PipeSignal type;
+        std::string text;
+        ErrorLogger::ErrorMessage msg;
+        unsigned int result;
+    };
+
+    /** @brief Queue a message for the main thread */
+    void queueMessage(const QueuedMessage &message);
+
+    static void *threadProc(void *args);
+
+    /** @brief Files to check, the biggest file first */
+    std::vector<std::pair<std::size_t, std::string> > _workList;
+    std::size_t _nextFile;
+    pthread_mutex_t _fileSync;
+
+    /** @brief Messages from the worker threads */
+    std::list<QueuedMessage> _messageQueue;
+    pthread_mutex_t _messageSync;
+    pthread_cond_t _messageCond;
+
+    /** @brief Is the files checked by threads in this process? */
+    bool _useThreads;
+
 public:
     /**
      * @return true if support for threads exist.
@@ -108,7 +192,7 @@ private:
     std::size_t _totalFileSize;
     CRITICAL_SECTION _fileSync;
 
-    std::list<std::string> _errorList;
+    UniqueErrorFilter _errorList;
     CRITICAL_SECTION _errorSync;
 
     CRITICAL_SECTION _reportSync;
@@ -7,6 +7,11 @@ win32 {
     LIBS += -lshlwapi
 }
 
+# The ThreadExecutor uses POSIX threads
+unix {
+    LIBS += -lpthread
+}
+
 # Add more strict compiling flags for GCC
 contains(QMAKE_CXX, g++) {
     QMAKE_CXXFLAGS_WARN_ON += -Wextra -pedantic -Wfloat-equal -Wcast-qual -Wlogical-op -Wno-long-long
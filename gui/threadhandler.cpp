@@ -22,6 +22,7 @@
 #include <QDebug>
 #include "common.h"
 #include "settings.h"
+#include "preprocessor.h"
 #include "checkthread.h"
 #include "threadhandler.h"
 #include "resultsview.h"
@@ -64,6 +65,9 @@ void ThreadHandler::Check(const Settings &settings, bool recheck)
         return;
     }
 
+    // Headers might have changed since the last check
+    Preprocessor::clearHeaderCache();
+
     SetThreadCount(settings._jobs);
 
     mRunningThreadCount = mThreads.size();
@@ -59,7 +59,9 @@ public:
     }
 
     /**
-     * analyse code - must be thread safe
+     * analyse code - must be thread safe. The results of all files are
+     * merged in the summary database, the check can read them from
+     * Settings::summaries when it checks a file.
      * @param tokens The tokens to analyse
      * @param result container where results are stored
      */
@@ -69,15 +71,6 @@ public:
         (void)result;
     }
 
-    /**
-     * Save analysis data - the caller ensures thread safety
-     * @param data The data where the results are saved
-     */
-    virtual void saveAnalysisData(const std::set<std::string> &data) const {
-        // suppress compiler warnings
-        (void)data;
-    }
-
     /** run checks, the token list is not simplified */
     virtual void runChecks(const Tokenizer *, const Settings *, ErrorLogger *) {
     }
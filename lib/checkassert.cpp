@@ -49,7 +49,7 @@ void CheckAssert::assertWithSideEffects()
 
                 // functions with non-const references
                 else if (f->argCount() != 0) {
-                    for (std::list<Variable>::const_iterator it = f->argumentList.begin(); it != f->argumentList.end(); ++it) {
+                    for (StableVector<Variable>::const_iterator it = f->argumentList.begin(); it != f->argumentList.end(); ++it) {
                         if (it->isConst() || it->isLocal()) continue;
                         else if (it->isReference()) {
                             const Token* next = it->nameToken()->next();
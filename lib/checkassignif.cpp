@@ -244,7 +244,7 @@ void CheckAssignIf::multiCondition()
 
     const SymbolDatabase* const symbolDatabase = _tokenizer->getSymbolDatabase();
 
-    for (std::list<Scope>::const_iterator i = symbolDatabase->scopeList.begin(); i != symbolDatabase->scopeList.end(); ++i) {
+    for (StableVector<Scope>::const_iterator i = symbolDatabase->scopeList.begin(); i != symbolDatabase->scopeList.end(); ++i) {
         if (i->type == Scope::eIf && Token::Match(i->classDef, "if ( %var% & %num% ) {")) {
             const Token* const tok = i->classDef;
             const unsigned int varid(tok->tokAt(2)->varId());
@@ -915,7 +915,7 @@ void CheckBufferOverrun::checkScope(const Token *tok, const std::vector<std::str
     // Array index..
     if ((declarationId > 0 && Token::Match(tok, "%varid% [ %num% ]", declarationId)) ||
         (declarationId == 0 && Token::Match(tok, (varnames + " [ %num% ]").c_str()))) {
-        const MathLib::bigint index = MathLib::toLongNumber(tok->strAt(2 + varc));
+        const MathLib::bigint index = tok->tokAt(2 + varc)->number().getInt();
         if (index >= size) {
             std::vector<MathLib::bigint> indexes;
             indexes.push_back(index);
@@ -1085,7 +1085,7 @@ void CheckBufferOverrun::checkScope(const Token *tok, const std::vector<std::str
         // snprintf..
         const std::string snprintfPattern = declarationId > 0 ? std::string("snprintf ( %varid% , %num% ,") : ("snprintf ( " + varnames + " , %num% ,");
         if (Token::Match(tok, snprintfPattern.c_str(), declarationId)) {
-            const MathLib::bigint n = MathLib::toLongNumber(tok->strAt(4 + varc));
+            const MathLib::bigint n = tok->tokAt(4 + varc)->number().getInt();
             if (n > total_size)
                 outOfBoundsError(tok->tokAt(4 + varc), "snprintf size", true, n, total_size);
         }
@@ -1103,7 +1103,7 @@ void CheckBufferOverrun::checkScope(const Token *tok, const std::vector<std::str
 
         // undefined behaviour: result of pointer arithmetic is out of bounds
         else if (declarationId && Token::Match(tok, "= %varid% + %num% ;", declarationId)) {
-            const MathLib::bigint index = MathLib::toLongNumber(tok->strAt(3));
+            const MathLib::bigint index = tok->tokAt(3)->number().getInt();
             if (index > size && _settings->isEnabled("portability"))
                 pointerOutOfBoundsError(tok->next(), "buffer");
             if (index >= size && Token::Match(tok->tokAt(-2), "[;{}] %varid% =", declarationId))
@@ -1215,7 +1215,7 @@ void CheckBufferOverrun::checkScope(const Token *tok, const ArrayInfo &arrayInfo
         }
 
         if (Token::Match(tok, "strncpy|memcpy|memmove ( %varid% , %str% , %num% )", arrayInfo.declarationId())) {
-            unsigned int num = (unsigned int)MathLib::toLongNumber(tok->strAt(6));
+            unsigned int num = (unsigned int)tok->tokAt(6)->number().getInt();
             if (Token::getStrLength(tok->tokAt(4)) >= (unsigned int)total_size && (unsigned int)total_size == num) {
                 if (_settings->inconclusive)
                     bufferNotZeroTerminatedError(tok, tok->strAt(2), tok->str());
@@ -1291,7 +1291,7 @@ void CheckBufferOverrun::checkScope(const Token *tok, const ArrayInfo &arrayInfo
 
         // snprintf..
         if (total_size > 0 && Token::Match(tok, "snprintf ( %varid% , %num% ,", arrayInfo.declarationId())) {
-            const MathLib::bigint n = MathLib::toLongNumber(tok->strAt(4));
+            const MathLib::bigint n = tok->tokAt(4)->number().getInt();
             if (n > total_size)
                 outOfBoundsError(tok->tokAt(4), "snprintf size", true, n, total_size);
         }
@@ -1306,7 +1306,7 @@ void CheckBufferOverrun::checkScope(const Token *tok, const ArrayInfo &arrayInfo
 
         // undefined behaviour: result of pointer arithmetic is out of bounds
         if (_settings->isEnabled("portability") && Token::Match(tok, "= %varid% + %num% ;", arrayInfo.declarationId())) {
-            const MathLib::bigint index = MathLib::toLongNumber(tok->strAt(3));
+            const MathLib::bigint index = tok->tokAt(3)->number().getInt();
             if (index < 0 || index > arrayInfo.num(0)) {
                 pointerOutOfBoundsError(tok->next(), "array");
             }
@@ -1436,7 +1436,7 @@ void CheckBufferOverrun::checkGlobalAndLocalVariable()
                                          tok->progressValue());
 
             if (Token::Match(tok, "[*;{}] %var% = new %type% [ %num% ]")) {
-                size = MathLib::toLongNumber(tok->strAt(6));
+                size = tok->tokAt(6)->number().getInt();
                 type = tok->strAt(4);
                 var = tok->next()->variable();
                 nextTok = 8;
@@ -1453,7 +1453,7 @@ void CheckBufferOverrun::checkGlobalAndLocalVariable()
                 var = tok->next()->variable();
                 nextTok = 4;
             } else if (Token::Match(tok, "[*;{}] %var% = malloc|alloca ( %num% ) ;")) {
-                size = MathLib::toLongNumber(tok->strAt(5));
+                size = tok->tokAt(5)->number().getInt();
                 type = "char";   // minimum type, typesize=1
                 var = tok->next()->variable();
                 nextTok = 7;
@@ -1507,7 +1507,7 @@ void CheckBufferOverrun::checkStructVariable()
         const Scope * scope = symbolDatabase->classAndStructScopes[i];
 
         // check all variables to see if they are arrays
-        std::list<Variable>::const_iterator var;
+        StableVector<Variable>::const_iterator var;
         for (var = scope->varlist.begin(); var != scope->varlist.end(); ++var) {
             if (var->isArray()) {
                 // create ArrayInfo from the array variable
@@ -2040,7 +2040,7 @@ public:
 private:
     /** @brief Copy this check. Called from the ExecutionPath baseclass. */
     ExecutionPath *copy() {
-        return new ExecutionPathBufferOverrun(*this);
+        return new (pool) ExecutionPathBufferOverrun(*this);
     }
 
     /** @brief is other execution path equal? */
@@ -2056,8 +2056,8 @@ private:
     void operator=(const ExecutionPathBufferOverrun &);
 
     /** internal constructor for creating extra checks */
-    ExecutionPathBufferOverrun(Check *c, const std::map<unsigned int, CheckBufferOverrun::ArrayInfo> &arrayinfo, unsigned int varid_)
-        : ExecutionPath(c, varid_),
+    ExecutionPathBufferOverrun(Check *c, ExecutionPathPool *p, const std::map<unsigned int, CheckBufferOverrun::ArrayInfo> &arrayinfo, unsigned int varid_)
+        : ExecutionPath(c, varid_, p),
           arrayInfo(arrayinfo),
           value(0) { // Pretend that variables are initialized to 0. This checking is not about uninitialized variables.
     }
@@ -2123,7 +2123,7 @@ private:
         if (Token::Match(tok.previous(), "[;{}]")) {
             // Declaring variable..
             if (Token::Match(&tok, "%type% %var% ;") /*&& (tok.isStandardType() || isC)*/) {
-                checks.push_back(new ExecutionPathBufferOverrun(owner, arrayInfo, tok.next()->varId()));
+                checks.push_back(new (pool) ExecutionPathBufferOverrun(owner, pool, arrayInfo, tok.next()->varId()));
                 return tok.tokAt(2);
             }
 
@@ -2171,7 +2171,7 @@ void CheckBufferOverrun::executionPaths()
 
     // Perform checking - check how the arrayInfo arrays are used
     ExecutionPathBufferOverrun c(this, arrayInfo);
-    checkExecutionPaths(_tokenizer->getSymbolDatabase(), &c);
+    checkExecutionPaths(_tokenizer->getSymbolDatabase(), _settings, &c);
 }
 
 
@@ -2258,7 +2258,7 @@ void CheckBufferOverrun::writeOutsideBufferSize()
                 tok = tok->tokAt(2)->nextArgument(); // set tokenptr to %str% parameter
                 const std::size_t stringLength = Token::getStrLength(tok)+1; // zero-terminated string!
                 tok = tok->tokAt(2); // set tokenptr to %num% parameter
-                const MathLib::bigint writeLength = MathLib::toLongNumber(tok->str());
+                const MathLib::bigint writeLength = tok->number().getInt();
                 if (static_cast<std::size_t>(writeLength) > stringLength)
                     writeOutsideBufferSizeError(tok, stringLength, writeLength, functionName);
             }
@@ -87,7 +87,7 @@ void CheckClass::constructors()
         // There are no constructors.
         if (scope->numConstructors == 0 && style) {
             // If there is a private variable, there should be a constructor..
-            std::list<Variable>::const_iterator var;
+            StableVector<Variable>::const_iterator var;
             for (var = scope->varlist.begin(); var != scope->varlist.end(); ++var) {
                 if (var->isPrivate() && !var->isStatic() &&
                     (!var->isClass() || (var->type() && var->type()->needInitialization == Type::True))) {
@@ -104,7 +104,7 @@ void CheckClass::constructors()
         // TODO: handle union variables better
         {
             bool bailout = false;
-            for (std::list<Scope *>::const_iterator it = scope->nestedList.begin(); it != scope->nestedList.end(); ++it) {
+            for (std::vector<Scope *>::const_iterator it = scope->nestedList.begin(); it != scope->nestedList.end(); ++it) {
                 const Scope * const nestedScope = *it;
                 if (nestedScope->type == Scope::eUnion) {
                     bailout = true;
@@ -116,7 +116,7 @@ void CheckClass::constructors()
         }
 
 
-        std::list<Function>::const_iterator func;
+        StableVector<Function>::const_iterator func;
         std::vector<Usage> usage(scope->varlist.size());
 
         for (func = scope->functionList.begin(); func != scope->functionList.end(); ++func) {
@@ -131,7 +131,7 @@ void CheckClass::constructors()
             initializeVarList(*func, callstack, &(*scope), usage);
 
             // Check if any variables are uninitialized
-            std::list<Variable>::const_iterator var;
+            StableVector<Variable>::const_iterator var;
             unsigned int count = 0;
             for (var = scope->varlist.begin(); var != scope->varlist.end(); ++var, ++count) {
                 // check for C++11 initializer
@@ -229,7 +229,7 @@ void CheckClass::copyconstructors()
         const Scope * scope = symbolDatabase->classAndStructScopes[i];
         std::map<unsigned int, const Token*> allocatedVars;
 
-        for (std::list<Function>::const_iterator func = scope->functionList.begin(); func != scope->functionList.end(); ++func) {
+        for (StableVector<Function>::const_iterator func = scope->functionList.begin(); func != scope->functionList.end(); ++func) {
             if (func->type == Function::eConstructor && func->functionScope) {
                 const Token* tok = func->functionScope->classDef->linkAt(1);
                 for (const Token* const end = func->functionScope->classStart; tok != end; tok = tok->next()) {
@@ -251,7 +251,7 @@ void CheckClass::copyconstructors()
 
         std::set<const Token*> copiedVars;
         const Token* copyCtor = 0;
-        for (std::list<Function>::const_iterator func = scope->functionList.begin(); func != scope->functionList.end(); ++func) {
+        for (StableVector<Function>::const_iterator func = scope->functionList.begin(); func != scope->functionList.end(); ++func) {
             if (func->type == Function::eCopyConstructor) {
                 copyCtor = func->tokenDef;
                 if (func->functionScope) {
@@ -324,7 +324,7 @@ void CheckClass::noCopyConstructorError(const Token *tok, const std::string &cla
 
 bool CheckClass::canNotCopy(const Scope *scope)
 {
-    std::list<Function>::const_iterator func;
+    StableVector<Function>::const_iterator func;
     bool constructor = false;
     bool publicAssign = false;
     bool publicCopy = false;
@@ -344,7 +344,7 @@ bool CheckClass::canNotCopy(const Scope *scope)
 
 bool CheckClass::canNotMove(const Scope *scope)
 {
-    std::list<Function>::const_iterator func;
+    StableVector<Function>::const_iterator func;
     bool constructor = false;
     bool publicAssign = false;
     bool publicCopy = false;
@@ -368,7 +368,7 @@ bool CheckClass::canNotMove(const Scope *scope)
 
 void CheckClass::assignVar(const std::string &varname, const Scope *scope, std::vector<Usage> &usage)
 {
-    std::list<Variable>::const_iterator var;
+    StableVector<Variable>::const_iterator var;
     unsigned int count = 0;
 
     for (var = scope->varlist.begin(); var != scope->varlist.end(); ++var, ++count) {
@@ -381,7 +381,7 @@ void CheckClass::assignVar(const std::string &varname, const Scope *scope, std::
 
 void CheckClass::initVar(const std::string &varname, const Scope *scope, std::vector<Usage> &usage)
 {
-    std::list<Variable>::const_iterator var;
+    StableVector<Variable>::const_iterator var;
     unsigned int count = 0;
 
     for (var = scope->varlist.begin(); var != scope->varlist.end(); ++var, ++count) {
@@ -414,7 +414,7 @@ bool CheckClass::isBaseClassFunc(const Token *tok, const Scope *scope)
 
         // Check if base class exists in database
         if (derivedFrom && derivedFrom->classScope) {
-            std::list<Function>::const_iterator func;
+            StableVector<Function>::const_iterator func;
 
             for (func = derivedFrom->classScope->functionList.begin(); func != derivedFrom->classScope->functionList.end(); ++func) {
                 if (func->tokenDef->str() == tok->str())
@@ -515,7 +515,7 @@ void CheckClass::initializeVarList(const Function &func, std::list<const Functio
 
         // Calling member variable function?
         if (Token::Match(ftok->next(), "%var% . %var% (")) {
-            std::list<Variable>::const_iterator var;
+            StableVector<Variable>::const_iterator var;
             for (var = scope->varlist.begin(); var != scope->varlist.end(); ++var) {
                 if (var->declarationId() == ftok->next()->varId()) {
                     /** @todo false negative: we assume function changes variable state */
@@ -799,7 +799,7 @@ static bool checkFunctionUsage(const std::string& name, const Scope* scope)
     if (!scope)
         return true; // Assume it is used, if scope is not seen
 
-    for (std::list<Function>::const_iterator func = scope->functionList.begin(); func != scope->functionList.end(); ++func) {
+    for (StableVector<Function>::const_iterator func = scope->functionList.begin(); func != scope->functionList.end(); ++func) {
         if (func->functionScope) {
             for (const Token *ftok = func->functionScope->classDef->linkAt(1); ftok != func->functionScope->classEnd; ftok = ftok->next()) {
                 if (ftok->str() == name) // Function used. TODO: Handle overloads
@@ -811,7 +811,7 @@ static bool checkFunctionUsage(const std::string& name, const Scope* scope)
             return true;
     }
 
-    for (std::list<Scope*>::const_iterator i = scope->nestedList.begin(); i != scope->nestedList.end(); ++i) {
+    for (std::vector<Scope*>::const_iterator i = scope->nestedList.begin(); i != scope->nestedList.end(); ++i) {
         if ((*i)->isClassOrStruct())
             if (checkFunctionUsage(name, *i)) // Check nested classes, which can access private functions of their base
                 return true;
@@ -834,7 +834,7 @@ void CheckClass::privateFunctions()
             continue;
 
         std::list<const Function*> FuncList;
-        for (std::list<Function>::const_iterator func = scope->functionList.begin(); func != scope->functionList.end(); ++func) {
+        for (StableVector<Function>::const_iterator func = scope->functionList.begin(); func != scope->functionList.end(); ++func) {
             // Get private functions..
             if (func->type == Function::eFunction && func->access == Private)
                 FuncList.push_back(&*func);
@@ -972,7 +972,7 @@ void CheckClass::checkMemsetType(const Scope *start, const Token *tok, const Sco
     }
 
     // Warn if type is a class that contains any virtual functions
-    std::list<Function>::const_iterator func;
+    StableVector<Function>::const_iterator func;
 
     for (func = type->functionList.begin(); func != type->functionList.end(); ++func) {
         if (func->isVirtual) {
@@ -984,7 +984,7 @@ void CheckClass::checkMemsetType(const Scope *start, const Token *tok, const Sco
     }
 
     // Warn if type is a class or struct that contains any std::* variables
-    std::list<Variable>::const_iterator var;
+    StableVector<Variable>::const_iterator var;
 
     for (var = type->varlist.begin(); var != type->varlist.end(); ++var) {
         // don't warn if variable static or const, pointer or reference
@@ -1044,7 +1044,7 @@ void CheckClass::operatorEq()
     const std::size_t classes = symbolDatabase->classAndStructScopes.size();
     for (std::size_t i = 0; i < classes; ++i) {
         const Scope * scope = symbolDatabase->classAndStructScopes[i];
-        std::list<Function>::const_iterator func;
+        StableVector<Function>::const_iterator func;
 
         for (func = scope->functionList.begin(); func != scope->functionList.end(); ++func) {
             if (func->type == Function::eOperatorEqual && func->access != Private) {
@@ -1083,7 +1083,7 @@ void CheckClass::operatorEqRetRefThis()
     const std::size_t classes = symbolDatabase->classAndStructScopes.size();
     for (std::size_t i = 0; i < classes; ++i) {
         const Scope * scope = symbolDatabase->classAndStructScopes[i];
-        std::list<Function>::const_iterator func;
+        StableVector<Function>::const_iterator func;
 
         for (func = scope->functionList.begin(); func != scope->functionList.end(); ++func) {
             if (func->type == Function::eOperatorEqual && func->hasBody) {
@@ -1113,7 +1113,7 @@ void CheckClass::checkReturnPtrThis(const Scope *scope, const Function *func, co
             // check if a function is called
             if (tok->strAt(2) == "(" &&
                 tok->linkAt(2)->next()->str() == ";") {
-                std::list<Function>::const_iterator it;
+                StableVector<Function>::const_iterator it;
 
                 // check if it is a member function
                 for (it = scope->functionList.begin(); it != scope->functionList.end(); ++it) {
@@ -1179,7 +1179,7 @@ void CheckClass::operatorEqToSelf()
     const std::size_t classes = symbolDatabase->classAndStructScopes.size();
     for (std::size_t i = 0; i < classes; ++i) {
         const Scope * scope = symbolDatabase->classAndStructScopes[i];
-        std::list<Function>::const_iterator func;
+        StableVector<Function>::const_iterator func;
 
         // skip classes with multiple inheritance
         if (scope->definedType->derivedFrom.size() > 1)
@@ -1449,7 +1449,7 @@ void CheckClass::checkConst()
     const std::size_t classes = symbolDatabase->classAndStructScopes.size();
     for (std::size_t i = 0; i < classes; ++i) {
         const Scope * scope = symbolDatabase->classAndStructScopes[i];
-        std::list<Function>::const_iterator func;
+        StableVector<Function>::const_iterator func;
 
         for (func = scope->functionList.begin(); func != scope->functionList.end(); ++func) {
             // does the function have a body?
@@ -1548,7 +1548,7 @@ bool CheckClass::isMemberVar(const Scope *scope, const Token *tok)
         }
     } while (again);
 
-    std::list<Variable>::const_iterator var;
+    StableVector<Variable>::const_iterator var;
     for (var = scope->varlist.begin(); var != scope->varlist.end(); ++var) {
         if (var->name() == tok->str()) {
             if (tok->varId() == 0)
@@ -1616,7 +1616,7 @@ bool CheckClass::isMemberFunc(const Scope *scope, const Token *tok)
 {
     unsigned int args = countParameters(tok);
 
-    for (std::list<Function>::const_iterator func = scope->functionList.begin(); func != scope->functionList.end(); ++func) {
+    for (StableVector<Function>::const_iterator func = scope->functionList.begin(); func != scope->functionList.end(); ++func) {
         /** @todo we need to look at the argument types when there are overloaded functions
           * with the same number of arguments */
         if (func->tokenDef->str() == tok->str() && (func->argCount() == args || (func->argCount() > args && countMinArgs(func->argDef) <= args))) {
@@ -1646,7 +1646,7 @@ bool CheckClass::isConstMemberFunc(const Scope *scope, const Token *tok)
 {
     unsigned int args = countParameters(tok);
 
-    std::list<Function>::const_iterator func;
+    StableVector<Function>::const_iterator func;
     unsigned int matches = 0;
     unsigned int consts = 0;
 
@@ -1847,7 +1847,7 @@ void CheckClass::initializerListOrder()
     const std::size_t classes = symbolDatabase->classAndStructScopes.size();
     for (std::size_t i = 0; i < classes; ++i) {
         const Scope * info = symbolDatabase->classAndStructScopes[i];
-        std::list<Function>::const_iterator func;
+        StableVector<Function>::const_iterator func;
 
         // iterate through all member functions looking for constructors
         for (func = info->functionList.begin(); func != info->functionList.end(); ++func) {
@@ -1937,7 +1937,7 @@ void CheckClass::checkDuplInheritedMembers()
         return;
 
     // Iterate over all classes
-    for (std::list<Type>::const_iterator classIt = symbolDatabase->typeList.begin();
+    for (StableVector<Type>::const_iterator classIt = symbolDatabase->typeList.begin();
          classIt != symbolDatabase->typeList.end();
          ++classIt) {
         // Iterate over the parent classes
@@ -1948,10 +1948,10 @@ void CheckClass::checkDuplInheritedMembers()
             if (!parentClassIt->type || !parentClassIt->type->classScope)
                 continue;
             // Check if they have a member variable in common
-            for (std::list<Variable>::const_iterator classVarIt = classIt->classScope->varlist.begin();
+            for (StableVector<Variable>::const_iterator classVarIt = classIt->classScope->varlist.begin();
                  classVarIt != classIt->classScope->varlist.end();
                  ++classVarIt) {
-                for (std::list<Variable>::const_iterator parentClassVarIt = parentClassIt->type->classScope->varlist.begin();
+                for (StableVector<Variable>::const_iterator parentClassVarIt = parentClassIt->type->classScope->varlist.begin();
                      parentClassVarIt != parentClassIt->type->classScope->varlist.end();
                      ++parentClassVarIt) {
                     if (classVarIt->name() == parentClassVarIt->name()) { // Check if the class and its parent have a common variable
@@ -468,7 +468,7 @@ const char *CheckMemoryLeak::functionArgAlloc(const Function *func, unsigned int
     if (!func || !func->functionScope)
         return "";
 
-    std::list<Variable>::const_iterator arg = func->argumentList.begin();
+    StableVector<Variable>::const_iterator arg = func->argumentList.begin();
     for (; arg != func->argumentList.end(); ++arg) {
         if (arg->index() == targetpar-1)
             break;
@@ -730,6 +730,26 @@ static void addtoken(Token **rettail, const Token *tok, const std::string &str)
     (*rettail)->fileIndex(tok->fileIndex());
 }
 
+/**
+ * Get the end of a function call statement "; f ( .. ) ;" if the code that
+ * getcode() generates for it only depends on whether the variable is used in
+ * it.
+ */
+static const Token *callStatementEnd(const Token *tok)
+{
+    const Token *ftok = tok->next();
+    if (Token::Match(ftok, "if|for|while|switch|return|throw|catch|delete|sizeof|do|else|case|goto|setjmp|longjmp|fcloseall"))
+        return 0;
+    const Token *end = ftok->next()->link();
+    if (!end || end->strAt(1) != ";")
+        return 0;
+    for (const Token *tok2 = ftok->tokAt(2); tok2 != end; tok2 = tok2->next()) {
+        if (Token::Match(tok2, "{|}|fcloseall"))
+            return 0;
+    }
+    return end->next();
+}
+
 
 Token *CheckMemoryLeakInFunction::getcode(const Token *tok, std::list<const Token *> callstack, const unsigned int varid, CheckMemoryLeak::AllocType &alloctype, CheckMemoryLeak::AllocType &dealloctype, bool classmember, unsigned int sz)
 {
@@ -738,15 +758,33 @@ Token *CheckMemoryLeakInFunction::getcode(const Token *tok, std::list<const Toke
     std::set<unsigned int> extravar;
 
     // The first token should be ";"
-    Token* rethead = new Token(0);
+    Token* rethead = Token::create(0, &codeArena);
     rethead->str(";");
     rethead->linenr(tok->linenr());
     rethead->fileIndex(tok->fileIndex());
     Token* rettail = rethead;
 
+    // function call statement whose generated code is recorded
+    const Token *recordStart = 0;
+    const Token *recordEnd = 0;
+    Token *recordTail = 0;
+
     int indentlevel = 0;
     int parlevel = 0;
     for (; tok; tok = tok->next()) {
+        if (tok == recordEnd) {
+            if (parlevel == 0) {
+                CallStatementCode &code = callStatementCode[recordStart];
+                code.end = recordEnd;
+                code.classmember = classmember;
+                for (const Token *tok2 = recordTail->next(); tok2; tok2 = tok2->next()) {
+                    const CodeToken codeToken = { tok2->str(), tok2->linenr(), tok2->fileIndex() };
+                    code.code.push_back(codeToken);
+                }
+            }
+            recordStart = recordEnd = 0;
+        }
+
         if (tok->str() == "{") {
             addtoken(&rettail, tok, "{");
             ++indentlevel;
@@ -774,8 +812,30 @@ Token *CheckMemoryLeakInFunction::getcode(const Token *tok, std::list<const Toke
             const Token *tok2 = tok;
             while (Token::Match(tok2->next(), "%var% ."))
                 tok2 = tok2->tokAt(2);
-            if (Token::Match(tok2->next(), "%var% ("))
-                ;
+            if (Token::Match(tok2->next(), "%var% (")) {
+                // The generated code for a function call that doesn't use
+                // the variable is the same for all variables. Reuse it.
+                if (tok2 == tok && callstack.empty() && !recordStart) {
+                    std::map<const Token *, CallStatementCode>::const_iterator it = callStatementCode.find(tok);
+                    const Token *end = (it != callStatementCode.end()) ? it->second.end : callStatementEnd(tok);
+                    if (end && !Token::findmatch(tok, "%varid%", end, varid)) {
+                        if (it == callStatementCode.end()) {
+                            recordStart = tok;
+                            recordEnd = end;
+                            recordTail = rettail;
+                        } else if (it->second.classmember == classmember) {
+                            for (std::vector<CodeToken>::const_iterator code = it->second.code.begin(); code != it->second.code.end(); ++code) {
+                                rettail->insertToken(code->str);
+                                rettail = rettail->next();
+                                rettail->linenr(code->linenr);
+                                rettail->fileIndex(code->fileIndex);
+                            }
+                            tok = end->previous();
+                            continue;
+                        }
+                    }
+                }
+            }
 
             else if (Token::Match(tok->next(), "continue|break|return|throw|goto|do|else"))
                 ;
@@ -2256,6 +2316,8 @@ void CheckMemoryLeakInFunction::check()
         else
             checkScope(var->nameToken(), var->name(), i, isInMemberFunc(var->scope()), sz);
     }
+
+    callStatementCode.clear();
 }
 //---------------------------------------------------------------------------
 
@@ -2273,7 +2335,7 @@ void CheckMemoryLeakInClass::check()
     const std::size_t classes = symbolDatabase->classAndStructScopes.size();
     for (std::size_t i = 0; i < classes; ++i) {
         const Scope * scope = symbolDatabase->classAndStructScopes[i];
-        std::list<Variable>::const_iterator var;
+        StableVector<Variable>::const_iterator var;
         for (var = scope->varlist.begin(); var != scope->varlist.end(); ++var) {
             if (!var->isStatic() && var->isPointer()) {
                 // allocation but no deallocation of private variables in public function..
@@ -2315,7 +2377,7 @@ void CheckMemoryLeakInClass::variable(const Scope *scope, const Token *tokVarnam
     bool deallocInDestructor = false;
 
     // Inspect member functions
-    std::list<Function>::const_iterator func;
+    StableVector<Function>::const_iterator func;
     for (func = scope->functionList.begin(); func != scope->functionList.end(); ++func) {
         const bool constructor = func->isConstructor();
         const bool destructor = func->isDestructor();
@@ -2443,7 +2505,7 @@ void CheckMemoryLeakInClass::checkPublicFunctions(const Scope *scope, const Toke
 
     // Parse public functions..
     // If they allocate member variables, they should also deallocate
-    std::list<Function>::const_iterator func;
+    StableVector<Function>::const_iterator func;
 
     for (func = scope->functionList.begin(); func != scope->functionList.end(); ++func) {
         if ((func->type == Function::eFunction || func->type == Function::eOperatorEqual) &&
@@ -2502,13 +2564,13 @@ bool CheckMemoryLeakStructMember::isMalloc(const Variable *variable)
 void CheckMemoryLeakStructMember::checkStructVariable(const Variable * const variable)
 {
     // This should be in the CheckMemoryLeak base class
-    static std::set<std::string> ignoredFunctions;
-    if (ignoredFunctions.empty()) {
-        ignoredFunctions.insert("if");
-        ignoredFunctions.insert("for");
-        ignoredFunctions.insert("while");
-        ignoredFunctions.insert("malloc");
-    }
+    static const char * const _ignoredFunctions[] = {
+        "if",
+        "for",
+        "while",
+        "malloc"
+    };
+    static const std::set<std::string> ignoredFunctions(_ignoredFunctions, _ignoredFunctions + sizeof(_ignoredFunctions)/sizeof(*_ignoredFunctions));
 
     // Is struct variable a pointer?
     if (variable->isPointer()) {
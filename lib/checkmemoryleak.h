@@ -36,9 +36,12 @@
 
 #include "config.h"
 #include "check.h"
+#include "tokenlist.h"
 
 #include <list>
+#include <map>
 #include <string>
+#include <vector>
 
 class Token;
 class Scope;
@@ -340,6 +343,36 @@ private:
     std::set<std::string> notnoreturn;
 
     const SymbolDatabase *symbolDatabase;
+
+    /**
+     * The code that getcode() generates is allocated here. The tokens and
+     * strings are reused for the next variable.
+     */
+    TokenArena codeArena;
+
+    /** A token that getcode() generated */
+    struct CodeToken {
+        std::string str;
+        unsigned int linenr;
+        unsigned int fileIndex;
+    };
+
+    /**
+     * The code that getcode() generates for a function call statement
+     * that doesn't use the variable. It is the same for all variables
+     * that are not used in the statement.
+     */
+    struct CallStatementCode {
+        CallStatementCode() : end(0), classmember(false) { }
+
+        /** the ";" at the end of the statement */
+        const Token *end;
+        bool classmember;
+        std::vector<CodeToken> code;
+    };
+
+    /** Generated code for function call statements, by statement start */
+    std::map<const Token *, CallStatementCode> callStatementCode;
 };
 
 
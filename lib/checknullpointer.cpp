@@ -43,183 +43,186 @@ namespace {
 void CheckNullPointer::parseFunctionCall(const Token &tok, std::list<const Token *> &var, const Library *library, unsigned char value)
 {
     // standard functions that dereference first parameter..
-    static std::set<std::string> functionNames1_all;     // used no matter what 'value' is
-    static std::set<std::string> functionNames1_nullptr; // used only when 'value' is 0
-    static std::set<std::string> functionNames1_uninit;  // used only when 'value' is non-zero
-    if (functionNames1_all.empty()) {
+    static const char * const _functionNames1_all[] = {
         // cstdlib
-        functionNames1_all.insert("atoi");
-        functionNames1_all.insert("atof");
-        functionNames1_all.insert("atol");
-        functionNames1_all.insert("qsort");
-        functionNames1_all.insert("strtof");
-        functionNames1_all.insert("strtod");
-        functionNames1_all.insert("strtol");
-        functionNames1_all.insert("strtoul");
-        functionNames1_all.insert("strtold");
-        functionNames1_all.insert("strtoll");
-        functionNames1_all.insert("strtoull");
-        functionNames1_all.insert("wcstof");
-        functionNames1_all.insert("wcstod");
-        functionNames1_all.insert("wcstol");
-        functionNames1_all.insert("wcstoul");
-        functionNames1_all.insert("wcstold");
-        functionNames1_all.insert("wcstoll");
-        functionNames1_all.insert("wcstoull");
+        "atoi",
+        "atof",
+        "atol",
+        "qsort",
+        "strtof",
+        "strtod",
+        "strtol",
+        "strtoul",
+        "strtold",
+        "strtoll",
+        "strtoull",
+        "wcstof",
+        "wcstod",
+        "wcstol",
+        "wcstoul",
+        "wcstold",
+        "wcstoll",
+        "wcstoull",
         // cstring
-        functionNames1_all.insert("memchr");
-        functionNames1_all.insert("memcmp");
-        functionNames1_all.insert("strcat");
-        functionNames1_all.insert("strncat");
-        functionNames1_all.insert("strcoll");
-        functionNames1_all.insert("strchr");
-        functionNames1_all.insert("strrchr");
-        functionNames1_all.insert("strcmp");
-        functionNames1_all.insert("strncmp");
-        functionNames1_all.insert("strcspn");
-        functionNames1_all.insert("strdup");
-        functionNames1_all.insert("strndup");
-        functionNames1_all.insert("strpbrk");
-        functionNames1_all.insert("strlen");
-        functionNames1_all.insert("strspn");
-        functionNames1_all.insert("strstr");
-        functionNames1_all.insert("wcscat");
-        functionNames1_all.insert("wcsncat");
-        functionNames1_all.insert("wcscoll");
-        functionNames1_all.insert("wcschr");
-        functionNames1_all.insert("wcsrchr");
-        functionNames1_all.insert("wcscmp");
-        functionNames1_all.insert("wcsncmp");
-        functionNames1_all.insert("wcscspn");
-        functionNames1_all.insert("wcsdup");
-        functionNames1_all.insert("wcsndup");
-        functionNames1_all.insert("wcspbrk");
-        functionNames1_all.insert("wcslen");
-        functionNames1_all.insert("wcsspn");
-        functionNames1_all.insert("wcsstr");
+        "memchr",
+        "memcmp",
+        "strcat",
+        "strncat",
+        "strcoll",
+        "strchr",
+        "strrchr",
+        "strcmp",
+        "strncmp",
+        "strcspn",
+        "strdup",
+        "strndup",
+        "strpbrk",
+        "strlen",
+        "strspn",
+        "strstr",
+        "wcscat",
+        "wcsncat",
+        "wcscoll",
+        "wcschr",
+        "wcsrchr",
+        "wcscmp",
+        "wcsncmp",
+        "wcscspn",
+        "wcsdup",
+        "wcsndup",
+        "wcspbrk",
+        "wcslen",
+        "wcsspn",
+        "wcsstr",
         // cstdio
-        functionNames1_all.insert("fclose");
-        functionNames1_all.insert("feof");
-        functionNames1_all.insert("fwrite");
-        functionNames1_all.insert("fseek");
-        functionNames1_all.insert("ftell");
-        functionNames1_all.insert("fputs");
-        functionNames1_all.insert("fputws");
-        functionNames1_all.insert("ferror");
-        functionNames1_all.insert("fgetc");
-        functionNames1_all.insert("fgetwc");
-        functionNames1_all.insert("fgetpos");
-        functionNames1_all.insert("fsetpos");
-        functionNames1_all.insert("freopen");
-        functionNames1_all.insert("fscanf");
-        functionNames1_all.insert("fprintf");
-        functionNames1_all.insert("fwscanf");
-        functionNames1_all.insert("fwprintf");
-        functionNames1_all.insert("fopen");
-        functionNames1_all.insert("rewind");
-        functionNames1_all.insert("printf");
-        functionNames1_all.insert("wprintf");
-        functionNames1_all.insert("scanf");
-        functionNames1_all.insert("wscanf");
-        functionNames1_all.insert("fscanf");
-        functionNames1_all.insert("sscanf");
-        functionNames1_all.insert("fwscanf");
-        functionNames1_all.insert("swscanf");
-        functionNames1_all.insert("setbuf");
-        functionNames1_all.insert("setvbuf");
-        functionNames1_all.insert("rename");
-        functionNames1_all.insert("remove");
-        functionNames1_all.insert("puts");
-        functionNames1_all.insert("getc");
-        functionNames1_all.insert("clearerr");
+        "fclose",
+        "feof",
+        "fwrite",
+        "fseek",
+        "ftell",
+        "fputs",
+        "fputws",
+        "ferror",
+        "fgetc",
+        "fgetwc",
+        "fgetpos",
+        "fsetpos",
+        "freopen",
+        "fscanf",
+        "fprintf",
+        "fwscanf",
+        "fwprintf",
+        "fopen",
+        "rewind",
+        "printf",
+        "wprintf",
+        "scanf",
+        "wscanf",
+        "fscanf",
+        "sscanf",
+        "fwscanf",
+        "swscanf",
+        "setbuf",
+        "setvbuf",
+        "rename",
+        "remove",
+        "puts",
+        "getc",
+        "clearerr",
         // ctime
-        functionNames1_all.insert("asctime");
-        functionNames1_all.insert("ctime");
-        functionNames1_all.insert("mktime");
-
-        functionNames1_nullptr.insert("itoa");
-        functionNames1_nullptr.insert("memcpy");
-        functionNames1_nullptr.insert("memmove");
-        functionNames1_nullptr.insert("memset");
-        functionNames1_nullptr.insert("strcpy");
-        functionNames1_nullptr.insert("sprintf");
-        functionNames1_nullptr.insert("vsprintf");
-        functionNames1_nullptr.insert("vprintf");
-        functionNames1_nullptr.insert("fprintf");
-        functionNames1_nullptr.insert("vfprintf");
-        functionNames1_nullptr.insert("wcscpy");
-        functionNames1_nullptr.insert("swprintf");
-        functionNames1_nullptr.insert("vswprintf");
-        functionNames1_nullptr.insert("vwprintf");
-        functionNames1_nullptr.insert("fwprintf");
-        functionNames1_nullptr.insert("vfwprintf");
-        functionNames1_nullptr.insert("fread");
-        functionNames1_nullptr.insert("gets");
-        functionNames1_nullptr.insert("gmtime");
-        functionNames1_nullptr.insert("localtime");
-        functionNames1_nullptr.insert("strftime");
-
-        functionNames1_uninit.insert("perror");
-        functionNames1_uninit.insert("fflush");
-    }
+        "asctime",
+        "ctime",
+        "mktime"
+    };
+    static const std::set<std::string> functionNames1_all(_functionNames1_all, _functionNames1_all + sizeof(_functionNames1_all)/sizeof(*_functionNames1_all)); // used no matter what 'value' is
+    static const char * const _functionNames1_nullptr[] = {
+        "itoa",
+        "memcpy",
+        "memmove",
+        "memset",
+        "strcpy",
+        "sprintf",
+        "vsprintf",
+        "vprintf",
+        "fprintf",
+        "vfprintf",
+        "wcscpy",
+        "swprintf",
+        "vswprintf",
+        "vwprintf",
+        "fwprintf",
+        "vfwprintf",
+        "fread",
+        "gets",
+        "gmtime",
+        "localtime",
+        "strftime"
+    };
+    static const std::set<std::string> functionNames1_nullptr(_functionNames1_nullptr, _functionNames1_nullptr + sizeof(_functionNames1_nullptr)/sizeof(*_functionNames1_nullptr)); // used only when 'value' is 0
+    static const char * const _functionNames1_uninit[] = {
+        "perror",
+        "fflush"
+    };
+    static const std::set<std::string> functionNames1_uninit(_functionNames1_uninit, _functionNames1_uninit + sizeof(_functionNames1_uninit)/sizeof(*_functionNames1_uninit)); // used only when 'value' is non-zero
 
     // standard functions that dereference second parameter..
-    static std::set<std::string> functionNames2_all;     // used no matter what 'value' is
-    static std::set<std::string> functionNames2_nullptr; // used only if 'value' is 0
-    if (functionNames2_all.empty()) {
-        functionNames2_all.insert("itoa");
-        functionNames2_all.insert("mbstowcs");
-        functionNames2_all.insert("wcstombs");
-        functionNames2_all.insert("memcmp");
-        functionNames2_all.insert("memcpy");
-        functionNames2_all.insert("memmove");
-        functionNames2_all.insert("strcat");
-        functionNames2_all.insert("strncat");
-        functionNames2_all.insert("strcmp");
-        functionNames2_all.insert("strncmp");
-        functionNames2_all.insert("strcoll");
-        functionNames2_all.insert("strcpy");
-        functionNames2_all.insert("strcspn");
-        functionNames2_all.insert("strncpy");
-        functionNames2_all.insert("strpbrk");
-        functionNames2_all.insert("strspn");
-        functionNames2_all.insert("strstr");
-        functionNames2_all.insert("strxfrm");
-        functionNames2_all.insert("wcscat");
-        functionNames2_all.insert("wcsncat");
-        functionNames2_all.insert("wcscmp");
-        functionNames2_all.insert("wcsncmp");
-        functionNames2_all.insert("wcscoll");
-        functionNames2_all.insert("wcscpy");
-        functionNames2_all.insert("wcscspn");
-        functionNames2_all.insert("wcsncpy");
-        functionNames2_all.insert("wcspbrk");
-        functionNames2_all.insert("wcsspn");
-        functionNames2_all.insert("wcsstr");
-        functionNames2_all.insert("wcsxfrm");
-        functionNames2_all.insert("sprintf");
-        functionNames2_all.insert("fprintf");
-        functionNames2_all.insert("fscanf");
-        functionNames2_all.insert("sscanf");
-        functionNames2_all.insert("swprintf");
-        functionNames2_all.insert("fwprintf");
-        functionNames2_all.insert("fwscanf");
-        functionNames2_all.insert("swscanf");
-        functionNames2_all.insert("fputs");
-        functionNames2_all.insert("fputc");
-        functionNames2_all.insert("ungetc");
-        functionNames2_all.insert("fputws");
-        functionNames2_all.insert("fputwc");
-        functionNames2_all.insert("ungetwc");
-        functionNames2_all.insert("rename");
-        functionNames2_all.insert("putc");
-        functionNames2_all.insert("putwc");
-        functionNames2_all.insert("freopen");
-
-        functionNames2_nullptr.insert("frexp");
-        functionNames2_nullptr.insert("modf");
-        functionNames2_nullptr.insert("fgetpos");
-    }
+    static const char * const _functionNames2_all[] = {
+        "itoa",
+        "mbstowcs",
+        "wcstombs",
+        "memcmp",
+        "memcpy",
+        "memmove",
+        "strcat",
+        "strncat",
+        "strcmp",
+        "strncmp",
+        "strcoll",
+        "strcpy",
+        "strcspn",
+        "strncpy",
+        "strpbrk",
+        "strspn",
+        "strstr",
+        "strxfrm",
+        "wcscat",
+        "wcsncat",
+        "wcscmp",
+        "wcsncmp",
+        "wcscoll",
+        "wcscpy",
+        "wcscspn",
+        "wcsncpy",
+        "wcspbrk",
+        "wcsspn",
+        "wcsstr",
+        "wcsxfrm",
+        "sprintf",
+        "fprintf",
+        "fscanf",
+        "sscanf",
+        "swprintf",
+        "fwprintf",
+        "fwscanf",
+        "swscanf",
+        "fputs",
+        "fputc",
+        "ungetc",
+        "fputws",
+        "fputwc",
+        "ungetwc",
+        "rename",
+        "putc",
+        "putwc",
+        "freopen"
+    };
+    static const std::set<std::string> functionNames2_all(_functionNames2_all, _functionNames2_all + sizeof(_functionNames2_all)/sizeof(*_functionNames2_all)); // used no matter what 'value' is
+    static const char * const _functionNames2_nullptr[] = {
+        "frexp",
+        "modf",
+        "fgetpos"
+    };
+    static const std::set<std::string> functionNames2_nullptr(_functionNames2_nullptr, _functionNames2_nullptr + sizeof(_functionNames2_nullptr)/sizeof(*_functionNames2_nullptr)); // used only if 'value' is 0
 
     if (Token::Match(&tok, "%var% ( )") || !tok.tokAt(2))
         return;
@@ -501,7 +504,7 @@ void CheckNullPointer::nullPointerLinkedList()
     //        if (tok->str() == "hello")
     //            tok = tok->next;   // <- tok might become a null pointer!
     //    }
-    for (std::list<Scope>::const_iterator i = symbolDatabase->scopeList.begin(); i != symbolDatabase->scopeList.end(); ++i) {
+    for (StableVector<Scope>::const_iterator i = symbolDatabase->scopeList.begin(); i != symbolDatabase->scopeList.end(); ++i) {
         const Token* const tok1 = i->classDef;
         // search for a "for" scope..
         if (i->type != Scope::eFor || !tok1)
@@ -524,7 +527,7 @@ void CheckNullPointer::nullPointerLinkedList()
                     continue;
 
                 // Check usage of dereferenced variable in the loop..
-                for (std::list<Scope*>::const_iterator j = i->nestedList.begin(); j != i->nestedList.end(); ++j) {
+                for (std::vector<Scope*>::const_iterator j = i->nestedList.begin(); j != i->nestedList.end(); ++j) {
                     Scope* scope = *j;
                     if (scope->type != Scope::eWhile)
                         continue;
@@ -750,7 +753,7 @@ void CheckNullPointer::nullPointerByDeRefAndChec()
     // Dereferencing a pointer and then checking if it's NULL..
     // This check will first scan for the check. And then scan backwards
     // from the check, searching for dereferencing.
-    for (std::list<Scope>::const_iterator i = symbolDatabase->scopeList.begin(); i != symbolDatabase->scopeList.end(); ++i) {
+    for (StableVector<Scope>::const_iterator i = symbolDatabase->scopeList.begin(); i != symbolDatabase->scopeList.end(); ++i) {
         // TODO: false negatives.
         // - logical operators
         const Token* tok = i->classDef;
@@ -928,7 +931,7 @@ void CheckNullPointer::nullPointerByCheckAndDeRef()
     const SymbolDatabase *symbolDatabase = _tokenizer->getSymbolDatabase();
 
     // Check if pointer is NULL and then dereference it..
-    for (std::list<Scope>::const_iterator i = symbolDatabase->scopeList.begin(); i != symbolDatabase->scopeList.end(); ++i) {
+    for (StableVector<Scope>::const_iterator i = symbolDatabase->scopeList.begin(); i != symbolDatabase->scopeList.end(); ++i) {
         if (i->type != Scope::eIf && i->type != Scope::eElseIf && i->type != Scope::eWhile)
             continue;
         if (!i->classDef || i->classDef->isExpandedMacro())
@@ -1368,8 +1371,8 @@ private:
     const Library *library;
 
     /** Create checking of specific variable: */
-    Nullpointer(Check *c, const unsigned int id, const std::string &name, const SymbolDatabase* symbolDatabase_, const Library *lib)
-        : ExecutionPath(c, id),
+    Nullpointer(Check *c, ExecutionPathPool *p, const unsigned int id, const std::string &name, const SymbolDatabase* symbolDatabase_, const Library *lib)
+        : ExecutionPath(c, id, p),
           symbolDatabase(symbolDatabase_),
           library(lib),
           varname(name),
@@ -1378,7 +1381,7 @@ private:
 
     /** Copy this check */
     ExecutionPath *copy() {
-        return new Nullpointer(*this);
+        return new (pool) Nullpointer(*this);
     }
 
     /** no implementation => compiler error if used by accident */
@@ -1441,7 +1444,7 @@ private:
             // Pointer declaration declaration?
             const Variable *var = tok.variable();
             if (var && var->isPointer() && var->nameToken() == &tok)
-                checks.push_back(new Nullpointer(owner, var->declarationId(), var->name(), symbolDatabase, library));
+                checks.push_back(new (pool) Nullpointer(owner, pool, var->declarationId(), var->name(), symbolDatabase, library));
         }
 
         if (Token::simpleMatch(&tok, "try {")) {
@@ -1556,7 +1559,7 @@ void CheckNullPointer::executionPaths()
 {
     // Check for null pointer errors..
     Nullpointer c(this, _tokenizer->getSymbolDatabase(), &_settings->library);
-    checkExecutionPaths(_tokenizer->getSymbolDatabase(), &c);
+    checkExecutionPaths(_tokenizer->getSymbolDatabase(), _settings, &c);
 }
 
 void CheckNullPointer::nullPointerError(const Token *tok)
@@ -36,8 +36,13 @@ namespace
 CCheckStyle::CCheckStyle( ):Check( "Style" )
 {
     //ds clear all containers
-    m_vecParsedFunctionList.clear( );
-    m_vecParsedVariableList.clear( );
+    m_setParsedFunctions.clear( );
+    m_setParsedFunctionsNoScope.clear( );
+    m_setParsedFunctionsScope.clear( );
+    m_setParsedVariables.clear( );
+    m_setParsedVariablesNoScope.clear( );
+    m_setParsedVariablesScope.clear( );
+    m_setParsedVariablesType.clear( );
     m_mapWhitelist.clear( );
 }
 
@@ -45,8 +50,13 @@ CCheckStyle::CCheckStyle( ):Check( "Style" )
 CCheckStyle::CCheckStyle( const Tokenizer* p_Tokenizer, const Settings* p_Settings, ErrorLogger* p_ErrorLogger ):Check( "Style", p_Tokenizer, p_Settings, p_ErrorLogger )
 {
     //ds clear all containers
-    m_vecParsedFunctionList.clear( );
-    m_vecParsedVariableList.clear( );
+    m_setParsedFunctions.clear( );
+    m_setParsedFunctionsNoScope.clear( );
+    m_setParsedFunctionsScope.clear( );
+    m_setParsedVariables.clear( );
+    m_setParsedVariablesNoScope.clear( );
+    m_setParsedVariablesScope.clear( );
+    m_setParsedVariablesType.clear( );
     m_mapWhitelist.clear( );
 
     //ds initialize whitelist
@@ -111,8 +121,13 @@ CCheckStyle::CCheckStyle( const Tokenizer* p_Tokenizer, const Settings* p_Settin
 CCheckStyle::~CCheckStyle( )
 {
     //ds clear all containers
-    m_vecParsedFunctionList.clear( );
-    m_vecParsedVariableList.clear( );
+    m_setParsedFunctions.clear( );
+    m_setParsedFunctionsNoScope.clear( );
+    m_setParsedFunctionsScope.clear( );
+    m_setParsedVariables.clear( );
+    m_setParsedVariablesNoScope.clear( );
+    m_setParsedVariablesScope.clear( );
+    m_setParsedVariablesType.clear( );
     m_mapWhitelist.clear( );
 }
 
@@ -139,8 +154,8 @@ void CCheckStyle::checkComplete( )
             //ds check if the function is real (sometimes get 0 pointers from the statement above) and if we don't have it already checked
             if( 0 != pcFunction && false == _isChecked( pcFunction ) )
             {
-                //ds add it to our vector
-                m_vecParsedFunctionList.push_back( *pcFunction );
+                //ds add it to our sets
+                _setChecked( pcFunction );
 
                 //ds check if the function is class/struct based by determining its scope
                 if( true == pcCurrent->scope( )->isClassOrStruct( ) )
@@ -170,13 +185,10 @@ void CCheckStyle::checkComplete( )
                 }
 
                 //ds check each argument of the function as variable
-                for( std::list< Variable >::const_iterator itVariable = pcFunction->argumentList.begin( ); itVariable != pcFunction->argumentList.end( ); ++itVariable )
+                for( StableVector< Variable >::const_iterator itVariable = pcFunction->argumentList.begin( ); itVariable != pcFunction->argumentList.end( ); ++itVariable )
                 {
-                    //ds get the variable from the iterator (this avoids the overloading of checkPrefix( ) for a const_iterator Variable)
-                    Variable cVariable( *itVariable );
-
-                    //ds check for a parameter variable
-                    checkPrefixVariable( pcCurrent, &cVariable, "parameter" );
+                    //ds check for a parameter variable (no copy of the variable needed)
+                    checkPrefixVariable( pcCurrent, &( *itVariable ), "parameter" );
                 }
             }
         }
@@ -193,8 +205,8 @@ void CCheckStyle::checkComplete( )
                 //ds do not parse arguments again (parameters, they are parsed right after a function head is detected)
                 if( false == pcVariable->isArgument( ) )
                 {
-                    //ds add it to our vector
-                    m_vecParsedVariableList.push_back( *pcVariable );
+                    //ds add it to our sets
+                    _setChecked( pcVariable );
 
                     //ds check if the variable is defined inside of a class/struct by determining its scope
                     if( pcCurrent->scope( )->isClassOrStruct( ) )
@@ -1057,34 +1069,22 @@ bool CCheckStyle::_isChecked( const Function* p_cFunction ) const
         return false;
     }
 
-    //ds success bool
-    bool bHasBeenFound( false );
+    //ds the name and type have to match
+    const TFunctionKey cKey( p_cFunction->name( ), p_cFunction->type );
 
-    for( std::vector< Function >::const_iterator itFunction = m_vecParsedFunctionList.begin( ); itFunction != m_vecParsedFunctionList.end( ); ++itFunction )
+    if( 0 == m_setParsedFunctions.count( cKey ) )
     {
-        //ds check the name and type
-        if( itFunction->name( )        == p_cFunction->name( )       &&
-            itFunction->type           == p_cFunction->type          &&
-            itFunction->minArgCount( ) == itFunction->minArgCount( ) )
-        {
-            //ds if we have a scope check it
-            if( 0 != itFunction->functionScope && 0 != p_cFunction->functionScope )
-            {
-                //ds check the scope name
-                if( itFunction->functionScope->className == p_cFunction->functionScope->className )
-                {
-                    bHasBeenFound = true;
-                }
-            }
-            else
-            {
-                //ds no scope
-                bHasBeenFound = true;
-            }
-        }
+        return false;
+    }
+
+    //ds without a scope on either side the name and type are enough
+    if( 0 == p_cFunction->functionScope || 0 != m_setParsedFunctionsNoScope.count( cKey ) )
+    {
+        return true;
     }
 
-    return bHasBeenFound;
+    //ds check the scope name
+    return 0 != m_setParsedFunctionsScope.count( TFunctionScopeKey( cKey, p_cFunction->functionScope->className ) );
 }
 
 bool CCheckStyle::_isChecked( const Variable* p_cVariable ) const
@@ -1098,41 +1098,66 @@ bool CCheckStyle::_isChecked( const Variable* p_cVariable ) const
         return false;
     }
 
-    //ds success bool
-    bool bHasBeenFound( false );
+    //ds the name and index have to match
+    const TVariableKey cKey( p_cVariable->name( ), p_cVariable->index( ) );
 
-    for( std::vector< Variable >::const_iterator itVariable = m_vecParsedVariableList.begin( ); itVariable != m_vecParsedVariableList.end( ); ++itVariable )
+    if( 0 == m_setParsedVariables.count( cKey ) )
     {
-        //ds check the name
-        if( itVariable->name( )  == p_cVariable->name( )  &&
-            itVariable->index( ) == p_cVariable->index( ) )
-        {
-            //ds if we have a type
-            if( 0 != itVariable->type( ) && 0 != p_cVariable->type( ) )
-            {
-                //ds check it
-                if( itVariable->type( )->name( ) == p_cVariable->type( )->name( ) )
-                {
-                    bHasBeenFound = true;
-                }
-            }
+        return false;
+    }
 
-            //ds if we have a scope check it
-            if( 0 != itVariable->scope( ) && 0 != p_cVariable->scope( ) )
-            {
-                //ds check the scope name
-                if( itVariable->scope( )->className == p_cVariable->scope( )->className )
-                {
-                    bHasBeenFound = true;
-                }
-            }
-            else
-            {
-                //ds no scope
-                bHasBeenFound = true;
-            }
-        }
+    //ds without a scope on either side the name and index are enough
+    if( 0 == p_cVariable->scope( ) || 0 != m_setParsedVariablesNoScope.count( cKey ) )
+    {
+        return true;
+    }
+
+    //ds check the scope name
+    if( 0 != m_setParsedVariablesScope.count( TVariableScopeKey( cKey, p_cVariable->scope( )->className ) ) )
+    {
+        return true;
     }
 
-    return bHasBeenFound;
+    //ds check the type name
+    return 0 != p_cVariable->type( ) && 0 != m_setParsedVariablesType.count( TVariableScopeKey( cKey, p_cVariable->type( )->name( ) ) );
+}
+
+void CCheckStyle::_setChecked( const Function* p_cFunction )
+{
+    const TFunctionKey cKey( p_cFunction->name( ), p_cFunction->type );
+
+    m_setParsedFunctions.insert( cKey );
+
+    //ds register the scope name if we have a scope
+    if( 0 != p_cFunction->functionScope )
+    {
+        m_setParsedFunctionsScope.insert( TFunctionScopeKey( cKey, p_cFunction->functionScope->className ) );
+    }
+    else
+    {
+        m_setParsedFunctionsNoScope.insert( cKey );
+    }
+}
+
+void CCheckStyle::_setChecked( const Variable* p_cVariable )
+{
+    const TVariableKey cKey( p_cVariable->name( ), p_cVariable->index( ) );
+
+    m_setParsedVariables.insert( cKey );
+
+    //ds register the type name if we have a type
+    if( 0 != p_cVariable->type( ) )
+    {
+        m_setParsedVariablesType.insert( TVariableScopeKey( cKey, p_cVariable->type( )->name( ) ) );
+    }
+
+    //ds register the scope name if we have a scope
+    if( 0 != p_cVariable->scope( ) )
+    {
+        m_setParsedVariablesScope.insert( TVariableScopeKey( cKey, p_cVariable->scope( )->className ) );
+    }
+    else
+    {
+        m_setParsedVariablesNoScope.insert( cKey );
+    }
 }
@@ -24,6 +24,10 @@
 #include "settings.h"
 #include "symboldatabase.h"
 
+#include <set>
+#include <string>
+#include <utility>
+
 
 
 class Token;
@@ -128,21 +132,38 @@ private:
     const Token* _getLink( const Token* p_pcTokenStart ) const;
     const Token* _getLinkInverse( const Token* p_pcTokenEnd ) const;
 
-    //ds check vectors (overloaded for easy readability)
+    //ds check sets (overloaded for easy readability)
     bool _isChecked( const Function* p_cFunction ) const;
     bool _isChecked( const Variable* p_cVariable ) const;
 
+    //ds add to the checked sets (overloaded for easy readability)
+    void _setChecked( const Function* p_cFunction );
+    void _setChecked( const Variable* p_cVariable );
+
 //ds attributes
 private:
 
     //ds whitelist for names (set in constructor)
     std::map< std::string, std::string > m_mapWhitelist;
 
-    //ds vector containing all found functions
-    std::vector< Function > m_vecParsedFunctionList;
+    //ds function identity: name and type (plus the scope class name for functions with a scope)
+    typedef std::pair< std::string, int > TFunctionKey;
+    typedef std::pair< TFunctionKey, std::string > TFunctionScopeKey;
+
+    //ds variable identity: name and index (plus the scope class name or type name)
+    typedef std::pair< std::string, unsigned int > TVariableKey;
+    typedef std::pair< TVariableKey, std::string > TVariableScopeKey;
+
+    //ds sets containing the identities of all checked functions (all, without scope, with scope)
+    std::set< TFunctionKey > m_setParsedFunctions;
+    std::set< TFunctionKey > m_setParsedFunctionsNoScope;
+    std::set< TFunctionScopeKey > m_setParsedFunctionsScope;
 
-    //ds vector containing all variables
-    std::vector< Variable > m_vecParsedVariableList;
+    //ds sets containing the identities of all checked variables (all, without scope, with scope, with type)
+    std::set< TVariableKey > m_setParsedVariables;
+    std::set< TVariableKey > m_setParsedVariablesNoScope;
+    std::set< TVariableScopeKey > m_setParsedVariablesScope;
+    std::set< TVariableScopeKey > m_setParsedVariablesType;
 
 };
 
@@ -23,6 +23,7 @@
 #include "executionpath.h"
 #include "checknullpointer.h"   // CheckNullPointer::parseFunctionCall
 #include "symboldatabase.h"
+#include "summarydatabase.h"
 #include <algorithm>
 #include <map>
 #include <cassert>
@@ -54,22 +55,22 @@ static const Token * skipBrackets(const Token *tok)
 class UninitVar : public ExecutionPath {
 public:
     /** Startup constructor */
-    explicit UninitVar(Check *c, const SymbolDatabase* db, const Library *lib, bool isc)
-        : ExecutionPath(c, 0), symbolDatabase(db), library(lib), isC(isc), var(0), alloc(false), strncpy_(false), memset_nonzero(false) {
+    UninitVar(Check *c, const SymbolDatabase* db, const Library *lib, const std::set<std::string> *uvarfunc, bool isc)
+        : ExecutionPath(c, 0), symbolDatabase(db), library(lib), uvarFunctions(uvarfunc), isC(isc), var(0), alloc(false), strncpy_(false), memset_nonzero(false) {
     }
 
 private:
     /** Create a copy of this check */
     ExecutionPath *copy() {
-        return new UninitVar(*this);
+        return new (pool) UninitVar(*this);
     }
 
     /** no implementation => compiler error if used */
     void operator=(const UninitVar &);
 
     /** internal constructor for creating extra checks */
-    UninitVar(Check *c, const Variable* v, const SymbolDatabase* db, const Library *lib, bool isc)
-        : ExecutionPath(c, v->declarationId()), symbolDatabase(db), library(lib), isC(isc), var(v), alloc(false), strncpy_(false), memset_nonzero(false) {
+    UninitVar(Check *c, ExecutionPathPool *p, const Variable* v, const SymbolDatabase* db, const Library *lib, const std::set<std::string> *uvarfunc, bool isc)
+        : ExecutionPath(c, v->declarationId(), p), symbolDatabase(db), library(lib), uvarFunctions(uvarfunc), isC(isc), var(v), alloc(false), strncpy_(false), memset_nonzero(false) {
     }
 
     /** is other execution path equal? */
@@ -84,6 +85,9 @@ private:
     /** pointer to library */
     const Library *library;
 
+    /** Functions that don't handle uninitialized variables well */
+    const std::set<std::string> *uvarFunctions;
+
     const bool isC;
 
     /** variable for this check */
@@ -418,7 +422,7 @@ private:
                 }
                 const Scope* parent = var2->scope()->nestedIn;
                 while (parent) {
-                    for (std::list<Variable>::const_iterator j = parent->varlist.begin(); j != parent->varlist.end(); ++j) {
+                    for (StableVector<Variable>::const_iterator j = parent->varlist.begin(); j != parent->varlist.end(); ++j) {
                         if (j->name() == var2->name()) {
                             ExecutionPath::bailOutVar(checks, j->declarationId()); // If there is a variable with the same name in other scopes, this might cause false positives, if there are unexpanded macros
                             break;
@@ -428,7 +432,7 @@ private:
                 }
 
                 if (var2->isPointer())
-                    checks.push_back(new UninitVar(owner, var2, symbolDatabase, library, isC));
+                    checks.push_back(new (pool) UninitVar(owner, pool, var2, symbolDatabase, library, uvarFunctions, isC));
                 else if (var2->typeEndToken()->str() != ">") {
                     bool stdtype = false;  // TODO: change to isC to handle unknown types better
                     for (const Token* tok2 = var2->typeStartToken(); tok2 != var2->nameToken(); tok2 = tok2->next()) {
@@ -438,7 +442,7 @@ private:
                         }
                     }
                     if (stdtype && (!var2->isArray() || var2->nameToken()->linkAt(1)->strAt(1) == ";"))
-                        checks.push_back(new UninitVar(owner, var2, symbolDatabase, library, isC));
+                        checks.push_back(new (pool) UninitVar(owner, pool, var2, symbolDatabase, library, uvarFunctions, isC));
                 }
                 return &tok;
             }
@@ -606,7 +610,7 @@ private:
             }
         }
 
-        if (Token::Match(&tok, "%var% (") && uvarFunctions.find(tok.str()) == uvarFunctions.end()) {
+        if (Token::Match(&tok, "%var% (") && uvarFunctions->find(tok.str()) == uvarFunctions->end()) {
             // sizeof/typeof doesn't dereference. A function name that is all uppercase
             // might be an unexpanded macro that uses sizeof/typeof
             if (Token::Match(&tok, "sizeof|typeof ("))
@@ -923,9 +927,6 @@ private:
 
 public:
 
-    /** Functions that don't handle uninitialized variables well */
-    static std::set<std::string> uvarFunctions;
-
     static void analyseFunctions(const Token * const tokens, std::set<std::string> &func) {
         for (const Token *tok = tokens; tok; tok = tok->next()) {
             if (tok->str() == "{") {
@@ -1016,10 +1017,6 @@ public:
     }
 };
 
-/** Functions that don't handle uninitialized variables well */
-std::set<std::string> UninitVar::uvarFunctions;
-
-
 /// @}
 
 
@@ -1028,21 +1025,18 @@ void CheckUninitVar::analyse(const Token * tokens, std::set<std::string> &func)
     UninitVar::analyseFunctions(tokens, func);
 }
 
-void CheckUninitVar::saveAnalysisData(const std::set<std::string> &data) const
-{
-    UninitVar::uvarFunctions.insert(data.begin(), data.end());
-}
-
 void CheckUninitVar::executionPaths()
 {
     // check if variable is accessed uninitialized..
     {
-        // no writing if multiple threads are used (TODO: thread safe analysis?)
-        if (_settings->_jobs == 1)
-            UninitVar::analyseFunctions(_tokenizer->tokens(), UninitVar::uvarFunctions);
-
-        UninitVar c(this, _tokenizer->getSymbolDatabase(), &_settings->library, _tokenizer->isC());
-        checkExecutionPaths(_tokenizer->getSymbolDatabase(), &c);
+        // the functions in this file and in the other files of the program
+        std::set<std::string> uvarFunctions;
+        if (_settings->summaries)
+            uvarFunctions = _settings->summaries->data(myName());
+        UninitVar::analyseFunctions(_tokenizer->tokens(), uvarFunctions);
+
+        UninitVar c(this, _tokenizer->getSymbolDatabase(), &_settings->library, &uvarFunctions, _tokenizer->isC());
+        checkExecutionPaths(_tokenizer->getSymbolDatabase(), _settings, &c);
     }
 }
 
@@ -1050,7 +1044,7 @@ void CheckUninitVar::executionPaths()
 void CheckUninitVar::check()
 {
     const SymbolDatabase *symbolDatabase = _tokenizer->getSymbolDatabase();
-    std::list<Scope>::const_iterator scope;
+    StableVector<Scope>::const_iterator scope;
 
     // check every executable scope
     for (scope = symbolDatabase->scopeList.begin(); scope != symbolDatabase->scopeList.end(); ++scope) {
@@ -1062,7 +1056,7 @@ void CheckUninitVar::check()
 
 void CheckUninitVar::checkScope(const Scope* scope)
 {
-    for (std::list<Variable>::const_iterator i = scope->varlist.begin(); i != scope->varlist.end(); ++i) {
+    for (StableVector<Variable>::const_iterator i = scope->varlist.begin(); i != scope->varlist.end(); ++i) {
         if ((_tokenizer->isCPP() && i->type() && !i->isPointer() && i->type()->needInitialization != Type::True) ||
             i->isStatic() || i->isExtern() || i->isConst() || i->isArray() || i->isReference())
             continue;
@@ -1098,7 +1092,7 @@ void CheckUninitVar::checkScope(const Scope* scope)
             for (std::size_t j = 0U; j < symbolDatabase->classAndStructScopes.size(); ++j) {
                 const Scope *scope2 = symbolDatabase->classAndStructScopes[j];
                 if (scope2->className == structname && scope2->numConstructors == 0U) {
-                    for (std::list<Variable>::const_iterator it = scope2->varlist.begin(); it != scope2->varlist.end(); ++it) {
+                    for (StableVector<Variable>::const_iterator it = scope2->varlist.begin(); it != scope2->varlist.end(); ++it) {
                         const Variable &var = *it;
                         if (!var.isArray())
                             checkScopeForVariable(scope, tok, *i, NULL, NULL, var.name());
@@ -72,9 +72,6 @@ public:
      */
     void analyse(const Token * tokens, std::set<std::string> &func) const;
 
-    /** Save analysis results */
-    void saveAnalysisData(const std::set<std::string> &data) const;
-
     /** @brief new type of check: check execution paths */
     void executionPaths();
 
@@ -22,6 +22,7 @@
 #include "tokenize.h"
 #include "token.h"
 #include <cctype>
+#include <sstream>
 //---------------------------------------------------------------------------
 
 
@@ -153,6 +154,53 @@ void CheckUnusedFunctions::parseTokens(const Tokenizer &tokenizer)
 
 
 
+std::string CheckUnusedFunctions::summary() const
+{
+    // One function per line: name, line number, used flags, file name.
+    // The file name is last because it can contain spaces.
+    std::ostringstream oss;
+    for (std::map<std::string, FunctionUsage>::const_iterator it = _functions.begin(); it != _functions.end(); ++it) {
+        const FunctionUsage &func = it->second;
+        oss << it->first << ' ' << func.lineNumber << ' ' << func.usedSameFile << ' ' << func.usedOtherFile << ' ' << func.filename << '\n';
+    }
+    return oss.str();
+}
+
+void CheckUnusedFunctions::merge(const std::string &summary)
+{
+    std::istringstream iss(summary);
+    std::string name;
+    while (iss >> name) {
+        FunctionUsage other;
+        iss >> other.lineNumber >> other.usedSameFile >> other.usedOtherFile;
+        iss.get();
+        std::getline(iss, other.filename);
+
+        FunctionUsage &func = _functions[name];
+
+        // Function declaration, same as in parseTokens()
+        if (!other.filename.empty()) {
+            if (!func.lineNumber)
+                func.lineNumber = other.lineNumber;
+
+            if (func.filename.empty())
+                func.filename = other.filename;
+            else if (func.filename != other.filename)
+                func.usedOtherFile |= func.usedSameFile;
+        }
+
+        // Function usage
+        if (other.usedSameFile || other.usedOtherFile) {
+            if (func.filename.empty() || func.filename == "+")
+                func.usedOtherFile = true;
+            else
+                func.usedSameFile = true;
+        }
+    }
+}
+
+
+
 
 void CheckUnusedFunctions::check(ErrorLogger * const errorLogger)
 {
@@ -46,6 +46,24 @@ public:
     // * What functions are declared
     void parseTokens(const Tokenizer &tokenizer);
 
+    /**
+     * @brief The declared and used functions as text. When the files are
+     * checked in parallel each file gets its own summary, and they are
+     * merged before check() is called.
+     */
+    std::string summary() const;
+
+    /**
+     * @brief Add a summary() from another instance. Merging the summaries
+     * of the files in the order they are checked gives the same result as
+     * parsing all files with one instance.
+     */
+    void merge(const std::string &summary);
+
+    void clear() {
+        _functions.clear();
+    }
+
     void check(ErrorLogger * const errorLogger);
 
 private:
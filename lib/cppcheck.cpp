@@ -22,11 +22,18 @@
 
 #include "check.h"
 #include "path.h"
+#include "threadpool.h"
+#include "utils.h"
 
 #include <algorithm>
+#include <cstdio>
 #include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
 #include <sstream>
 #include <stdexcept>
+#include <vector>
 #include "timer.h"
 
 #ifdef HAVE_RULES
@@ -39,15 +46,94 @@ static const char ExtraVersion[] = "";
 
 static TimerResults S_timerResults;
 
+static const unsigned int timerPreprocess = Timer::id("Preprocessor::preprocess");
+static const unsigned int timerGetcode = Timer::id("Preprocessor::getcode");
+static const unsigned int timerTokenize = Timer::id("Tokenizer::tokenize");
+static const unsigned int timerSimplifyTokenList = Timer::id("Tokenizer::simplifyTokenList");
+
+namespace {
+    /** The messages of the whole program analysis are not shown, they come when the file is checked */
+    class SilentErrorLogger : public ErrorLogger {
+    public:
+        virtual void reportOut(const std::string &) {
+        }
+        virtual void reportErr(const ErrorLogger::ErrorMessage &) {
+        }
+    };
+}
+
+#ifdef HAVE_RULES
+struct CppCheck::CompiledRules {
+    struct Entry {
+        Settings::Rule rule;
+        unsigned int timerId;
+        pcre *re;
+        pcre_extra *extra;
+    };
+
+    std::vector<Entry> entries;
+
+    ~CompiledRules() {
+        for (std::vector<Entry>::iterator it = entries.begin(); it != entries.end(); ++it) {
+            if (it->extra) {
+#ifdef PCRE_STUDY_JIT_COMPILE
+                pcre_free_study(it->extra);
+#else
+                pcre_free(it->extra);
+#endif
+            }
+            pcre_free(it->re);
+        }
+    }
+};
+#else
+struct CppCheck::CompiledRules {
+};
+#endif
+
 CppCheck::CppCheck(ErrorLogger &errorLogger, bool useGlobalSuppressions)
-    : _errorLogger(errorLogger), exitcode(0), _useGlobalSuppressions(useGlobalSuppressions), tooManyConfigs(false), _simplify(true), m_strRawCode( "" )
+    : _checkUnusedFunctions(0, 0, 0), _errorLogger(errorLogger), exitcode(0), _useGlobalSuppressions(useGlobalSuppressions), tooManyConfigs(false), _simplify(true), m_strRawCode( "" ), _recordResults(false), _cacheHits(0), _cacheMisses(0), _showStatistics(true), _profileTokens(0), _profileSimplifiedTokens(0), _compiledRules(0)
 {
 }
 
 CppCheck::~CppCheck()
 {
-    if (_settings._showtime != SHOWTIME_NONE)
-        S_timerResults.ShowResults();
+    delete _compiledRules;
+
+    S_timerResults.merge(_timerResults);
+    if (!_showStatistics)
+        return;
+
+    if (_settings._showtime == SHOWTIME_SUMMARY || _settings._showtime == SHOWTIME_TOP5 || _settings._showtime == SHOWTIME_JSON || _settings._showtime == SHOWTIME_CSV)
+        S_timerResults.ShowResults(_settings._showtime, std::cout);
+
+    // the other statistics are not written in the machine-readable formats
+    if (_settings._showtime == SHOWTIME_FILE || _settings._showtime == SHOWTIME_SUMMARY || _settings._showtime == SHOWTIME_TOP5) {
+        std::cout << "Duplicate errors filtered: " << _errorFilter.hits() << std::endl;
+        std::cout << "Tokens allocated: " << _tokenStats.tokens
+                  << " (" << _tokenStats.reused << " reused, "
+                  << _tokenStats.slabs << " slabs, "
+                  << _tokenStats.strings << " strings, "
+                  << (_tokenStats.bytes / 1024U) << " KiB)" << std::endl;
+        std::cout << "Simplify iterations: " << _simplifyStats.iterations
+                  << " (" << _simplifyStats.tokensVisited << " of " << _simplifyStats.tokensTotal
+                  << " tokens visited per pass)" << std::endl;
+
+        const Preprocessor::HeaderCacheStats headers(Preprocessor::headerCacheStats());
+        const std::size_t headerReads = headers.hits + headers.misses;
+        std::cout << "Header cache: " << headers.hits << " hits, " << headers.misses << " misses ("
+                  << (headerReads ? (100U * headers.hits / headerReads) : 0U) << "% hit rate, "
+                  << (headers.bytesSaved / 1024U) << " KiB saved), "
+                  << headers.resolveHits << " of " << (headers.resolveHits + headers.resolveMisses)
+                  << " header paths cached" << std::endl;
+        std::cout << "Execution paths: " << _executionPathStats.paths << " in "
+                  << _executionPathStats.functions << " function checks ("
+                  << _executionPathStats.merges << " merged, "
+                  << _executionPathStats.budgetBailouts << " budget bailouts)";
+        if (_executionPathStats.maxPaths > 0)
+            std::cout << ", most in " << _executionPathStats.maxPathsFunction << ": " << _executionPathStats.maxPaths;
+        std::cout << std::endl;
+    }
 }
 
 const char * CppCheck::version()
@@ -104,6 +190,7 @@ bool CppCheck::findError(std::string code, const char FileName[])
             // is still there.
             code = previousCode.substr(found+9);
             _errorList.clear();
+            _errorFilter.clear();
             checkFile(code, FileName);
         }
 
@@ -133,6 +220,11 @@ unsigned int CppCheck::processFile(const std::string& filename)
 {
     exitcode = 0;
 
+    const bool profile = !_settings.profileOut.empty();
+    const double fileStart = profile ? Timer::wallTime() : 0.0;
+    _timerResults.recordEvents(profile);
+    _traceEvents.setFile(filename, "");
+
     // only show debug warnings for accepted C/C++ source files
     if (!Path::acceptFile(filename))
         _settings.debugwarnings = false;
@@ -161,9 +253,10 @@ unsigned int CppCheck::processFile(const std::string& filename)
         } else {
             // Only file name was given, read the content from file
             std::ifstream fin(filename.c_str());
-            Timer t("Preprocessor::preprocess", _settings._showtime, &S_timerResults);
+            Timer t(timerPreprocess, timerMode(), &_timerResults);
             preprocessor.preprocess(fin, filedata, m_strRawCode, configurations, filename, _settings._includePaths);
         }
+        _traceEvents.addTimerEvents(_timerResults, 0);
 
         // Run rules on this code
         for (std::list<Settings::Rule>::const_iterator it = _settings.rules.begin(); it != _settings.rules.end(); ++it) {
@@ -204,41 +297,81 @@ unsigned int CppCheck::processFile(const std::string& filename)
             }
         }
 
+        // Preprocessed code of the configurations that have been checked, by
+        // hash. Often many configurations only differ in code that is not used.
+        // There is no need to tokenize and check the same code again.
+        std::multimap<unsigned long long, std::string> checkedCode;
+
+        // The line table is shared by all configurations
+        const PreprocessorLines lines(filedata);
+
         unsigned int checkCount = 0;
         for (std::list<std::string>::const_iterator it = configurations.begin(); it != configurations.end(); ++it) {
-            // Check only a few configurations (default 12), after that bail out, unless --force
-            // was used.
-            if (!_settings._force && ++checkCount > _settings._maxConfigs)
-                break;
-
             cfg = *it;
 
-            // If only errors are printed, print filename after the check
-            if (_settings._errorsOnly == false && it != configurations.begin()) {
-                std::string fixedpath = Path::simplifyPath(filename.c_str());
-                fixedpath = Path::toNativeSeparators(fixedpath);
-                _errorLogger.reportOut(std::string("Checking ") + fixedpath + ": " + cfg + std::string("..."));
-            }
-
             if (!_settings.userDefines.empty()) {
                 if (!cfg.empty())
                     cfg = ";" + cfg;
                 cfg = _settings.userDefines + cfg;
             }
 
-            Timer t("Preprocessor::getcode", _settings._showtime, &S_timerResults);
-            const std::string codeWithoutCfg = preprocessor.getcode(filedata, cfg, filename);
+            _traceEvents.setFile(filename, cfg);
+            const double cfgStart = profile ? Timer::wallTime() : 0.0;
+            _profileTokens = _profileSimplifiedTokens = 0;
+
+            Timer t(timerGetcode, timerMode(), &_timerResults);
+            const std::string codeWithoutCfg = preprocessor.getcode(lines, cfg, filename);
             t.Stop();
 
+            // Identical code is skipped before it is counted as a checked configuration.
+            // The hash only finds the candidates, the code is compared too.
+            const unsigned long long hash = fnv1a(FNV1A_OFFSET_BASIS, codeWithoutCfg);
+            typedef std::multimap<unsigned long long, std::string>::const_iterator CodeIterator;
+            const std::pair<CodeIterator, CodeIterator> sameHash = checkedCode.equal_range(hash);
+            bool checked = false;
+            for (CodeIterator code = sameHash.first; code != sameHash.second && !checked; ++code)
+                checked = (code->second == codeWithoutCfg);
+            if (checked) {
+                _traceEvents.addTimerEvents(_timerResults, 0);
+                continue;
+            }
+            checkedCode.insert(std::make_pair(hash, codeWithoutCfg));
+
+            // Check only a few configurations (default 12), after that bail out, unless --force
+            // was used.
+            if (!_settings._force && checkCount >= _settings._maxConfigs) {
+                _traceEvents.addTimerEvents(_timerResults, 0);
+                break;
+            }
+
+            // If only errors are printed, print filename after the check
+            if (_settings._errorsOnly == false && checkCount > 0) {
+                std::string fixedpath = Path::simplifyPath(filename.c_str());
+                fixedpath = Path::toNativeSeparators(fixedpath);
+                _errorLogger.reportOut(std::string("Checking ") + fixedpath + ": " + *it + std::string("..."));
+            }
+            ++checkCount;
+
             const std::string &appendCode = _settings.append();
 
             if (_settings.debugFalsePositive) {
                 if (findError(codeWithoutCfg + appendCode, filename.c_str())) {
                     return exitcode;
                 }
+            } else if (!_settings.cacheDir.empty() && !_settings.isEnabled("unusedFunction")) {
+                checkFileCached(codeWithoutCfg + appendCode, filename);
             } else {
                 checkFile(codeWithoutCfg + appendCode, filename.c_str());
             }
+
+            if (profile) {
+                std::ostringstream args;
+                args << "\"tokens\": " << _profileTokens
+                     << ", \"simplifiedTokens\": " << _profileSimplifiedTokens
+                     << ", \"peakMemoryKiB\": " << TraceEvents::peakMemoryKiB();
+                _traceEvents.add(cfg.empty() ? std::string("(default)") : cfg, "configuration", 0, cfgStart, Timer::wallTime() - cfgStart, args.str());
+                _traceEvents.addTimerEvents(_timerResults, 0);
+            }
         }
     } catch (const std::runtime_error &e) {
         internalError(filename, e.what());
@@ -246,10 +379,17 @@ unsigned int CppCheck::processFile(const std::string& filename)
         internalError(filename, e.errorMessage);
     }
 
+    if (profile) {
+        _traceEvents.setFile(filename, "");
+        _traceEvents.addTimerEvents(_timerResults, 0);
+        _traceEvents.add(filename, "file", 0, fileStart, Timer::wallTime() - fileStart);
+    }
+
     if (_settings.isEnabled("information") || _settings.checkConfiguration)
         reportUnmatchedSuppressions(_settings.nomsg.getUnmatchedLocalSuppressions(filename));
 
     _errorList.clear();
+    _errorFilter.clear();
     return exitcode;
 }
 
@@ -281,7 +421,7 @@ void CppCheck::internalError(const std::string &filename, const std::string &msg
 void CppCheck::checkFunctionUsage()
 {
     // This generates false positives - especially for libraries
-    if (_settings.isEnabled("unusedFunction") && _settings._jobs == 1) {
+    if (_settings.isEnabled("unusedFunction")) {
         const bool verbose_orig = _settings._verbose;
         _settings._verbose = false;
 
@@ -294,51 +434,119 @@ void CppCheck::checkFunctionUsage()
     }
 }
 
-void CppCheck::analyseFile(std::istream &fin, const std::string &filename)
+std::string CppCheck::takeFunctionUsage()
+{
+    const std::string summary = _checkUnusedFunctions.summary();
+    _checkUnusedFunctions.clear();
+    return summary;
+}
+
+void CppCheck::addFunctionUsage(const std::string &summary)
+{
+    _checkUnusedFunctions.merge(summary);
+}
+
+std::string CppCheck::takeProfile()
+{
+    return _traceEvents.take();
+}
+
+void CppCheck::setProfilePid(unsigned int pid)
+{
+    _traceEvents.setPid(pid);
+}
+
+unsigned int CppCheck::timerMode() const
+{
+    // --profile-out needs the measurements even when they are not shown
+    if (_settings._showtime == SHOWTIME_NONE && !_settings.profileOut.empty())
+        return SHOWTIME_SUMMARY;
+    return _settings._showtime;
+}
+
+std::string CppCheck::takeSummary()
 {
+    const std::string summary = SummaryDatabase::serialize(_summary);
+    _summary.clear();
+    return summary;
+}
+
+void CppCheck::addSummary(const SummaryDatabase::Record &record)
+{
+    if (_recordResults && !record.empty())
+        recordResult('S', SummaryDatabase::serialize(record));
+
+    for (SummaryDatabase::Record::const_iterator it = record.begin(); it != record.end(); ++it)
+        _summary[it->first].insert(it->second.begin(), it->second.end());
+}
+
+SummaryDatabase::Record CppCheck::analyseTokens(const Tokenizer &tokenizer)
+{
+    SummaryDatabase::Record record;
+    for (std::list<Check *>::const_iterator it = Check::instances().begin(); it != Check::instances().end(); ++it) {
+        std::set<std::string> data;
+        (*it)->analyse(tokenizer.tokens(), data);
+        if (!data.empty())
+            record[(*it)->name()].swap(data);
+    }
+    return record;
+}
+
+void CppCheck::analyseFile(std::istream &fin, const std::string &filename, SummaryDatabase &summaries)
+{
+    SilentErrorLogger errorLogger;
+
     // Preprocess file..
-    Preprocessor preprocessor(&_settings, this);
+    Preprocessor preprocessor(&_settings, &errorLogger);
     std::list<std::string> configurations;
     std::string filedata = "";
     preprocessor.preprocess(fin, filedata, configurations, filename, _settings._includePaths);
-    const std::string code = preprocessor.getcode(filedata, "", filename);
+    cfg = "";
+    const std::string code = preprocessor.getcode(filedata, cfg, filename);
 
     if (_settings.checkConfiguration) {
         return;
     }
 
     // Tokenize..
-    Tokenizer tokenizer(&_settings, this);
+    Tokenizer tokenizer(&_settings, &errorLogger);
     std::istringstream istr(code);
-    tokenizer.tokenize(istr, filename.c_str(), "");
-    tokenizer.simplifyTokenList();
-
-    // Analyse the tokens..
-    std::set<std::string> data;
-    for (std::list<Check *>::const_iterator it = Check::instances().begin(); it != Check::instances().end(); ++it) {
-        (*it)->analyse(tokenizer.tokens(), data);
+    try {
+        if (!tokenizer.tokenize(istr, filename.c_str(), "") || !tokenizer.simplifyTokenList())
+            return;
+    } catch (const InternalError &) {
+        // It is reported when the file is checked
+        return;
     }
 
-    // Save analysis results..
-    // TODO: This loop should be protected by a mutex or something like that
-    //       The saveAnalysisData must _not_ be called from many threads at the same time.
-    for (std::list<Check *>::const_iterator it = Check::instances().begin(); it != Check::instances().end(); ++it) {
-        (*it)->saveAnalysisData(data);
-    }
+    // Analyse the tokens..
+    summaries.addRecord(filename, analyseTokens(tokenizer));
 }
 
 //---------------------------------------------------------------------------
 // CppCheck - A function that checks a specified file
 //---------------------------------------------------------------------------
 
+static std::size_t countTokens(const Token *tok)
+{
+    std::size_t count = 0;
+    for (; tok; tok = tok->next())
+        ++count;
+    return count;
+}
+
 void CppCheck::checkFile(const std::string &code, const char FileName[])
 {
     if (_settings.terminated() || _settings.checkConfiguration)
         return;
 
     Tokenizer _tokenizer(&_settings, this);
-    if (_settings._showtime != SHOWTIME_NONE)
-        _tokenizer.setTimerResults(&S_timerResults);
+    if (_settings._showtime != SHOWTIME_NONE) {
+        _tokenizer.setTimerResults(&_timerResults);
+        _tokenizer.setTokenStats(&_tokenStats);
+        _tokenizer.setSimplifyStats(&_simplifyStats);
+    }
+    _settings.executionPathStats = (_settings._showtime != SHOWTIME_NONE) ? &_executionPathStats : 0;
     try {
         bool result;
 
@@ -356,7 +564,7 @@ void CppCheck::checkFile(const std::string &code, const char FileName[])
         // Tokenize the file
         std::istringstream istr(code);
 
-        Timer timer("Tokenizer::tokenize", _settings._showtime, &S_timerResults);
+        Timer timer(timerTokenize, timerMode(), &_timerResults);
 
         //ds add the raw code to the tokenizer
         result = _tokenizer.tokenize(istr, FileName, cfg, m_strRawCode);
@@ -366,21 +574,24 @@ void CppCheck::checkFile(const std::string &code, const char FileName[])
             // File had syntax errors, abort
             return;
         }
+        if (!_settings.profileOut.empty())
+            _profileTokens = countTokens(_tokenizer.tokens());
 
         // Update the _dependencies..
-        if (_tokenizer.list.getFiles().size() >= 2)
+        if (_tokenizer.list.getFiles().size() >= 2) {
             _dependencies.insert(_tokenizer.list.getFiles().begin()+1, _tokenizer.list.getFiles().end());
+            if (_recordResults) {
+                for (std::vector<std::string>::const_iterator it = _tokenizer.list.getFiles().begin()+1; it != _tokenizer.list.getFiles().end(); ++it)
+                    recordResult('D', *it);
+            }
+        }
 
         // call all "runChecks" in all registered Check classes
-        for (std::list<Check *>::iterator it = Check::instances().begin(); it != Check::instances().end(); ++it) {
-            if (_settings.terminated())
-                return;
-
-            Timer timerRunChecks((*it)->name() + "::runChecks", _settings._showtime, &S_timerResults);
-            (*it)->runChecks(&_tokenizer, &_settings, this);
-        }
+        runChecks(_tokenizer, false);
+        if (_settings.terminated())
+            return;
 
-        if (_settings.isEnabled("unusedFunction") && _settings._jobs == 1)
+        if (_settings.isEnabled("unusedFunction"))
             _checkUnusedFunctions.parseTokens(_tokenizer);
 
         executeRules("normal", _tokenizer);
@@ -388,20 +599,20 @@ void CppCheck::checkFile(const std::string &code, const char FileName[])
         if (!_simplify)
             return;
 
-        Timer timer3("Tokenizer::simplifyTokenList", _settings._showtime, &S_timerResults);
+        Timer timer3(timerSimplifyTokenList, timerMode(), &_timerResults);
         result = _tokenizer.simplifyTokenList();
         timer3.Stop();
         if (!result)
             return;
+        if (!_settings.profileOut.empty())
+            _profileSimplifiedTokens = countTokens(_tokenizer.tokens());
 
-        // call all "runSimplifiedChecks" in all registered Check classes
-        for (std::list<Check *>::iterator it = Check::instances().begin(); it != Check::instances().end(); ++it) {
-            if (_settings.terminated())
-                return;
+        // whole program analysis data for the summary database
+        if (_settings.summaries)
+            addSummary(analyseTokens(_tokenizer));
 
-            Timer timerSimpleChecks((*it)->name() + "::runSimplifiedChecks", _settings._showtime, &S_timerResults);
-            (*it)->runSimplifiedChecks(&_tokenizer, &_settings, this);
-        }
+        // call all "runSimplifiedChecks" in all registered Check classes
+        runChecks(_tokenizer, true);
 
         if (_settings.terminated())
             return;
@@ -430,10 +641,305 @@ void CppCheck::checkFile(const std::string &code, const char FileName[])
                                                "cppcheckError",
                                                false);
 
+        if (_recordResults)
+            recordResult('C', errmsg.serialize());
         _errorLogger.reportErr(errmsg);
     }
 }
 
+namespace {
+    /** @brief The messages of one check, they are reported when all checks are done */
+    class CheckResults : public ErrorLogger {
+    public:
+        CheckResults() : failure(NO_FAILURE), internalError(0, "") {
+        }
+
+        void reportOut(const std::string &outmsg) {
+            add('O', outmsg, ErrorLogger::ErrorMessage());
+        }
+
+        void reportErr(const ErrorLogger::ErrorMessage &msg) {
+            add('E', "", msg);
+        }
+
+        void reportInfo(const ErrorLogger::ErrorMessage &msg) {
+            add('I', "", msg);
+        }
+
+        /** Report the messages in the order they were added */
+        void replay(ErrorLogger &errorLogger) const {
+            for (std::list<Message>::const_iterator it = _messages.begin(); it != _messages.end(); ++it) {
+                if (it->type == 'O')
+                    errorLogger.reportOut(it->text);
+                else if (it->type == 'E')
+                    errorLogger.reportErr(it->msg);
+                else
+                    errorLogger.reportInfo(it->msg);
+            }
+        }
+
+        /** The check was stopped by an exception, it is thrown again after the messages are reported */
+        enum { NO_FAILURE, INTERNAL_ERROR, RUNTIME_ERROR } failure;
+        InternalError internalError;
+        std::string runtimeError;
+
+    private:
+        struct Message {
+            char type;
+            std::string text;
+            ErrorLogger::ErrorMessage msg;
+        };
+
+        void add(char type, const std::string &text, const ErrorLogger::ErrorMessage &msg) {
+            _messages.push_back(Message());
+            _messages.back().type = type;
+            _messages.back().text = text;
+            _messages.back().msg = msg;
+        }
+
+        std::list<Message> _messages;
+    };
+
+    /** @brief The checks that run at the same time on one token list */
+    struct CheckTasks {
+        const Tokenizer *tokenizer;
+        const Settings *settings;
+        unsigned int showtime;
+        bool simplified;
+        std::vector<Check *> checks;
+        const std::vector<unsigned int> *timers;
+        std::vector<CheckResults> results;
+
+        /** each task measures its own time, nothing is locked */
+        std::vector<TimerResultsLocal> timerResults;
+    };
+}
+
+static void runCheckTask(void *data, std::size_t index)
+{
+    CheckTasks * const tasks = static_cast<CheckTasks *>(data);
+    Check * const check = tasks->checks[index];
+    CheckResults &results = tasks->results[index];
+    if (tasks->settings->terminated())
+        return;
+
+    try {
+        Timer timer((*tasks->timers)[index], tasks->showtime, &tasks->timerResults[index]);
+        if (tasks->simplified)
+            check->runSimplifiedChecks(tasks->tokenizer, tasks->settings, &results);
+        else
+            check->runChecks(tasks->tokenizer, tasks->settings, &results);
+    } catch (const InternalError &e) {
+        results.failure = CheckResults::INTERNAL_ERROR;
+        results.internalError = e;
+    } catch (const std::exception &e) {
+        results.failure = CheckResults::RUNTIME_ERROR;
+        results.runtimeError = e.what();
+    }
+}
+
+void CppCheck::updateCheckTimers()
+{
+    // Check::instances() is read once, the checks are run from this copy
+    const std::vector<Check *> checks(Check::instances().begin(), Check::instances().end());
+    if (checks == _timedChecks)
+        return;
+
+    _timedChecks = checks;
+    _runChecksTimers.clear();
+    _runSimplifiedChecksTimers.clear();
+    for (std::vector<Check *>::const_iterator it = checks.begin(); it != checks.end(); ++it) {
+        _runChecksTimers.push_back(Timer::id((*it)->name() + "::runChecks"));
+        _runSimplifiedChecksTimers.push_back(Timer::id((*it)->name() + "::runSimplifiedChecks"));
+    }
+}
+
+void CppCheck::runChecks(const Tokenizer &tokenizer, bool simplified)
+{
+    updateCheckTimers();
+
+    if (_settings._checkThreads <= 1) {
+        for (std::size_t index = 0; index < _timedChecks.size(); ++index) {
+            if (_settings.terminated())
+                return;
+
+            if (simplified) {
+                Timer timerSimpleChecks(_runSimplifiedChecksTimers[index], timerMode(), &_timerResults);
+                _timedChecks[index]->runSimplifiedChecks(&tokenizer, &_settings, this);
+            } else {
+                Timer timerRunChecks(_runChecksTimers[index], timerMode(), &_timerResults);
+                _timedChecks[index]->runChecks(&tokenizer, &_settings, this);
+            }
+        }
+        return;
+    }
+
+    // The checks only read the token list and the symbol database. Each
+    // check reports to its own CheckResults so the output is the same as
+    // when the checks are run one by one.
+    CheckTasks tasks;
+    tasks.tokenizer = &tokenizer;
+    tasks.settings = &_settings;
+    tasks.simplified = simplified;
+    tasks.checks = _timedChecks;
+    tasks.timers = simplified ? &_runSimplifiedChecksTimers : &_runChecksTimers;
+    tasks.results.resize(tasks.checks.size());
+    tasks.showtime = timerMode();
+    tasks.timerResults.resize(tasks.checks.size());
+    for (std::size_t i = 0; i < tasks.timerResults.size(); ++i)
+        tasks.timerResults[i].recordEvents(!_settings.profileOut.empty());
+
+    ThreadPool::run(runCheckTask, &tasks, tasks.checks.size(), _settings._checkThreads);
+
+    // each check is shown in its own thread in the profile
+    for (std::size_t i = 0; i < tasks.timerResults.size(); ++i) {
+        _traceEvents.addTimerEvents(tasks.timerResults[i], (unsigned int)i + 1U);
+        S_timerResults.merge(tasks.timerResults[i]);
+    }
+
+    for (std::size_t i = 0; i < tasks.results.size(); ++i) {
+        const CheckResults &results = tasks.results[i];
+        results.replay(*this);
+        if (results.failure == CheckResults::INTERNAL_ERROR)
+            throw results.internalError;
+        if (results.failure == CheckResults::RUNTIME_ERROR)
+            throw std::runtime_error(results.runtimeError);
+    }
+}
+
+unsigned long long CppCheck::cacheKey(const std::string &code, const std::string &filename) const
+{
+    // Everything that can change the results must be a part of the key
+    std::ostringstream key;
+    key << Version << '\n'
+        << filename << '\n'
+        << cfg << '\n'
+        << _settings.inconclusive << ' ' << _settings.experimental << ' ' << _settings.debugwarnings << ' '
+        << _settings.checkLibrary << ' ' << _simplify << ' ' << (int)_settings.enforcedLang << '\n'
+        << (int)_settings.standards.c << ' ' << (int)_settings.standards.cpp << ' ' << _settings.standards.posix << '\n'
+        << (int)_settings.platformType << ' '
+        << _settings.sizeof_bool << ' ' << _settings.sizeof_short << ' ' << _settings.sizeof_int << ' '
+        << _settings.sizeof_long << ' ' << _settings.sizeof_long_long << ' ' << _settings.sizeof_float << ' '
+        << _settings.sizeof_double << ' ' << _settings.sizeof_long_double << ' ' << _settings.sizeof_wchar_t << ' '
+        << _settings.sizeof_size_t << ' ' << _settings.sizeof_pointer << '\n'
+        << _settings.maxExecutionPaths << '\n';
+    for (std::set<std::string>::const_iterator it = _settings.enabled().begin(); it != _settings.enabled().end(); ++it)
+        key << "enabled " << *it << '\n';
+    for (std::vector<std::string>::const_iterator it = _settings._basePaths.begin(); it != _settings._basePaths.end(); ++it)
+        key << "basepath " << *it << '\n';
+    for (std::list<Settings::Rule>::const_iterator it = _settings.rules.begin(); it != _settings.rules.end(); ++it)
+        key << "rule " << it->tokenlist << ' ' << it->id << ' ' << it->severity << ' ' << it->pattern << ' ' << it->summary << '\n';
+    key << _settings.library.fingerprint();
+    // only the whole program analysis data that the code can use
+    if (_settings.summaries)
+        key << "summaries\n" << _settings.summaries->usedData(code);
+
+    return fnv1a(fnv1a(FNV1A_OFFSET_BASIS, key.str()), code);
+}
+
+std::string CppCheck::cacheFileName(const std::string &code, const std::string &filename) const
+{
+    const unsigned long long hash = cacheKey(code, filename);
+
+    std::ostringstream name;
+    name << _settings.cacheDir;
+    if (!_settings.cacheDir.empty() && _settings.cacheDir[_settings.cacheDir.size() - 1U] != '/')
+        name << '/';
+    name << std::hex << std::setw(16) << std::setfill('0') << hash << ".cache";
+    return name.str();
+}
+
+void CppCheck::recordResult(char type, const std::string &data)
+{
+    std::ostringstream ostr;
+    ostr << type << ' ' << data.size() << ' ' << data << '\n';
+    _recordedResults += ostr.str();
+}
+
+bool CppCheck::replayCacheFile(std::istream &istr, const std::string &filename)
+{
+    std::string header, version, file, config;
+    if (!std::getline(istr, header) || header != "cppcheck-cache" ||
+        !std::getline(istr, version) || version != Version ||
+        !std::getline(istr, file) || file != filename ||
+        !std::getline(istr, config) || config != cfg)
+        return false;
+
+    // Read all results before anything is reported
+    std::list<std::pair<char, std::string> > results;
+    char type = 0;
+    while (istr >> type) {
+        std::string::size_type size = 0;
+        if (!(istr >> size) || istr.get() != ' ')
+            return false;
+        std::string data(size, '\0');
+        if (size > 0 && !istr.read(&data[0], (std::streamsize)size))
+            return false;
+        if (istr.get() != '\n')
+            return false;
+        results.push_back(std::make_pair(type, data));
+    }
+
+    for (std::list<std::pair<char, std::string> >::const_iterator it = results.begin(); it != results.end(); ++it) {
+        if (it->first == 'D') {
+            _dependencies.insert(it->second);
+            continue;
+        }
+        if (it->first == 'S') {
+            addSummary(SummaryDatabase::deserialize(it->second));
+            continue;
+        }
+
+        ErrorLogger::ErrorMessage msg;
+        msg.deserialize(it->second);
+        if (it->first == 'E')
+            reportErr(msg);
+        else if (it->first == 'I')
+            reportInfo(msg);
+        else if (it->first == 'C')
+            _errorLogger.reportErr(msg);
+    }
+
+    return true;
+}
+
+void CppCheck::checkFileCached(const std::string &code, const std::string &filename)
+{
+    const std::string cacheFile = cacheFileName(code, filename);
+
+    {
+        std::ifstream fin(cacheFile.c_str(), std::ios::in | std::ios::binary);
+        if (fin.is_open() && replayCacheFile(fin, filename)) {
+            ++_cacheHits;
+            return;
+        }
+    }
+
+    ++_cacheMisses;
+
+    _recordResults = true;
+    _recordedResults.clear();
+    checkFile(code, filename.c_str());
+    _recordResults = false;
+
+    if (_settings.terminated())
+        return;
+
+    // Write the results to a temporary file that is renamed when it is
+    // complete, so other cppcheck instances never read a partial file.
+    // Each process and thread has its own temporary file.
+    const std::string tempFile = Path::temporaryFileName(cacheFile);
+    {
+        std::ofstream fout(tempFile.c_str(), std::ios::out | std::ios::binary);
+        if (!fout.is_open())
+            return;
+        fout << "cppcheck-cache\n" << Version << '\n' << filename << '\n' << cfg << '\n' << _recordedResults;
+    }
+    _recordedResults.clear();
+    if (std::rename(tempFile.c_str(), cacheFile.c_str()) != 0)
+        std::remove(tempFile.c_str());
+}
+
 void CppCheck::executeRules(const std::string &tokenlist, const Tokenizer &tokenizer)
 {
     (void)tokenlist;
@@ -451,36 +957,31 @@ void CppCheck::executeRules(const std::string &tokenlist, const Tokenizer &token
     if (isrule == false)
         return;
 
-    // Write all tokens in a string that can be parsed by pcre
-    std::ostringstream ostr;
-    for (const Token *tok = tokenizer.tokens(); tok; tok = tok->next())
-        ostr << " " << tok->str();
-    const std::string str(ostr.str());
+    if (!_compiledRules)
+        compileRules();
+
+    // Write all tokens in a string that can be parsed by pcre. The end offset
+    // of each token is saved so matches can be mapped to tokens quickly.
+    std::string str;
+    std::vector<std::size_t> tokenEnds;
+    std::vector<const Token *> tokens;
+    for (const Token *tok = tokenizer.tokens(); tok; tok = tok->next()) {
+        str += ' ';
+        str += tok->str();
+        tokenEnds.push_back(str.size());
+        tokens.push_back(tok);
+    }
 
-    for (std::list<Settings::Rule>::const_iterator it = _settings.rules.begin(); it != _settings.rules.end(); ++it) {
-        const Settings::Rule &rule = *it;
-        if (rule.pattern.empty() || rule.id.empty() || rule.severity.empty() || rule.tokenlist != tokenlist)
+    for (std::vector<CompiledRules::Entry>::const_iterator it = _compiledRules->entries.begin(); it != _compiledRules->entries.end(); ++it) {
+        const Settings::Rule &rule = it->rule;
+        if (rule.tokenlist != tokenlist)
             continue;
 
-        const char *error = 0;
-        int erroffset = 0;
-        pcre *re = pcre_compile(rule.pattern.c_str(),0,&error,&erroffset,NULL);
-        if (!re) {
-            if (error) {
-                ErrorLogger::ErrorMessage errmsg(std::list<ErrorLogger::ErrorMessage::FileLocation>(),
-                                                 Severity::error,
-                                                 error,
-                                                 "pcre_compile",
-                                                 false);
-
-                reportErr(errmsg);
-            }
-            continue;
-        }
+        Timer timer(it->timerId, timerMode(), &_timerResults);
 
         int pos = 0;
         int ovector[30];
-        while (pos < (int)str.size() && 0 <= pcre_exec(re, NULL, str.c_str(), (int)str.size(), pos, 0, ovector, 30)) {
+        while (pos < (int)str.size() && 0 <= pcre_exec(it->re, it->extra, str.c_str(), (int)str.size(), pos, 0, ovector, 30)) {
             unsigned int pos1 = (unsigned int)ovector[0];
             unsigned int pos2 = (unsigned int)ovector[1];
 
@@ -492,14 +993,11 @@ void CppCheck::executeRules(const std::string &tokenlist, const Tokenizer &token
             loc.setfile(tokenizer.getSourceFilePath());
             loc.line = 0;
 
-            std::size_t len = 0;
-            for (const Token *tok = tokenizer.tokens(); tok; tok = tok->next()) {
-                len = len + 1U + tok->str().size();
-                if (len > pos1) {
-                    loc.setfile(tokenizer.list.getFiles().at(tok->fileIndex()));
-                    loc.line = tok->linenr();
-                    break;
-                }
+            const std::vector<std::size_t>::const_iterator end = std::upper_bound(tokenEnds.begin(), tokenEnds.end(), (std::size_t)pos1);
+            if (end != tokenEnds.end()) {
+                const Token *tok = tokens[(std::size_t)(end - tokenEnds.begin())];
+                loc.setfile(tokenizer.list.getFiles().at(tok->fileIndex()));
+                loc.line = tok->linenr();
             }
 
             const std::list<ErrorLogger::ErrorMessage::FileLocation> callStack(1, loc);
@@ -515,8 +1013,52 @@ void CppCheck::executeRules(const std::string &tokenlist, const Tokenizer &token
             // Report error
             reportErr(errmsg);
         }
+    }
+#endif
+}
+
+void CppCheck::compileRules()
+{
+    delete _compiledRules;
+    _compiledRules = new CompiledRules;
+
+#ifdef HAVE_RULES
+    for (std::list<Settings::Rule>::const_iterator it = _settings.rules.begin(); it != _settings.rules.end(); ++it) {
+        const Settings::Rule &rule = *it;
+        if (rule.pattern.empty() || rule.id.empty() || rule.severity.empty())
+            continue;
 
-        pcre_free(re);
+        const char *error = 0;
+        int erroffset = 0;
+        pcre *re = pcre_compile(rule.pattern.c_str(),0,&error,&erroffset,NULL);
+        if (!re) {
+            if (error) {
+                ErrorLogger::ErrorMessage errmsg(std::list<ErrorLogger::ErrorMessage::FileLocation>(),
+                                                 Severity::error,
+                                                 error,
+                                                 "pcre_compile",
+                                                 false);
+
+                reportErr(errmsg);
+            }
+            continue;
+        }
+
+        // Study the pattern, use the JIT compiler if it is available. If
+        // studying fails the rule is still executed without the extra data.
+        error = 0;
+#ifdef PCRE_STUDY_JIT_COMPILE
+        pcre_extra *extra = pcre_study(re, PCRE_STUDY_JIT_COMPILE, &error);
+#else
+        pcre_extra *extra = pcre_study(re, 0, &error);
+#endif
+
+        CompiledRules::Entry entry;
+        entry.rule = rule;
+        entry.timerId = Timer::id("Rule::" + rule.id + " (" + rule.tokenlist + ") " + rule.pattern);
+        entry.re = re;
+        entry.extra = error ? NULL : extra;
+        _compiledRules->entries.push_back(entry);
     }
 #endif
 }
@@ -570,17 +1112,16 @@ void CppCheck::tooManyConfigsError(const std::string &file, const std::size_t nu
 
 void CppCheck::reportErr(const ErrorLogger::ErrorMessage &msg)
 {
-    std::string errmsg = msg.toString(_settings._verbose);
-    if (errmsg.empty())
-        return;
+    if (_recordResults)
+        recordResult('E', msg.serialize());
 
     // Alert only about unique errors
-    if (std::find(_errorList.begin(), _errorList.end(), errmsg) != _errorList.end())
+    if (!_errorFilter.insert(msg, _settings._verbose))
         return;
 
     if (_settings.debugFalsePositive) {
         // Don't print out error
-        _errorList.push_back(errmsg);
+        _errorList.push_back(msg.toString(_settings._verbose));
         return;
     }
 
@@ -602,8 +1143,6 @@ void CppCheck::reportErr(const ErrorLogger::ErrorMessage &msg)
     if (!_settings.nofail.isSuppressed(msg._id, file, line))
         exitcode = 1;
 
-    _errorList.push_back(errmsg);
-
     _errorLogger.reportErr(msg);
 }
 
@@ -619,6 +1158,9 @@ void CppCheck::reportProgress(const std::string &filename, const char stage[], c
 
 void CppCheck::reportInfo(const ErrorLogger::ErrorMessage &msg)
 {
+    if (_recordResults)
+        recordResult('I', msg.serialize());
+
     // Suppressing info message?
     std::string file;
     unsigned int line(0);
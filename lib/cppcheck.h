@@ -23,10 +23,15 @@
 #include "settings.h"
 #include "errorlogger.h"
 #include "checkunusedfunctions.h"
+#include "executionpath.h"
+#include "summarydatabase.h"
+#include "timer.h"
+#include "tokenlist.h"
 
 #include <string>
 #include <list>
 #include <istream>
+#include <vector>
 
 /// @addtogroup Core
 /// @{
@@ -38,6 +43,9 @@
  * Usage: See check() for more info.
  */
 class CPPCHECKLIB CppCheck : ErrorLogger {
+    // let tests access private function for testing
+    friend class TestCppcheck;
+
 public:
     /**
      * @brief Constructor.
@@ -84,6 +92,45 @@ public:
      */
     void checkFunctionUsage();
 
+    /**
+     * @brief Get the function usage of the files checked since the last
+     * call and forget it. This is used when the files are checked in
+     * parallel, see CheckUnusedFunctions::summary().
+     */
+    std::string takeFunctionUsage();
+
+    /**
+     * @brief Add the function usage of a file checked by another instance,
+     * the result of its takeFunctionUsage().
+     */
+    void addFunctionUsage(const std::string &summary);
+
+    /**
+     * @brief Get the whole program analysis data (Check::analyse()) of the
+     * files checked since the last call and forget it. It is only made when
+     * Settings::summaries is set. The text is a serialized SummaryDatabase
+     * record, the caller adds it to the summary database.
+     */
+    std::string takeSummary();
+
+    /**
+     * @brief Get the profile events of the files checked since the last
+     * call and forget them (--profile-out). See TraceEvents::write().
+     */
+    std::string takeProfile();
+
+    /** @brief Process id of the profile events, each -j worker has its own */
+    void setProfilePid(unsigned int pid);
+
+    /**
+     * @brief Write the --showtime statistics when destroyed, true by default.
+     * The timers of an instance that doesn't write them are still added to
+     * the timer summary, the -j worker threads use this.
+     */
+    void showStatistics(bool show) {
+        _showStatistics = show;
+    }
+
     /**
      * @brief Get reference to current settings.
      * @return a reference to current settings
@@ -120,9 +167,13 @@ public:
     void getErrorMessages();
 
     /**
-     * @brief Analyse file - It's public so unit tests can be written
+     * @brief Analyse file for the whole program analysis, see Check::analyse().
+     * Nothing is reported, the messages come when the file is checked.
+     * @param f the file
+     * @param filename name of the file
+     * @param summaries the record of the file is added here
      */
-    void analyseFile(std::istream &f, const std::string &filename);
+    void analyseFile(std::istream &f, const std::string &filename, SummaryDatabase &summaries);
 
     /**
      * @brief Get dependencies. Use this after calling 'check'.
@@ -137,6 +188,16 @@ public:
         _simplify = false;
     }
 
+    /** @brief Number of configurations whose results were read from the cache (--cache-dir) */
+    unsigned int cacheHits() const {
+        return _cacheHits;
+    }
+
+    /** @brief Number of configurations that were checked and written to the cache (--cache-dir) */
+    unsigned int cacheMisses() const {
+        return _cacheMisses;
+    }
+
 private:
 
     /** @brief There has been a internal error => Report information message */
@@ -148,6 +209,49 @@ private:
     /** @brief Check file */
     void checkFile(const std::string &code, const char FileName[]);
 
+    /** @brief Timer mode of the measurements, --profile-out turns them on */
+    unsigned int timerMode() const;
+
+    /**
+     * @brief Copy Check::instances() to _timedChecks and look up the timer
+     * ids of the checks if the list has changed
+     */
+    void updateCheckTimers();
+
+    /** @brief Check::analyse() data of the tokens */
+    static SummaryDatabase::Record analyseTokens(const Tokenizer &tokenizer);
+
+    /** @brief Add analysis data of the checked code to the summary, see takeSummary() */
+    void addSummary(const SummaryDatabase::Record &record);
+
+    /**
+     * @brief Check file using the cache directory. If the same code has been
+     * checked with the same settings before, the saved results are reported.
+     * Otherwise the file is checked and the results are saved.
+     */
+    void checkFileCached(const std::string &code, const std::string &filename);
+
+    /**
+     * @brief Run the checks of all registered Check classes. When
+     * --check-threads is used the checks run at the same time and their
+     * results are reported in registration order.
+     * @param tokenizer tokenizer
+     * @param simplified if true runSimplifiedChecks() is called, otherwise runChecks()
+     */
+    void runChecks(const Tokenizer &tokenizer, bool simplified);
+
+    /** @brief Hash of the given code and the current settings */
+    unsigned long long cacheKey(const std::string &code, const std::string &filename) const;
+
+    /** @brief Name of the cache file for the given code and the current settings */
+    std::string cacheFileName(const std::string &code, const std::string &filename) const;
+
+    /** @brief Report the results saved in a cache file. Returns false if the file is not valid. */
+    bool replayCacheFile(std::istream &istr, const std::string &filename);
+
+    /** @brief Save a result that is written to the cache file */
+    void recordResult(char type, const std::string &data);
+
     /**
      * @brief Execute rules, if any
      * @param tokenlist token list to use (normal / simple)
@@ -155,6 +259,12 @@ private:
      */
     void executeRules(const std::string &tokenlist, const Tokenizer &tokenizer);
 
+    /**
+     * @brief Compile and study all rule patterns. This is done once,
+     * the compiled patterns are reused for every file and configuration.
+     */
+    void compileRules();
+
     /**
      * @brief Errors and warnings are directed here.
      *
@@ -184,7 +294,12 @@ private:
      */
     static void replaceAll(std::string& code, const std::string &from, const std::string &to);
 
+    /** @brief Reported errors, only saved when --debug-fp is used */
     std::list<std::string> _errorList;
+
+    /** @brief Errors reported for the current file, used to alert only about unique errors */
+    UniqueErrorFilter _errorFilter;
+
     Settings _settings;
     std::string _fileContent;
     std::set<std::string> _dependencies;
@@ -196,6 +311,10 @@ private:
      */
     virtual void reportInfo(const ErrorLogger::ErrorMessage &msg);
 
+    /**
+     * @brief Function usage of the checked files. It is not added to
+     * Check::instances(), that list is shared by the threads that check files.
+     */
     CheckUnusedFunctions _checkUnusedFunctions;
     ErrorLogger &_errorLogger;
 
@@ -215,6 +334,52 @@ private:
     //ds code with comments and whitespaces
     std::string m_strRawCode;
 
+    /** @brief Are results saved for the cache file? */
+    bool _recordResults;
+
+    /** @brief Results saved for the cache file */
+    std::string _recordedResults;
+
+    /** @brief Analysis data of the checked files, see takeSummary() */
+    SummaryDatabase::Record _summary;
+
+    unsigned int _cacheHits;
+    unsigned int _cacheMisses;
+
+    /** @brief Write the --showtime statistics when destroyed? */
+    bool _showStatistics;
+
+    /** @brief Token allocation statistics (--showtime) */
+    TokenArena::Stats _tokenStats;
+
+    /** @brief Statistics of the token simplification loop (--showtime) */
+    Tokenizer::SimplifyStats _simplifyStats;
+
+    /** @brief Statistics of the execution path checks (--showtime) */
+    ExecutionPathStats _executionPathStats;
+
+    /** @brief Timer results of this thread, merged when a file is done (--showtime) */
+    TimerResultsLocal _timerResults;
+
+    /**
+     * @brief The checks that are run and the timer ids of their runChecks()
+     * and runSimplifiedChecks(), in the same order. See updateCheckTimers().
+     */
+    std::vector<Check *> _timedChecks;
+    std::vector<unsigned int> _runChecksTimers;
+    std::vector<unsigned int> _runSimplifiedChecksTimers;
+
+    /** @brief Hotspot profile of the checked files (--profile-out) */
+    TraceEvents _traceEvents;
+
+    /** @brief Number of tokens of the configuration before and after simplifyTokenList() (--profile-out) */
+    std::size_t _profileTokens;
+    std::size_t _profileSimplifiedTokens;
+
+    /** @brief Precompiled rule patterns, created by compileRules() */
+    struct CompiledRules;
+    CompiledRules *_compiledRules;
+
 };
 
 /// @}
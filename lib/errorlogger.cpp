@@ -21,6 +21,7 @@
 #include "cppcheck.h"
 #include "tokenlist.h"
 #include "token.h"
+#include "utils.h"
 
 #include <tinyxml2.h>
 
@@ -341,6 +342,48 @@ std::string ErrorLogger::callStackToString(const std::list<ErrorLogger::ErrorMes
 }
 
 
+/** FNV-1a hash of a string, continuing from the given hash value */
+static unsigned long long hashString(unsigned long long hash, const std::string &str)
+{
+    // separator so "ab"+"c" and "a"+"bc" hash differently
+    return fnv1aValue(fnv1a(hash, str), 0xffU);
+}
+
+bool UniqueErrorFilter::Fingerprint::operator<(const Fingerprint &other) const
+{
+    if (hash != other.hash)
+        return hash < other.hash;
+    if (line != other.line)
+        return line < other.line;
+    if (id != other.id)
+        return id < other.id;
+    return file < other.file;
+}
+
+bool UniqueErrorFilter::insert(const ErrorLogger::ErrorMessage &msg, bool verbose)
+{
+    Fingerprint fp;
+    fp.line = 0;
+    fp.id = msg._id;
+    if (!msg._callStack.empty()) {
+        fp.file = msg._callStack.back().getfile(false);
+        fp.line = msg._callStack.back().line;
+    }
+
+    unsigned long long hash = hashString(FNV1A_OFFSET_BASIS, verbose ? msg.verboseMessage() : msg.shortMessage());
+    hash = fnv1aValue(hash, (unsigned long long)msg._severity + (msg._inconclusive ? 0x100U : 0U));
+    for (std::list<ErrorLogger::ErrorMessage::FileLocation>::const_iterator loc = msg._callStack.begin(); loc != msg._callStack.end(); ++loc) {
+        hash = hashString(hash, loc->getfile(false));
+        hash = fnv1aValue(hash, loc->line);
+    }
+    fp.hash = hash;
+
+    if (_fingerprints.insert(fp).second)
+        return true;
+    ++_hits;
+    return false;
+}
+
 ErrorLogger::ErrorMessage::FileLocation::FileLocation(const Token* tok, const TokenList* list)
     : line(tok->linenr()), _file(list->file(tok))
 {
@@ -21,6 +21,7 @@
 #define errorloggerH
 
 #include <list>
+#include <set>
 #include <string>
 
 #include "config.h"
@@ -306,6 +307,56 @@ public:
     static std::string callStackToString(const std::list<ErrorLogger::ErrorMessage::FileLocation> &callStack);
 };
 
+/**
+ * @brief Index of already reported error messages. It is used to alert only
+ * about unique errors. A message is identified by a compact fingerprint
+ * (id, file, line and a hash of the remaining fields) so the messages don't
+ * need to be formatted or compared as text.
+ */
+class CPPCHECKLIB UniqueErrorFilter {
+public:
+    UniqueErrorFilter()
+        : _hits(0) {
+    }
+
+    /**
+     * @brief Remember a message.
+     * @param msg the message
+     * @param verbose is the verbose message shown? If not, messages that
+     * only differ in the verbose text are duplicates.
+     * @return true if the message is new, false if it is a duplicate
+     */
+    bool insert(const ErrorLogger::ErrorMessage &msg, bool verbose);
+
+    /** @brief Forget all messages. The hit counter is kept. */
+    void clear() {
+        _fingerprints.clear();
+    }
+
+    /** @brief Number of unique messages */
+    std::size_t size() const {
+        return _fingerprints.size();
+    }
+
+    /** @brief Number of duplicate messages that have been filtered out */
+    std::size_t hits() const {
+        return _hits;
+    }
+
+private:
+    struct Fingerprint {
+        unsigned long long hash;
+        unsigned int line;
+        std::string id;
+        std::string file;
+
+        bool operator<(const Fingerprint &other) const;
+    };
+
+    std::set<Fingerprint> _fingerprints;
+    std::size_t _hits;
+};
+
 /// @}
 
 #endif
@@ -19,6 +19,7 @@
 
 #include "executionpath.h"
 #include "token.h"
+#include "settings.h"
 #include "symboldatabase.h"
 #include <memory>
 #include <set>
@@ -26,6 +27,124 @@
 #include <iostream>
 
 
+// Pool allocation. Every path starts with a header that holds its pool and
+// its size, the header size keeps the alignment of the path.
+static const std::size_t poolUnit = 16;
+static const std::size_t poolHeader = 16;
+static const std::size_t poolChunkSize = 16384;
+
+ExecutionPathPool::ExecutionPathPool(unsigned int maxPaths_)
+    : maxPaths(maxPaths_), paths(0), merges(0), budgetBailouts(0), _chunkPos(0), _chunkEnd(0)
+{
+}
+
+ExecutionPathPool::~ExecutionPathPool()
+{
+    for (std::vector<char *>::const_iterator it = _chunks.begin(); it != _chunks.end(); ++it)
+        delete [] *it;
+}
+
+void *ExecutionPathPool::allocate(std::size_t size)
+{
+    ++paths;
+
+    const std::size_t units = (size + poolUnit - 1) / poolUnit;
+    if (units < _freeLists.size() && _freeLists[units]) {
+        void *p = _freeLists[units];
+        _freeLists[units] = *static_cast<void **>(p);
+        return p;
+    }
+
+    // big paths are not pooled
+    size = units * poolUnit;
+    if (size > poolChunkSize / 4)
+        return ::operator new(size);
+
+    if (_chunkPos == 0 || size > std::size_t(_chunkEnd - _chunkPos)) {
+        _chunks.push_back(new char[poolChunkSize]);
+        _chunkPos = _chunks.back();
+        _chunkEnd = _chunkPos + poolChunkSize;
+    }
+    void *p = _chunkPos;
+    _chunkPos += size;
+    return p;
+}
+
+void ExecutionPathPool::deallocate(void *p, std::size_t size)
+{
+    const std::size_t units = (size + poolUnit - 1) / poolUnit;
+    if (units * poolUnit > poolChunkSize / 4) {
+        ::operator delete(p);
+        return;
+    }
+
+    if (units >= _freeLists.size())
+        _freeLists.resize(units + 1U, 0);
+    *static_cast<void **>(p) = _freeLists[units];
+    _freeLists[units] = p;
+}
+
+ExecutionPathStats::ExecutionPathStats()
+    : functions(0), paths(0), merges(0), budgetBailouts(0), maxPaths(0)
+{
+}
+
+void ExecutionPathStats::add(const std::string &function, unsigned long paths_, unsigned long merges_, unsigned long budgetBailouts_)
+{
+    MutexLock lock(_mutex);
+    ++functions;
+    paths += paths_;
+    merges += merges_;
+    budgetBailouts += budgetBailouts_;
+    if (paths_ > maxPaths) {
+        maxPaths = paths_;
+        maxPathsFunction = function;
+    }
+}
+
+void *ExecutionPath::operator new(std::size_t size, ExecutionPathPool *p)
+{
+    char *mem = static_cast<char *>(p ? p->allocate(size + poolHeader) : ::operator new(size + poolHeader));
+    *reinterpret_cast<ExecutionPathPool **>(mem) = p;
+    *reinterpret_cast<std::size_t *>(mem + sizeof(ExecutionPathPool *)) = size;
+    return mem + poolHeader;
+}
+
+void *ExecutionPath::operator new(std::size_t size)
+{
+    return operator new(size, static_cast<ExecutionPathPool *>(0));
+}
+
+void ExecutionPath::operator delete(void *ptr)
+{
+    if (!ptr)
+        return;
+    char *mem = static_cast<char *>(ptr) - poolHeader;
+    ExecutionPathPool *p = *reinterpret_cast<ExecutionPathPool **>(mem);
+    if (p)
+        p->deallocate(mem, *reinterpret_cast<std::size_t *>(mem + sizeof(ExecutionPathPool *)) + poolHeader);
+    else
+        ::operator delete(mem);
+}
+
+void ExecutionPath::operator delete(void *ptr, ExecutionPathPool * /*p*/)
+{
+    operator delete(ptr);
+}
+
+/**
+ * Are there too many execution paths to continue? The budget is
+ * Settings::maxExecutionPaths, 10 if there is no pool.
+ */
+static bool budgetExceeded(const std::list<ExecutionPath *> &checks, ExecutionPathPool *pool)
+{
+    if (checks.size() <= (pool ? pool->maxPaths : 10U))
+        return false;
+    if (pool)
+        ++pool->budgetBailouts;
+    return true;
+}
+
 
 // default : bail out if the condition is has variable handling
 bool ExecutionPath::parseCondition(const Token &tok, std::list<ExecutionPath *> & checks)
@@ -91,6 +210,7 @@ static void parseIfSwitchBody(const Token * const tok,
 {
     std::set<unsigned int> countif2;
     std::list<ExecutionPath *> c;
+    ExecutionPathPool *pool = checks.empty() ? 0 : checks.front()->pool;
     if (!checks.empty()) {
         std::list<ExecutionPath *>::const_iterator it;
         for (it = checks.begin(); it != checks.end(); ++it) {
@@ -117,10 +237,20 @@ static void parseIfSwitchBody(const Token * const tok,
                 break;
             }
         }
+
+        // merge with an equal path from another branch
+        for (it = newchecks.begin(); !duplicate && it != newchecks.end(); ++it) {
+            if (*(*it) == *c.back() && (*it)->numberOfIf == c.back()->numberOfIf)
+                duplicate = true;
+        }
+
         if (!duplicate)
             newchecks.push_back(c.back());
-        else
+        else {
             delete c.back();
+            if (pool)
+                ++pool->merges;
+        }
         c.pop_back();
     }
 
@@ -160,7 +290,7 @@ void ExecutionPath::checkScope(const Token *tok, std::list<ExecutionPath *> &che
 
         if (Token::simpleMatch(tok, "while (")) {
             // parse condition
-            if (checks.size() > 10 || check->parseCondition(*tok->tokAt(2), checks)) {
+            if (budgetExceeded(checks, check->pool) || check->parseCondition(*tok->tokAt(2), checks)) {
                 ExecutionPath::bailOut(checks);
                 return;
             }
@@ -206,7 +336,7 @@ void ExecutionPath::checkScope(const Token *tok, std::list<ExecutionPath *> &che
 
             if (tok->str() == "switch") {
                 // parse condition
-                if (checks.size() > 10 || check->parseCondition(*tok->next(), checks)) {
+                if (budgetExceeded(checks, check->pool) || check->parseCondition(*tok->next(), checks)) {
                     ExecutionPath::bailOut(checks);
                     return;
                 }
@@ -375,7 +505,7 @@ void ExecutionPath::checkScope(const Token *tok, std::list<ExecutionPath *> &che
                 tok = tok->next();
 
                 // parse condition
-                if (checks.size() > 10 || check->parseCondition(*tok->next(), checks)) {
+                if (budgetExceeded(checks, check->pool) || check->parseCondition(*tok->next(), checks)) {
                     ExecutionPath::bailOut(checks);
                     ExecutionPath::bailOut(newchecks);
                     return;
@@ -463,12 +593,20 @@ void ExecutionPath::checkScope(const Token *tok, std::list<ExecutionPath *> &che
     }
 }
 
-void checkExecutionPaths(const SymbolDatabase *symbolDatabase, ExecutionPath *c)
+void checkExecutionPaths(const SymbolDatabase *symbolDatabase, const Settings *settings, ExecutionPath *c)
 {
-    for (std::list<Scope>::const_iterator i = symbolDatabase->scopeList.begin(); i != symbolDatabase->scopeList.end(); ++i) {
+    // The copies of c are allocated in the pool
+    ExecutionPathPool pool(settings->maxExecutionPaths);
+    c->pool = &pool;
+
+    for (StableVector<Scope>::const_iterator i = symbolDatabase->scopeList.begin(); i != symbolDatabase->scopeList.end(); ++i) {
         if (i->type != Scope::eFunction || !i->classStart)
             continue;
 
+        const unsigned long paths = pool.paths;
+        const unsigned long merges = pool.merges;
+        const unsigned long budgetBailouts = pool.budgetBailouts;
+
         // Check function
         std::list<ExecutionPath *> checks;
         checks.push_back(c->copy());
@@ -481,5 +619,10 @@ void checkExecutionPaths(const SymbolDatabase *symbolDatabase, ExecutionPath *c)
             delete checks.back();
             checks.pop_back();
         }
+
+        if (settings->executionPathStats)
+            settings->executionPathStats->add(i->className, pool.paths - paths, pool.merges - merges, pool.budgetBailouts - budgetBailouts);
     }
+
+    c->pool = 0;
 }
@@ -19,13 +19,84 @@
 #ifndef executionpathH
 #define executionpathH
 
+#include <cstddef>
 #include <list>
+#include <string>
+#include <vector>
 #include "config.h"
+#include "mutex.h"
 
 class Token;
 class Check;
+class Settings;
 class SymbolDatabase;
 
+/**
+ * @brief Memory for the execution paths of one checkExecutionPaths() call.
+ *
+ * The paths are copied at every branch and most of them are deleted soon
+ * after. Freed paths are kept in a free list for each size and reused, the
+ * memory is released when the pool is destroyed. The pool also holds the
+ * path budget and counts the paths for --showtime. A pool is only used by
+ * one thread.
+ */
+class CPPCHECKLIB ExecutionPathPool {
+public:
+    explicit ExecutionPathPool(unsigned int maxPaths_);
+    ~ExecutionPathPool();
+
+    void *allocate(std::size_t size);
+    void deallocate(void *p, std::size_t size);
+
+    /** bail out when there are more paths than this at a condition */
+    const unsigned int maxPaths;
+
+    /** number of allocated paths */
+    unsigned long paths;
+
+    /** number of paths that were merged with an equal path */
+    unsigned long merges;
+
+    /** number of times all paths were bailed out because of maxPaths */
+    unsigned long budgetBailouts;
+
+private:
+    // disallow copying
+    ExecutionPathPool(const ExecutionPathPool &);
+    ExecutionPathPool &operator=(const ExecutionPathPool &);
+
+    /** free list for each size, the index is the size in units of 16 bytes */
+    std::vector<void *> _freeLists;
+
+    /** allocated chunks */
+    std::vector<char *> _chunks;
+
+    /** unused part of the last chunk */
+    char *_chunkPos;
+    char *_chunkEnd;
+};
+
+/** @brief Execution path statistics of the checked functions (--showtime) */
+class CPPCHECKLIB ExecutionPathStats {
+public:
+    ExecutionPathStats();
+
+    /** Add the statistics of one function. This can be called from several threads. */
+    void add(const std::string &function, unsigned long paths, unsigned long merges, unsigned long budgetBailouts);
+
+    unsigned long functions;
+    unsigned long paths;
+    unsigned long merges;
+    unsigned long budgetBailouts;
+
+    /** the function with the most paths */
+    std::string maxPathsFunction;
+    unsigned long maxPaths;
+
+private:
+    Mutex _mutex;
+};
+
 /**
  * Base class for Execution Paths checking
  * An execution path is a linear list of statements. There are no "if"/.. to worry about.
@@ -42,12 +113,22 @@ protected:
     virtual bool is_equal(const ExecutionPath *) const = 0;
 
 public:
-    ExecutionPath(Check *c, unsigned int id) : owner(c), numberOfIf(0), varId(id) {
+    ExecutionPath(Check *c, unsigned int id, ExecutionPathPool *p = 0) : owner(c), numberOfIf(0), varId(id), pool(p) {
     }
 
     virtual ~ExecutionPath() {
     }
 
+    /**
+     * Allocate a path in a pool. Copies of a path must be allocated in
+     * the pool of the path: new (pool) Derived(*this). Without a pool
+     * the path is allocated on the heap.
+     */
+    static void *operator new(std::size_t size, ExecutionPathPool *p);
+    static void *operator new(std::size_t size);
+    static void operator delete(void *ptr);
+    static void operator delete(void *ptr, ExecutionPathPool *p);
+
     /** Implement this in each derived class. This function must create a copy of the current instance */
     virtual ExecutionPath *copy() = 0;
 
@@ -59,6 +140,9 @@ public:
 
     const unsigned int varId;
 
+    /** the pool for the copies of this path, NULL => the heap is used */
+    ExecutionPathPool *pool;
+
     /**
      * bail out all execution paths
      * @param checks the execution paths to bail out on
@@ -128,7 +212,7 @@ public:
 };
 
 
-void checkExecutionPaths(const SymbolDatabase *symbolDatabase, ExecutionPath *c);
+void checkExecutionPaths(const SymbolDatabase *symbolDatabase, const Settings *settings, ExecutionPath *c);
 
 
 #endif
@@ -26,6 +26,7 @@ HEADERS += $${BASEPATH}check.h \
            $${BASEPATH}checkpostfixoperator.h \
            $${BASEPATH}checksizeof.h \
            $${BASEPATH}checkstl.h \
+           $${BASEPATH}checkstyle.h \
            $${BASEPATH}checkuninitvar.h \
            $${BASEPATH}checkunusedfunctions.h \
            $${BASEPATH}checkunusedvar.h \
@@ -34,12 +35,15 @@ HEADERS += $${BASEPATH}check.h \
            $${BASEPATH}executionpath.h \
            $${BASEPATH}library.h \
            $${BASEPATH}mathlib.h \
+           $${BASEPATH}mutex.h \
            $${BASEPATH}path.h \
            $${BASEPATH}preprocessor.h \
            $${BASEPATH}settings.h \
+           $${BASEPATH}summarydatabase.h \
            $${BASEPATH}suppressions.h \
            $${BASEPATH}symboldatabase.h \
            $${BASEPATH}templatesimplifier.h \
+           $${BASEPATH}threadpool.h \
            $${BASEPATH}timer.h \
            $${BASEPATH}token.h \
            $${BASEPATH}tokenize.h \
@@ -66,6 +70,7 @@ SOURCES += $${BASEPATH}check64bit.cpp \
            $${BASEPATH}checkpostfixoperator.cpp \
            $${BASEPATH}checksizeof.cpp \
            $${BASEPATH}checkstl.cpp \
+           $${BASEPATH}checkstyle.cpp \
            $${BASEPATH}checkuninitvar.cpp \
            $${BASEPATH}checkunusedfunctions.cpp \
            $${BASEPATH}checkunusedvar.cpp \
@@ -74,12 +79,15 @@ SOURCES += $${BASEPATH}check64bit.cpp \
            $${BASEPATH}executionpath.cpp \
            $${BASEPATH}library.cpp \
            $${BASEPATH}mathlib.cpp \
+           $${BASEPATH}mutex.cpp \
            $${BASEPATH}path.cpp \
            $${BASEPATH}preprocessor.cpp \
            $${BASEPATH}settings.cpp \
+           $${BASEPATH}summarydatabase.cpp \
            $${BASEPATH}suppressions.cpp \
            $${BASEPATH}symboldatabase.cpp \
            $${BASEPATH}templatesimplifier.cpp \
+           $${BASEPATH}threadpool.cpp \
            $${BASEPATH}timer.cpp \
            $${BASEPATH}token.cpp \
            $${BASEPATH}tokenize.cpp \
@@ -22,6 +22,7 @@
 
 #include <string>
 #include <algorithm>
+#include <sstream>
 
 Library::Library() : allocid(0)
 {
@@ -147,3 +148,27 @@ bool Library::load(const char exename[], const char path[])
     }
     return true;
 }
+
+std::string Library::fingerprint() const
+{
+    std::ostringstream ostr;
+    for (std::map<std::string, int>::const_iterator it = _alloc.begin(); it != _alloc.end(); ++it)
+        ostr << "alloc " << it->first << ' ' << it->second << '\n';
+    for (std::map<std::string, int>::const_iterator it = _dealloc.begin(); it != _dealloc.end(); ++it)
+        ostr << "dealloc " << it->first << ' ' << it->second << '\n';
+    for (std::map<std::string, bool>::const_iterator it = _noreturn.begin(); it != _noreturn.end(); ++it)
+        ostr << "noreturn " << it->first << ' ' << it->second << '\n';
+    for (std::set<std::string>::const_iterator it = use.begin(); it != use.end(); ++it)
+        ostr << "use " << *it << '\n';
+    for (std::set<std::string>::const_iterator it = leakignore.begin(); it != leakignore.end(); ++it)
+        ostr << "leakignore " << *it << '\n';
+    for (std::set<std::string>::const_iterator it = returnuninitdata.begin(); it != returnuninitdata.end(); ++it)
+        ostr << "returnuninitdata " << *it << '\n';
+    for (std::map<std::string, std::map<int, ArgumentChecks> >::const_iterator it = argumentChecks.begin(); it != argumentChecks.end(); ++it) {
+        for (std::map<int, ArgumentChecks>::const_iterator arg = it->second.begin(); arg != it->second.end(); ++arg) {
+            ostr << "arg " << it->first << ' ' << arg->first << ' '
+                 << arg->second.notnull << arg->second.notuninit << arg->second.formatstr << arg->second.strz << '\n';
+        }
+    }
+    return ostr.str();
+}
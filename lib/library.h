@@ -38,6 +38,9 @@ public:
 
     bool load(const char exename[], const char path[]);
 
+    /** @brief All library data as text. Used to detect changes in the configuration. */
+    std::string fingerprint() const;
+
     /** get allocation id for function (by name) */
     int alloc(const std::string &name) const {
         return getid(_alloc, name);
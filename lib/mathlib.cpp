@@ -24,6 +24,7 @@
 #include <string>
 #include <sstream>
 #include <cstdlib>
+#include <cstring>
 #include <cmath>
 #include <cctype>
 #include <limits>
@@ -345,6 +346,161 @@ std::string MathLib::calculate(const std::string &first, const std::string &seco
     }
 }
 
+MathLib::Value::Value(const std::string &str) : _intValue(0), _isFloat(false), _isUnsigned(false), _isLong(false)
+{
+    // suffixes
+    std::string::size_type end = str.size();
+    while (end > 0 && std::strchr("uUlL", str[end - 1])) {
+        --end;
+        if (str[end] == 'u' || str[end] == 'U')
+            _isUnsigned = true;
+        else
+            _isLong = true;
+    }
+
+    // Plain decimal integer that fits in a bigint. This is the common case
+    // so it is parsed directly.
+    const std::string::size_type start = (!str.empty() && str[0] == '-') ? 1U : 0U;
+    if (end > start && end - start <= 18U && (str[start] != '0' || end - start == 1U)) {
+        bigint value = 0;
+        std::string::size_type i = start;
+        while (i < end && std::isdigit(static_cast<unsigned char>(str[i])))
+            value = value * 10 + (str[i++] - '0');
+        if (i == end) {
+            _intValue = (start == 1U) ? -value : value;
+            return;
+        }
+    }
+
+    if (MathLib::isInt(str))
+        _intValue = toLongNumber(str);
+    else {
+        _isFloat = true;
+        _doubleValue = toDoubleNumber(str);
+    }
+}
+
+MathLib::bigint MathLib::Value::getInt() const
+{
+    if (!_isFloat)
+        return _intValue;
+    if (_doubleValue >= static_cast<double>(std::numeric_limits<bigint>::max()))
+        return std::numeric_limits<bigint>::max();
+    if (_doubleValue <= static_cast<double>(std::numeric_limits<bigint>::min()))
+        return std::numeric_limits<bigint>::min();
+    return static_cast<bigint>(_doubleValue);
+}
+
+std::string MathLib::Value::str() const
+{
+    return _isFloat ? doubleToString(_doubleValue) : longToString(_intValue);
+}
+
+MathLib::Value MathLib::add(const Value &first, const Value &second)
+{
+    if (first.isInt() && second.isInt())
+        return Value(first.getInt() + second.getInt());
+
+    double d1 = first.getDouble();
+    double d2 = second.getDouble();
+
+    int count = 0;
+    while (d1 > 100000.0 * d2 && doubleToString(d1+d2)==first.str() && ++count<5)
+        d2 *= 10.0;
+    while (d2 > 100000.0 * d1 && doubleToString(d1+d2)==second.str() && ++count<5)
+        d1 *= 10.0;
+
+    return Value(d1 + d2);
+}
+
+MathLib::Value MathLib::subtract(const Value &first, const Value &second)
+{
+    if (first.isInt() && second.isInt())
+        return Value(first.getInt() - second.getInt());
+
+    // Same as for the strings, the values are compared as text
+    if (first.str() == second.str())
+        return Value(0.0);
+
+    double d1 = first.getDouble();
+    double d2 = second.getDouble();
+
+    int count = 0;
+    while (d1 > 100000.0 * d2 && doubleToString(d1-d2)==first.str() && ++count<5)
+        d2 *= 10.0;
+    while (d2 > 100000.0 * d1 && doubleToString(d1-d2)==second.str() && ++count<5)
+        d1 *= 10.0;
+
+    return Value(d1 - d2);
+}
+
+MathLib::Value MathLib::divide(const Value &first, const Value &second)
+{
+    if (first.isInt() && second.isInt()) {
+        const bigint a = first.getInt();
+        const bigint b = second.getInt();
+        if (a == std::numeric_limits<bigint>::min())
+            throw InternalError(0, "Internal Error: Division overflow");
+        if (b == 0)
+            throw InternalError(0, "Internal Error: Division by zero");
+        return Value(a / b);
+    } else if (second.isFloat() && second.str() == "0.0") {
+        // Same as for the strings, a division by "0.0" gives "inf.0"
+        return Value(std::numeric_limits<double>::infinity());
+    }
+    return Value(first.getDouble() / second.getDouble());
+}
+
+MathLib::Value MathLib::multiply(const Value &first, const Value &second)
+{
+    if (first.isInt() && second.isInt())
+        return Value(first.getInt() * second.getInt());
+    return Value(first.getDouble() * second.getDouble());
+}
+
+MathLib::Value MathLib::mod(const Value &first, const Value &second)
+{
+    if (first.isInt() && second.isInt()) {
+        const bigint b = second.getInt();
+        if (b == 0)
+            throw InternalError(0, "Internal Error: Division by zero");
+        return Value(first.getInt() % b);
+    }
+    return Value(std::fmod(first.getDouble(), second.getDouble()));
+}
+
+MathLib::Value MathLib::calculate(const Value &first, const Value &second, char action)
+{
+    switch (action) {
+    case '+':
+        return MathLib::add(first, second);
+
+    case '-':
+        return MathLib::subtract(first, second);
+
+    case '*':
+        return MathLib::multiply(first, second);
+
+    case '/':
+        return MathLib::divide(first, second);
+
+    case '%':
+        return MathLib::mod(first, second);
+
+    case '&':
+        return Value(first.getInt() & second.getInt());
+
+    case '|':
+        return Value(first.getInt() | second.getInt());
+
+    case '^':
+        return Value(first.getInt() ^ second.getInt());
+
+    default:
+        throw InternalError(0, std::string("Unexpected action '") + action + "' in MathLib::calculate(). Please report this to Cppcheck developers.");
+    }
+}
+
 std::string MathLib::sin(const std::string &tok)
 {
     return doubleToString(std::sin(toDoubleNumber(tok)));
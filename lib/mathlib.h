@@ -33,6 +33,65 @@ class CPPCHECKLIB MathLib {
 public:
     typedef long long bigint;
 
+    /**
+     * @brief A parsed number. Number tokens keep their value (Token::number())
+     * so the calculations don't need to parse and format strings.
+     */
+    class CPPCHECKLIB Value {
+    public:
+        /** The integer 0 */
+        Value() : _intValue(0), _isFloat(false), _isUnsigned(false), _isLong(false) {
+        }
+
+        /** Parse a number, the same way as toLongNumber() / toDoubleNumber() */
+        explicit Value(const std::string &str);
+
+        explicit Value(bigint intValue) : _intValue(intValue), _isFloat(false), _isUnsigned(false), _isLong(false) {
+        }
+
+        explicit Value(double doubleValue) : _doubleValue(doubleValue), _isFloat(true), _isUnsigned(false), _isLong(false) {
+        }
+
+        /** Is the value an integer, see isInt() */
+        bool isInt() const {
+            return !_isFloat;
+        }
+
+        bool isFloat() const {
+            return _isFloat;
+        }
+
+        /** Is there a 'u' suffix */
+        bool isUnsigned() const {
+            return _isUnsigned;
+        }
+
+        /** Is there a 'l' or 'll' suffix */
+        bool isLong() const {
+            return _isLong;
+        }
+
+        /** The value as an integer, floats are truncated */
+        bigint getInt() const;
+
+        /** The value as a double */
+        double getDouble() const {
+            return _isFloat ? _doubleValue : static_cast<double>(_intValue);
+        }
+
+        /** The value formatted by longToString() or doubleToString() */
+        std::string str() const;
+
+    private:
+        union {
+            bigint _intValue;
+            double _doubleValue;
+        };
+        bool _isFloat;
+        bool _isUnsigned;
+        bool _isLong;
+    };
+
     static bigint toLongNumber(const std::string & str);
     static std::string longToString(const bigint value);
     static double toDoubleNumber(const std::string & str);
@@ -52,6 +111,14 @@ public:
     static std::string mod(const std::string & first, const std::string & second);
     static std::string calculate(const std::string & first, const std::string & second, char action);
 
+    // Calculations on parsed values, the results are the same as for the strings
+    static Value add(const Value &first, const Value &second);
+    static Value subtract(const Value &first, const Value &second);
+    static Value multiply(const Value &first, const Value &second);
+    static Value divide(const Value &first, const Value &second);
+    static Value mod(const Value &first, const Value &second);
+    static Value calculate(const Value &first, const Value &second, char action);
+
     static std::string sin(const std::string & tok);
     static std::string cos(const std::string & tok);
     static std::string tan(const std::string & tok);
@@ -0,0 +1,69 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2013 Daniel Marjamäki and Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mutex.h"
+
+#ifdef _WIN32
+#include <windows.h>
+
+Mutex::Mutex() : _mutex(new CRITICAL_SECTION)
+{
+    InitializeCriticalSection(static_cast<CRITICAL_SECTION *>(_mutex));
+}
+
+Mutex::~Mutex()
+{
+    DeleteCriticalSection(static_cast<CRITICAL_SECTION *>(_mutex));
+    delete static_cast<CRITICAL_SECTION *>(_mutex);
+}
+
+void Mutex::lock()
+{
+    EnterCriticalSection(static_cast<CRITICAL_SECTION *>(_mutex));
+}
+
+void Mutex::unlock()
+{
+    LeaveCriticalSection(static_cast<CRITICAL_SECTION *>(_mutex));
+}
+
+#else
+#include <pthread.h>
+
+Mutex::Mutex() : _mutex(new pthread_mutex_t)
+{
+    pthread_mutex_init(static_cast<pthread_mutex_t *>(_mutex), NULL);
+}
+
+Mutex::~Mutex()
+{
+    pthread_mutex_destroy(static_cast<pthread_mutex_t *>(_mutex));
+    delete static_cast<pthread_mutex_t *>(_mutex);
+}
+
+void Mutex::lock()
+{
+    pthread_mutex_lock(static_cast<pthread_mutex_t *>(_mutex));
+}
+
+void Mutex::unlock()
+{
+    pthread_mutex_unlock(static_cast<pthread_mutex_t *>(_mutex));
+}
+
+#endif
@@ -0,0 +1,71 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2013 Daniel Marjamäki and Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//---------------------------------------------------------------------------
+#ifndef mutexH
+#define mutexH
+//---------------------------------------------------------------------------
+
+#include "config.h"
+
+/// @addtogroup Core
+/// @{
+
+/**
+ * @brief Mutex for data that is shared by the threads that check files.
+ * The platform specific parts are kept in mutex.cpp.
+ */
+class CPPCHECKLIB Mutex {
+public:
+    Mutex();
+    ~Mutex();
+
+    void lock();
+    void unlock();
+
+private:
+    // disallow copying
+    Mutex(const Mutex &);
+    Mutex &operator=(const Mutex &);
+
+    void *_mutex;
+};
+
+/** @brief Lock a mutex for the lifetime of this object */
+class CPPCHECKLIB MutexLock {
+public:
+    explicit MutexLock(Mutex &mutex) : _mutex(mutex) {
+        _mutex.lock();
+    }
+
+    ~MutexLock() {
+        _mutex.unlock();
+    }
+
+private:
+    // disallow copying
+    MutexLock(const MutexLock &);
+    MutexLock &operator=(const MutexLock &);
+
+    Mutex &_mutex;
+};
+
+/// @}
+
+//---------------------------------------------------------------------------
+#endif
@@ -22,6 +22,13 @@
 #include <cstring>
 #include <cctype>
 #include "path.h"
+#include "mutex.h"
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
 
 /** Is the filesystem case insensitive? */
 static bool caseInsensitiveFilesystem()
@@ -216,3 +223,26 @@ bool Path::isHeader(const std::string &path)
     const std::string extension = getFilenameExtensionInLowerCase(path);
     return (extension.compare(0, 2, ".h") == 0);
 }
+
+/** Counter for the temporary file names of this process */
+static unsigned long temporaryFileCount = 0;
+static Mutex temporaryFileCountMutex;
+
+std::string Path::temporaryFileName(const std::string &filename)
+{
+    unsigned long number;
+    {
+        MutexLock lock(temporaryFileCountMutex);
+        number = temporaryFileCount++;
+    }
+
+#ifdef _WIN32
+    const long pid = (long)_getpid();
+#else
+    const long pid = (long)getpid();
+#endif
+
+    std::ostringstream ostr;
+    ostr << filename << '.' << pid << '.' << number << ".tmp";
+    return ostr.str();
+}
@@ -123,6 +123,15 @@ public:
      */
     static bool isCPP(const std::string &extensionInLowerCase);
 
+    /**
+     * @brief Name for a temporary file next to the given file. The name
+     * contains the process id and a counter, so no other process or
+     * thread uses the same name.
+     * @param filename the file that is written through the temporary file
+     * @return name of the temporary file
+     */
+    static std::string temporaryFileName(const std::string &filename);
+
 private:
     /**
      * @brief Is filename a header based on file extension
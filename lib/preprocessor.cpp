@@ -23,21 +23,81 @@
 #include "path.h"
 #include "errorlogger.h"
 #include "settings.h"
+#include "mutex.h"
+#include "utils.h"
 
 #include <algorithm>
 #include <sstream>
 #include <fstream>
 #include <cstdlib>
 #include <cctype>
+#include <cstring>
 #include <vector>
 #include <set>
 #include <stack>
+#include <ctime>
+#include <sys/types.h>
+#include <sys/stat.h>
 
 bool Preprocessor::missingIncludeFlag;
 
+PreprocessorLines::PreprocessorLines(const std::string &code)
+    : _code(&code)
+{
+    std::string::size_type pos = 0;
+    while (pos < code.size()) {
+        std::string::size_type end = code.find('\n', pos);
+        if (end == std::string::npos)
+            end = code.size();
+
+        LineInfo info;
+        info.offset = pos;
+        info.length = end - pos;
+        info.directive = (code[pos] == '#') ? classify(code.c_str() + pos, info.length) : NoDirective;
+        _lines.push_back(info);
+
+        pos = end + 1;
+    }
+}
+
+PreprocessorLines::Directive PreprocessorLines::classify(const char line[], std::string::size_type length)
+{
+    static const struct {
+        const char *name;
+        std::string::size_type length;
+        Directive directive;
+    } directives[] = {
+        { "include", 7, Include },
+        { "define", 6, Define },
+        { "undef", 5, Undef },
+        { "if", 2, If },
+        { "ifdef", 5, Ifdef },
+        { "ifndef", 6, Ifndef },
+        { "elif", 4, Elif },
+        { "else", 4, Else },
+        { "endif", 5, Endif },
+        { "file", 4, File },
+        { "endfile", 7, Endfile },
+        { "line", 4, Line },
+        { "pragma", 6, Pragma },
+        { "error", 5, Error }
+    };
+
+    std::string::size_type len = 1;
+    while (len < length && std::isalpha(static_cast<unsigned char>(line[len])))
+        ++len;
+    --len;
+
+    for (std::size_t i = 0; i < sizeof(directives) / sizeof(*directives); ++i) {
+        if (directives[i].length == len && std::strncmp(line + 1, directives[i].name, len) == 0)
+            return directives[i].directive;
+    }
+    return OtherDirective;
+}
+
 char Preprocessor::macroChar = char(1);
 
-Preprocessor::Preprocessor(Settings *settings, ErrorLogger *errorLogger) : _settings(settings), _errorLogger(errorLogger)
+Preprocessor::Preprocessor(Settings *settings, ErrorLogger *errorLogger) : _settings(settings), _errorLogger(errorLogger), _commentReports(0)
 {
 
 }
@@ -177,7 +237,7 @@ std::string Preprocessor::read(std::istream &istr, const std::string &filename)
     // handling <backslash><newline>
     // when this is encountered the <backslash><newline> will be "skipped".
     // on the next <newline>, extra newlines will be added
-    std::ostringstream code;
+    std::string code;
     unsigned int newlines = 0;
     for (unsigned char ch = readChar(istr,bom); istr.good(); ch = readChar(istr,bom)) {
         // Replace assorted special chars with spaces..
@@ -215,20 +275,20 @@ std::string Preprocessor::read(std::istream &istr, const std::string &filename)
                 ++newlines;
                 (void)readChar(istr,bom);   // Skip the "<backslash><newline>"
             } else {
-                code << "\\" << spaces;
+                code += "\\" + spaces;
             }
         } else {
-            code << char(ch);
+            code += char(ch);
 
             // if there has been <backslash><newline> sequences, add extra newlines..
             if (ch == '\n' && newlines > 0) {
-                code << std::string(newlines, '\n');
+                code.append(newlines, '\n');
                 newlines = 0;
             }
         }
     }
-    std::string result = code.str();
-    code.str("");
+    std::string result;
+    result.swap(code);
 
     // ------------------------------------------------------------------------------------------
     //
@@ -278,7 +338,7 @@ std::string Preprocessor::read( std::istream &istr, const std::string &filename,
     // handling <backslash><newline>
     // when this is encountered the <backslash><newline> will be "skipped".
     // on the next <newline>, extra newlines will be added
-    std::ostringstream code;
+    std::string code;
     unsigned int newlines = 0;
     for (unsigned char ch = readChar(istr,bom); istr.good(); ch = readChar(istr,bom)) {
         // Replace assorted special chars with spaces..
@@ -316,20 +376,20 @@ std::string Preprocessor::read( std::istream &istr, const std::string &filename,
                 ++newlines;
                 (void)readChar(istr,bom);   // Skip the "<backslash><newline>"
             } else {
-                code << "\\" << spaces;
+                code += "\\" + spaces;
             }
         } else {
-            code << char(ch);
+            code += char(ch);
 
             // if there has been <backslash><newline> sequences, add extra newlines..
             if (ch == '\n' && newlines > 0) {
-                code << std::string(newlines, '\n');
+                code.append(newlines, '\n');
                 newlines = 0;
             }
         }
     }
-    std::string result = code.str();
-    code.str("");
+    std::string result;
+    result.swap(code);
 
     //ds get the raw code here
     p_strRawCode = result;
@@ -372,11 +432,25 @@ std::string Preprocessor::read( std::istream &istr, const std::string &filename,
 
 std::string Preprocessor::preprocessCleanupDirectives(const std::string &processedFile)
 {
-    std::ostringstream code;
-    std::istringstream sstr(processedFile);
+    std::string code;
+    code.reserve(processedFile.size());
 
+    const PreprocessorLines lines(processedFile);
     std::string line;
-    while (std::getline(sstr, line)) {
+    for (std::size_t nr = 0; nr < lines.size(); ++nr) {
+        // Do not mess with regular code..
+        if (lines.directive(nr) == PreprocessorLines::NoDirective && processedFile[lines.offset(nr)] != ' ') {
+            if (lines.length(nr) > 0) {
+                const std::string::size_type end = processedFile.find_last_not_of(' ', lines.offset(nr) + lines.length(nr) - 1);
+                code.append(processedFile, lines.offset(nr), end + 1 - lines.offset(nr));
+            }
+            if (lines.terminated(nr))
+                code += '\n';
+            continue;
+        }
+
+        lines.getline(nr, line);
+
         // Trim lines..
         if (!line.empty() && line[0] == ' ')
             line.erase(0, line.find_first_not_of(" "));
@@ -392,7 +466,7 @@ std::string Preprocessor::preprocessCleanupDirectives(const std::string &process
             } escapeStatus = ESC_NONE;
 
             char prev = ' '; // hack to make it skip spaces between # and the directive
-            code << "#";
+            code += '#';
             std::string::const_iterator i = line.begin();
             ++i;
 
@@ -423,14 +497,14 @@ std::string Preprocessor::preprocessCleanupDirectives(const std::string &process
                 if (escapeStatus == ESC_NONE) {
                     if (needSpace) {
                         if (*i == '(' || *i == '!')
-                            code << " ";
+                            code += ' ';
                         else if (!std::isalpha(*i))
                             needSpace = false;
                     }
                     if (*i == '#')
                         needSpace = true;
                 }
-                code << *i;
+                code += *i;
                 if (escapeStatus != ESC_NONE && prev == '\\' && *i == '\\') {
                     prev = ' ';
                 } else {
@@ -443,12 +517,13 @@ std::string Preprocessor::preprocessCleanupDirectives(const std::string &process
             }
         } else {
             // Do not mess with regular code..
-            code << line;
+            code += line;
         }
-        code << (sstr.eof()?"":"\n");
+        if (lines.terminated(nr))
+            code += '\n';
     }
 
-    return code.str();
+    return code;
 }
 
 static bool hasbom(const std::string &str)
@@ -497,7 +572,8 @@ std::string Preprocessor::removeComments(const std::string &str, const std::stri
     // when this is encountered the <backslash><newline> will be "skipped".
     // on the next <newline>, extra newlines will be added
     unsigned int newlines = 0;
-    std::ostringstream code;
+    std::string code;
+    code.reserve(str.size());
     unsigned char previous = 0;
     bool inPreprocessorLine = false;
     std::vector<std::string> suppressionIDs;
@@ -511,6 +587,7 @@ std::string Preprocessor::removeComments(const std::string &str, const std::stri
                    << "Neither unicode nor extended ASCII are supported. "
                    << "(line=" << lineno << ", character code=" << std::hex << (int(ch) & 0xff) << ")";
             writeError(filename, lineno, _errorLogger, "syntaxError", errmsg.str());
+            ++_commentReports;
         }
 
         if (_settings && _settings->terminated())
@@ -520,7 +597,7 @@ std::string Preprocessor::removeComments(const std::string &str, const std::stri
             str.compare(i, 9, "#warning ") == 0) {
 
             if (str.compare(i, 6, "#error") == 0)
-                code << "#error";
+                code += "#error";
 
             i = str.find("\n", i);
             if (i == std::string::npos)
@@ -535,7 +612,7 @@ std::string Preprocessor::removeComments(const std::string &str, const std::stri
             if (ch == ' ' && previous == ' ') {
                 // Skip double white space
             } else {
-                code << char(ch);
+                code += char(ch);
                 previous = ch;
             }
 
@@ -545,7 +622,7 @@ std::string Preprocessor::removeComments(const std::string &str, const std::stri
                     inPreprocessorLine = false;
                 ++lineno;
                 if (newlines > 0) {
-                    code << std::string(newlines, '\n');
+                    code.append(newlines, '\n');
                     newlines = 0;
                     previous = '\n';
                 }
@@ -577,7 +654,7 @@ std::string Preprocessor::removeComments(const std::string &str, const std::stri
                 fallThroughComment = true;
             }
 
-            code << "\n";
+            code += "\n";
             previous = '\n';
             ++lineno;
         } else if (str.compare(i, 2, "/*", 0, 2) == 0) {
@@ -611,9 +688,9 @@ std::string Preprocessor::removeComments(const std::string &str, const std::stri
             }
         } else if ((i==0 || std::isspace(str[i-1])) && str.compare(i,5,"__asm",0,5) == 0) {
             while (i < str.size() && !std::isspace(str[i]))
-                code << str[i++];
+                code += str[i++];
             while (i < str.size() && std::isspace(str[i]))
-                code << str[i++];
+                code += str[i++];
             if (str[i] == '{') {
                 // Ticket 4873: Extract comments from the __asm / __asm__'s content
                 std::string asmBody;
@@ -625,12 +702,12 @@ std::string Preprocessor::removeComments(const std::string &str, const std::stri
                     }
                     asmBody += str[i++];
                 }
-                code << removeComments(asmBody, filename);
-                code << '}';
+                code += removeComments(asmBody, filename);
+                code += '}';
             } else
                 --i;
         } else if (ch == '#' && previous == '\n') {
-            code << ch;
+            code += ch;
             previous = ch;
             inPreprocessorLine = true;
 
@@ -638,6 +715,7 @@ std::string Preprocessor::removeComments(const std::string &str, const std::stri
             if (!suppressionIDs.empty()) {
                 if (_settings != NULL) {
                     // Add the suppressions.
+                    _commentReports += static_cast<unsigned int>(suppressionIDs.size());
                     for (std::size_t j = 0; j < suppressionIDs.size(); ++j) {
                         const std::string errmsg(_settings->nomsg.addSuppression(suppressionIDs[j], filename, lineno));
                         if (!errmsg.empty()) {
@@ -666,6 +744,7 @@ std::string Preprocessor::removeComments(const std::string &str, const std::stri
                 if (!suppressionIDs.empty()) {
                     if (_settings != NULL) {
                         // Add the suppressions.
+                        _commentReports += static_cast<unsigned int>(suppressionIDs.size());
                         for (std::size_t j = 0; j < suppressionIDs.size(); ++j) {
                             const std::string errmsg(_settings->nomsg.addSuppression(suppressionIDs[j], filename, lineno));
                             if (!errmsg.empty()) {
@@ -679,7 +758,7 @@ std::string Preprocessor::removeComments(const std::string &str, const std::stri
 
             // String or char constants..
             if (ch == '\"' || ch == '\'') {
-                code << char(ch);
+                code += char(ch);
                 char chNext;
                 do {
                     ++i;
@@ -690,12 +769,12 @@ std::string Preprocessor::removeComments(const std::string &str, const std::stri
                         if (chSeq == '\n')
                             ++newlines;
                         else {
-                            code << chNext;
-                            code << chSeq;
+                            code += chNext;
+                            code += chSeq;
                             previous = static_cast<unsigned char>(chSeq);
                         }
                     } else {
-                        code << chNext;
+                        code += chNext;
                         previous = static_cast<unsigned char>(chNext);
                     }
                 } while (i < str.length() && chNext != ch && chNext != '\n');
@@ -720,50 +799,54 @@ std::string Preprocessor::removeComments(const std::string &str, const std::stri
                 const std::string::size_type endpos = str.find(")" + delim + "\"", i);
                 if (delim != " " && endpos != std::string::npos) {
                     unsigned int rawstringnewlines = 0;
-                    code << '\"';
+                    code += '\"';
                     for (std::string::size_type p = i + 3 + delim.size(); p < endpos; ++p) {
                         if (str[p] == '\n') {
                             rawstringnewlines++;
-                            code << "\\n";
+                            code += "\\n";
                         } else if (std::iscntrl((unsigned char)str[p]) ||
                                    std::isspace((unsigned char)str[p])) {
-                            code << " ";
+                            code += " ";
                         } else if (str[p] == '\"' || str[p] == '\'') {
-                            code << "\\" << (char)str[p];
+                            code += '\\';
+                            code += (char)str[p];
                         } else {
-                            code << (char)str[p];
+                            code += (char)str[p];
                         }
                     }
-                    code << "\"";
+                    code += "\"";
                     if (rawstringnewlines > 0)
-                        code << std::string(rawstringnewlines, '\n');
+                        code.append(rawstringnewlines, '\n');
                     i = endpos + delim.size() + 1;
                 } else {
-                    code << "R";
+                    code += "R";
                     previous = 'R';
                 }
             } else {
-                code << char(ch);
+                code += char(ch);
                 previous = ch;
             }
         }
     }
 
-    return code.str();
+    return code;
 }
 
 std::string Preprocessor::removeIf0(const std::string &code)
 {
-    std::ostringstream ret;
-    std::istringstream istr(code);
+    std::string ret;
+    ret.reserve(code.size());
+    const PreprocessorLines lines(code);
     std::string line;
-    while (std::getline(istr,line)) {
-        ret << line << "\n";
-        if (line == "#if 0") {
+    for (std::size_t nr = 0; nr < lines.size(); ++nr) {
+        lines.append(nr, ret);
+        ret += '\n';
+        if (lines.length(nr) == 5 && lines.startsWith(nr, "#if 0", 5)) {
             // goto the end of the '#if 0' block
             unsigned int level = 1;
             bool in = false;
-            while (level > 0 && std::getline(istr,line)) {
+            while (level > 0 && nr + 1 < lines.size()) {
+                lines.getline(++nr, line);
                 if (line.compare(0,3,"#if") == 0)
                     ++level;
                 else if (line == "#endif")
@@ -773,18 +856,18 @@ std::string Preprocessor::removeIf0(const std::string &code)
                         in = true;
                 } else {
                     if (in)
-                        ret << line << "\n";
-                    else
-                        // replace code within '#if 0' block with empty lines
-                        ret << "\n";
+                        ret += line;
+                    // else: replace code within '#if 0' block with empty lines
+                    ret += '\n';
                     continue;
                 }
 
-                ret << line << "\n";
+                ret += line;
+                ret += '\n';
             }
         }
     }
-    return ret.str();
+    return ret;
 }
 
 
@@ -793,10 +876,18 @@ std::string Preprocessor::removeParentheses(const std::string &str)
     if (str.find("\n#if") == std::string::npos && str.compare(0, 3, "#if") != 0)
         return str;
 
-    std::istringstream istr(str);
-    std::ostringstream ret;
+    std::string ret;
+    ret.reserve(str.size());
+    const PreprocessorLines lines(str);
     std::string line;
-    while (std::getline(istr, line)) {
+    for (std::size_t nr = 0; nr < lines.size(); ++nr) {
+        if (lines.directive(nr) == PreprocessorLines::NoDirective) {
+            lines.append(nr, ret);
+            ret += '\n';
+            continue;
+        }
+
+        lines.getline(nr, line);
         if (line.compare(0, 3, "#if") == 0 || line.compare(0, 5, "#elif") == 0) {
             std::string::size_type pos;
             pos = 0;
@@ -848,10 +939,11 @@ std::string Preprocessor::removeParentheses(const std::string &str)
             else if (line.compare(0, 6, "#elif(") == 0)
                 line.insert(5, " ");
         }
-        ret << line << "\n";
+        ret += line;
+        ret += '\n';
     }
 
-    return ret.str();
+    return ret;
 }
 
 
@@ -882,6 +974,55 @@ void Preprocessor::preprocess(std::istream &istr, std::map<std::string, std::str
     }
 }
 
+bool Preprocessor::addDefinedParentheses(std::string &code) const
+{
+    const PreprocessorLines lines(code);
+
+    // Only #if and #elif lines are changed. The code is copied if there is such a line.
+    std::string ret;
+    std::string::size_type copied = 0;
+    std::string line;
+    for (std::size_t nr = 0; nr < lines.size(); ++nr) {
+        if (!(lines.directive(nr) == PreprocessorLines::If && lines.startsWith(nr, "#if ", 4)) &&
+            !(lines.directive(nr) == PreprocessorLines::Elif && lines.startsWith(nr, "#elif ", 6)))
+            continue;
+
+        lines.getline(nr, line);
+        if (line.find(" defined ") == std::string::npos)
+            continue;
+
+        std::string::size_type pos = 0;
+        while ((pos = line.find(" defined ")) != std::string::npos) {
+            line[pos+8] = '(';
+            pos = line.find_first_of(" |&", pos + 8);
+            if (pos == std::string::npos)
+                line += ")";
+            else
+                line.insert(pos, ")");
+
+            if (_settings && _settings->terminated())
+                return false;
+        }
+
+        if (ret.empty())
+            ret.reserve(code.size() + 64);
+        ret.append(code, copied, lines.offset(nr) - copied);
+        ret += line;
+        copied = lines.offset(nr) + lines.length(nr);
+    }
+
+    if (copied > 0) {
+        ret.append(code, copied, std::string::npos);
+        code.swap(ret);
+    }
+
+    // All lines end with a newline
+    if (!code.empty() && code[code.size() - 1] != '\n')
+        code += '\n';
+
+    return true;
+}
+
 std::string Preprocessor::removeSpaceNearNL(const std::string &str)
 {
     std::string tmp;
@@ -1025,29 +1166,8 @@ void Preprocessor::preprocess(std::istream &srcCodeStream, std::string &processe
     removeAsm(processedFile);
 
     // Replace "defined A" with "defined(A)"
-    {
-        std::istringstream istr(processedFile);
-        std::ostringstream ostr;
-        std::string line;
-        while (std::getline(istr, line)) {
-            if (line.compare(0, 4, "#if ") == 0 || line.compare(0, 6, "#elif ") == 0) {
-                std::string::size_type pos = 0;
-                while ((pos = line.find(" defined ")) != std::string::npos) {
-                    line[pos+8] = '(';
-                    pos = line.find_first_of(" |&", pos + 8);
-                    if (pos == std::string::npos)
-                        line += ")";
-                    else
-                        line.insert(pos, ")");
-
-                    if (_settings && _settings->terminated())
-                        return;
-                }
-            }
-            ostr << line << "\n";
-        }
-        processedFile = ostr.str();
-    }
+    if (!addDefinedParentheses(processedFile))
+        return;
 
     std::map<std::string, std::string> defs(getcfgmap(_settings ? _settings->userDefines : std::string("")));
 
@@ -1136,29 +1256,8 @@ void Preprocessor::preprocess(std::istream &srcCodeStream, std::string &processe
     removeAsm(processedFile);
 
     // Replace "defined A" with "defined(A)"
-    {
-        std::istringstream istr(processedFile);
-        std::ostringstream ostr;
-        std::string line;
-        while (std::getline(istr, line)) {
-            if (line.compare(0, 4, "#if ") == 0 || line.compare(0, 6, "#elif ") == 0) {
-                std::string::size_type pos = 0;
-                while ((pos = line.find(" defined ")) != std::string::npos) {
-                    line[pos+8] = '(';
-                    pos = line.find_first_of(" |&", pos + 8);
-                    if (pos == std::string::npos)
-                        line += ")";
-                    else
-                        line.insert(pos, ")");
-
-                    if (_settings && _settings->terminated())
-                        return;
-                }
-            }
-            ostr << line << "\n";
-        }
-        processedFile = ostr.str();
-    }
+    if (!addDefinedParentheses(processedFile))
+        return;
 
     std::map<std::string, std::string> defs(getcfgmap(_settings ? _settings->userDefines : std::string("")));
 
@@ -1219,22 +1318,24 @@ void Preprocessor::handleUndef(std::list<std::string> &configurations) const
 }
 
 // Get the DEF in this line: "#ifdef DEF"
-std::string Preprocessor::getdef(std::string line, bool def)
+std::string Preprocessor::getdef(const std::string &directive, bool def)
 {
-    if (line.empty() || line[0] != '#')
+    if (directive.empty() || directive[0] != '#')
         return "";
 
     // If def is true, the line must start with "#ifdef"
-    if (def && line.compare(0, 7, "#ifdef ") != 0 && line.compare(0, 4, "#if ") != 0
-        && (line.compare(0, 6, "#elif ") != 0 || line.compare(0, 7, "#elif !") == 0)) {
+    if (def && directive.compare(0, 7, "#ifdef ") != 0 && directive.compare(0, 4, "#if ") != 0
+        && (directive.compare(0, 6, "#elif ") != 0 || directive.compare(0, 7, "#elif !") == 0)) {
         return "";
     }
 
     // If def is false, the line must start with "#ifndef"
-    if (!def && line.compare(0, 8, "#ifndef ") != 0 && line.compare(0, 7, "#elif !") != 0) {
+    if (!def && directive.compare(0, 8, "#ifndef ") != 0 && directive.compare(0, 7, "#elif !") != 0) {
         return "";
     }
 
+    std::string line(directive);
+
     // Remove the "#ifdef" or "#ifndef"
     if (line.compare(0, 12, "#if defined ") == 0)
         line.erase(0, 11);
@@ -1341,9 +1442,9 @@ std::list<std::string> Preprocessor::getcfgs(const std::string &filedata, const
     bool includeguard = false;
 
     unsigned int linenr = 0;
-    std::istringstream istr(filedata);
+    const PreprocessorLines lines(filedata);
     std::string line;
-    while (std::getline(istr, line)) {
+    for (std::size_t nr = 0; nr < lines.size(); ++nr) {
         ++linenr;
 
         if (_settings && _settings->terminated())
@@ -1352,8 +1453,16 @@ std::list<std::string> Preprocessor::getcfgs(const std::string &filedata, const
         if (_errorLogger)
             _errorLogger->reportProgress(filename, "Preprocessing (get configurations 1)", 0);
 
-        if (line.empty())
+        if (lines.length(nr) == 0)
+            continue;
+
+        // Only directives are interesting
+        if (lines.directive(nr) == PreprocessorLines::NoDirective) {
+            includeguard = false;
             continue;
+        }
+
+        lines.getline(nr, line);
 
         if (line.compare(0, 6, "#file ") == 0) {
             includeguard = true;
@@ -1876,11 +1985,18 @@ bool Preprocessor::match_cfg_def(std::map<std::string, std::string> cfg, std::st
 }
 
 std::string Preprocessor::getcode(const std::string &filedata, const std::string &cfg, const std::string &filename)
+{
+    const PreprocessorLines lines(filedata);
+    return getcode(lines, cfg, filename);
+}
+
+std::string Preprocessor::getcode(const PreprocessorLines &lines, const std::string &cfg, const std::string &filename)
 {
     // For the error report
     unsigned int lineno = 0;
 
-    std::ostringstream ret;
+    std::string ret;
+    ret.reserve(lines.code().size());
 
     bool match = true;
     std::list<bool> matching_ifdef;
@@ -1894,24 +2010,34 @@ std::string Preprocessor::getcode(const std::string &filedata, const std::string
     std::stack<std::string> filenames;
     filenames.push(filename);
     std::stack<unsigned int> lineNumbers;
-    std::istringstream istr(filedata);
     std::string line;
-    while (std::getline(istr, line)) {
+    for (std::size_t nr = 0; nr < lines.size(); ++nr) {
         ++lineno;
 
         if (_settings && _settings->terminated())
             return "";
 
+        // Code is kept if it's part of this configuration
+        if (lines.directive(nr) == PreprocessorLines::NoDirective) {
+            if (match)
+                lines.append(nr, ret);
+            ret += '\n';
+            continue;
+        }
+
+        lines.getline(nr, line);
+
         if (line.compare(0, 11, "#pragma asm") == 0) {
-            ret << "\n";
+            ret += '\n';
             bool found_end = false;
-            while (getline(istr, line)) {
+            while (nr + 1 < lines.size()) {
+                lines.getline(++nr, line);
                 if (line.compare(0, 14, "#pragma endasm") == 0) {
                     found_end = true;
                     break;
                 }
 
-                ret << "\n";
+                ret += '\n';
             }
             if (!found_end)
                 break;
@@ -1922,11 +2048,11 @@ std::string Preprocessor::getcode(const std::string &filedata, const std::string
                 std::istringstream tempIstr(line);
                 tokenizer.tokenize(tempIstr, "");
                 if (Token::Match(tokenizer.tokens(), "( %var% = %any% )")) {
-                    ret << "asm(" << tokenizer.tokens()->strAt(1) << ");";
+                    ret += "asm(" + tokenizer.tokens()->strAt(1) + ");";
                 }
             }
 
-            ret << "\n";
+            ret += '\n';
 
             continue;
         }
@@ -2076,14 +2202,15 @@ std::string Preprocessor::getcode(const std::string &filedata, const std::string
             line = "";
         }
 
-        ret << line << "\n";
+        ret += line;
+        ret += '\n';
     }
 
-    if (!validateCfg(ret.str(), cfg)) {
+    if (!validateCfg(ret, cfg)) {
         return "";
     }
 
-    return expandMacros(ret.str(), filename, cfg, _errorLogger);
+    return expandMacros(ret, filename, cfg, _errorLogger, &_macroCache);
 }
 
 void Preprocessor::error(const std::string &filename, unsigned int linenr, const std::string &msg)
@@ -2164,8 +2291,215 @@ static bool openHeader(std::string &filename, const std::list<std::string> &incl
     return false;
 }
 
+namespace {
+    /** A header that has been read by Preprocessor::read() */
+    struct CachedHeader {
+        CachedHeader(const std::string &c, std::time_t t, std::size_t s)
+            : code(c), lines(code), mtime(t), size(s) {
+        }
+
+        const std::string code;
+        const PreprocessorLines lines;
+
+        /** modification time and size of the file when it was read */
+        const std::time_t mtime;
+        const std::size_t size;
+    };
+
+    /**
+     * Headers and header paths that are shared by all Preprocessor
+     * instances, so a header that is included by many files is searched
+     * for and read once. Headers that are replaced because the file has
+     * changed are kept until the cache is cleared, another thread might
+     * still use them. The cache is cleared when a check is started and
+     * when it is full no more headers and paths are added.
+     */
+    struct HeaderCache {
+        HeaderCache() : bytes(0) {
+        }
+
+        ~HeaderCache() {
+            clear();
+        }
+
+        void clear() {
+            for (std::map<std::string, CachedHeader *>::iterator it = headers.begin(); it != headers.end(); ++it)
+                delete it->second;
+            for (std::list<CachedHeader *>::iterator it = replaced.begin(); it != replaced.end(); ++it)
+                delete *it;
+            headers.clear();
+            replaced.clear();
+            paths.clear();
+            bytes = 0;
+            stats = Preprocessor::HeaderCacheStats();
+        }
+
+        /** Maximum size of the cached headers, including the replaced ones */
+        static const std::size_t maxBytes = 64U * 1024U * 1024U;
+
+        /** Maximum number of cached header paths */
+        static const std::size_t maxPaths = 100000U;
+
+        Mutex mutex;
+
+        /** include name, including path and include paths => header path */
+        std::map<std::string, std::string> paths;
+
+        /** header path => header */
+        std::map<std::string, CachedHeader *> headers;
+        std::list<CachedHeader *> replaced;
+
+        /** size of the code in headers and replaced */
+        std::size_t bytes;
+
+        Preprocessor::HeaderCacheStats stats;
+    };
+
+    HeaderCache headerCache;
+}
+
+static bool getFileStamp(const std::string &filename, std::time_t &mtime, std::size_t &size)
+{
+#ifdef _WIN32
+    struct _stat st;
+    if (_stat(filename.c_str(), &st) != 0)
+        return false;
+#else
+    struct stat st;
+    if (stat(filename.c_str(), &st) != 0)
+        return false;
+#endif
+    mtime = st.st_mtime;
+    size = static_cast<std::size_t>(st.st_size);
+    return true;
+}
+
+/**
+ * Find header. The path is looked up in the header cache before the
+ * include paths are searched. A cached path is only used when the file
+ * still exists.
+ * @param filename header name (in/out)
+ * @param includePaths paths where to look for the file
+ * @param filePath path to the header file
+ * @return if file is found then true is returned
+ */
+static bool findHeader(std::string &filename, const std::list<std::string> &includePaths, const std::string &filePath)
+{
+    std::string key(filename + '\n' + filePath);
+    for (std::list<std::string>::const_iterator it = includePaths.begin(); it != includePaths.end(); ++it)
+        key += '\n' + *it;
+
+    std::string cachedPath;
+    {
+        MutexLock lock(headerCache.mutex);
+        const std::map<std::string, std::string>::const_iterator it = headerCache.paths.find(key);
+        if (it != headerCache.paths.end())
+            cachedPath = it->second;
+    }
+
+    if (!cachedPath.empty()) {
+        std::time_t mtime;
+        std::size_t size;
+        if (getFileStamp(cachedPath, mtime, size)) {
+            MutexLock lock(headerCache.mutex);
+            ++headerCache.stats.resolveHits;
+            filename = cachedPath;
+            return true;
+        }
+
+        // The header has been removed, search it again
+        MutexLock lock(headerCache.mutex);
+        headerCache.paths.erase(key);
+    }
+
+    std::ifstream fin;
+    if (!openHeader(filename, includePaths, filePath, fin))
+        return false;
+
+    MutexLock lock(headerCache.mutex);
+    ++headerCache.stats.resolveMisses;
+    if (headerCache.paths.size() < HeaderCache::maxPaths)
+        headerCache.paths[key] = filename;
+    return true;
+}
+
+Preprocessor::HeaderCacheStats Preprocessor::headerCacheStats()
+{
+    MutexLock lock(headerCache.mutex);
+    return headerCache.stats;
+}
+
+void Preprocessor::clearHeaderCache()
+{
+    MutexLock lock(headerCache.mutex);
+    headerCache.clear();
+}
+
+const PreprocessorLines *Preprocessor::readHeader(const std::string &filename, std::string &code)
+{
+    // The "#error" lines are kept when there are user defines
+    const std::string key((_settings && !_settings->userDefines.empty() ? "D:" : "U:") + filename);
+
+    std::time_t mtime = 0;
+    std::size_t size = 0;
+    const bool stamped = getFileStamp(filename, mtime, size);
+    if (stamped) {
+        MutexLock lock(headerCache.mutex);
+        const std::map<std::string, CachedHeader *>::const_iterator it = headerCache.headers.find(key);
+        if (it != headerCache.headers.end() && it->second->mtime == mtime && it->second->size == size) {
+            ++headerCache.stats.hits;
+            headerCache.stats.bytesSaved += size;
+            return &it->second->lines;
+        }
+    }
+
+    std::ifstream fin(filename.c_str());
+    if (!fin.is_open()) {
+        code.clear();
+        return NULL;
+    }
+
+    // Headers with inline suppressions or errors in the comments are
+    // read every time so these are reported for each file.
+    const unsigned int commentReports = _commentReports;
+    code = read(fin, filename);
+    const bool cacheable = stamped && commentReports == _commentReports && !(_settings && _settings->terminated());
+
+    CachedHeader *header = cacheable ? new CachedHeader(code, mtime, size) : NULL;
+
+    MutexLock lock(headerCache.mutex);
+    ++headerCache.stats.misses;
+    if (!header)
+        return NULL;
+    const std::map<std::string, CachedHeader *>::iterator it = headerCache.headers.find(key);
+    if (it != headerCache.headers.end() && it->second->mtime == mtime && it->second->size == size) {
+        // Another thread has read it at the same time
+        delete header;
+        return &it->second->lines;
+    }
+    if (headerCache.bytes + header->code.size() > HeaderCache::maxBytes) {
+        // The cache is full
+        delete header;
+        return NULL;
+    }
+    headerCache.bytes += header->code.size();
+    if (it != headerCache.headers.end()) {
+        headerCache.replaced.push_back(it->second);
+        it->second = header;
+    } else {
+        headerCache.headers[key] = header;
+    }
+    return &header->lines;
+}
+
 
 std::string Preprocessor::handleIncludes(const std::string &code, const std::string &filePath, const std::list<std::string> &includePaths, std::map<std::string,std::string> &defs, std::list<std::string> &pragmaOnce, std::list<std::string> includes)
+{
+    const PreprocessorLines lines(code);
+    return handleIncludes(lines, filePath, includePaths, defs, pragmaOnce, includes);
+}
+
+std::string Preprocessor::handleIncludes(const PreprocessorLines &lines, const std::string &filePath, const std::list<std::string> &includePaths, std::map<std::string,std::string> &defs, std::list<std::string> &pragmaOnce, std::list<std::string> includes)
 {
     const std::string path(filePath.substr(0, 1 + filePath.find_last_of("\\/")));
 
@@ -2186,16 +2520,26 @@ std::string Preprocessor::handleIncludes(const std::string &code, const std::str
     if (_errorLogger)
         _errorLogger->reportProgress(filePath, "Preprocessor (handleIncludes)", 0);
 
-    std::ostringstream ostr;
-    std::istringstream istr(code);
+    std::string ostr;
+    ostr.reserve(lines.code().size());
     std::string line;
     bool suppressCurrentCodePath = false;
-    while (std::getline(istr,line)) {
+    for (std::size_t nr = 0; nr < lines.size(); ++nr) {
         ++linenr;
 
         if (_settings && _settings->terminated())
             return "";
 
+        // Code is kept if it's part of the current code path
+        if (lines.directive(nr) == PreprocessorLines::NoDirective) {
+            if (indentmatch == indent && !suppressCurrentCodePath)
+                lines.append(nr, ostr);
+            ostr += '\n';
+            continue;
+        }
+
+        lines.getline(nr, line);
+
         // has there been a true #if condition at the current indentmatch level?
         // then no more #elif or #else can be true before the #endif is seen.
         while (elseIsTrueStack.size() != indentmatch + 1) {
@@ -2323,7 +2667,7 @@ std::string Preprocessor::handleIncludes(const std::string &code, const std::str
 
                 const HeaderTypes headerType = getHeaderFileName(filename);
                 if (headerType == NoHeader) {
-                    ostr << std::endl;
+                    ostr += '\n';
                     continue;
                 }
 
@@ -2331,20 +2675,19 @@ std::string Preprocessor::handleIncludes(const std::string &code, const std::str
                 std::string filepath;
                 if (headerType == UserHeader)
                     filepath = path;
-                std::ifstream fin;
-                if (!openHeader(filename, includePaths, filepath, fin)) {
+                if (!findHeader(filename, includePaths, filepath)) {
                     missingInclude(Path::toNativeSeparators(filePath),
                                    linenr,
                                    filename,
                                    headerType
                                   );
-                    ostr << std::endl;
+                    ostr += '\n';
                     continue;
                 }
 
                 // Prevent that files are recursively included
                 if (std::find(includes.begin(), includes.end(), filename) != includes.end()) {
-                    ostr << std::endl;
+                    ostr += '\n';
                     continue;
                 }
 
@@ -2352,25 +2695,30 @@ std::string Preprocessor::handleIncludes(const std::string &code, const std::str
 
                 // Don't include header if it's already included and contains #pragma once
                 if (std::find(pragmaOnce.begin(), pragmaOnce.end(), filename) != pragmaOnce.end()) {
-                    ostr << std::endl;
+                    ostr += '\n';
                     continue;
                 }
 
-                ostr << "#file \"" << filename << "\"\n"
-                     << handleIncludes(read(fin, filename), filename, includePaths, defs, pragmaOnce, includes) << std::endl
-                     << "#endfile\n";
+                std::string headerCode;
+                const PreprocessorLines *header = readHeader(filename, headerCode);
+                ostr += "#file \"" + filename + "\"\n";
+                if (header)
+                    ostr += handleIncludes(*header, filename, includePaths, defs, pragmaOnce, includes);
+                else
+                    ostr += handleIncludes(headerCode, filename, includePaths, defs, pragmaOnce, includes);
+                ostr += "\n#endfile\n";
                 continue;
             }
 
             if (!suppressCurrentCodePath)
-                ostr << line;
+                ostr += line;
         }
 
         // A line has been read..
-        ostr << "\n";
+        ostr += '\n';
     }
 
-    return ostr.str();
+    return ostr;
 }
 
 std::string Preprocessor::handleIncludesRaw(const std::string &code, const std::string &filePath, const std::list<std::string> &includePaths, std::map<std::string,std::string> &defs, std::list<std::string> &pragmaOnce, std::list<std::string> includes)
@@ -2394,16 +2742,27 @@ std::string Preprocessor::handleIncludesRaw(const std::string &code, const std::
     if (_errorLogger)
         _errorLogger->reportProgress(filePath, "Preprocessor (handleIncludes)", 0);
 
-    std::ostringstream ostr;
-    std::istringstream istr(code);
+    std::string ostr;
+    ostr.reserve(code.size());
+    const PreprocessorLines lines(code);
     std::string line;
     bool suppressCurrentCodePath = false;
-    while (std::getline(istr,line)) {
+    for (std::size_t nr = 0; nr < lines.size(); ++nr) {
         ++linenr;
 
         if (_settings && _settings->terminated())
             return "";
 
+        // Code is kept if it's part of the current code path
+        if (lines.directive(nr) == PreprocessorLines::NoDirective) {
+            if (indentmatch == indent && !suppressCurrentCodePath)
+                lines.append(nr, ostr);
+            ostr += '\n';
+            continue;
+        }
+
+        lines.getline(nr, line);
+
         // has there been a true #if condition at the current indentmatch level?
         // then no more #elif or #else can be true before the #endif is seen.
         while (elseIsTrueStack.size() != indentmatch + 1) {
@@ -2531,7 +2890,7 @@ std::string Preprocessor::handleIncludesRaw(const std::string &code, const std::
 
                 const HeaderTypes headerType = getHeaderFileName(filename);
                 if (headerType == NoHeader) {
-                    ostr << std::endl;
+                    ostr += '\n';
                     continue;
                 }
 
@@ -2546,13 +2905,13 @@ std::string Preprocessor::handleIncludesRaw(const std::string &code, const std::
                                    filename,
                                    headerType
                                   );
-                    ostr << std::endl;
+                    ostr += '\n';
                     continue;
                 }
 
                 // Prevent that files are recursively included
                 if (std::find(includes.begin(), includes.end(), filename) != includes.end()) {
-                    ostr << std::endl;
+                    ostr += '\n';
                     continue;
                 }
 
@@ -2560,7 +2919,7 @@ std::string Preprocessor::handleIncludesRaw(const std::string &code, const std::
 
                 // Don't include header if it's already included and contains #pragma once
                 if (std::find(pragmaOnce.begin(), pragmaOnce.end(), filename) != pragmaOnce.end()) {
-                    ostr << std::endl;
+                    ostr += '\n';
                     continue;
                 }
 
@@ -2571,21 +2930,21 @@ std::string Preprocessor::handleIncludesRaw(const std::string &code, const std::
                 read( fin, filename, strRawCode );
 
                 //ds call the raw handleIncludes with raw code
-                ostr << handleIncludesRaw( strRawCode, filename, includePaths, defs, pragmaOnce, includes );
+                ostr += handleIncludesRaw( strRawCode, filename, includePaths, defs, pragmaOnce, includes );
 
                 //ds go on
                 continue;
             }
 
             if (!suppressCurrentCodePath)
-                ostr << line;
+                ostr += line;
         }
 
         // A line has been read..
-        ostr << "\n";
+        ostr += '\n';
     }
 
-    return ostr.str();
+    return ostr;
 }
 
 void Preprocessor::handleIncludes(std::string &code, const std::string &filePath, const std::list<std::string> &includePaths)
@@ -2631,8 +2990,7 @@ void Preprocessor::handleIncludes(std::string &code, const std::string &filePath
         std::string filepath;
         if (headerType == UserHeader && !paths.empty())
             filepath = paths.back();
-        std::ifstream fin;
-        const bool fileOpened(openHeader(filename, includePaths, filepath, fin));
+        const bool fileOpened(findHeader(filename, includePaths, filepath));
 
         if (fileOpened) {
             filename = Path::simplifyPath(filename.c_str());
@@ -2641,13 +2999,13 @@ void Preprocessor::handleIncludes(std::string &code, const std::string &filePath
             if (handledFiles.find(tempFile) != handledFiles.end()) {
                 // We have processed this file already once, skip
                 // it this time to avoid eternal loop.
-                fin.close();
                 continue;
             }
 
             handledFiles.insert(tempFile);
-            processedFile = Preprocessor::read(fin, filename);
-            fin.close();
+            const PreprocessorLines *header = readHeader(filename, processedFile);
+            if (header)
+                processedFile = header->code();
         }
 
         if (!processedFile.empty()) {
@@ -2831,13 +3189,130 @@ static void getparams(const std::string &line,
     }
 }
 
-/** @brief Class that the preprocessor uses when it expands macros. This class represents a preprocessor macro */
+/**
+ * @brief Index of the macros that are defined at some point of the code, by
+ * name. It is an open addressing hash table with linear probing. The macros
+ * are not owned by the table.
+ */
+class MacroTable {
+public:
+    MacroTable() : _size(0), _table(16) {
+    }
+
+    /** find macro with given name, returns NULL if there is no such macro */
+    const PreprocessorMacro *find(const std::string &name) const {
+        const std::size_t h = hash(name);
+        const std::size_t mask = _table.size() - 1;
+        for (std::size_t i = h & mask; _table[i].macro; i = (i + 1) & mask) {
+            if (_table[i].hash == h && *_table[i].name == name)
+                return _table[i].macro;
+        }
+        return 0;
+    }
+
+    /**
+     * add macro, a macro with the same name is replaced
+     * @param name name of the macro, must live as long as the macro is in the table
+     * @param macro the macro
+     */
+    void insert(const std::string &name, const PreprocessorMacro *macro) {
+        if (2 * (_size + 1) > _table.size())
+            rehash(2 * _table.size());
+
+        const std::size_t h = hash(name);
+        const std::size_t mask = _table.size() - 1;
+        std::size_t i = h & mask;
+        for (; _table[i].macro; i = (i + 1) & mask) {
+            if (_table[i].hash == h && *_table[i].name == name)
+                break;
+        }
+        if (!_table[i].macro)
+            ++_size;
+        _table[i].hash = h;
+        _table[i].name = &name;
+        _table[i].macro = macro;
+    }
+
+    /** remove the macro with the given name */
+    void erase(const std::string &name) {
+        const std::size_t h = hash(name);
+        const std::size_t mask = _table.size() - 1;
+        std::size_t i = h & mask;
+        for (; _table[i].macro; i = (i + 1) & mask) {
+            if (_table[i].hash == h && *_table[i].name == name)
+                break;
+        }
+        if (!_table[i].macro)
+            return;
+
+        // Move the following entries back so there are no gaps before them
+        _table[i] = Slot();
+        --_size;
+        for (std::size_t j = (i + 1) & mask; _table[j].macro; j = (j + 1) & mask) {
+            const std::size_t k = _table[j].hash & mask;
+            if ((i < j) ? (i < k && k <= j) : (i < k || k <= j))
+                continue;
+            _table[i] = _table[j];
+            _table[j] = Slot();
+            i = j;
+        }
+    }
+
+private:
+    struct Slot {
+        Slot() : hash(0), name(0), macro(0) {
+        }
+        std::size_t hash;
+        const std::string *name;
+        const PreprocessorMacro *macro;
+    };
+
+    static std::size_t hash(const std::string &name) {
+        return static_cast<std::size_t>(fnv1a(FNV1A_OFFSET_BASIS, name));
+    }
+
+    void rehash(std::size_t size) {
+        std::vector<Slot> old(size);
+        old.swap(_table);
+        const std::size_t mask = _table.size() - 1;
+        for (std::vector<Slot>::const_iterator it = old.begin(); it != old.end(); ++it) {
+            if (!it->macro)
+                continue;
+            std::size_t i = it->hash & mask;
+            while (_table[i].macro)
+                i = (i + 1) & mask;
+            _table[i] = *it;
+        }
+    }
+
+    /** number of macros */
+    std::size_t _size;
+
+    /** the size is a power of two and it is at most half full */
+    std::vector<Slot> _table;
+};
+
+/**
+ * @brief Class that the preprocessor uses when it expands macros. This class represents a preprocessor macro.
+ * The macro is tokenized once when it is created, it does not change after that.
+ */
 class PreprocessorMacro {
 private:
-    Settings settings;
+    /** token of the macro definition */
+    struct MacroToken {
+        std::string str;
+        bool name;
+        bool number;
+
+        /** index of the macro parameter that the token is ("#x" is the parameter "x"), -1 if it is not a parameter */
+        int param;
+    };
 
     /** tokens of this macro */
-    Tokenizer tokenizer;
+    std::vector<MacroToken> _tokens;
+
+    /** index of the first ")" in the tokens, the size of _tokens if there is none */
+    std::size_t _endpar;
 
     /** macro parameters */
     std::vector<std::string> _params;
@@ -2848,36 +3323,36 @@ private:
     /** macro definition in plain text */
     const std::string _macro;
 
-    /** prefix that is used by cppcheck to separate macro parameters. Always "__cppcheck__" */
-    const std::string _prefix;
-
     /** does this macro take a variable number of parameters? */
     bool _variadic;
 
     /** The macro has parentheses but no parameters.. "AAA()" */
     bool _nopar;
 
+    /** disabled copy constructor */
+    PreprocessorMacro(const PreprocessorMacro &);
+
     /** disabled assignment operator */
     void operator=(const PreprocessorMacro &);
 
     /** @brief expand inner macro */
     std::vector<std::string> expandInnerMacros(const std::vector<std::string> &params1,
-            const std::map<std::string, PreprocessorMacro *> &macros) const {
+            const MacroTable &macros) const {
         std::string innerMacroName;
 
         // Is there an inner macro..
         {
-            const Token *tok = Token::findsimplematch(tokens(), ")");
-            if (!Token::Match(tok, ") %var% ("))
+            std::size_t tok = _endpar;
+            if (tok + 2 >= _tokens.size() || !_tokens[tok + 1].name || _tokens[tok + 2].str != "(")
                 return params1;
-            innerMacroName = tok->strAt(1);
-            tok = tok->tokAt(3);
+            innerMacroName = _tokens[tok + 1].str;
+            tok += 3;
             unsigned int par = 0;
-            while (Token::Match(tok, "%var% ,|)")) {
-                tok = tok->tokAt(2);
+            while (tok + 1 < _tokens.size() && _tokens[tok].name && (_tokens[tok + 1].str == "," || _tokens[tok + 1].str == ")")) {
+                tok += 2;
                 par++;
             }
-            if (tok || par != params1.size())
+            if (tok < _tokens.size() || par != params1.size())
                 return params1;
         }
 
@@ -2894,13 +3369,11 @@ private:
                 getparams(param, pos, innerparams, num, endFound);
                 if (pos == param.length()-1 && num==0 && endFound && innerparams.size() == params1.size()) {
                     // Is inner macro defined?
-                    std::map<std::string, PreprocessorMacro *>::const_iterator it = macros.find(innerMacroName);
-                    if (it != macros.end()) {
+                    const PreprocessorMacro *innerMacro = macros.find(innerMacroName);
+                    if (innerMacro) {
                         // expand the inner macro
-                        const PreprocessorMacro *innerMacro = it->second;
-
                         std::string innercode;
-                        std::map<std::string,PreprocessorMacro *> innermacros = macros;
+                        MacroTable innermacros = macros;
                         innermacros.erase(innerMacroName);
                         innerMacro->code(innerparams, innermacros, innercode);
                         params2[ipar] = innercode;
@@ -2918,18 +3391,19 @@ public:
      * for this class - everything is setup here.
      * @param macro The code after define, until end of line,
      * e.g. "A(x) foo(x);"
+     * @param settings settings that are used when the macro is tokenized
      */
-    explicit PreprocessorMacro(const std::string &macro)
-        : _macro(macro), _prefix("__cppcheck__") {
-        tokenizer.setSettings(&settings);
-
+    PreprocessorMacro(const std::string &macro, const Settings *settings)
+        : _endpar(0), _macro(macro) {
         // Tokenize the macro to make it easier to handle
+        TokenList tokenlist(settings);
         std::istringstream istr(macro);
-        tokenizer.list.createTokens(istr);
+        tokenlist.createTokens(istr);
+        const Token *tokens = tokenlist.front();
 
         // macro name..
-        if (tokens() && tokens()->isName())
-            _name = tokens()->str();
+        if (tokens && tokens->isName())
+            _name = tokens->str();
 
         // initialize parameters to default values
         _variadic = _nopar = false;
@@ -2937,8 +3411,8 @@ public:
         std::string::size_type pos = macro.find_first_of(" (");
         if (pos != std::string::npos && macro[pos] == '(') {
             // Extract macro parameters
-            if (Token::Match(tokens(), "%var% ( %var%")) {
-                for (const Token *tok = tokens()->tokAt(2); tok; tok = tok->next()) {
+            if (Token::Match(tokens, "%var% ( %var%")) {
+                for (const Token *tok = tokens->tokAt(2); tok; tok = tok->next()) {
                     if (tok->str() == ")")
                         break;
                     if (Token::simpleMatch(tok, ". . . )")) {
@@ -2952,17 +3426,33 @@ public:
                 }
             }
 
-            else if (Token::Match(tokens(), "%var% ( . . . )"))
+            else if (Token::Match(tokens, "%var% ( . . . )"))
                 _variadic = true;
 
-            else if (Token::Match(tokens(), "%var% ( )"))
+            else if (Token::Match(tokens, "%var% ( )"))
                 _nopar = true;
         }
-    }
 
-    /** return tokens of this macro */
-    const Token *tokens() const {
-        return tokenizer.tokens();
+        // Copy the tokens and look up the parameters
+        for (const Token *tok = tokens; tok; tok = tok->next()) {
+            MacroToken token;
+            token.str = tok->str();
+            token.name = tok->isName();
+            token.number = tok->isNumber();
+            token.param = -1;
+            if (token.str[0] == '#' || token.name) {
+                const std::string::size_type offset = (token.str[0] == '#') ? 1U : 0U;
+                for (unsigned int i = 0; i < _params.size(); ++i) {
+                    if (token.str.compare(offset, std::string::npos, _params[i]) == 0) {
+                        token.param = (int)i;
+                        break;
+                    }
+                }
+            }
+            _tokens.push_back(token);
+        }
+        while (_endpar < _tokens.size() && _tokens[_endpar].str != ")")
+            ++_endpar;
     }
 
     /** read parameters of this macro */
@@ -2992,7 +3482,7 @@ public:
      * @param macrocode output string
      * @return true if the expanding was successful
      */
-    bool code(const std::vector<std::string> &params2, const std::map<std::string, PreprocessorMacro *> &macros, std::string &macrocode) const {
+    bool code(const std::vector<std::string> &params2, const MacroTable &macros, std::string &macrocode) const {
         if (_nopar || (_params.empty() && _variadic)) {
             macrocode = _macro.substr(1 + _macro.find(")"));
             if (macrocode.empty())
@@ -3040,75 +3530,70 @@ public:
         else {
             const std::vector<std::string> givenparams = expandInnerMacros(params2, macros);
 
-            const Token *tok = tokens();
-            while (tok && tok->str() != ")")
-                tok = tok->next();
-            if (tok) {
-                bool optcomma = false;
-                while (NULL != (tok = tok->next())) {
-                    std::string str = tok->str();
-                    if (str == "##")
-                        continue;
-                    if (str[0] == '#' || tok->isName()) {
-                        const bool stringify(str[0] == '#');
-                        if (stringify) {
-                            str = str.erase(0, 1);
-                        }
-                        for (unsigned int i = 0; i < _params.size(); ++i) {
-                            if (str == _params[i]) {
-                                if (_variadic &&
-                                    (i == _params.size() - 1 ||
-                                     (givenparams.size() + 2 == _params.size() && i + 1 == _params.size() - 1))) {
-                                    str = "";
-                                    for (unsigned int j = (unsigned int)_params.size() - 1; j < givenparams.size(); ++j) {
-                                        if (optcomma || j > _params.size() - 1)
-                                            str += ",";
-                                        optcomma = false;
-                                        str += givenparams[j];
-                                    }
-                                } else if (i >= givenparams.size()) {
-                                    // Macro had more parameters than caller used.
-                                    macrocode = "";
-                                    return false;
-                                } else if (stringify) {
-                                    const std::string &s(givenparams[i]);
-                                    std::ostringstream ostr;
-                                    ostr << "\"";
-                                    for (std::string::size_type j = 0; j < s.size(); ++j) {
-                                        if (s[j] == '\\' || s[j] == '\"')
-                                            ostr << '\\';
-                                        ostr << s[j];
-                                    }
-                                    str = ostr.str() + "\"";
-                                } else
-                                    str = givenparams[i];
-
-                                break;
+            bool optcomma = false;
+            for (std::size_t tok = _endpar + 1; tok < _tokens.size(); ++tok) {
+                const MacroToken &token = _tokens[tok];
+                if (token.str == "##")
+                    continue;
+                std::string str = token.str;
+                if (str[0] == '#' || token.name) {
+                    const bool stringify(str[0] == '#');
+                    if (stringify) {
+                        str = str.erase(0, 1);
+                    }
+                    if (token.param >= 0) {
+                        const unsigned int i = (unsigned int)token.param;
+                        if (_variadic &&
+                            (i == _params.size() - 1 ||
+                             (givenparams.size() + 2 == _params.size() && i + 1 == _params.size() - 1))) {
+                            str = "";
+                            for (unsigned int j = (unsigned int)_params.size() - 1; j < givenparams.size(); ++j) {
+                                if (optcomma || j > _params.size() - 1)
+                                    str += ",";
+                                optcomma = false;
+                                str += givenparams[j];
                             }
-                        }
-
-                        // expand nopar macro
-                        if (tok->strAt(-1) != "##") {
-                            const std::map<std::string, PreprocessorMacro *>::const_iterator it = macros.find(str);
-                            if (it != macros.end() && it->second->_macro.find("(") == std::string::npos) {
-                                str = it->second->_macro;
-                                if (str.find(" ") != std::string::npos)
-                                    str.erase(0, str.find(" "));
-                                else
-                                    str = "";
+                        } else if (i >= givenparams.size()) {
+                            // Macro had more parameters than caller used.
+                            macrocode = "";
+                            return false;
+                        } else if (stringify) {
+                            const std::string &s(givenparams[i]);
+                            std::ostringstream ostr;
+                            ostr << "\"";
+                            for (std::string::size_type j = 0; j < s.size(); ++j) {
+                                if (s[j] == '\\' || s[j] == '\"')
+                                    ostr << '\\';
+                                ostr << s[j];
                             }
-                        }
+                            str = ostr.str() + "\"";
+                        } else
+                            str = givenparams[i];
                     }
-                    if (_variadic && tok->str() == "," && tok->next() && tok->next()->str() == "##") {
-                        optcomma = true;
-                        continue;
+
+                    // expand nopar macro
+                    if (_tokens[tok - 1].str != "##") {
+                        const PreprocessorMacro *macro = macros.find(str);
+                        if (macro && macro->_macro.find("(") == std::string::npos) {
+                            str = macro->_macro;
+                            if (str.find(" ") != std::string::npos)
+                                str.erase(0, str.find(" "));
+                            else
+                                str = "";
+                        }
                     }
-                    optcomma = false;
-                    macrocode += str;
-                    if (Token::Match(tok, "%var% %var%") ||
-                        Token::Match(tok, "%var% %num%") ||
-                        Token::Match(tok, "%num% %var%") ||
-                        Token::simpleMatch(tok, "> >"))
+                }
+                if (_variadic && token.str == "," && tok + 1 < _tokens.size() && _tokens[tok + 1].str == "##") {
+                    optcomma = true;
+                    continue;
+                }
+                optcomma = false;
+                macrocode += str;
+                if (tok + 1 < _tokens.size()) {
+                    const MacroToken &next = _tokens[tok + 1];
+                    if ((token.name && (next.name || next.number)) ||
+                        (token.number && next.name) ||
+                        (token.str == ">" && next.str == ">"))
                         macrocode += " ";
                 }
             }
@@ -3248,24 +3733,52 @@ void Preprocessor::validateCfgError(const std::string &cfg, const std::string &m
     _errorLogger->reportInfo(errmsg);
 }
 
-std::string Preprocessor::expandMacros(const std::string &code, std::string filename, const std::string &cfg, ErrorLogger *errorLogger)
+static void deleteMacros(std::map<std::string, PreprocessorMacro *> &macros)
+{
+    for (std::map<std::string, PreprocessorMacro *>::iterator it = macros.begin(); it != macros.end(); ++it)
+        delete it->second;
+    macros.clear();
+}
+
+/** get the macro for a definition, it is parsed if it isn't in the cache */
+static const PreprocessorMacro *getMacro(const std::string &definition, std::map<std::string, PreprocessorMacro *> &macroCache, const Settings *settings)
+{
+    PreprocessorMacro *&macro = macroCache[definition];
+    if (!macro)
+        macro = new PreprocessorMacro(definition, settings);
+    return macro;
+}
+
+Preprocessor::~Preprocessor()
+{
+    deleteMacros(_macroCache);
+}
+
+std::string Preprocessor::expandMacros(const std::string &code, std::string filename, const std::string &cfg, ErrorLogger *errorLogger, std::map<std::string, PreprocessorMacro *> *macroCache)
 {
     // Search for macros and expand them..
     // --------------------------------------------
 
-    // Available macros (key=macroname, value=macro).
-    std::map<std::string, PreprocessorMacro *> macros;
+    // The parsed macros. They are deleted before returning if there is no cache.
+    std::map<std::string, PreprocessorMacro *> localMacroCache;
+    if (!macroCache)
+        macroCache = &localMacroCache;
+
+    // settings for tokenizing the macros
+    const Settings settings;
+
+    // Available macros. The names of the user defined macros are in cfgmap.
+    MacroTable macros;
+    const std::map<std::string,std::string> cfgmap(getcfgmap(cfg));
 
     {
         // fill up "macros" with user defined macros
-        const std::map<std::string,std::string> cfgmap(getcfgmap(cfg));
         std::map<std::string, std::string>::const_iterator it;
         for (it = cfgmap.begin(); it != cfgmap.end(); ++it) {
             std::string s = it->first;
             if (!it->second.empty())
                 s += " " + it->second;
-            PreprocessorMacro *macro = new PreprocessorMacro(s);
-            macros[it->first] = macro;
+            macros.insert(it->first, getMacro(s, *macroCache, &settings));
         }
     }
 
@@ -3284,30 +3797,16 @@ std::string Preprocessor::expandMacros(const std::string &code, std::string file
     while (getlines(istr, line)) {
         // defining a macro..
         if (line.compare(0, 8, "#define ") == 0) {
-            PreprocessorMacro *macro = new PreprocessorMacro(line.substr(8));
-            if (macro->name().empty() || macro->name() == "NULL") {
-                delete macro;
-            } else if (macro->name() == "BOOST_FOREACH") {
-                // BOOST_FOREACH is currently too complex to parse, so skip it.
-                delete macro;
-            } else {
-                std::map<std::string, PreprocessorMacro *>::iterator it;
-                it = macros.find(macro->name());
-                if (it != macros.end())
-                    delete it->second;
-                macros[macro->name()] = macro;
-            }
+            const PreprocessorMacro *macro = getMacro(line.substr(8), *macroCache, &settings);
+            // BOOST_FOREACH is currently too complex to parse, so skip it.
+            if (!macro->name().empty() && macro->name() != "NULL" && macro->name() != "BOOST_FOREACH")
+                macros.insert(macro->name(), macro);
             line = "\n";
         }
 
         // undefining a macro..
         else if (line.compare(0, 7, "#undef ") == 0) {
-            std::map<std::string, PreprocessorMacro *>::iterator it;
-            it = macros.find(line.substr(7));
-            if (it != macros.end()) {
-                delete it->second;
-                macros.erase(it);
-            }
+            macros.erase(line.substr(7));
             line = "\n";
         }
 
@@ -3376,10 +3875,7 @@ std::string Preprocessor::expandMacros(const std::string &code, std::string file
                                    "noQuoteCharPair",
                                    std::string("No pair for character (") + ch + "). Can't process file. File is either invalid or unicode, which is currently not supported.");
 
-                        std::map<std::string, PreprocessorMacro *>::iterator it;
-                        for (it = macros.begin(); it != macros.end(); ++it)
-                            delete it->second;
-                        macros.clear();
+                        deleteMacros(localMacroCache);
                         return "";
                     }
 
@@ -3403,13 +3899,10 @@ std::string Preprocessor::expandMacros(const std::string &code, std::string file
                     const std::string id = line.substr(pos1, pos - pos1);
 
                     // is there a macro with this name?
-                    std::map<std::string, PreprocessorMacro *>::const_iterator it;
-                    it = macros.find(id);
-                    if (it == macros.end())
+                    const PreprocessorMacro * const macro = macros.find(id);
+                    if (!macro)
                         break;  // no macro with this name exist
 
-                    const PreprocessorMacro * const macro = it->second;
-
                     // check that pos is within allowed limits for this
                     // macro
                     {
@@ -3458,10 +3951,7 @@ std::string Preprocessor::expandMacros(const std::string &code, std::string file
                                    "syntaxError",
                                    std::string("Syntax error. Not enough parameters for macro '") + macro->name() + "'.");
 
-                        std::map<std::string, PreprocessorMacro *>::iterator iter;
-                        for (iter = macros.begin(); iter != macros.end(); ++iter)
-                            delete iter->second;
-                        macros.clear();
+                        deleteMacros(localMacroCache);
                         return "";
                     }
 
@@ -3512,9 +4002,7 @@ std::string Preprocessor::expandMacros(const std::string &code, std::string file
         }
     }
 
-    for (std::map<std::string, PreprocessorMacro *>::iterator it = macros.begin(); it != macros.end(); ++it)
-        delete it->second;
-    macros.clear();
+    deleteMacros(localMacroCache);
 
     return ostr.str();
 }
@@ -25,14 +25,105 @@
 #include <istream>
 #include <string>
 #include <list>
+#include <vector>
 #include "config.h"
 
 class ErrorLogger;
+class PreprocessorMacro;
 class Settings;
 
 /// @addtogroup Core
 /// @{
 
+/**
+ * @brief Line table for preprocessor code.
+ * The lines are offsets into one string, each with the directive found at
+ * the start of the line. The preprocessor passes walk the code through
+ * this table instead of copying it into a std::istringstream. The string
+ * must not be changed or destroyed while the table is used.
+ */
+class CPPCHECKLIB PreprocessorLines {
+public:
+    /** Directive at the start of a line */
+    enum Directive {
+        NoDirective = 0,
+        Include,
+        Define,
+        Undef,
+        If,
+        Ifdef,
+        Ifndef,
+        Elif,
+        Else,
+        Endif,
+        File,
+        Endfile,
+        Line,
+        Pragma,
+        Error,
+        OtherDirective
+    };
+
+    explicit PreprocessorLines(const std::string &code);
+
+    /** number of lines, a trailing newline doesn't start a new line (like std::getline) */
+    std::size_t size() const {
+        return _lines.size();
+    }
+
+    /** the code of the table */
+    const std::string &code() const {
+        return *_code;
+    }
+
+    /** offset of line nr in the code */
+    std::string::size_type offset(std::size_t nr) const {
+        return _lines[nr].offset;
+    }
+
+    /** length of line nr without newline */
+    std::string::size_type length(std::size_t nr) const {
+        return _lines[nr].length;
+    }
+
+    Directive directive(std::size_t nr) const {
+        return _lines[nr].directive;
+    }
+
+    /** is line nr followed by a newline? */
+    bool terminated(std::size_t nr) const {
+        return _lines[nr].offset + _lines[nr].length < _code->size();
+    }
+
+    /** copy line nr into str (without newline) */
+    void getline(std::size_t nr, std::string &str) const {
+        str.assign(*_code, _lines[nr].offset, _lines[nr].length);
+    }
+
+    /** append line nr to str (without newline) */
+    void append(std::size_t nr, std::string &str) const {
+        str.append(*_code, _lines[nr].offset, _lines[nr].length);
+    }
+
+    /** does line nr start with the given text? */
+    bool startsWith(std::size_t nr, const char str[], std::string::size_type len) const {
+        return _lines[nr].length >= len && _code->compare(_lines[nr].offset, len, str) == 0;
+    }
+
+    /** classify the directive of a line, the '#' must be the first character */
+    static Directive classify(const char line[], std::string::size_type length);
+
+private:
+    struct LineInfo {
+        std::string::size_type offset;
+        std::string::size_type length;
+        Directive directive;
+    };
+
+    const std::string *_code;
+    std::vector<LineInfo> _lines;
+};
+
 /**
  * @brief The cppcheck preprocessor.
  * The preprocessor has special functionality for extracting the various ifdef
@@ -54,9 +145,36 @@ public:
     static char macroChar;
 
     Preprocessor(Settings *settings = 0, ErrorLogger *errorLogger = 0);
+    ~Preprocessor();
 
     static bool missingIncludeFlag;
 
+    /** @brief Statistics of the header cache that is shared by all Preprocessor instances */
+    struct HeaderCacheStats {
+        HeaderCacheStats() : hits(0), misses(0), bytesSaved(0), resolveHits(0), resolveMisses(0) { }
+
+        /** headers that were taken from the cache */
+        std::size_t hits;
+
+        /** headers that were read from disk */
+        std::size_t misses;
+
+        /** size of the headers that didn't need to be read again */
+        std::size_t bytesSaved;
+
+        /** include names whose path was known already */
+        std::size_t resolveHits;
+
+        /** include names that were searched for in the include paths */
+        std::size_t resolveMisses;
+    };
+
+    /** @brief Get the statistics of the header cache */
+    static HeaderCacheStats headerCacheStats();
+
+    /** @brief Forget all headers and include paths in the header cache */
+    static void clearHeaderCache();
+
     /**
      * Extract the code for each configuration
      * @param istr The (file/string) stream to read from.
@@ -106,6 +224,15 @@ public:
      */
     std::string getcode(const std::string &filedata, const std::string &cfg, const std::string &filename);
 
+    /**
+     * Get preprocessed code for a given configuration. Use this when the code
+     * of several configurations is extracted from the same file data.
+     * @param lines line table of the file data
+     * @param cfg configuration to read out
+     * @param filename name of source file
+     */
+    std::string getcode(const PreprocessorLines &lines, const std::string &cfg, const std::string &filename);
+
     /**
      * simplify condition
      * @param variables Variable values
@@ -155,9 +282,11 @@ public:
      * @param filename filename of source file
      * @param cfg user given -D configuration
      * @param errorLogger Error logger to write errors to (if any)
+     * @param macroCache parsed macros by definition, they can be reused by
+     * the next call. If it is NULL the parsed macros are deleted.
      * @return the expanded string
      */
-    static std::string expandMacros(const std::string &code, std::string filename, const std::string &cfg, ErrorLogger *errorLogger);
+    static std::string expandMacros(const std::string &code, std::string filename, const std::string &cfg, ErrorLogger *errorLogger, std::map<std::string, PreprocessorMacro *> *macroCache = 0);
 
     /**
      * Remove comments from code. This should only be called from read().
@@ -207,7 +336,7 @@ private:
      */
     static std::string removeSpaceNearNL(const std::string &str);
 
-    static std::string getdef(std::string line, bool def);
+    static std::string getdef(const std::string &directive, bool def);
 
 public:
 
@@ -217,6 +346,13 @@ public:
      */
     std::list<std::string> getcfgs(const std::string &filedata, const std::string &filename, const std::map<std::string, std::string> &defs);
 
+    /**
+     * Replace "defined A" with "defined(A)" in #if and #elif
+     * @param code Code processed by read(), modified in place.
+     * @return false if the check was terminated
+     */
+    bool addDefinedParentheses(std::string &code) const;
+
     /**
      * Remove asm(...) from a string
      * @param str Code
@@ -252,6 +388,18 @@ public:
     }
 
 private:
+    /**
+     * Read a header. Headers are read once per process, later reads
+     * are taken from the header cache if the file is unchanged.
+     * @param filename path of the header
+     * @param code the code of the header if it isn't cached
+     * @return the cached header or NULL if it's returned in code
+     */
+    const PreprocessorLines *readHeader(const std::string &filename, std::string &code);
+
+    /** handle includes for a specific configuration, the code is given as a line table */
+    std::string handleIncludes(const PreprocessorLines &lines, const std::string &filePath, const std::list<std::string> &includePaths, std::map<std::string,std::string> &defs, std::list<std::string> &pragmaOnce, std::list<std::string> includes);
+
     void missingInclude(const std::string &filename, unsigned int linenr, const std::string &header, HeaderTypes headerType);
 
     void error(const std::string &filename, unsigned int linenr, const std::string &msg);
@@ -273,8 +421,20 @@ private:
     Settings *_settings;
     ErrorLogger *_errorLogger;
 
+    /** errors and inline suppressions reported by removeComments(), a header that reports any is not cached */
+    unsigned int _commentReports;
+
     /** filename for cpp/c file - useful when reporting errors */
     std::string file0;
+
+    /** macros parsed by expandMacros(), they are shared by all configurations */
+    std::map<std::string, PreprocessorMacro *> _macroCache;
+
+    /** Disable copy constructor, no implementation */
+    Preprocessor(const Preprocessor &);
+
+    /** Disable assignment operator, no implementation */
+    Preprocessor &operator=(const Preprocessor &);
 };
 
 /// @}
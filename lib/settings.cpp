@@ -34,11 +34,16 @@ Settings::Settings()
       _relativePaths(false),
       _xml(false), _xml_version(1),
       _jobs(1),
+      useProcesses(false),
+      _checkThreads(1),
       _exitCode(0),
       _showtime(0),
       _maxConfigs(12),
+      maxExecutionPaths(10),
+      executionPathStats(0),
       enforcedLang(None),
       reportProgress(false),
+      summaries(0),
       checkConfiguration(false),
       checkLibrary(false)
 {
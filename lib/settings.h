@@ -28,6 +28,9 @@
 #include "suppressions.h"
 #include "standards.h"
 
+class ExecutionPathStats;
+class SummaryDatabase;
+
 /// @addtogroup Core
 /// @{
 
@@ -109,6 +112,14 @@ public:
         time. Default is 1. (-j N) */
     unsigned int _jobs;
 
+    /** @brief Check each file in a separate process instead of using
+        threads when -j is used (--executor=process). */
+    bool useProcesses;
+
+    /** @brief How many threads should run the checks of one file at
+        the same time. Default is 1. (--check-threads=N) */
+    unsigned int _checkThreads;
+
     /** @brief If errors are found, this value is returned from main().
         Default value is 0. */
     int _exitCode;
@@ -117,9 +128,12 @@ public:
         e.g. "{severity} {file}:{line} {message} {id}" */
     std::string _outputFormat;
 
-    /** @brief show timing information (--showtime=file|summary|top5) */
+    /** @brief show timing information (--showtime=file|summary|top5|json|csv) */
     unsigned int _showtime;
 
+    /** @brief Trace file of the time spent in each file, configuration and check (--profile-out) */
+    std::string profileOut;
+
     /** @brief List of include paths, e.g. "my/includes/" which should be used
         for finding include files inside source files. (-I) */
     std::list<std::string> _includePaths;
@@ -134,6 +148,15 @@ public:
         Default is 12. (--max-configs=N) */
     unsigned int _maxConfigs;
 
+    /** @brief Maximum number of execution paths at a condition before the
+        execution path checks bail out of a function. Default is 10.
+        (--max-execution-paths=N) */
+    unsigned int maxExecutionPaths;
+
+    /** @brief The execution path checks add their statistics here when
+        it is not NULL (--showtime) */
+    ExecutionPathStats *executionPathStats;
+
     /**
      * @brief Returns true if given id is in the list of
      * enabled extra checks (--enable)
@@ -150,6 +173,11 @@ public:
      */
     std::string addEnabled(const std::string &str);
 
+    /** @brief All enabled extra checks */
+    const std::set<std::string> &enabled() const {
+        return _enabled;
+    }
+
     enum Language {
         None, C, CPP
     };
@@ -175,6 +203,15 @@ public:
     /** @brief --report-progress */
     bool reportProgress;
 
+    /** @brief Directory where analysis results are cached between runs (--cache-dir) */
+    std::string cacheDir;
+
+    /**
+     * @brief Whole program analysis data of the files, read by the checks.
+     * It is saved in the cache directory between runs. NULL if there is none.
+     */
+    const SummaryDatabase *summaries;
+
     /** Library (--library) */
     Library library;
 
@@ -0,0 +1,322 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2013 Daniel Marjamäki and Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//---------------------------------------------------------------------------
+#ifndef stablevectorH
+#define stablevectorH
+//---------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <new>
+
+/// @addtogroup Core
+/// @{
+
+/**
+ * @brief Sequence container that stores its elements in contiguous chunks.
+ *
+ * The first chunk has room for one element and every following chunk is
+ * twice as large as the one before, up to 64 elements. Elements are never
+ * moved: pointers and references to them stay valid until the element is
+ * removed. An empty container does not allocate anything.
+ *
+ * Only the operations the symbol database needs are provided: elements are
+ * added and removed at the end, and iteration is bidirectional.
+ */
+template<class T>
+class StableVector {
+private:
+    /**
+     * Chunk header, the elements follow it in the same allocation. The
+     * capacity of a chunk is given by its index, see chunkSize().
+     */
+    struct Chunk {
+        Chunk *previous;
+        Chunk *next;
+
+        T *elements() {
+            return reinterpret_cast<T *>(this + 1);
+        }
+    };
+
+    /** number of elements in the chunk with the given index */
+    static std::size_t chunkSize(std::size_t index) {
+        return index < 6U ? std::size_t(1) << index : 64U;
+    }
+
+    /** number of elements in the chunks before the chunk with the given index */
+    static std::size_t chunkStart(std::size_t index) {
+        return index < 6U ? (std::size_t(1) << index) - 1U : 63U + 64U * (index - 6U);
+    }
+
+public:
+    typedef T value_type;
+    typedef T &reference;
+    typedef const T &const_reference;
+    typedef T *pointer;
+    typedef const T *const_pointer;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    /** @brief Iterator, V is T or const T */
+    template<class V>
+    class Iterator {
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef V *pointer;
+        typedef V &reference;
+
+        Iterator() : _container(0), _chunk(0), _index(0), _offset(0) {
+        }
+
+        /** iterator to const_iterator conversion */
+        Iterator(const Iterator<T> &other)
+            : _container(other._container), _chunk(other._chunk), _index(other._index), _offset(other._offset) {
+        }
+
+        Iterator &operator=(const Iterator<T> &other) {
+            _container = other._container;
+            _chunk = other._chunk;
+            _index = other._index;
+            _offset = other._offset;
+            return *this;
+        }
+
+        reference operator*() const {
+            return _chunk->elements()[_offset];
+        }
+
+        pointer operator->() const {
+            return _chunk->elements() + _offset;
+        }
+
+        Iterator &operator++() {
+            if (++_offset == chunkSize(_index)) {
+                _chunk = _chunk->next;
+                ++_index;
+                _offset = 0;
+            }
+            return *this;
+        }
+
+        Iterator operator++(int) {
+            Iterator it(*this);
+            ++*this;
+            return it;
+        }
+
+        Iterator &operator--() {
+            if (_offset == 0) {
+                _chunk = _chunk ? _chunk->previous : _container->_last;
+                --_index;
+                _offset = chunkSize(_index);
+            }
+            --_offset;
+            return *this;
+        }
+
+        Iterator operator--(int) {
+            Iterator it(*this);
+            --*this;
+            return it;
+        }
+
+        bool operator==(const Iterator &other) const {
+            return _index == other._index && _offset == other._offset;
+        }
+
+        bool operator!=(const Iterator &other) const {
+            return !(*this == other);
+        }
+
+    private:
+        friend class StableVector;
+        friend class Iterator<const T>;
+
+        Iterator(const StableVector *container, Chunk *chunk, size_type index, size_type offset)
+            : _container(container), _chunk(chunk), _index(index), _offset(offset) {
+        }
+
+        const StableVector *_container;
+
+        /** current chunk, NULL for end() when the last chunk is full */
+        Chunk *_chunk;
+
+        /** index of the current chunk */
+        size_type _index;
+
+        size_type _offset;
+    };
+
+    typedef Iterator<T> iterator;
+    typedef Iterator<const T> const_iterator;
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    StableVector() : _first(0), _last(0), _chunks(0), _used(0) {
+    }
+
+    StableVector(const StableVector &other) : _first(0), _last(0), _chunks(0), _used(0) {
+        for (const_iterator it = other.begin(); it != other.end(); ++it)
+            push_back(*it);
+    }
+
+    ~StableVector() {
+        clear();
+    }
+
+    StableVector &operator=(const StableVector &other) {
+        if (this != &other) {
+            StableVector copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    void swap(StableVector &other) {
+        std::swap(_first, other._first);
+        std::swap(_last, other._last);
+        std::swap(_chunks, other._chunks);
+        std::swap(_used, other._used);
+    }
+
+    size_type size() const {
+        return _chunks > 0 ? chunkStart(_chunks - 1) + _used : 0;
+    }
+
+    bool empty() const {
+        return _chunks == 0;
+    }
+
+    iterator begin() {
+        return iterator(this, _first, 0, 0);
+    }
+
+    const_iterator begin() const {
+        return const_iterator(this, _first, 0, 0);
+    }
+
+    iterator end() {
+        if (_chunks > 0 && _used < chunkSize(_chunks - 1))
+            return iterator(this, _last, _chunks - 1, _used);
+        return iterator(this, 0, _chunks, 0);
+    }
+
+    const_iterator end() const {
+        if (_chunks > 0 && _used < chunkSize(_chunks - 1))
+            return const_iterator(this, _last, _chunks - 1, _used);
+        return const_iterator(this, 0, _chunks, 0);
+    }
+
+    reverse_iterator rbegin() {
+        return reverse_iterator(end());
+    }
+
+    const_reverse_iterator rbegin() const {
+        return const_reverse_iterator(end());
+    }
+
+    reverse_iterator rend() {
+        return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator rend() const {
+        return const_reverse_iterator(begin());
+    }
+
+    reference front() {
+        return *_first->elements();
+    }
+
+    const_reference front() const {
+        return *_first->elements();
+    }
+
+    reference back() {
+        return _last->elements()[_used - 1];
+    }
+
+    const_reference back() const {
+        return _last->elements()[_used - 1];
+    }
+
+    void push_back(const T &value) {
+        if (_chunks == 0 || _used == chunkSize(_chunks - 1)) {
+            // every chunk holds at least one element
+            Chunk *chunk = static_cast<Chunk *>(::operator new(sizeof(Chunk) + chunkSize(_chunks) * sizeof(T)));
+            try {
+                new(chunk->elements()) T(value);
+            } catch (...) {
+                ::operator delete(chunk);
+                throw;
+            }
+            chunk->previous = _last;
+            chunk->next = 0;
+            if (_last)
+                _last->next = chunk;
+            else
+                _first = chunk;
+            _last = chunk;
+            ++_chunks;
+            _used = 1;
+        } else {
+            new(_last->elements() + _used) T(value);
+            ++_used;
+        }
+    }
+
+    void pop_back() {
+        --_used;
+        _last->elements()[_used].~T();
+        if (_used == 0) {
+            Chunk *chunk = _last;
+            _last = chunk->previous;
+            if (_last)
+                _last->next = 0;
+            else
+                _first = 0;
+            ::operator delete(chunk);
+            --_chunks;
+            _used = _chunks > 0 ? chunkSize(_chunks - 1) : 0;
+        }
+    }
+
+    void clear() {
+        while (_chunks > 0)
+            pop_back();
+    }
+
+private:
+    Chunk *_first;
+    Chunk *_last;
+
+    /** number of chunks */
+    size_type _chunks;
+
+    /** number of elements in the last chunk */
+    size_type _used;
+};
+
+/// @}
+
+//---------------------------------------------------------------------------
+#endif
@@ -0,0 +1,169 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2013 Daniel Marjamäki and Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "summarydatabase.h"
+#include "path.h"
+
+#include <cctype>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+/** first line of a saved database, the number is the format version */
+static const char fileHeader[] = "cppcheck-summaries 3";
+
+SummaryDatabase::SummaryDatabase()
+{
+}
+
+std::string SummaryDatabase::serialize(const Record &record)
+{
+    std::string text;
+    for (Record::const_iterator it = record.begin(); it != record.end(); ++it) {
+        for (std::set<std::string>::const_iterator item = it->second.begin(); item != it->second.end(); ++item)
+            text += it->first + '\t' + *item + '\n';
+    }
+    return text;
+}
+
+SummaryDatabase::Record SummaryDatabase::deserialize(const std::string &text)
+{
+    Record record;
+    std::istringstream istr(text);
+    std::string line;
+    while (std::getline(istr, line)) {
+        const std::string::size_type tab = line.find('\t');
+        if (tab != std::string::npos)
+            record[line.substr(0, tab)].insert(line.substr(tab + 1));
+    }
+    return record;
+}
+
+void SummaryDatabase::addRecord(const std::string &filename, const Record &record)
+{
+    MutexLock lock(_mutex);
+    _records[filename] = record;
+    for (Record::const_iterator it = record.begin(); it != record.end(); ++it)
+        _merged[it->first].insert(it->second.begin(), it->second.end());
+}
+
+void SummaryDatabase::keepFiles(const std::set<std::string> &filenames)
+{
+    MutexLock lock(_mutex);
+    for (std::map<std::string, Record>::iterator it = _records.begin(); it != _records.end();) {
+        if (filenames.find(it->first) == filenames.end())
+            _records.erase(it++);
+        else
+            ++it;
+    }
+}
+
+void SummaryDatabase::merge()
+{
+    MutexLock lock(_mutex);
+    _merged.clear();
+    for (std::map<std::string, Record>::const_iterator file = _records.begin(); file != _records.end(); ++file) {
+        for (Record::const_iterator it = file->second.begin(); it != file->second.end(); ++it)
+            _merged[it->first].insert(it->second.begin(), it->second.end());
+    }
+}
+
+const std::set<std::string> &SummaryDatabase::data(const std::string &check) const
+{
+    static const std::set<std::string> empty;
+    const Record::const_iterator it = _merged.find(check);
+    return (it != _merged.end()) ? it->second : empty;
+}
+
+std::string SummaryDatabase::usedData(const std::string &code) const
+{
+    // the names in the code
+    std::set<std::string> names;
+    for (std::string::size_type pos = 0; pos < code.size();) {
+        if (!std::isalpha((unsigned char)code[pos]) && code[pos] != '_') {
+            ++pos;
+            continue;
+        }
+        const std::string::size_type start = pos;
+        while (pos < code.size() && (std::isalnum((unsigned char)code[pos]) || code[pos] == '_'))
+            ++pos;
+        names.insert(code.substr(start, pos - start));
+    }
+
+    Record used;
+    for (Record::const_iterator it = _merged.begin(); it != _merged.end(); ++it) {
+        for (std::set<std::string>::const_iterator name = names.begin(); name != names.end(); ++name) {
+            if (it->second.find(*name) != it->second.end())
+                used[it->first].insert(*name);
+        }
+    }
+    return serialize(used);
+}
+
+std::size_t SummaryDatabase::size() const
+{
+    MutexLock lock(_mutex);
+    return _records.size();
+}
+
+bool SummaryDatabase::load(const std::string &filename)
+{
+    std::ifstream fin(filename.c_str(), std::ios::in | std::ios::binary);
+    std::string line;
+    if (!fin.is_open() || !std::getline(fin, line) || line != fileHeader)
+        return false;
+
+    // "file <name>" followed by the serialized record of the file
+    std::map<std::string, Record> records;
+    Record *record = 0;
+    while (std::getline(fin, line)) {
+        if (line.compare(0, 5, "file ") == 0) {
+            record = &records[line.substr(5)];
+            continue;
+        }
+        const std::string::size_type tab = line.find('\t');
+        if (!record || tab == std::string::npos)
+            return false;
+        (*record)[line.substr(0, tab)].insert(line.substr(tab + 1));
+    }
+
+    MutexLock lock(_mutex);
+    for (std::map<std::string, Record>::const_iterator it = records.begin(); it != records.end(); ++it)
+        _records[it->first] = it->second;
+    return true;
+}
+
+bool SummaryDatabase::save(const std::string &filename) const
+{
+    const std::string tempFile = Path::temporaryFileName(filename);
+    {
+        std::ofstream fout(tempFile.c_str(), std::ios::out | std::ios::binary);
+        if (!fout.is_open())
+            return false;
+
+        fout << fileHeader << '\n';
+        MutexLock lock(_mutex);
+        for (std::map<std::string, Record>::const_iterator it = _records.begin(); it != _records.end(); ++it)
+            fout << "file " << it->first << '\n' << serialize(it->second);
+    }
+    if (std::rename(tempFile.c_str(), filename.c_str()) != 0) {
+        std::remove(tempFile.c_str());
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,114 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2013 Daniel Marjamäki and Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//---------------------------------------------------------------------------
+#ifndef summarydatabaseH
+#define summarydatabaseH
+//---------------------------------------------------------------------------
+
+#include "config.h"
+#include "mutex.h"
+
+#include <map>
+#include <set>
+#include <string>
+
+/// @addtogroup Core
+/// @{
+
+/**
+ * @brief Whole program analysis data, see Check::analyse().
+ *
+ * A file is analysed when it is checked, every file has a record with the
+ * data of each check. The checks read the merged data of the records
+ * through data(). The records can be saved and loaded again, so the checks
+ * can use the data of all files of the previous run.
+ */
+class CPPCHECKLIB SummaryDatabase {
+public:
+    /** @brief Analysis data of one file, key is the check name */
+    typedef std::map<std::string, std::set<std::string> > Record;
+
+    SummaryDatabase();
+
+    /** @brief Text form of a record, one "check<tab>item" line per item */
+    static std::string serialize(const Record &record);
+
+    /** @brief Read a record written by serialize() */
+    static Record deserialize(const std::string &text);
+
+    /**
+     * @brief Set the record of a file, an earlier record of the file is
+     * replaced. The items of the record are added to the merged data at
+     * once, the items of a replaced record stay there until merge().
+     * This can be called from several threads, but not while data() is used.
+     * @param filename the analysed file
+     * @param record the analysis data
+     */
+    void addRecord(const std::string &filename, const Record &record);
+
+    /** @brief Remove the records of the files that are not in the given set */
+    void keepFiles(const std::set<std::string> &filenames);
+
+    /** @brief Merge the records, the result is returned by data() */
+    void merge();
+
+    /** @brief Merged data of a check. This can be called from several threads. */
+    const std::set<std::string> &data(const std::string &check) const;
+
+    /**
+     * @brief The merged items that are names in the given code, in the
+     * form of serialize(). The checks of the code only look up these
+     * items, so their results only depend on them.
+     */
+    std::string usedData(const std::string &code) const;
+
+    /** @brief Number of files that have a record */
+    std::size_t size() const;
+
+    /**
+     * @brief Read the records from a file written by save()
+     * @return false if the file can't be read or it is for another version
+     */
+    bool load(const std::string &filename);
+
+    /**
+     * @brief Write all records to a file. It is written to a temporary file
+     * first which is renamed, so a partial file is never read.
+     */
+    bool save(const std::string &filename) const;
+
+private:
+    // disallow copying
+    SummaryDatabase(const SummaryDatabase &);
+    SummaryDatabase &operator=(const SummaryDatabase &);
+
+    /** protects _records and _merged */
+    mutable Mutex _mutex;
+
+    /** the record of each file, key is the file name */
+    std::map<std::string, Record> _records;
+
+    /** the merged data */
+    Record _merged;
+};
+
+/// @}
+
+//---------------------------------------------------------------------------
+#endif
@@ -25,6 +25,7 @@
 #include "errorlogger.h"
 #include "check.h"
 
+#include <algorithm>
 #include <string>
 #include <sstream>
 #include <climits>
@@ -132,9 +133,7 @@ SymbolDatabase::SymbolDatabase(const Tokenizer *tokenizer, const Settings *setti
                 if (new_scope->isClassOrStruct() || new_scope->type == Scope::eUnion) {
                     Type* new_type = findType(tok->next(), scope);
                     if (!new_type) {
-                        typeList.push_back(Type(new_scope->classDef, new_scope, scope));
-                        new_type = &typeList.back();
-                        scope->definedTypes.push_back(new_type);
+                        new_type = addType(Type(new_scope->classDef, new_scope, scope), scope);
                     } else
                         new_type->classScope = new_scope;
                     new_scope->definedType = new_type;
@@ -162,7 +161,7 @@ SymbolDatabase::SymbolDatabase(const Tokenizer *tokenizer, const Settings *setti
                 }
 
                 // make the new scope the current scope
-                scope->nestedList.push_back(new_scope);
+                addRecordScope(scope, new_scope);
                 scope = new_scope;
 
                 tok = tok2;
@@ -191,7 +190,7 @@ SymbolDatabase::SymbolDatabase(const Tokenizer *tokenizer, const Settings *setti
             }
 
             // make the new scope the current scope
-            scope->nestedList.push_back(new_scope);
+            addRecordScope(scope, new_scope);
             scope = &scopeList.back();
 
             tok = tok2;
@@ -202,8 +201,7 @@ SymbolDatabase::SymbolDatabase(const Tokenizer *tokenizer, const Settings *setti
                  tok->strAt(-1) != "friend") {
             if (!findType(tok->next(), scope)) {
                 // fill typeList..
-                typeList.push_back(Type(tok, 0, scope));
-                scope->definedTypes.push_back(&typeList.back());
+                addType(Type(tok, 0, scope), scope);
             }
             tok = tok->tokAt(2);
         }
@@ -243,9 +241,7 @@ SymbolDatabase::SymbolDatabase(const Tokenizer *tokenizer, const Settings *setti
                 varNameTok = varNameTok->next();
             }
 
-            typeList.push_back(Type(tok, new_scope, scope));
-            new_scope->definedType = &typeList.back();
-            scope->definedTypes.push_back(&typeList.back());
+            new_scope->definedType = addType(Type(tok, new_scope, scope), scope);
 
             scope->addVariable(varNameTok, tok, tok, access[scope], new_scope->definedType, scope);
 
@@ -261,7 +257,7 @@ SymbolDatabase::SymbolDatabase(const Tokenizer *tokenizer, const Settings *setti
             }
 
             // make the new scope the current scope
-            scope->nestedList.push_back(new_scope);
+            addRecordScope(scope, new_scope);
             scope = new_scope;
 
             tok = tok2;
@@ -280,9 +276,7 @@ SymbolDatabase::SymbolDatabase(const Tokenizer *tokenizer, const Settings *setti
             new_scope->classStart = tok2;
             new_scope->classEnd = tok2->link();
 
-            typeList.push_back(Type(tok, new_scope, scope));
-            new_scope->definedType = &typeList.back();
-            scope->definedTypes.push_back(&typeList.back());
+            new_scope->definedType = addType(Type(tok, new_scope, scope), scope);
 
             // make sure we have valid code
             if (!new_scope->classEnd) {
@@ -291,7 +285,7 @@ SymbolDatabase::SymbolDatabase(const Tokenizer *tokenizer, const Settings *setti
             }
 
             // make the new scope the current scope
-            scope->nestedList.push_back(new_scope);
+            addRecordScope(scope, new_scope);
             scope = new_scope;
 
             tok = tok2;
@@ -459,7 +453,7 @@ SymbolDatabase::SymbolDatabase(const Tokenizer *tokenizer, const Settings *setti
                         if (tok->str() != ";")
                             tok = tok->next();
 
-                        scope->functionList.push_back(function);
+                        scope->addFunction(function);
                     }
 
                     // default or delete
@@ -471,7 +465,7 @@ SymbolDatabase::SymbolDatabase(const Tokenizer *tokenizer, const Settings *setti
 
                         tok = end->tokAt(3);
 
-                        scope->functionList.push_back(function);
+                        scope->addFunction(function);
                     }
 
                     // pure virtual function
@@ -483,7 +477,7 @@ SymbolDatabase::SymbolDatabase(const Tokenizer *tokenizer, const Settings *setti
                         else
                             tok = end->tokAt(3);
 
-                        scope->functionList.push_back(function);
+                        scope->addFunction(function);
                     }
 
                     // inline function
@@ -497,9 +491,7 @@ SymbolDatabase::SymbolDatabase(const Tokenizer *tokenizer, const Settings *setti
                         if (!end)
                             continue;
 
-                        scope->functionList.push_back(function);
-
-                        Function* funcptr = &scope->functionList.back();
+                        Function* funcptr = scope->addFunction(function);
                         const Token *tok2 = funcStart;
 
                         addNewFunction(&scope, &tok2);
@@ -606,7 +598,7 @@ SymbolDatabase::SymbolDatabase(const Tokenizer *tokenizer, const Settings *setti
                     // function prototype
                     else if (Token::simpleMatch(argStart->link(), ") ;")) {
                         bool newFunc = true; // Is this function already in the database?
-                        for (std::list<Function>::const_iterator i = scope->functionList.begin(); i != scope->functionList.end(); ++i) {
+                        for (StableVector<Function>::const_iterator i = scope->functionList.begin(); i != scope->functionList.end(); ++i) {
                             if (i->tokenDef->str() == tok->str() && Function::argsMatch(scope, i->argDef->next(), argStart->next(), "", 0)) {
                                 newFunc = false;
                                 break;
@@ -624,7 +616,7 @@ SymbolDatabase::SymbolDatabase(const Tokenizer *tokenizer, const Settings *setti
                     else if (Token::simpleMatch(argStart->link(), ") ) (") &&
                              Token::simpleMatch(argStart->link()->linkAt(2), ") ;")) {
                         bool newFunc = true; // Is this function already in the database?
-                        for (std::list<Function>::const_iterator i = scope->functionList.begin(); i != scope->functionList.end(); ++i) {
+                        for (StableVector<Function>::const_iterator i = scope->functionList.begin(); i != scope->functionList.end(); ++i) {
                             if (i->tokenDef->str() == tok->str() && Function::argsMatch(scope, i->argDef, argStart, "", 0))
                                 newFunc = false;
                         }
@@ -649,7 +641,7 @@ SymbolDatabase::SymbolDatabase(const Tokenizer *tokenizer, const Settings *setti
                         scopeList.push_back(Scope(this, tok, scope, Scope::eTry, tok1));
 
                     tok = tok1;
-                    scope->nestedList.push_back(&scopeList.back());
+                    scope->addNestedScope(&scopeList.back());
                     scope = &scopeList.back();
                 } else if (Token::Match(tok, "if|for|while|catch|switch (") && Token::simpleMatch(tok->next()->link(), ") {")) {
                     const Token *tok1 = tok->next()->link()->next();
@@ -666,7 +658,7 @@ SymbolDatabase::SymbolDatabase(const Tokenizer *tokenizer, const Settings *setti
                     } else if (tok->str() == "switch")
                         scopeList.push_back(Scope(this, tok, scope, Scope::eSwitch, tok1));
 
-                    scope->nestedList.push_back(&scopeList.back());
+                    scope->addNestedScope(&scopeList.back());
                     scope = &scopeList.back();
                     if (scope->type == Scope::eFor)
                         scope->checkVariable(tok->tokAt(2), Local); // check for variable declaration and add it to new scope if found
@@ -676,7 +668,7 @@ SymbolDatabase::SymbolDatabase(const Tokenizer *tokenizer, const Settings *setti
                 } else if (tok->str() == "{") {
                     if (!Token::Match(tok->previous(), "=|,")) {
                         scopeList.push_back(Scope(this, tok, scope, Scope::eUnconditional, tok));
-                        scope->nestedList.push_back(&scopeList.back());
+                        scope->addNestedScope(&scopeList.back());
                         scope = &scopeList.back();
                     } else {
                         tok = tok->link();
@@ -686,22 +678,26 @@ SymbolDatabase::SymbolDatabase(const Tokenizer *tokenizer, const Settings *setti
         }
     }
 
+    // index scopes by name
+    for (StableVector<Scope>::const_iterator it = scopeList.begin(); it != scopeList.end(); ++it)
+        _scopesByName.insert(std::make_pair(it->className, &*it));
+
     // fill in base class info
-    for (std::list<Type>::iterator it = typeList.begin(); it != typeList.end(); ++it) {
+    for (StableVector<Type>::iterator it = typeList.begin(); it != typeList.end(); ++it) {
         // finish filling in base class info
         for (unsigned int i = 0; i < it->derivedFrom.size(); ++i)
             it->derivedFrom[i].type = findType(it->derivedFrom[i].nameTok, it->enclosingScope);
     }
 
     // fill in friend info
-    for (std::list<Type>::iterator it = typeList.begin(); it != typeList.end(); ++it) {
+    for (StableVector<Type>::iterator it = typeList.begin(); it != typeList.end(); ++it) {
         for (std::list<Type::FriendInfo>::iterator i = it->friendList.begin(); i != it->friendList.end(); ++i) {
             i->type = findType(i->nameStart, it->enclosingScope);
         }
     }
 
     // fill in using info
-    for (std::list<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
+    for (StableVector<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
         for (std::list<Scope::UsingInfo>::iterator i = it->usingList.begin(); i != it->usingList.end(); ++i) {
             // check scope for match
             scope = findScope(i->start->tokAt(2), &(*it));
@@ -714,14 +710,14 @@ SymbolDatabase::SymbolDatabase(const Tokenizer *tokenizer, const Settings *setti
     }
 
     // fill in variable info
-    for (std::list<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
+    for (StableVector<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
         // find variables
         it->getVariableList();
     }
 
     // fill in function arguments
-    for (std::list<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
-        std::list<Function>::iterator func;
+    for (StableVector<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
+        StableVector<Function>::iterator func;
 
         for (func = it->functionList.begin(); func != it->functionList.end(); ++func) {
             // add arguments
@@ -730,13 +726,13 @@ SymbolDatabase::SymbolDatabase(const Tokenizer *tokenizer, const Settings *setti
     }
 
     // fill in function scopes
-    for (std::list<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
+    for (StableVector<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
         if (it->type == Scope::eFunction)
             functionScopes.push_back(&*it);
     }
 
     // fill in class and struct scopes
-    for (std::list<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
+    for (StableVector<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
         if (it->isClassOrStruct())
             classAndStructScopes.push_back(&*it);
     }
@@ -748,7 +744,7 @@ SymbolDatabase::SymbolDatabase(const Tokenizer *tokenizer, const Settings *setti
     do {
         unknowns = 0;
 
-        for (std::list<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
+        for (StableVector<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
             scope = &(*it);
 
             if (!scope->definedType) {
@@ -760,7 +756,7 @@ SymbolDatabase::SymbolDatabase(const Tokenizer *tokenizer, const Settings *setti
                 // check for default constructor
                 bool hasDefaultConstructor = false;
 
-                std::list<Function>::const_iterator func;
+                StableVector<Function>::const_iterator func;
 
                 for (func = scope->functionList.begin(); func != scope->functionList.end(); ++func) {
                     if (func->type == Function::eConstructor) {
@@ -789,7 +785,7 @@ SymbolDatabase::SymbolDatabase(const Tokenizer *tokenizer, const Settings *setti
                     bool needInitialization = false;
                     bool unknown = false;
 
-                    std::list<Variable>::const_iterator var;
+                    StableVector<Variable>::const_iterator var;
                     for (var = scope->varlist.begin(); var != scope->varlist.end(); ++var) {
                         if (var->isClass()) {
                             if (var->type()) {
@@ -822,7 +818,7 @@ SymbolDatabase::SymbolDatabase(const Tokenizer *tokenizer, const Settings *setti
 
     // this shouldn't happen so output a debug warning
     if (retry == 100 && _settings->debugwarnings) {
-        for (std::list<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
+        for (StableVector<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
             scope = &(*it);
 
             if (scope->isClassOrStruct() && scope->definedType->needInitialization == Type::Unknown)
@@ -835,11 +831,11 @@ SymbolDatabase::SymbolDatabase(const Tokenizer *tokenizer, const Settings *setti
     std::fill_n(_variableList.begin(), _variableList.size(), (const Variable*)NULL);
 
     // check all scopes for variables
-    for (std::list<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
+    for (StableVector<Scope>::iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
         scope = &(*it);
 
         // add all variables
-        std::list<Variable>::iterator var;
+        StableVector<Variable>::iterator var;
         for (var = scope->varlist.begin(); var != scope->varlist.end(); ++var) {
             unsigned int varId = var->declarationId();
             if (varId)
@@ -853,9 +849,9 @@ SymbolDatabase::SymbolDatabase(const Tokenizer *tokenizer, const Settings *setti
         }
 
         // add all function parameters
-        std::list<Function>::iterator func;
+        StableVector<Function>::iterator func;
         for (func = scope->functionList.begin(); func != scope->functionList.end(); ++func) {
-            std::list<Variable>::iterator arg;
+            StableVector<Variable>::iterator arg;
             for (arg = func->argumentList.begin(); arg != func->argumentList.end(); ++arg) {
                 // check for named parameters
                 if (arg->nameToken() && arg->declarationId()) {
@@ -1221,7 +1217,7 @@ bool Function::argsMatch(const Scope *scope, const Token *first, const Token *se
 Function* SymbolDatabase::addGlobalFunction(Scope*& scope, const Token*& tok, const Token *argStart, const Token* funcStart)
 {
     Function* function = 0;
-    for (std::list<Function>::iterator i = scope->functionList.begin(); i != scope->functionList.end(); ++i) {
+    for (StableVector<Function>::iterator i = scope->functionList.begin(); i != scope->functionList.end(); ++i) {
         if (i->tokenDef->str() == tok->str() && Function::argsMatch(scope, i->argDef->next(), argStart->next(), "", 0))
             function = &*i;
     }
@@ -1274,8 +1270,22 @@ Function* SymbolDatabase::addGlobalFunctionDecl(Scope*& scope, const Token *argS
     function.type = Function::eFunction;
     function.nestedIn = scope;
 
-    scope->functionList.push_back(function);
-    return &scope->functionList.back();
+    return scope->addFunction(function);
+}
+
+void SymbolDatabase::addRecordScope(Scope *scope, Scope *new_scope)
+{
+    scope->addNestedScope(new_scope);
+    _recordScopes[new_scope->className].push_back(std::make_pair(scopeList.size() - 1, new_scope));
+}
+
+Type *SymbolDatabase::addType(const Type &type, Scope *scope)
+{
+    typeList.push_back(type);
+    Type *new_type = &typeList.back();
+    scope->addDefinedType(new_type);
+    _typesByName[new_type->name()].push_back(new_type);
+    return new_type;
 }
 
 void SymbolDatabase::addClassFunction(Scope **scope, const Token **tok, const Token *argStart)
@@ -1311,11 +1321,18 @@ void SymbolDatabase::addClassFunction(Scope **scope, const Token **tok, const To
         path_length++;
     }
 
-    std::list<Scope>::iterator it1;
-
-    // search for match
-    for (it1 = scopeList.begin(); it1 != scopeList.end(); ++it1) {
-        Scope *scope1 = &(*it1);
+    // search for match, in the order of scopeList. The name in tok1 can
+    // change while a scope is checked, the search continues after it.
+    std::size_t position = 0;
+    for (;;) {
+        std::map<std::string, std::vector<std::pair<std::size_t, Scope *> > >::const_iterator records = _recordScopes.find(tok1->str());
+        if (records == _recordScopes.end())
+            break;
+        std::vector<std::pair<std::size_t, Scope *> >::const_iterator it1 = std::lower_bound(records->second.begin(), records->second.end(), std::make_pair(position, static_cast<Scope *>(0)));
+        if (it1 == records->second.end())
+            break;
+        position = it1->first + 1;
+        Scope *scope1 = it1->second;
 
         bool match = false;
         if (scope1->className == tok1->str() && (scope1->type != Scope::eFunction)) {
@@ -1356,7 +1373,7 @@ void SymbolDatabase::addClassFunction(Scope **scope, const Token **tok, const To
         }
 
         if (match) {
-            std::list<Function>::iterator func;
+            StableVector<Function>::iterator func;
 
             for (func = scope1->functionList.begin(); func != scope1->functionList.end(); ++func) {
                 if (!func->hasBody && func->tokenDef->str() == (*tok)->str()) {
@@ -1427,7 +1444,7 @@ void SymbolDatabase::addNewFunction(Scope **scope, const Token **tok)
             return;
         }
 
-        (*scope)->nestedList.push_back(new_scope);
+        (*scope)->addNestedScope(new_scope);
         *scope = new_scope;
         *tok = tok1;
     } else {
@@ -1546,9 +1563,9 @@ void SymbolDatabase::debugMessage(const Token *tok, const std::string &msg) cons
 const Function* Type::getFunction(const std::string& funcName) const
 {
     if (classScope) {
-        for (std::list<Function>::const_iterator i = classScope->functionList.begin(); i != classScope->functionList.end(); ++i)
-            if (i->name() == funcName)
-                return &*i;
+        std::map<std::string, std::vector<const Function *> >::const_iterator it = classScope->_functionsByName.find(funcName);
+        if (it != classScope->_functionsByName.end())
+            return it->second.front();
     }
 
     for (std::size_t i = 0; i < derivedFrom.size(); i++) {
@@ -1673,7 +1690,7 @@ void SymbolDatabase::printOut(const char *title) const
     if (title)
         std::cout << "\n### " << title << " ###\n";
 
-    for (std::list<Scope>::const_iterator scope = scopeList.begin(); scope != scopeList.end(); ++scope) {
+    for (StableVector<Scope>::const_iterator scope = scopeList.begin(); scope != scopeList.end(); ++scope) {
         std::cout << "Scope: " << &*scope << std::endl;
         std::cout << "    type: " << scope->type << std::endl;
         std::cout << "    className: " << scope->className << std::endl;
@@ -1695,7 +1712,7 @@ void SymbolDatabase::printOut(const char *title) const
         else
             std::cout << std::endl;
 
-        std::list<Function>::const_iterator func;
+        StableVector<Function>::const_iterator func;
 
         // find the function body if not implemented inline
         for (func = scope->functionList.begin(); func != scope->functionList.end(); ++func) {
@@ -1748,7 +1765,7 @@ void SymbolDatabase::printOut(const char *title) const
             } else
                 std::cout << "Unknown" << std::endl;
 
-            std::list<Variable>::const_iterator var;
+            StableVector<Variable>::const_iterator var;
 
             for (var = func->argumentList.begin(); var != func->argumentList.end(); ++var) {
                 std::cout << "        Variable: " << &*var << std::endl;
@@ -1756,7 +1773,7 @@ void SymbolDatabase::printOut(const char *title) const
             }
         }
 
-        std::list<Variable>::const_iterator var;
+        StableVector<Variable>::const_iterator var;
 
         for (var = scope->varlist.begin(); var != scope->varlist.end(); ++var) {
             std::cout << "    Variable: " << &*var << std::endl;
@@ -1774,7 +1791,7 @@ void SymbolDatabase::printOut(const char *title) const
 
         std::cout << "    nestedList[" << scope->nestedList.size() << "] = (";
 
-        std::list<Scope *>::const_iterator nsi;
+        std::vector<Scope *>::const_iterator nsi;
 
         std::size_t count = scope->nestedList.size();
         for (nsi = scope->nestedList.begin(); nsi != scope->nestedList.end(); ++nsi) {
@@ -1813,7 +1830,7 @@ void SymbolDatabase::printOut(const char *title) const
         std::cout << std::endl;
     }
 
-    for (std::list<Type>::const_iterator type = typeList.begin(); type != typeList.end(); ++type) {
+    for (StableVector<Type>::const_iterator type = typeList.begin(); type != typeList.end(); ++type) {
         std::cout << "Type: " << &(*type) << std::endl;
         std::cout << "    name: " << type->name() << std::endl;
         std::cout << "    classDef: " << _tokenizer->list.fileLine(type->classDef) << std::endl;
@@ -2001,7 +2018,7 @@ bool Function::isImplicitlyVirtual_rec(const ::Type* baseType, bool& safe) const
         if (baseType->derivedFrom[i].type && baseType->derivedFrom[i].type->classScope) {
             const Scope *parent = baseType->derivedFrom[i].type->classScope;
 
-            std::list<Function>::const_iterator func;
+            StableVector<Function>::const_iterator func;
 
             // check if function defined in base class
             for (func = parent->functionList.begin(); func != parent->functionList.end(); ++func) {
@@ -2042,7 +2059,7 @@ bool Function::isImplicitlyVirtual_rec(const ::Type* baseType, bool& safe) const
 
 const Variable* Function::getArgumentVar(unsigned int num) const
 {
-    for (std::list<Variable>::const_iterator i = argumentList.begin(); i != argumentList.end(); ++i) {
+    for (StableVector<Variable>::const_iterator i = argumentList.begin(); i != argumentList.end(); ++i) {
         if (i->index() == num)
             return (&*i);
         else if (i->index() > num)
@@ -2111,7 +2128,7 @@ Scope::Scope(const SymbolDatabase *check_, const Token *classDef_, const Scope *
 bool Scope::hasDefaultConstructor() const
 {
     if (numConstructors) {
-        std::list<Function>::const_iterator func;
+        StableVector<Function>::const_iterator func;
 
         for (func = functionList.begin(); func != functionList.end(); ++func) {
             if (func->type == Function::eConstructor && func->argCount() == 0)
@@ -2332,7 +2349,7 @@ const Token *Scope::checkVariable(const Token *tok, AccessControl varaccess)
 
 const Variable *Scope::getVariable(const std::string &varname) const
 {
-    std::list<Variable>::const_iterator iter;
+    StableVector<Variable>::const_iterator iter;
 
     for (iter = varlist.begin(); iter != varlist.end(); ++iter) {
         if (iter->name() == varname)
@@ -2418,35 +2435,34 @@ bool Scope::isVariableDeclaration(const Token* tok, const Token*& vartok, const
 
 const Type* SymbolDatabase::findVariableType(const Scope *start, const Token *typeTok) const
 {
-    std::list<Type>::const_iterator type;
-
-    for (type = typeList.begin(); type != typeList.end(); ++type) {
-        // do the names match?
-        if (type->name() == typeTok->str()) {
-            // check if type does not have a namespace
-            if (typeTok->strAt(-1) != "::") {
-                const Scope *parent = start;
-
-                // check if in same namespace
-                while (parent) {
-                    // out of line class function belongs to class
-                    if (parent->type == Scope::eFunction && parent->functionOf)
-                        parent = parent->functionOf;
-                    else if (parent != type->enclosingScope)
-                        parent = parent->nestedIn;
-                    else
-                        break;
-                }
-
-                if (type->enclosingScope == parent)
-                    return &(*type);
+    std::map<std::string, std::vector<const Type *> >::const_iterator types = _typesByName.find(typeTok->str());
+    if (types == _typesByName.end())
+        return NULL;
+
+    for (std::vector<const Type *>::const_iterator type = types->second.begin(); type != types->second.end(); ++type) {
+        // check if type does not have a namespace
+        if (typeTok->strAt(-1) != "::") {
+            const Scope *parent = start;
+
+            // check if in same namespace
+            while (parent) {
+                // out of line class function belongs to class
+                if (parent->type == Scope::eFunction && parent->functionOf)
+                    parent = parent->functionOf;
+                else if (parent != (*type)->enclosingScope)
+                    parent = parent->nestedIn;
+                else
+                    break;
             }
 
-            // type has a namespace
-            else {
-                // FIXME check if namespace path matches supplied path
-                return &(*type);
-            }
+            if ((*type)->enclosingScope == parent)
+                return *type;
+        }
+
+        // type has a namespace
+        else {
+            // FIXME check if namespace path matches supplied path
+            return *type;
         }
     }
 
@@ -2461,24 +2477,26 @@ const Type* SymbolDatabase::findVariableType(const Scope *start, const Token *ty
  */
 const Function* Scope::findFunction(const Token *tok) const
 {
-    for (std::list<Function>::const_iterator i = functionList.begin(); i != functionList.end(); ++i) {
-        if (i->tokenDef->str() == tok->str()) {
-            const Function *func = &*i;
-            if (tok->strAt(1) == "(" && tok->tokAt(2)) {
-                // check the arguments
-                unsigned int args = 0;
-                const Token *arg = tok->tokAt(2);
-                while (arg && arg->str() != ")") {
-                    /** @todo check argument type for match */
-                    args++;
-                    arg = arg->nextArgument();
-                }
-
-                // check for argument count match or default arguments
-                if (args == func->argCount() ||
-                    (args < func->argCount() && args >= func->minArgCount()))
-                    return func;
+    std::map<std::string, std::vector<const Function *> >::const_iterator overloads = _functionsByName.find(tok->str());
+    if (overloads == _functionsByName.end())
+        return 0;
+
+    for (std::vector<const Function *>::const_iterator i = overloads->second.begin(); i != overloads->second.end(); ++i) {
+        const Function *func = *i;
+        if (tok->strAt(1) == "(" && tok->tokAt(2)) {
+            // check the arguments
+            unsigned int args = 0;
+            const Token *arg = tok->tokAt(2);
+            while (arg && arg->str() != ")") {
+                /** @todo check argument type for match */
+                args++;
+                arg = arg->nextArgument();
             }
+
+            // check for argument count match or default arguments
+            if (args == func->argCount() ||
+                (args < func->argCount() && args >= func->minArgCount()))
+                return func;
         }
     }
 
@@ -2572,63 +2590,43 @@ const Function* SymbolDatabase::findFunction(const Token *tok) const
 
 const Scope *SymbolDatabase::findScopeByName(const std::string& name) const
 {
-    for (std::list<Scope>::const_iterator it = scopeList.begin(); it != scopeList.end(); ++it) {
-        if (it->className == name)
-            return &*it;
-    }
-    return 0;
+    std::map<std::string, const Scope *>::const_iterator it = _scopesByName.find(name);
+    return (it != _scopesByName.end()) ? it->second : 0;
 }
 
 //---------------------------------------------------------------------------
 
 Scope *Scope::findInNestedList(const std::string & name)
 {
-    std::list<Scope *>::iterator it;
-
-    for (it = nestedList.begin(); it != nestedList.end(); ++it) {
-        if ((*it)->className == name)
-            return (*it);
-    }
-    return 0;
+    std::map<std::string, Scope *>::const_iterator it = _nestedByName.find(name);
+    return (it != _nestedByName.end()) ? it->second : 0;
 }
 
 //---------------------------------------------------------------------------
 
 const Scope *Scope::findRecordInNestedList(const std::string & name) const
 {
-    std::list<Scope *>::const_iterator it;
-
-    for (it = nestedList.begin(); it != nestedList.end(); ++it) {
-        if ((*it)->className == name && (*it)->type != eFunction)
-            return (*it);
-    }
-    return 0;
+    std::map<std::string, Scope *>::const_iterator it = _recordsByName.find(name);
+    return (it != _recordsByName.end()) ? it->second : 0;
 }
 
 //---------------------------------------------------------------------------
 
 const Type* Scope::findType(const std::string & name) const
 {
-    std::list<Type*>::const_iterator it;
-
-    for (it = definedTypes.begin(); it != definedTypes.end(); ++it) {
-        if ((*it)->name() == name)
-            return (*it);
-    }
-    return 0;
+    std::map<std::string, Type *>::const_iterator it = _typesByName.find(name);
+    return (it != _typesByName.end()) ? it->second : 0;
 }
 
 //---------------------------------------------------------------------------
 
 Scope *Scope::findInNestedListRecursive(const std::string & name)
 {
-    std::list<Scope *>::iterator it;
-
-    for (it = nestedList.begin(); it != nestedList.end(); ++it) {
-        if ((*it)->className == name)
-            return (*it);
-    }
+    Scope *scope = findInNestedList(name);
+    if (scope)
+        return scope;
 
+    std::vector<Scope *>::iterator it;
     for (it = nestedList.begin(); it != nestedList.end(); ++it) {
         Scope *child = (*it)->findInNestedListRecursive(name);
         if (child)
@@ -2639,9 +2637,37 @@ Scope *Scope::findInNestedListRecursive(const std::string & name)
 
 //---------------------------------------------------------------------------
 
+Function *Scope::addFunction(const Function &func)
+{
+    functionList.push_back(func);
+    Function *newFunction = &functionList.back();
+    _functionsByName[newFunction->name()].push_back(newFunction);
+    return newFunction;
+}
+
+//---------------------------------------------------------------------------
+
+void Scope::addNestedScope(Scope *scope)
+{
+    nestedList.push_back(scope);
+    _nestedByName.insert(std::make_pair(scope->className, scope));
+    if (scope->type != eFunction)
+        _recordsByName.insert(std::make_pair(scope->className, scope));
+}
+
+//---------------------------------------------------------------------------
+
+void Scope::addDefinedType(Type *type_)
+{
+    definedTypes.push_back(type_);
+    _typesByName.insert(std::make_pair(type_->name(), type_));
+}
+
+//---------------------------------------------------------------------------
+
 const Function *Scope::getDestructor() const
 {
-    std::list<Function>::const_iterator it;
+    StableVector<Function>::const_iterator it;
     for (it = functionList.begin(); it != functionList.end(); ++it) {
         if (it->type == Function::eDestructor)
             return &(*it);
@@ -2654,7 +2680,7 @@ const Function *Scope::getDestructor() const
 unsigned int Scope::getNestedNonFunctions() const
 {
     unsigned int nested = 0;
-    std::list<Scope *>::const_iterator ni;
+    std::vector<Scope *>::const_iterator ni;
     for (ni = nestedList.begin(); ni != nestedList.end(); ++ni) {
         if ((*ni)->type != Scope::eFunction)
             nested++;
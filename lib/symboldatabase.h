@@ -23,12 +23,14 @@
 
 #include <string>
 #include <list>
+#include <map>
 #include <vector>
 #include <set>
 
 #include "config.h"
 #include "token.h"
 #include "mathlib.h"
+#include "stablevector.h"
 
 class Tokenizer;
 class Settings;
@@ -505,7 +507,7 @@ public:
     const Token *retDef;
     const Scope *functionScope; // scope of function body
     const Scope* nestedIn; // Scope the function is declared in
-    std::list<Variable> argumentList; // argument list
+    StableVector<Variable> argumentList; // argument list
     unsigned int initArgCount; // number of args with default values
     Type type;             // constructor, destructor, ...
     AccessControl access;  // public/protected/private
@@ -532,6 +534,9 @@ class CPPCHECKLIB Scope {
     // let tests access private function for testing
     friend class TestSymbolDatabase;
 
+    // Type::getFunction() uses the function index
+    friend class Type;
+
 public:
     struct UsingInfo {
         const Token *start;
@@ -548,16 +553,16 @@ public:
     const Token *classDef;   // class/struct/union/namespace token
     const Token *classStart; // '{' token
     const Token *classEnd;   // '}' token
-    std::list<Function> functionList;
-    std::list<Variable> varlist;
+    StableVector<Function> functionList;
+    StableVector<Variable> varlist;
     const Scope *nestedIn;
-    std::list<Scope *> nestedList;
+    std::vector<Scope *> nestedList;
     unsigned int numConstructors;
     unsigned int numCopyOrMoveConstructors;
     std::list<UsingInfo> usingList;
     ScopeType type;
     Type* definedType;
-    std::list<Type*> definedTypes;
+    std::vector<Type*> definedTypes;
 
     // function specific fields
     const Scope *functionOf; // scope this function belongs to
@@ -607,6 +612,19 @@ public:
      */
     Scope *findInNestedListRecursive(const std::string & name);
 
+    /**
+     * @brief add a function to functionList
+     * @param func function to add
+     * @return pointer to the added function
+     */
+    Function *addFunction(const Function &func);
+
+    /** @brief add a scope to nestedList */
+    void addNestedScope(Scope *scope);
+
+    /** @brief add a type to definedTypes */
+    void addDefinedType(Type *type_);
+
     void addVariable(const Token *token_, const Token *start_,
                      const Token *end_, AccessControl access_, const Type *type_,
                      const Scope *scope_) {
@@ -656,6 +674,18 @@ private:
      * @return true if tok points to a variable declaration, false otherwise
      */
     bool isVariableDeclaration(const Token* tok, const Token*& vartok, const Token*& typetok) const;
+
+    /** @brief functions by name, the overloads in the order of functionList */
+    std::map<std::string, std::vector<const Function *> > _functionsByName;
+
+    /** @brief first scope of nestedList with each name */
+    std::map<std::string, Scope *> _nestedByName;
+
+    /** @brief first scope of nestedList with each name that is not a function */
+    std::map<std::string, Scope *> _recordsByName;
+
+    /** @brief first type of definedTypes with each name */
+    std::map<std::string, Type *> _typesByName;
 };
 
 class CPPCHECKLIB SymbolDatabase {
@@ -663,7 +693,7 @@ public:
     SymbolDatabase(const Tokenizer *tokenizer, const Settings *settings, ErrorLogger *errorLogger);
 
     /** @brief Information about all namespaces/classes/structrues */
-    std::list<Scope> scopeList;
+    StableVector<Scope> scopeList;
 
     /** @brief Fast access to function scopes */
     std::vector<const Scope *> functionScopes;
@@ -672,7 +702,7 @@ public:
     std::vector<const Scope *> classAndStructScopes;
 
     /** @brief Fast access to types */
-    std::list<Type> typeList;
+    StableVector<Type> typeList;
 
     /**
      * @brief find a variable type if it's a user defined type
@@ -702,10 +732,7 @@ public:
     }
 
     bool isClassOrStruct(const std::string &type) const {
-        for (std::list<Type>::const_iterator i = typeList.begin(); i != typeList.end(); ++i)
-            if (i->name() == type)
-                return true;
-        return false;
+        return _typesByName.find(type) != _typesByName.end();
     }
 
     const Variable *getVariableFromVarId(std::size_t varId) const {
@@ -731,6 +758,10 @@ private:
     // Needed by Borland C++:
     friend class Scope;
 
+    /** @brief add a new class, struct, union or namespace scope (the last one in scopeList) to scope */
+    void addRecordScope(Scope *scope, Scope *new_scope);
+    /** @brief add a type to typeList and to the definedTypes of scope */
+    Type *addType(const Type &type, Scope *scope);
     void addClassFunction(Scope **info, const Token **tok, const Token *argStart);
     Function *addGlobalFunctionDecl(Scope*& scope, const Token *argStart, const Token* funcStart);
     Function *addGlobalFunction(Scope*& scope, const Token*& tok, const Token *argStart, const Token* funcStart);
@@ -746,7 +777,16 @@ private:
     std::vector<const Variable *> _variableList;
 
     /** list for missing types */
-    std::list<Type> _blankTypes;
+    StableVector<Type> _blankTypes;
+
+    /** @brief types by name, in the order of typeList */
+    std::map<std::string, std::vector<const Type *> > _typesByName;
+
+    /** @brief first scope of scopeList with each name */
+    std::map<std::string, const Scope *> _scopesByName;
+
+    /** @brief class, struct, union and namespace scopes by name with their position in scopeList */
+    std::map<std::string, std::vector<std::pair<std::size_t, Scope *> > > _recordScopes;
 };
 
 #endif
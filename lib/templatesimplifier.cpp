@@ -65,6 +65,73 @@ static void printvector(const std::vector<const Token *> &v)
 
 //---------------------------------------------------------------------------
 
+TemplateInstantiations::TemplateInstantiations(const std::list<Token *> &instantiations)
+    : _usagesValid(false)
+{
+    for (std::list<Token *>::const_iterator it = instantiations.begin(); it != instantiations.end(); ++it)
+        add(*it);
+}
+
+void TemplateInstantiations::add(Token *tok)
+{
+    Position position;
+    position.instantiation = _instantiations.insert(_instantiations.end(), tok);
+    position.named = &_named[tok->str()];
+    position.namedPosition = position.named->insert(position.named->end(), position.instantiation);
+    _positions.insert(std::make_pair(tok, position));
+}
+
+void TemplateInstantiations::remove(const Token *tok)
+{
+    std::multimap<const Token *, Position>::iterator it = _positions.lower_bound(tok);
+    while (it != _positions.end() && it->first == tok) {
+        it->second.named->erase(it->second.namedPosition);
+        _instantiations.erase(it->second.instantiation);
+        _positions.erase(it++);
+    }
+}
+
+bool TemplateInstantiations::usagesFrom(Token *front, const Token *tok, std::vector<Token *> &usages)
+{
+    if (!_usagesValid) {
+        _usagesValid = true;
+        addUsages(front);
+    }
+
+    const std::map<const Token *, std::pair<std::list<Token *> *, std::list<Token *>::iterator> >::const_iterator it = _usagePositions.find(tok);
+    if (it == _usagePositions.end())
+        return false;
+    usages.insert(usages.end(), it->second.second, it->second.first->end());
+    return true;
+}
+
+void TemplateInstantiations::addUsages(Token *tok)
+{
+    if (!_usagesValid)
+        return;
+    for (; tok; tok = tok->next()) {
+        if (Token::Match(tok, "%var% <"))
+            addUsage(tok);
+    }
+}
+
+void TemplateInstantiations::addUsage(Token *tok)
+{
+    std::list<Token *> *usages = &_usages[tok->str()];
+    _usagePositions[tok] = std::make_pair(usages, usages->insert(usages->end(), tok));
+}
+
+void TemplateInstantiations::removeUsage(const Token *tok)
+{
+    const std::map<const Token *, std::pair<std::list<Token *> *, std::list<Token *>::iterator> >::iterator it = _usagePositions.find(tok);
+    if (it != _usagePositions.end()) {
+        it->second.first->erase(it->second.second);
+        _usagePositions.erase(it);
+    }
+}
+
+//---------------------------------------------------------------------------
+
 void TemplateSimplifier::cleanupAfterSimplify(Token *tokens)
 {
     bool goback = false;
@@ -573,7 +640,7 @@ void TemplateSimplifier::useDefaultArgumentValues(const std::list<Token *> &temp
 
 bool TemplateSimplifier::instantiateMatch(const Token *instance, const std::string &name, std::size_t numberOfArguments, const char patternAfter[])
 {
-    if (!Token::simpleMatch(instance, (name + " <").c_str()))
+    if (!instance || instance->str() != name || !Token::simpleMatch(instance->next(), "<"))
         return false;
 
     if (numberOfArguments != TemplateSimplifier::templateParameters(instance->next()))
@@ -626,8 +693,10 @@ void TemplateSimplifier::expandTemplate(
     std::vector<const Token *> &typeParametersInDeclaration,
     const std::string &newName,
     std::vector<const Token *> &typesUsedInTemplateInstantiation,
-    std::list<Token *> &templateInstantiations)
+    TemplateInstantiations &templateInstantiations)
 {
+    Token * const last = tokenlist.back();
+
     for (const Token *tok3 = tokenlist.front(); tok3; tok3 = tok3->next()) {
         if (tok3->str() == "{" || tok3->str() == "(" || tok3->str() == "[")
             tok3 = tok3->link();
@@ -690,7 +759,7 @@ void TemplateSimplifier::expandTemplate(
             if (Token::Match(tok3, "%type% <")) {
                 //if (!Token::simpleMatch(tok3, (name + " <").c_str()))
                 //done = false;
-                templateInstantiations.push_back(tokenlist.back());
+                templateInstantiations.add(tokenlist.back());
             }
 
             // link() newly tokens manually
@@ -726,6 +795,8 @@ void TemplateSimplifier::expandTemplate(
 
         assert(brackets.empty());
     }
+
+    templateInstantiations.addUsages(last->next());
 }
 
 static bool isLowerThanOr(const Token* lower)
@@ -757,6 +828,16 @@ static bool isLowerEqualThanMulDiv(const Token* lower)
     return isLowerThanMulDiv(lower) || Token::Match(lower, "[*/%]");
 }
 
+// Replace tok1 with "tok1 op tok2". Integers are calculated on the parsed
+// values, floating point calculations depend on the spelling of the operands
+// so they are done on the strings.
+static void calculate(Token *tok1, const Token *tok2, char op)
+{
+    if (tok1->number().isInt() && tok2->number().isInt())
+        tok1->number(MathLib::calculate(tok1->number(), tok2->number(), op));
+    else
+        tok1->str(MathLib::calculate(tok1->str(), tok2->str(), op));
+}
 
 bool TemplateSimplifier::simplifyNumericCalculations(Token *tok)
 {
@@ -765,7 +846,7 @@ bool TemplateSimplifier::simplifyNumericCalculations(Token *tok)
     while (tok->tokAt(4) && tok->next()->isNumber() && tok->tokAt(3)->isNumber()) { // %any% %num% %any% %num% %any%
         const Token* op = tok->tokAt(2);
         const Token* after = tok->tokAt(4);
-        if (Token::Match(tok, "* %num% /") && (tok->strAt(3) != "0") && tok->next()->str() == MathLib::multiply(tok->strAt(3), MathLib::divide(tok->next()->str(), tok->strAt(3)))) {
+        if (Token::Match(tok, "* %num% /") && (tok->strAt(3) != "0") && tok->next()->str() == MathLib::multiply(tok->tokAt(3)->number(), MathLib::divide(tok->next()->number(), tok->tokAt(3)->number())).str()) {
             // Division where result is a whole number
         } else if (!((op->str() == "*" && (isLowerThanMulDiv(tok) || tok->str() == "*") && isLowerEqualThanMulDiv(after)) || // associative
                      (Token::Match(op, "[/%]") && isLowerThanMulDiv(tok) && isLowerEqualThanMulDiv(after)) || // NOT associative
@@ -785,33 +866,35 @@ bool TemplateSimplifier::simplifyNumericCalculations(Token *tok)
         // Integer operations
         if (Token::Match(op, ">>|<<|&|^|%or%")) {
             const char cop = op->str()[0];
-            const MathLib::bigint leftInt(MathLib::toLongNumber(tok->str()));
-            const MathLib::bigint rightInt(MathLib::toLongNumber(tok->strAt(2)));
-            std::string result;
+            const MathLib::bigint leftInt(tok->number().getInt());
+            const MathLib::bigint rightInt(tok->tokAt(2)->number().getInt());
+            bool calculated = true;
+            MathLib::Value result;
 
             if (cop == '&' || cop == '|' || cop == '^')
-                result = MathLib::calculate(tok->str(), tok->strAt(2), cop);
-            else if (cop == '<') {
-                if (tok->previous()->str() != "<<" && rightInt > 0) // Ensure that its not a shift operator as used for streams
-                    result = MathLib::longToString(leftInt << rightInt);
-            } else if (rightInt > 0)
-                result = MathLib::longToString(leftInt >> rightInt);
-
-            if (!result.empty()) {
+                result = MathLib::calculate(tok->number(), tok->tokAt(2)->number(), cop);
+            else if (cop == '<' && tok->previous()->str() != "<<" && rightInt > 0) // Ensure that its not a shift operator as used for streams
+                result = MathLib::Value(leftInt << rightInt);
+            else if (cop == '>' && rightInt > 0)
+                result = MathLib::Value(leftInt >> rightInt);
+            else
+                calculated = false;
+
+            if (calculated) {
                 ret = true;
-                tok->str(result);
+                tok->number(result);
                 tok->deleteNext(2);
                 continue;
             }
         }
 
         else if (Token::Match(tok->previous(), "- %num% - %num%"))
-            tok->str(MathLib::add(tok->str(), tok->strAt(2)));
+            calculate(tok, tok->tokAt(2), '+');
         else if (Token::Match(tok->previous(), "- %num% + %num%"))
-            tok->str(MathLib::subtract(tok->str(), tok->strAt(2)));
+            calculate(tok, tok->tokAt(2), '-');
         else {
             try {
-                tok->str(MathLib::calculate(tok->str(), tok->strAt(2), op->str()[0]));
+                calculate(tok, tok->tokAt(2), op->str()[0]);
             } catch (InternalError &e) {
                 e.token = tok;
                 throw;
@@ -827,10 +910,10 @@ bool TemplateSimplifier::simplifyNumericCalculations(Token *tok)
 
 // TODO: This is not the correct class for simplifyCalculations(), so it
 // should be moved away.
-bool TemplateSimplifier::simplifyCalculations(Token *_tokens)
+bool TemplateSimplifier::simplifyCalculations(Token *_tokens, const Token *endToken)
 {
     bool ret = false;
-    for (Token *tok = _tokens; tok; tok = tok->next()) {
+    for (Token *tok = _tokens; tok && tok != endToken; tok = tok->next()) {
         // Remove parentheses around variable..
         // keep parentheses here: dynamic_cast<Fred *>(p);
         // keep parentheses here: A operator * (int);
@@ -858,7 +941,7 @@ bool TemplateSimplifier::simplifyCalculations(Token *_tokens)
         }
 
         if (Token::Match(tok->previous(), "(|&&|%oror% %char% %comp% %num% &&|%oror%|)")) {
-            tok->str(MathLib::longToString(tok->str()[1] & 0xff));
+            tok->number(MathLib::Value(MathLib::bigint(tok->str()[1] & 0xff)));
         }
 
         if (tok->isNumber()) {
@@ -972,12 +1055,12 @@ bool TemplateSimplifier::simplifyCalculations(Token *_tokens)
             }
 
             if (Token::Match(tok, "%num% %comp% %num%") &&
-                MathLib::isInt(tok->str()) &&
-                MathLib::isInt(tok->strAt(2))) {
+                tok->number().isInt() &&
+                tok->tokAt(2)->number().isInt()) {
                 if (Token::Match(tok->previous(), "(|&&|%oror%") && Token::Match(tok->tokAt(3), ")|&&|%oror%|?")) {
-                    const MathLib::bigint op1(MathLib::toLongNumber(tok->str()));
+                    const MathLib::bigint op1(tok->number().getInt());
                     const std::string &cmp(tok->next()->str());
-                    const MathLib::bigint op2(MathLib::toLongNumber(tok->strAt(2)));
+                    const MathLib::bigint op2(tok->tokAt(2)->number().getInt());
 
                     std::string result;
 
@@ -1002,7 +1085,7 @@ bool TemplateSimplifier::simplifyCalculations(Token *_tokens)
         }
         // Division where result is a whole number
         else if (Token::Match(tok->previous(), "* %num% /") &&
-                 tok->str() == MathLib::multiply(tok->strAt(2), MathLib::divide(tok->str(), tok->strAt(2)))) {
+                 tok->str() == MathLib::multiply(tok->tokAt(2)->number(), MathLib::divide(tok->number(), tok->tokAt(2)->number())).str()) {
             tok->deleteNext(2);
         }
 
@@ -1019,7 +1102,7 @@ bool TemplateSimplifier::simplifyTemplateInstantiations(
     ErrorLogger& errorlogger,
     const Settings *_settings,
     const Token *tok,
-    std::list<Token *> &templateInstantiations,
+    TemplateInstantiations &templateInstantiations,
     std::set<std::string> &expandedtemplates)
 {
     // this variable is not used at the moment. The intention was to
@@ -1059,10 +1142,16 @@ bool TemplateSimplifier::simplifyTemplateInstantiations(
 
     bool instantiated = false;
 
-    for (std::list<Token *>::const_iterator iter2 = templateInstantiations.begin(); iter2 != templateInstantiations.end(); ++iter2) {
+    // Only the instantiations with the right name are looked at. The token
+    // list is simplified when the instantiations have been changed, that
+    // is done before the next instantiation of any template is looked at.
+    const std::list<TemplateInstantiations::iterator> &instantiations = templateInstantiations.named(name);
+    std::list<TemplateInstantiations::iterator>::const_iterator iter2;
+    for (iter2 = instantiations.begin(); iter2 != instantiations.end(); ++iter2) {
         if (amountOftemplateInstantiations != templateInstantiations.size()) {
             amountOftemplateInstantiations = templateInstantiations.size();
             simplifyCalculations(tokenlist.front());
+            templateInstantiations.invalidateUsages();
             ++recursiveCount;
             if (recursiveCount > 100) {
                 // bail out..
@@ -1070,12 +1159,12 @@ bool TemplateSimplifier::simplifyTemplateInstantiations(
             }
         }
 
-        Token * const tok2 = *iter2;
+        Token * const tok2 = **iter2;
         if (tok2->str() != name)
             continue;
 
         if (Token::Match(tok2->previous(), "[;{}=]") &&
-            !TemplateSimplifier::instantiateMatch(*iter2, name, typeParametersInDeclaration.size(), isfunc ? "(" : "*| %var%"))
+            !TemplateSimplifier::instantiateMatch(tok2, name, typeParametersInDeclaration.size(), isfunc ? "(" : "*| %var%"))
             continue;
 
         // New type..
@@ -1145,14 +1234,28 @@ bool TemplateSimplifier::simplifyTemplateInstantiations(
         }
 
         // Replace all these template usages..
+        std::vector<Token *> usages;
+        if (!templateInstantiations.usagesFrom(tokenlist.front(), tok2, usages)) {
+            for (Token *tok4 = tok2; tok4; tok4 = tok4->next()) {
+                if (tok4->str() == name)
+                    usages.push_back(tok4);
+            }
+        }
+
+        // usages in the template arguments of a matching usage are skipped
+        std::set<const Token *> skip;
+
         std::list< std::pair<Token *, Token *> > removeTokens;
-        for (Token *tok4 = tok2; tok4; tok4 = tok4->next()) {
-            if (Token::simpleMatch(tok4, templateMatchPattern.c_str())) {
+        for (std::vector<Token *>::const_iterator iter4 = usages.begin(); iter4 != usages.end(); ++iter4) {
+            Token * const tok4 = *iter4;
+            if (skip.find(tok4) == skip.end() && Token::simpleMatch(tok4, templateMatchPattern.c_str())) {
                 Token * tok5 = tok4->tokAt(2);
                 unsigned int typeCountInInstantiation = 1U; // There is always at least one type
                 const Token *typetok = (!typesUsedInTemplateInstantiation.empty()) ? typesUsedInTemplateInstantiation[0] : 0;
                 unsigned int indentlevel5 = 0;  // indentlevel for tok5
                 while (tok5 && (indentlevel5 > 0 || tok5->str() != ">")) {
+                    if (tok5->str() == name)
+                        skip.insert(tok5);
                     if (tok5->str() == "<" && templateParameters(tok5) > 0)
                         ++indentlevel5;
                     else if (indentlevel5 > 0 && Token::Match(tok5, "> [,>]"))
@@ -1178,16 +1281,18 @@ bool TemplateSimplifier::simplifyTemplateInstantiations(
                 // matching template usage => replace tokens..
                 // Foo < int >  =>  Foo<int>
                 if (tok5 && tok5->str() == ">" && typeCountInInstantiation == typesUsedInTemplateInstantiation.size()) {
+                    templateInstantiations.removeUsage(tok4);
                     tok4->str(newName);
                     for (Token *tok6 = tok4->next(); tok6 != tok5; tok6 = tok6->next()) {
-                        if (tok6->isName())
+                        if (tok6->isName()) {
                             templateInstantiations.remove(tok6);
+                            templateInstantiations.removeUsage(tok6);
+                        }
                     }
                     removeTokens.push_back(std::pair<Token*,Token*>(tok4, tok5->next()));
                 }
 
-                tok4 = tok5;
-                if (!tok4)
+                if (!tok5)
                     break;
             }
         }
@@ -1197,6 +1302,14 @@ bool TemplateSimplifier::simplifyTemplateInstantiations(
         }
     }
 
+    // the token list is simplified if there are instantiations of other templates left
+    if (iter2 == instantiations.end() && !instantiations.empty() &&
+        amountOftemplateInstantiations != templateInstantiations.size() &&
+        templateInstantiations.hasNext(instantiations.back())) {
+        simplifyCalculations(tokenlist.front());
+        templateInstantiations.invalidateUsages();
+    }
+
     // Template has been instantiated .. then remove the template declaration
     return instantiated;
 }
@@ -1243,6 +1356,8 @@ void TemplateSimplifier::simplifyTemplates(
     // Template arguments with default values
     TemplateSimplifier::useDefaultArgumentValues(templates, templateInstantiations);
 
+    TemplateInstantiations instantiations(templateInstantiations);
+
     // expand templates
     //bool done = false;
     //while (!done)
@@ -1254,7 +1369,7 @@ void TemplateSimplifier::simplifyTemplates(
                                 errorlogger,
                                 _settings,
                                 *iter1,
-                                templateInstantiations,
+                                instantiations,
                                 expandedtemplates);
             if (instantiated)
                 templates2.push_back(*iter1);
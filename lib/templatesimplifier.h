@@ -24,6 +24,7 @@
 
 #include <set>
 #include <list>
+#include <map>
 #include <string>
 #include <vector>
 #include "config.h"
@@ -37,6 +38,96 @@ class Settings;
 /// @addtogroup Core
 /// @{
 
+/**
+ * @brief Template instantiations, indexed by name.
+ *
+ * The instantiations are kept in the order they were found. The index by
+ * name gives the instantiations of one template without going through the
+ * instantiations of all the other templates.
+ *
+ * All usages of a name ("name <" in the token list) are indexed too, in
+ * token list order. They are used when the instantiations of a template are
+ * replaced with the new name. This index is thrown away when the token list
+ * is simplified and then collected again when it is needed.
+ */
+class CPPCHECKLIB TemplateInstantiations {
+public:
+    typedef std::list<Token *>::iterator iterator;
+
+    explicit TemplateInstantiations(const std::list<Token *> &instantiations);
+
+    /** add an instantiation, tok is the template name */
+    void add(Token *tok);
+
+    /** remove an instantiation. Nothing is done if tok is not an instantiation. */
+    void remove(const Token *tok);
+
+    std::size_t size() const {
+        return _instantiations.size();
+    }
+
+    /**
+     * instantiations with the given name. The list is updated by add()
+     * and remove() so it can be iterated while instantiations are added.
+     */
+    const std::list<iterator> &named(const std::string &name) {
+        return _named[name];
+    }
+
+    /** is there an instantiation after the given one */
+    bool hasNext(iterator it) const {
+        return ++it != _instantiations.end();
+    }
+
+    /**
+     * Get the usages of the name of tok that come after tok, in token list
+     * order. Usages inside template arguments are included.
+     * @param front first token in the token list
+     * @param tok usage, the name of a template followed by "<"
+     * @param usages the usages after tok and tok itself
+     * @return false if tok is not a known usage
+     */
+    bool usagesFrom(Token *front, const Token *tok, std::vector<Token *> &usages);
+
+    /** tokens were added at the end of the token list, tok is the first new token */
+    void addUsages(Token *tok);
+
+    /** a usage is renamed or removed from the token list */
+    void removeUsage(const Token *tok);
+
+    /** the token list has been simplified, the usages must be collected again */
+    void invalidateUsages() {
+        _usages.clear();
+        _usagePositions.clear();
+        _usagesValid = false;
+    }
+
+private:
+    void addUsage(Token *tok);
+
+    /** all instantiations in the order they were found */
+    std::list<Token *> _instantiations;
+
+    /** instantiations by name */
+    std::map<std::string, std::list<iterator> > _named;
+
+    /** position of an instantiation in _instantiations and _named */
+    struct Position {
+        iterator instantiation;
+        std::list<iterator> *named;
+        std::list<iterator>::iterator namedPosition;
+    };
+    std::multimap<const Token *, Position> _positions;
+
+    /** usages by name, in token list order */
+    std::map<std::string, std::list<Token *> > _usages;
+
+    /** position of a usage in _usages */
+    std::map<const Token *, std::pair<std::list<Token *> *, std::list<Token *>::iterator> > _usagePositions;
+
+    bool _usagesValid;
+};
+
 /** @brief Simplify templates from the preprocessed and partially simplified code. */
 class CPPCHECKLIB TemplateSimplifier {
     TemplateSimplifier();
@@ -115,7 +206,7 @@ public:
         std::vector<const Token *> &typeParametersInDeclaration,
         const std::string &newName,
         std::vector<const Token *> &typesUsedInTemplateInstantiation,
-        std::list<Token *> &templateInstantiations);
+        TemplateInstantiations &templateInstantiations);
 
     /**
      * Simplify templates : expand all instantiations for a template
@@ -124,7 +215,7 @@ public:
      * @param errorlogger error logger
      * @param _settings settings
      * @param tok token where the template declaration begins
-     * @param templateInstantiations a list of template usages (not necessarily just for this template)
+     * @param templateInstantiations template usages (not necessarily just for this template)
      * @param expandedtemplates all templates that has been expanded so far. The full names are stored.
      * @return true if the template was instantiated
      */
@@ -133,7 +224,7 @@ public:
         ErrorLogger& errorlogger,
         const Settings *_settings,
         const Token *tok,
-        std::list<Token *> &templateInstantiations,
+        TemplateInstantiations &templateInstantiations,
         std::set<std::string> &expandedtemplates);
 
     /**
@@ -161,10 +252,11 @@ public:
      * Simplify constant calculations such as "1+2" => "3".
      * This also performs simple cleanup of parentheses etc.
      * @param _tokens start token
+     * @param endToken the token after the last token to simplify
      * @return true if modifications to token-list are done.
      *         false if no modifications are done.
      */
-    static bool simplifyCalculations(Token *_tokens);
+    static bool simplifyCalculations(Token *_tokens, const Token *endToken = 0);
 
 private:
 
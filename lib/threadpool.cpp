@@ -0,0 +1,110 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2013 Daniel Marjamäki and Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "threadpool.h"
+#include "mutex.h"
+
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <process.h>
+#else
+#include <pthread.h>
+#endif
+
+namespace {
+    /** The tasks that are shared by the threads of ThreadPool::run() */
+    struct TaskQueue {
+        ThreadPool::Task task;
+        void *data;
+        std::size_t count;
+        std::size_t next;
+        Mutex mutex;
+    };
+}
+
+static void runTasks(TaskQueue *queue)
+{
+    for (;;) {
+        std::size_t index;
+        {
+            MutexLock lock(queue->mutex);
+            if (queue->next >= queue->count)
+                return;
+            index = queue->next++;
+        }
+        queue->task(queue->data, index);
+    }
+}
+
+#ifdef _WIN32
+static unsigned __stdcall threadProc(void *arg)
+{
+    runTasks(static_cast<TaskQueue *>(arg));
+    return 0;
+}
+#else
+static void *threadProc(void *arg)
+{
+    runTasks(static_cast<TaskQueue *>(arg));
+    return NULL;
+}
+#endif
+
+void ThreadPool::run(Task task, void *data, std::size_t count, unsigned int threads)
+{
+    TaskQueue queue;
+    queue.task = task;
+    queue.data = data;
+    queue.count = count;
+    queue.next = 0;
+
+    // The calling thread runs tasks too. If a thread can't be created
+    // the other threads run its tasks.
+    const std::size_t numberOfThreads = (threads < count) ? threads : count;
+#ifdef _WIN32
+    std::vector<HANDLE> handles;
+    for (std::size_t i = 1; i < numberOfThreads; ++i) {
+        const HANDLE handle = (HANDLE)_beginthreadex(NULL, 0, threadProc, &queue, 0, NULL);
+        if (!handle)
+            break;
+        handles.push_back(handle);
+    }
+
+    runTasks(&queue);
+
+    for (std::size_t i = 0; i < handles.size(); ++i) {
+        WaitForSingleObject(handles[i], INFINITE);
+        CloseHandle(handles[i]);
+    }
+#else
+    std::vector<pthread_t> handles;
+    for (std::size_t i = 1; i < numberOfThreads; ++i) {
+        pthread_t handle;
+        if (pthread_create(&handle, NULL, threadProc, &queue) != 0)
+            break;
+        handles.push_back(handle);
+    }
+
+    runTasks(&queue);
+
+    for (std::size_t i = 0; i < handles.size(); ++i)
+        pthread_join(handles[i], NULL);
+#endif
+}
@@ -0,0 +1,55 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2013 Daniel Marjamäki and Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//---------------------------------------------------------------------------
+#ifndef threadpoolH
+#define threadpoolH
+//---------------------------------------------------------------------------
+
+#include "config.h"
+
+#include <cstddef>
+
+/// @addtogroup Core
+/// @{
+
+/**
+ * @brief Run independent tasks on a number of threads.
+ * The platform specific parts are kept in threadpool.cpp.
+ */
+class CPPCHECKLIB ThreadPool {
+public:
+    /** A task, it is called once for each index */
+    typedef void (*Task)(void *data, std::size_t index);
+
+    /**
+     * Call the task for every index from 0 to count-1. The tasks are
+     * started in index order on the given number of threads, the calling
+     * thread is one of them. Returns when all tasks are done.
+     * @param task the task, it must not throw
+     * @param data data that is given to the task
+     * @param count number of tasks
+     * @param threads maximum number of threads
+     */
+    static void run(Task task, void *data, std::size_t count, unsigned int threads);
+};
+
+/// @}
+
+//---------------------------------------------------------------------------
+#endif
@@ -15,58 +15,265 @@
  * You should have received a copy of the GNU General Public License
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
+#include <algorithm>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <map>
+#include <sstream>
 #include "timer.h"
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#if (defined(__GNUC__) || defined(__sun)) && !defined(__MINGW32__)
+#define USE_GETRUSAGE
+#include <sys/resource.h>
+#endif
+
 /*
     TODO:
-    - handle SHOWTIME_TOP5 in TimerResults
-    - sort list by time
-    - do not sort the results alphabetically
     - rename "file" to "single"
-    - synchronise map access in multithreaded mode or disable timing
     - add unit tests
         - for --showtime (needs input file)
-        - for Timer* classes
 */
 
 
-void TimerResults::ShowResults() const
+namespace {
+    /** @brief The registered timer names, see Timer::id() */
+    struct TimerNames {
+        Mutex mutex;
+        std::map<std::string, unsigned int> ids;
+        std::vector<std::string> names;
+    };
+
+    TimerNames &timerNames()
+    {
+        static TimerNames names;
+        return names;
+    }
+
+    /** Timer result together with its id, for sorting */
+    struct TimerResult {
+        unsigned int id;
+        TimerResultsData data;
+
+        bool operator<(const TimerResult &other) const {
+            if (data._wall > other.data._wall)
+                return true;
+            if (data._wall < other.data._wall)
+                return false;
+            return id < other.id;
+        }
+    };
+
+    std::string jsonString(const std::string &str)
+    {
+        std::string ret("\"");
+        for (std::string::size_type i = 0; i < str.size(); ++i) {
+            const unsigned char c = (unsigned char)str[i];
+            if (c == '\"' || c == '\\') {
+                ret += '\\';
+                ret += str[i];
+            } else if (c < 0x20) {
+                static const char hex[] = "0123456789abcdef";
+                ret += "\\u00";
+                ret += hex[c >> 4];
+                ret += hex[c & 15];
+            } else
+                ret += str[i];
+        }
+        return ret + '\"';
+    }
+
+    std::string csvString(const std::string &str)
+    {
+        std::string ret("\"");
+        for (std::string::size_type i = 0; i < str.size(); ++i) {
+            if (str[i] == '\"')
+                ret += '\"';
+            ret += str[i];
+        }
+        return ret + '\"';
+    }
+}
+
+static void addResults(std::vector<TimerResultsData> &results, unsigned int id, double wall, double cpu)
 {
+    if (id >= results.size())
+        results.resize(id + 1U);
+    results[id]._wall += wall;
+    results[id]._cpu += cpu;
+    results[id]._numberOfResults++;
+}
+
+void TimerResultsLocal::AddResults(unsigned int id, double start, double wall, double cpu)
+{
+    addResults(_results, id, wall, cpu);
+    if (_recordEvents) {
+        const Event event = { id, start, wall };
+        _events.push_back(event);
+    }
+}
+
+void TimerResults::ShowResults(unsigned int mode, std::ostream &out) const
+{
+    std::vector<TimerResult> sorted;
     TimerResultsData overallData;
+    {
+        MutexLock lock(_mutex);
+        for (unsigned int id = 0; id < _results.size(); ++id) {
+            if (_results[id]._numberOfResults == 0)
+                continue;
+            TimerResult result;
+            result.id = id;
+            result.data = _results[id];
+            sorted.push_back(result);
+            overallData._wall += result.data._wall;
+            overallData._cpu += result.data._cpu;
+        }
+    }
+    std::sort(sorted.begin(), sorted.end());
+    if (mode == SHOWTIME_TOP5 && sorted.size() > 5U)
+        sorted.resize(5U);
+
+    if (mode == SHOWTIME_JSON) {
+        out << "{\"timers\": [";
+        for (std::vector<TimerResult>::const_iterator it = sorted.begin(); it != sorted.end(); ++it) {
+            out << (it == sorted.begin() ? "\n" : ",\n")
+                << "  {\"name\": " << jsonString(Timer::name(it->id))
+                << ", \"count\": " << it->data._numberOfResults
+                << ", \"wall\": " << it->data._wall
+                << ", \"cpu\": " << it->data._cpu << '}';
+        }
+        out << "\n], \"wall\": " << overallData._wall << ", \"cpu\": " << overallData._cpu << "}" << std::endl;
+        return;
+    }
+
+    if (mode == SHOWTIME_CSV) {
+        out << "name,count,wall,cpu" << std::endl;
+        for (std::vector<TimerResult>::const_iterator it = sorted.begin(); it != sorted.end(); ++it)
+            out << csvString(Timer::name(it->id)) << ',' << it->data._numberOfResults << ',' << it->data._wall << ',' << it->data._cpu << std::endl;
+        return;
+    }
 
-    std::map<std::string, struct TimerResultsData>::const_iterator I = _results.begin();
-    const std::map<std::string, struct TimerResultsData>::const_iterator E = _results.end();
+    for (std::vector<TimerResult>::const_iterator it = sorted.begin(); it != sorted.end(); ++it) {
+        const double sec = it->data._wall;
+        const double secAverage = sec / (double)(it->data._numberOfResults);
+        out << Timer::name(it->id) << ": " << sec << "s (avg. " << secAverage << "s - " << it->data._numberOfResults  << " result(s), cpu " << it->data._cpu << "s)" << std::endl;
+    }
 
-    while (I != E) {
-        const double sec = I->second.seconds();
-        const double secAverage = sec / (double)(I->second._numberOfResults);
-        std::cout << I->first << ": " << sec << "s (avg. " << secAverage << "s - " << I->second._numberOfResults  << " result(s))" << std::endl;
+    out << "Overall time: " << overallData._wall << "s (cpu " << overallData._cpu << "s)" << std::endl;
+}
 
-        overallData._clocks += I->second._clocks;
+void TimerResults::AddResults(unsigned int id, double /*start*/, double wall, double cpu)
+{
+    MutexLock lock(_mutex);
+    addResults(_results, id, wall, cpu);
+}
 
-        ++I;
+void TimerResults::merge(TimerResultsLocal &local)
+{
+    {
+        MutexLock lock(_mutex);
+        if (local._results.size() > _results.size())
+            _results.resize(local._results.size());
+        for (std::size_t id = 0; id < local._results.size(); ++id) {
+            _results[id]._wall += local._results[id]._wall;
+            _results[id]._cpu += local._results[id]._cpu;
+            _results[id]._numberOfResults += local._results[id]._numberOfResults;
+        }
     }
+    local._results.clear();
+}
+
+TimerResultsData TimerResults::result(unsigned int id) const
+{
+    MutexLock lock(_mutex);
+    return id < _results.size() ? _results[id] : TimerResultsData();
+}
+
+unsigned int Timer::id(const std::string &name)
+{
+    TimerNames &names = timerNames();
+    MutexLock lock(names.mutex);
+    const std::map<std::string, unsigned int>::const_iterator it = names.ids.find(name);
+    if (it != names.ids.end())
+        return it->second;
+    const unsigned int newId = (unsigned int)names.names.size();
+    names.ids[name] = newId;
+    names.names.push_back(name);
+    return newId;
+}
 
-    const double secOverall = overallData.seconds();
-    std::cout << "Overall time: " << secOverall << "s" << std::endl;
+std::string Timer::name(unsigned int id)
+{
+    TimerNames &names = timerNames();
+    MutexLock lock(names.mutex);
+    return id < names.names.size() ? names.names[id] : std::string();
+}
+
+#ifdef _WIN32
+
+double Timer::wallTime()
+{
+    LARGE_INTEGER frequency, counter;
+    if (!QueryPerformanceFrequency(&frequency) || !QueryPerformanceCounter(&counter))
+        return (double)std::clock() / CLOCKS_PER_SEC;
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
 }
 
-void TimerResults::AddResults(const std::string& str, std::clock_t clocks)
+double Timer::threadCpuTime()
 {
-    _results[str]._clocks += clocks;
-    _results[str]._numberOfResults++;
+    FILETIME creation, exit, kernel, user;
+    if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user))
+        return (double)std::clock() / CLOCKS_PER_SEC;
+    // 100 ns units
+    const unsigned long long k = ((unsigned long long)kernel.dwHighDateTime << 32) | kernel.dwLowDateTime;
+    const unsigned long long u = ((unsigned long long)user.dwHighDateTime << 32) | user.dwLowDateTime;
+    return (double)(k + u) / 1e7;
 }
 
-Timer::Timer(const std::string& str, unsigned int showtimeMode, TimerResultsIntf* timerResults)
-    : _str(str)
+#else
+
+double Timer::wallTime()
+{
+#if defined(CLOCK_MONOTONIC)
+    struct timespec ts;
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) == 0)
+        return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+#endif
+    return (double)std::clock() / CLOCKS_PER_SEC;
+}
+
+double Timer::threadCpuTime()
+{
+#if defined(CLOCK_THREAD_CPUTIME_ID)
+    struct timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0)
+        return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+#endif
+    return (double)std::clock() / CLOCKS_PER_SEC;
+}
+
+#endif
+
+Timer::Timer(unsigned int id, unsigned int showtimeMode, TimerResultsIntf* timerResults)
+    : _id(id)
     , _timerResults(timerResults)
-    , _start(0)
+    , _startWall(0.0)
+    , _startCpu(0.0)
     , _showtimeMode(showtimeMode)
     , _stopped(false)
 {
-    if (showtimeMode != SHOWTIME_NONE)
-        _start = std::clock();
+    if (showtimeMode != SHOWTIME_NONE) {
+        _startWall = wallTime();
+        _startCpu = threadCpuTime();
+    }
 }
 
 Timer::~Timer()
@@ -77,17 +284,85 @@ Timer::~Timer()
 void Timer::Stop()
 {
     if ((_showtimeMode != SHOWTIME_NONE) && !_stopped) {
-        const std::clock_t end = std::clock();
-        const std::clock_t diff = end - _start;
+        const double wall = wallTime() - _startWall;
+        const double cpu = threadCpuTime() - _startCpu;
 
         if (_showtimeMode == SHOWTIME_FILE) {
-            double sec = (double)diff / CLOCKS_PER_SEC;
-            std::cout << _str << ": " << sec << "s" << std::endl;
-        } else {
-            if (_timerResults)
-                _timerResults->AddResults(_str, diff);
+            // one write, the timers of other threads can stop at the same time
+            std::ostringstream line;
+            line << name(_id) << ": " << wall << "s (cpu " << cpu << "s)\n";
+            std::cout << line.str() << std::flush;
         }
+        if (_timerResults)
+            _timerResults->AddResults(_id, _startWall, wall, cpu);
     }
 
     _stopped = true;
 }
+
+void TraceEvents::add(const std::string &name, const char category[], unsigned int tid, double start, double wall, const std::string &args)
+{
+    // microseconds, the wall clock is the same in all processes
+    std::ostringstream ostr;
+    ostr << std::fixed << std::setprecision(3)
+         << "{\"name\": " << jsonString(name)
+         << ", \"cat\": \"" << category
+         << "\", \"ph\": \"X\", \"pid\": " << _pid
+         << ", \"tid\": " << tid
+         << ", \"ts\": " << start * 1e6
+         << ", \"dur\": " << wall * 1e6
+         << ", \"args\": {\"file\": " << jsonString(_file)
+         << ", \"configuration\": " << jsonString(_cfg);
+    if (!args.empty())
+        ostr << ", " << args;
+    ostr << "}}\n";
+    _events += ostr.str();
+}
+
+void TraceEvents::addTimerEvents(TimerResultsLocal &results, unsigned int tid)
+{
+    std::vector<TimerResultsLocal::Event> events;
+    results.takeEvents(events);
+    for (std::vector<TimerResultsLocal::Event>::const_iterator it = events.begin(); it != events.end(); ++it)
+        add(Timer::name(it->id), "timer", tid, it->start, it->wall);
+}
+
+std::string TraceEvents::take()
+{
+    std::string ret;
+    ret.swap(_events);
+    return ret;
+}
+
+bool TraceEvents::write(const std::string &filename, const std::string &events)
+{
+    std::ofstream fout(filename.c_str());
+    if (!fout.is_open())
+        return false;
+
+    fout << "{\"traceEvents\": [";
+    std::istringstream istr(events);
+    std::string line;
+    bool first = true;
+    while (std::getline(istr, line)) {
+        fout << (first ? "\n" : ",\n") << line;
+        first = false;
+    }
+    fout << "\n], \"displayTimeUnit\": \"ms\"}" << std::endl;
+    return fout.good();
+}
+
+unsigned long TraceEvents::peakMemoryKiB()
+{
+#ifdef USE_GETRUSAGE
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#ifdef __APPLE__
+        return (unsigned long)usage.ru_maxrss / 1024UL; // bytes on Mac OS X
+#else
+        return (unsigned long)usage.ru_maxrss;
+#endif
+    }
+#endif
+    return 0;
+}
@@ -20,65 +20,202 @@
 #define TIMER_H
 
 #include <string>
-#include <map>
-#include <ctime>
+#include <vector>
+#include <ostream>
 #include "config.h"
+#include "mutex.h"
 
 enum {
     SHOWTIME_NONE = 0,
     SHOWTIME_FILE,
     SHOWTIME_SUMMARY,
-    SHOWTIME_TOP5
+    SHOWTIME_TOP5,
+    SHOWTIME_JSON,
+    SHOWTIME_CSV
 };
 
 class CPPCHECKLIB TimerResultsIntf {
 public:
     virtual ~TimerResultsIntf() { }
 
-    virtual void AddResults(const std::string& str, std::clock_t clocks) = 0;
+    /**
+     * Add a measurement of the timer with the given id, see Timer::id().
+     * The start is the Timer::wallTime() when the timer was started.
+     */
+    virtual void AddResults(unsigned int id, double start, double wall, double cpu) = 0;
 };
 
 struct TimerResultsData {
-    std::clock_t _clocks;
+    /** wall clock time in seconds */
+    double _wall;
+
+    /** CPU time of the measuring threads in seconds */
+    double _cpu;
+
     long _numberOfResults;
 
     TimerResultsData()
-        : _clocks(0)
+        : _wall(0.0)
+        , _cpu(0.0)
         , _numberOfResults(0) {
     }
 
     double seconds() const {
-        double ret = (double)((unsigned long)_clocks) / (double)CLOCKS_PER_SEC;
-        return ret;
+        return _wall;
     }
 };
 
+/**
+ * @brief Timer results of one thread. Nothing is locked, the results are
+ * merged into TimerResults when the thread is done.
+ */
+class CPPCHECKLIB TimerResultsLocal : public TimerResultsIntf {
+public:
+    /** @brief One measurement, see recordEvents() */
+    struct Event {
+        unsigned int id;
+        double start;
+        double wall;
+    };
+
+    TimerResultsLocal() : _recordEvents(false) {
+    }
+
+    virtual void AddResults(unsigned int id, double start, double wall, double cpu);
+
+    /** @brief Keep every measurement too, not only the sums (--profile-out) */
+    void recordEvents(bool record) {
+        _recordEvents = record;
+    }
+
+    /** @brief Move the recorded measurements to the given vector */
+    void takeEvents(std::vector<Event> &events) {
+        events.clear();
+        events.swap(_events);
+    }
+
+private:
+    friend class TimerResults;
+
+    /** the index is the timer id */
+    std::vector<TimerResultsData> _results;
+
+    bool _recordEvents;
+    std::vector<Event> _events;
+};
+
 class CPPCHECKLIB TimerResults : public TimerResultsIntf {
 public:
     TimerResults() {
     }
 
-    void ShowResults() const;
-    virtual void AddResults(const std::string& str, std::clock_t clocks);
+    /**
+     * @brief Write the results sorted by the wall clock time. SHOWTIME_TOP5
+     * only writes the five slowest timers, SHOWTIME_JSON and SHOWTIME_CSV
+     * write all of them for other programs.
+     */
+    void ShowResults(unsigned int mode, std::ostream &out) const;
+    virtual void AddResults(unsigned int id, double start, double wall, double cpu);
+
+    /** @brief Add the results of a thread and clear them. The recorded events are kept. */
+    void merge(TimerResultsLocal &local);
+
+    /** @brief Results of a timer */
+    TimerResultsData result(unsigned int id) const;
 
 private:
-    std::map<std::string, struct TimerResultsData> _results;
+    /** the index is the timer id */
+    std::vector<TimerResultsData> _results;
+
+    /** The checks of a file can add results from many threads */
+    mutable Mutex _mutex;
 };
 
+/**
+ * @brief Measure the wall clock time and the CPU time of the current
+ * thread until the timer is stopped or destroyed.
+ */
 class CPPCHECKLIB Timer {
 public:
-    Timer(const std::string& str, unsigned int showtimeMode, TimerResultsIntf* timerResults = NULL);
+    Timer(unsigned int id, unsigned int showtimeMode, TimerResultsIntf* timerResults = NULL);
     ~Timer();
     void Stop();
 
+    /**
+     * @brief Id of a timer name. A new name is registered, the ids of
+     * names that are used often should be looked up once.
+     */
+    static unsigned int id(const std::string &name);
+
+    /** @brief Name of a timer id */
+    static std::string name(unsigned int id);
+
+    /** @brief Monotonic wall clock in seconds */
+    static double wallTime();
+
+    /** @brief CPU time of the current thread in seconds */
+    static double threadCpuTime();
+
 private:
     Timer& operator=(const Timer&); // disallow assignments
 
-    const std::string _str;
+    const unsigned int _id;
     TimerResultsIntf* _timerResults;
-    std::clock_t _start;
+    double _startWall;
+    double _startCpu;
     const unsigned int _showtimeMode;
     bool _stopped;
 };
 
+/**
+ * @brief Hotspot profile (--profile-out). The events are written in the
+ * trace event format of Chrome, chrome://tracing and Perfetto show them.
+ * Each event has the file and the configuration as arguments.
+ */
+class CPPCHECKLIB TraceEvents {
+public:
+    TraceEvents() : _pid(0) {
+    }
+
+    /** @brief Process of the following events, each -j worker has its own */
+    void setPid(unsigned int pid) {
+        _pid = pid;
+    }
+
+    /** @brief File and configuration of the following events */
+    void setFile(const std::string &file, const std::string &cfg) {
+        _file = file;
+        _cfg = cfg;
+    }
+
+    /**
+     * @brief Add a complete event
+     * @param name name of the event
+     * @param category category of the event
+     * @param tid thread of the event
+     * @param start Timer::wallTime() at the start
+     * @param wall duration in seconds
+     * @param args more arguments in JSON, for example "\"tokens\": 10"
+     */
+    void add(const std::string &name, const char category[], unsigned int tid, double start, double wall, const std::string &args = std::string());
+
+    /** @brief Add the recorded measurements of a thread, see TimerResultsLocal::recordEvents() */
+    void addTimerEvents(TimerResultsLocal &results, unsigned int tid);
+
+    /** @brief Take the events, one event on each line */
+    std::string take();
+
+    /** @brief Write the events from take() as a trace file */
+    static bool write(const std::string &filename, const std::string &events);
+
+    /** @brief Peak memory usage of the process in KiB, 0 if it is not known */
+    static unsigned long peakMemoryKiB();
+
+private:
+    unsigned int _pid;
+    std::string _file;
+    std::string _cfg;
+    std::string _events;
+};
+
 #endif // TIMER_H
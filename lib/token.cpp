@@ -19,6 +19,8 @@
 #include "token.h"
 #include "errorlogger.h"
 #include "check.h"
+#include "tokenlist.h"
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
 #include <cstring>
@@ -27,6 +29,9 @@
 #include <cctype>
 #include <sstream>
 #include <map>
+#include <new>
+
+static const std::string emptyString;
 
 Token::Token(Token **t) :
     tokensBack(t),
@@ -35,11 +40,14 @@ Token::Token(Token **t) :
     _link(0),
     _scope(0),
     _function(0), // Initialize whole union
-    _str(""),
+    _arena(0),
+    _str(&emptyString),
+    _strId(idNone),
     _varId(0),
     _fileIndex(0),
     _linenr(0),
     _progressValue(0),
+    _number(),
     _type(eNone),
     _isUnsigned(false),
     _isSigned(false),
@@ -48,6 +56,37 @@ Token::Token(Token **t) :
     _isUnused(false),
     _isStandardType(false),
     _isExpandedMacro(false),
+    _isChanged(false),
+    _astOperand1(NULL),
+    _astOperand2(NULL),
+    _astParent(NULL)
+{
+}
+
+Token::Token(Token **t, TokenArena *arena) :
+    tokensBack(t),
+    _next(0),
+    _previous(0),
+    _link(0),
+    _scope(0),
+    _function(0), // Initialize whole union
+    _arena(arena),
+    _str(&emptyString),
+    _strId(idNone),
+    _varId(0),
+    _fileIndex(0),
+    _linenr(0),
+    _progressValue(0),
+    _number(),
+    _type(eNone),
+    _isUnsigned(false),
+    _isSigned(false),
+    _isPointerCompare(false),
+    _isLong(false),
+    _isUnused(false),
+    _isStandardType(false),
+    _isExpandedMacro(false),
+    _isChanged(false),
     _astOperand1(NULL),
     _astOperand2(NULL),
     _astParent(NULL)
@@ -56,62 +95,218 @@ Token::Token(Token **t) :
 
 Token::~Token()
 {
+    if (!_arena && _str != &emptyString)
+        delete _str;
+}
+
+Token *Token::create(Token **tokensBack, TokenArena *arena)
+{
+    if (!arena)
+        return new Token(tokensBack);
+    return new (arena->allocate()) Token(tokensBack, arena);
+}
+
+void Token::destroy(Token *tok)
+{
+    TokenArena *arena = tok->_arena;
+    if (!arena) {
+        delete tok;
+        return;
+    }
+    tok->~Token();
+    arena->deallocate(tok);
+}
+
+namespace {
+    struct StrIdEntry {
+        const char *str;
+        Token::StrId id;
+    };
+
+    bool operator<(const StrIdEntry &entry, const std::string &str)
+    {
+        return std::strcmp(entry.str, str.c_str()) < 0;
+    }
+}
+
+/** Strings of the fixed ids, sorted by strcmp() */
+static const StrIdEntry strIds[] = {
+    { "!", Token::idNot },
+    { "!=", Token::idNotEqual },
+    { "#", Token::idHash },
+    { "%", Token::idPercent },
+    { "%=", Token::idModAssign },
+    { "&", Token::idAmp },
+    { "&&", Token::idAndAnd },
+    { "&=", Token::idAndAssign },
+    { "(", Token::idLParen },
+    { ")", Token::idRParen },
+    { "*", Token::idStar },
+    { "*=", Token::idMulAssign },
+    { "+", Token::idPlus },
+    { "++", Token::idIncrement },
+    { "+=", Token::idAddAssign },
+    { ",", Token::idComma },
+    { "-", Token::idMinus },
+    { "--", Token::idDecrement },
+    { "-=", Token::idSubAssign },
+    { "->", Token::idArrow },
+    { ".", Token::idDot },
+    { "...", Token::idEllipsis },
+    { "/", Token::idSlash },
+    { "/=", Token::idDivAssign },
+    { ":", Token::idColon },
+    { "::", Token::idScopeOp },
+    { ";", Token::idSemicolon },
+    { "<", Token::idLess },
+    { "<<", Token::idShiftLeft },
+    { "<<=", Token::idShlAssign },
+    { "<=", Token::idLessEqual },
+    { "=", Token::idAssign },
+    { "==", Token::idEqual },
+    { ">", Token::idGreater },
+    { ">=", Token::idGreaterEqual },
+    { ">>", Token::idShiftRight },
+    { ">>=", Token::idShrAssign },
+    { "?", Token::idQuestion },
+    { "NULL", Token::idNULL },
+    { "[", Token::idLBracket },
+    { "]", Token::idRBracket },
+    { "^", Token::idCaret },
+    { "^=", Token::idXorAssign },
+    { "asm", Token::idAsm },
+    { "auto", Token::idAuto },
+    { "bool", Token::idBool },
+    { "break", Token::idBreak },
+    { "case", Token::idCase },
+    { "catch", Token::idCatch },
+    { "char", Token::idChar },
+    { "class", Token::idClass },
+    { "const", Token::idConst },
+    { "const_cast", Token::idConst_cast },
+    { "continue", Token::idContinue },
+    { "default", Token::idDefault },
+    { "delete", Token::idDelete },
+    { "do", Token::idDo },
+    { "double", Token::idDouble },
+    { "dynamic_cast", Token::idDynamic_cast },
+    { "else", Token::idElse },
+    { "enum", Token::idEnum },
+    { "explicit", Token::idExplicit },
+    { "extern", Token::idExtern },
+    { "false", Token::idFalse },
+    { "float", Token::idFloat },
+    { "for", Token::idFor },
+    { "friend", Token::idFriend },
+    { "goto", Token::idGoto },
+    { "if", Token::idIf },
+    { "inline", Token::idInline },
+    { "int", Token::idInt },
+    { "long", Token::idLong },
+    { "mutable", Token::idMutable },
+    { "namespace", Token::idNamespace },
+    { "new", Token::idNew },
+    { "nullptr", Token::idNullptr },
+    { "operator", Token::idOperator },
+    { "private", Token::idPrivate },
+    { "protected", Token::idProtected },
+    { "public", Token::idPublic },
+    { "register", Token::idRegister },
+    { "reinterpret_cast", Token::idReinterpret_cast },
+    { "return", Token::idReturn },
+    { "short", Token::idShort },
+    { "signed", Token::idSigned },
+    { "size_t", Token::idSize_t },
+    { "sizeof", Token::idSizeof },
+    { "static", Token::idStatic },
+    { "static_cast", Token::idStatic_cast },
+    { "std", Token::idStd },
+    { "struct", Token::idStruct },
+    { "switch", Token::idSwitch },
+    { "template", Token::idTemplate },
+    { "this", Token::idThis },
+    { "throw", Token::idThrow },
+    { "true", Token::idTrue },
+    { "try", Token::idTry },
+    { "typedef", Token::idTypedef },
+    { "typename", Token::idTypename },
+    { "union", Token::idUnion },
+    { "unsigned", Token::idUnsigned },
+    { "using", Token::idUsing },
+    { "virtual", Token::idVirtual },
+    { "void", Token::idVoid },
+    { "volatile", Token::idVolatile },
+    { "wchar_t", Token::idWchar_t },
+    { "while", Token::idWhile },
+    { "{", Token::idLBrace },
+    { "|", Token::idPipe },
+    { "|=", Token::idOrAssign },
+    { "||", Token::idOrOr },
+    { "}", Token::idRBrace },
+    { "~", Token::idTilde },
+};
+
+Token::StrId Token::getStrId(const std::string &s)
+{
+    // Keywords and operators are short and don't start with a digit or quote
+    if (s.empty() || s.size() > 16U || std::isdigit((unsigned char)s[0]) || s[0] == '\"' || s[0] == '\'')
+        return idNone;
+
+    const StrIdEntry *end = strIds + sizeof(strIds) / sizeof(*strIds);
+    const StrIdEntry *it = std::lower_bound(strIds, end, s);
+    if (it != end && s == it->str)
+        return it->id;
+    return idNone;
+}
 
+void Token::setStr(const std::string &s)
+{
+    if (_arena)
+        _str = _arena->intern(s, _strId);
+    else {
+        if (_str == &emptyString)
+            _str = new std::string(s);
+        else
+            *const_cast<std::string *>(_str) = s;
+        _strId = getStrId(s);
+    }
 }
 
 void Token::update_property_info()
 {
-    if (!_str.empty()) {
-        if (_str == "true" || _str == "false")
+    if (!str().empty()) {
+        if (_strId == idTrue || _strId == idFalse)
             _type = eBoolean;
-        else if (_str[0] == '_' || std::isalpha(_str[0])) { // Name
+        else if (str()[0] == '_' || std::isalpha(str()[0])) { // Name
             if (_varId)
                 _type = eVariable;
             else if (_type != eVariable && _type != eFunction && _type != eType)
                 _type = eName;
-        } else if (std::isdigit(_str[0]) || (_str.length() > 1 && _str[0] == '-' && std::isdigit(_str[1])))
+        } else if (std::isdigit(str()[0]) || (str().length() > 1 && str()[0] == '-' && std::isdigit(str()[1])))
             _type = eNumber;
-        else if (_str.length() > 1 && _str[0] == '"' && _str[_str.length()-1] == '"')
+        else if (str().length() > 1 && str()[0] == '"' && str()[str().length()-1] == '"')
             _type = eString;
-        else if (_str.length() > 1 && _str[0] == '\'' && _str[_str.length()-1] == '\'')
+        else if (str().length() > 1 && str()[0] == '\'' && str()[str().length()-1] == '\'')
             _type = eChar;
-        else if (_str == "="   ||
-                 _str == "+="  ||
-                 _str == "-="  ||
-                 _str == "*="  ||
-                 _str == "/="  ||
-                 _str == "%="  ||
-                 _str == "&="  ||
-                 _str == "^="  ||
-                 _str == "|="  ||
-                 _str == "<<=" ||
-                 _str == ">>=")
+        else if (_strId >= idAssign && _strId <= idShrAssign)
             _type = eAssignmentOp;
-        else if (_str.size() == 1 && _str.find_first_of(",[]()?:") != std::string::npos)
+        else if (_strId >= idComma && _strId <= idColon)
             _type = eExtendedOp;
-        else if (_str=="<<" || _str==">>" || (_str.size()==1 && _str.find_first_of("+-*/%") != std::string::npos))
+        else if (_strId >= idPlus && _strId <= idShiftRight)
             _type = eArithmeticalOp;
-        else if (_str.size() == 1 && _str.find_first_of("&|^~") != std::string::npos)
+        else if (_strId >= idAmp && _strId <= idTilde)
             _type = eBitOp;
-        else if (_str == "&&" ||
-                 _str == "||" ||
-                 _str == "!")
+        else if (_strId >= idAndAnd && _strId <= idNot)
             _type = eLogicalOp;
-        else if ((_str == "==" ||
-                  _str == "!=" ||
-                  _str == "<"  ||
-                  _str == "<=" ||
-                  _str == ">"  ||
-                  _str == ">=") && !_link)
+        else if (_strId >= idEqual && _strId <= idGreaterEqual && !_link)
             _type = eComparisonOp;
-        else if (_str == "++" ||
-                 _str == "--")
+        else if (_strId == idIncrement || _strId == idDecrement)
             _type = eIncDecOp;
-        else if (_str.size() == 1 && (_str.find_first_of("{}") != std::string::npos || (_link && _str.find_first_of("<>") != std::string::npos)))
+        else if (_strId == idLBrace || _strId == idRBrace || (_link && (_strId == idLess || _strId == idGreater)))
             _type = eBracket;
 
         //ds added comment detection (minimum size 2)
-        else if( 2 == _str.size( ) && ( "//" == _str.substr( 0, 2 ) || "/*" == _str.substr( 0, 2 ) ) )
+        else if( 2 == str().size( ) && ( "//" == str().substr( 0, 2 ) || "/*" == str().substr( 0, 2 ) ) )
         {
             _type = eComment;
         }
@@ -129,16 +324,9 @@ void Token::update_property_isStandardType()
 {
     _isStandardType = false;
 
-    if (_str.size() < 3)
-        return;
-
-    static const char * const stdtype[] = {"int", "char", "bool", "long", "short", "float", "double", "wchar_t", "size_t", "void", 0};
-    for (int i = 0; stdtype[i]; i++) {
-        if (_str == stdtype[i]) {
-            _isStandardType = true;
-            _type = eType;
-            break;
-        }
+    if (_strId >= idBool && _strId <= idWchar_t) {
+        _isStandardType = true;
+        _type = eType;
     }
 }
 
@@ -147,8 +335,8 @@ bool Token::isUpperCaseName() const
 {
     if (!isName())
         return false;
-    for (unsigned int i = 0; i < _str.length(); ++i) {
-        if (std::islower(_str[i]))
+    for (unsigned int i = 0; i < str().length(); ++i) {
+        if (std::islower(str()[i]))
             return false;
     }
     return true;
@@ -156,16 +344,30 @@ bool Token::isUpperCaseName() const
 
 void Token::str(const std::string &s)
 {
-    _str = s;
+    setStr(s);
+    _varId = 0;
+    _isChanged = true;
+
+    update_property_info();
+    _number = (_type == eNumber) ? MathLib::Value(*_str) : MathLib::Value();
+}
+
+void Token::number(const MathLib::Value &value)
+{
+    setStr(value.str());
     _varId = 0;
+    _isChanged = true;
 
     update_property_info();
+    _number = (_type == eNumber) ? value : MathLib::Value();
 }
 
 void Token::concatStr(std::string const& b)
 {
-    _str.erase(_str.length() - 1);
-    _str.append(b.begin() + 1, b.end());
+    std::string s(str(), 0, str().length() - 1);
+    s.append(b.begin() + 1, b.end());
+    setStr(s);
+    _isChanged = true;
 
     update_property_info();
 }
@@ -173,15 +375,16 @@ void Token::concatStr(std::string const& b)
 std::string Token::strValue() const
 {
     assert(_type == eString);
-    return _str.substr(1, _str.length() - 2);
+    return str().substr(1, str().length() - 2);
 }
 
 void Token::deleteNext(unsigned long index)
 {
+    _isChanged = true;
     while (_next && index--) {
         Token *n = _next;
         _next = n->next();
-        delete n;
+        destroy(n);
     }
 
     if (_next)
@@ -192,9 +395,15 @@ void Token::deleteNext(unsigned long index)
 
 void Token::deleteThis()
 {
+    _isChanged = true;
     if (_next) { // Copy next to this and delete next
-        _str = _next->_str;
+        if (_arena && _arena == _next->_arena) {
+            _str = _next->_str;
+            _strId = _next->_strId;
+        } else
+            setStr(_next->str());
         _type = _next->_type;
+        _number = _next->_number;
         _isUnsigned = _next->_isUnsigned;
         _isSigned = _next->_isSigned;
         _isPointerCompare = _next->_isPointerCompare;
@@ -214,8 +423,13 @@ void Token::deleteThis()
 
         deleteNext();
     } else if (_previous && _previous->_previous) { // Copy previous to this and delete previous
-        _str = _previous->_str;
+        if (_arena && _arena == _previous->_arena) {
+            _str = _previous->_str;
+            _strId = _previous->_strId;
+        } else
+            setStr(_previous->str());
         _type = _previous->_type;
+        _number = _previous->_number;
         _isUnsigned = _previous->_isUnsigned;
         _isSigned = _previous->_isSigned;
         _isPointerCompare = _previous->_isPointerCompare;
@@ -237,7 +451,7 @@ void Token::deleteThis()
         _previous = _previous->_previous;
         _previous->_next = this;
 
-        delete toDelete;
+        destroy(toDelete);
     } else {
         // We are the last token in the list, we can't delete
         // ourselves, so just make us empty
@@ -275,7 +489,7 @@ void Token::replace(Token *replaceThis, Token *start, Token *end)
         tok->_progressValue = replaceThis->_progressValue;
 
     // Delete old token, which is replaced
-    delete replaceThis;
+    destroy(replaceThis);
 }
 
 const Token *Token::tokAt(int index) const
@@ -306,7 +520,7 @@ const std::string &Token::strAt(int index) const
     static const std::string empty_str;
 
     const Token *tok = this->tokAt(index);
-    return tok ? tok->_str : empty_str;
+    return tok ? tok->str() : empty_str;
 }
 
 static int multiComparePercent(const Token *tok, const char ** haystack_p,
@@ -350,6 +564,21 @@ static int multiComparePercent(const Token *tok, const char ** haystack_p,
             if (tok->isName())
                 return 1;
             *haystack_p = haystack = haystack + 5;
+        } else if (haystack[1] == 't' && // "%type%"
+                   haystack[2] == 'y' &&
+                   haystack[3] == 'p' &&
+                   haystack[4] == 'e' &&
+                   haystack[5] == '%') {
+            if (tok->isName() && tok->varId() == 0 && tok->strId() != Token::idDelete)
+                return 1;
+            *haystack_p = haystack = haystack + 6;
+        } else if (haystack[1] == 'n' && // "%num%"
+                   haystack[2] == 'u' &&
+                   haystack[3] == 'm' &&
+                   haystack[4] == '%') {
+            if (tok->isNumber())
+                return 1;
+            *haystack_p = haystack = haystack + 5;
         }
 
         if (*haystack == '|')
@@ -467,7 +696,7 @@ bool Token::simpleMatch(const Token *tok, const char pattern[])
     while (*current) {
         std::size_t length = static_cast<std::size_t>(next - current);
 
-        if (!tok || length != tok->_str.length() || std::strncmp(current, tok->_str.c_str(), length))
+        if (!tok || length != tok->str().length() || std::strncmp(current, tok->str().c_str(), length))
             return false;
 
         current = next;
@@ -720,7 +949,7 @@ bool Token::Match(const Token *tok, const char pattern[], unsigned int varid)
 
         // Parse multi options, such as void|int|char (accept token which is one of these 3)
         else if (chrInFirstWord(p, '|') && (p[0] != '|' || firstWordLen(p) > 2)) {
-            int res = multiCompare(tok, p, tok->_str.c_str());
+            int res = multiCompare(tok, p, tok->str().c_str());
             if (res == 0) {
                 // Empty alternative matches, use the same token on next round
                 while (*p && *p != ' ')
@@ -741,7 +970,7 @@ bool Token::Match(const Token *tok, const char pattern[], unsigned int varid)
                 ++p;
         }
 
-        else if (!firstWordEquals(p, tok->_str.c_str())) {
+        else if (!firstWordEquals(p, tok->str().c_str())) {
             return false;
         }
 
@@ -847,7 +1076,7 @@ const Token * Token::findClosingBracket() const
 {
     const Token *closing = 0;
 
-    if (_str == "<") {
+    if (str() == "<") {
         unsigned int depth = 0;
         for (closing = this; closing != NULL; closing = closing->next()) {
             if (closing->str() == "{" || closing->str() == "[" || closing->str() == "(")
@@ -923,14 +1152,15 @@ void Token::insertToken(const std::string &tokenStr, bool prepend)
     if (prepend && !this->previous())
         return;
 
-    if (_str.empty())
+    if (str().empty())
         newToken = this;
     else
-        newToken = new Token(tokensBack);
+        newToken = create(tokensBack, _arena);
     newToken->str(tokenStr);
     newToken->_linenr = _linenr;
     newToken->_fileIndex = _fileIndex;
     newToken->_progressValue = _progressValue;
+    _isChanged = true;
 
     if (newToken != this) {
         if (prepend) {
@@ -998,14 +1228,14 @@ void Token::stringify(std::ostream& os, bool varid, bool attributes) const
         if (isLong())
             os << "long ";
     }
-    if (_str[0] != '\"' || _str.find("\0") == std::string::npos)
-        os << _str;
+    if (str()[0] != '\"' || str().find("\0") == std::string::npos)
+        os << str();
     else {
-        for (std::size_t i = 0U; i < _str.size(); ++i) {
-            if (_str[i] == '\0')
+        for (std::size_t i = 0U; i < str().size(); ++i) {
+            if (str()[i] == '\0')
                 os << "\\0";
             else
-                os << _str[i];
+                os << str()[i];
         }
     }
     if (varid && _varId != 0)
@@ -1113,7 +1343,7 @@ void Token::astHandleParentheses()
     Token *innerTop;
     if (Token::Match(this, ")|]"))
         innerTop = _previous;
-    else if (_next && _next->_str == ")")
+    else if (_next && _next->str() == ")")
         return;
     else  // _str = "("
         innerTop = _next;
@@ -1121,7 +1351,7 @@ void Token::astHandleParentheses()
         innerTop = innerTop->_astParent;
 
     if (_astParent) {
-        if (_str == "(" && _astParent->_astOperand2 != NULL)
+        if (str() == "(" && _astParent->_astOperand2 != NULL)
             _astParent->_astOperand2 = innerTop;
         else
             _astParent->_astOperand1 = innerTop;
@@ -23,10 +23,12 @@
 #include <vector>
 #include <ostream>
 #include "config.h"
+#include "mathlib.h"
 
 class Scope;
 class Function;
 class Variable;
+class TokenArena;
 
 /// @addtogroup Core
 /// @{
@@ -42,6 +44,8 @@ class Variable;
  * The Token class also has other functions for management of token list, matching tokens, etc.
  */
 class CPPCHECKLIB Token {
+    friend class TokenList;
+
 private:
     Token **tokensBack;
 
@@ -50,7 +54,23 @@ private:
     Token(const Token &);
     Token operator=(const Token &);
 
+    /** Token that is allocated in the given arena (if it is non-zero) */
+    Token(Token **tokensBack, TokenArena *arena);
+
+    /** Delete a token that is created by create() */
+    static void destroy(Token *tok);
+
+    /** Set the string without updating the properties */
+    void setStr(const std::string &s);
+
 public:
+    /**
+     * Create a new token in the arena, or on the heap if there is no arena.
+     * Tokens that are inserted after it are allocated the same way. Use
+     * TokenList::deleteTokens() to delete them.
+     */
+    static Token *create(Token **tokensBack, TokenArena *arena);
+
     enum Type {
         eVariable, eType, eFunction, eName, eComment, eIndent, // Names: Variable (varId), Type (typeId, later), Function (FuncId, later), Name (unknown identifier) //ds added comment and indent type
         eNumber, eString, eChar, eBoolean, eLiteral, // Literals: Number, String, Character, User defined literal (C++11)
@@ -60,6 +80,48 @@ public:
         eNone
     };
 
+    /**
+     * @brief Fixed ids for the strings of keywords and operators.
+     * Comparing the id is faster than comparing the string. Tokens with
+     * other strings have the id idNone. Each group of operators is
+     * contiguous so the token type can be checked with a range.
+     */
+    enum StrId {
+        idNone = 0,
+        // assignment operators
+        idAssign, idAddAssign, idSubAssign, idMulAssign, idDivAssign, idModAssign,
+        idAndAssign, idOrAssign, idXorAssign, idShlAssign, idShrAssign,
+        // comparison operators
+        idEqual, idNotEqual, idLess, idLessEqual, idGreater, idGreaterEqual,
+        // arithmetical operators
+        idPlus, idMinus, idStar, idSlash, idPercent, idShiftLeft, idShiftRight,
+        // bit operators
+        idAmp, idPipe, idCaret, idTilde,
+        // logical operators
+        idAndAnd, idOrOr, idNot,
+        // increment/decrement operators
+        idIncrement, idDecrement,
+        // extended operators
+        idComma, idLBracket, idRBracket, idLParen, idRParen, idQuestion, idColon,
+        // braces
+        idLBrace, idRBrace,
+        // other punctuation
+        idSemicolon, idDot, idScopeOp, idArrow, idEllipsis, idHash,
+        // standard types
+        idBool, idChar, idDouble, idFloat, idInt, idLong, idShort, idSize_t, idVoid,
+        idWchar_t,
+        // other keywords
+        idAsm, idAuto, idBreak, idCase, idCatch, idClass, idConst, idConst_cast,
+        idContinue, idDefault, idDelete, idDo, idDynamic_cast, idElse, idEnum,
+        idExplicit, idExtern, idFalse, idFor, idFriend, idGoto, idIf, idInline,
+        idMutable, idNamespace, idNew, idOperator, idPrivate, idProtected, idPublic,
+        idRegister, idReinterpret_cast, idReturn, idSigned, idSizeof, idStatic,
+        idStatic_cast, idStruct, idSwitch, idTemplate, idThis, idThrow, idTrue, idTry,
+        idTypedef, idTypename, idUnion, idUnsigned, idUsing, idVirtual, idVolatile,
+        idWhile, idNULL, idNullptr, idStd,
+        idLast
+    };
+
     explicit Token(Token **tokensBack);
     ~Token();
 
@@ -72,9 +134,28 @@ public:
     void concatStr(std::string const& b);
 
     const std::string &str() const {
-        return _str;
+        return *_str;
     }
 
+    /**
+     * The value of a number token. It is parsed when the string is set.
+     * Only valid if isNumber() is true.
+     */
+    const MathLib::Value &number() const {
+        return _number;
+    }
+
+    /** Set the string of a number token from a calculated value, without parsing it again */
+    void number(const MathLib::Value &value);
+
+    /** Fixed id of the token string, idNone if it is not a keyword or operator */
+    StrId strId() const {
+        return _strId;
+    }
+
+    /** Get the fixed id of a string, idNone if it is not a keyword or operator */
+    static StrId getStrId(const std::string &s);
+
     /**
      * Unlink and delete the next 'index' tokens.
      */
@@ -277,7 +358,7 @@ public:
     //ds check for single or multi-line comments
     bool isSingleLine( ) const
     {
-        if( 1 < _str.length( ) && "//" == _str.substr( 0, 2 ) )
+        if( 1 < _str->length( ) && "//" == _str->substr( 0, 2 ) )
         {
             return true;
         }
@@ -291,6 +372,18 @@ public:
         _isExpandedMacro = m;
     }
 
+    /**
+     * Has the token been changed, inserted or has a following token been
+     * deleted since the flag was cleared? Used by the simplifications to
+     * find the code that needs to be simplified again.
+     */
+    bool isChanged() const {
+        return _isChanged;
+    }
+    void isChanged(bool changed) {
+        _isChanged = changed;
+    }
+
     static const Token *findsimplematch(const Token *tok, const char pattern[]);
     static const Token *findsimplematch(const Token *tok, const char pattern[], const Token *end);
     static const Token *findmatch(const Token *tok, const char pattern[], unsigned int varId = 0);
@@ -444,7 +537,7 @@ public:
      */
     void link(Token *linkToToken) {
         _link = linkToToken;
-        if (_str == "<" || _str == ">")
+        if (*_str == "<" || *_str == ">")
             update_property_info();
     }
 
@@ -606,7 +699,14 @@ private:
         const Variable *_variable;
     };
 
-    std::string _str;
+    /** Arena that the token is allocated in, 0 if it is allocated with new */
+    TokenArena *_arena;
+
+    /** Token string, interned in the arena. Tokens without arena own their string. */
+    const std::string *_str;
+
+    /** Fixed id of _str */
+    StrId _strId;
     unsigned int _varId;
     unsigned int _fileIndex;
     unsigned int _linenr;
@@ -617,6 +717,9 @@ private:
      */
     unsigned int _progressValue;
 
+    /** Parsed value of a number token */
+    MathLib::Value _number;
+
     Type _type;
     bool _isUnsigned;
     bool _isSigned;
@@ -625,6 +728,7 @@ private:
     bool _isUnused;
     bool _isStandardType;
     bool _isExpandedMacro;
+    bool _isChanged;
 
     /** Updates internal property cache like _isName or _isBoolean.
         Called after any _str() modification. */
@@ -662,7 +766,7 @@ public:
             ret = _astOperand1->astString();
         if (_astOperand2)
             ret += _astOperand2->astString();
-        return ret+_str;
+        return ret + *_str;
     }
 };
 
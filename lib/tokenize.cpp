@@ -26,12 +26,22 @@
 #include "symboldatabase.h"
 #include "templatesimplifier.h"
 #include "timer.h"
+#include "mutex.h"
+#include "utils.h"
 
 #include <cstring>
 #include <sstream>
 #include <cassert>
 #include <cctype>
+#include <deque>
 #include <stack>
+#include <vector>
+
+//---------------------------------------------------------------------------
+
+static const unsigned int timerSimplifyTypedef = Timer::id("Tokenizer::tokenize::simplifyTypedef");
+static const unsigned int timerSimplifyTemplates = Timer::id("Tokenizer::tokenize::simplifyTemplates");
+static const unsigned int timerSetVarId = Timer::id("Tokenizer::tokenize::setVarId");
 
 //---------------------------------------------------------------------------
 
@@ -43,7 +53,9 @@ Tokenizer::Tokenizer() :
     _symbolDatabase(0),
     _varId(0),
     _codeWithTemplates(false), //is there any templates?
-    m_timerResults(NULL)
+    m_timerResults(NULL),
+    m_tokenStats(NULL),
+    m_simplifyStats(NULL)
 {
 }
 
@@ -55,7 +67,9 @@ Tokenizer::Tokenizer(const Settings *settings, ErrorLogger *errorLogger) :
     _symbolDatabase(0),
     _varId(0),
     _codeWithTemplates(false), //is there any templates?
-    m_timerResults(NULL)
+    m_timerResults(NULL),
+    m_tokenStats(NULL),
+    m_simplifyStats(NULL)
 {
     // make sure settings are specified
     assert(_settings);
@@ -64,6 +78,11 @@ Tokenizer::Tokenizer(const Settings *settings, ErrorLogger *errorLogger) :
 Tokenizer::~Tokenizer()
 {
     delete _symbolDatabase;
+
+    if (m_tokenStats) {
+        *m_tokenStats += list.arenaStats();
+        *m_tokenStats += m_lstCustomTokenList.arenaStats();
+    }
 }
 
 
@@ -370,6 +389,10 @@ struct Space {
     bool isNamespace;
 };
 
+/** Number of the next unnamed struct, the threads that check files share it */
+static unsigned int unnamedCount = 0;
+static Mutex unnamedCountMutex;
+
 static Token *splitDefinitionFromTypedef(Token *tok)
 {
     Token *tok1;
@@ -389,8 +412,8 @@ static Token *splitDefinitionFromTypedef(Token *tok)
             if (Token::Match(tok1->next(), "%type%"))
                 name = tok1->next()->str();
             else { // create a unique name
-                static unsigned int count = 0;
-                name = "Unnamed" + MathLib::longToString(count++);
+                MutexLock lock(unnamedCountMutex);
+                name = "Unnamed" + MathLib::longToString(unnamedCount++);
             }
             tok->next()->insertToken(name);
         } else
@@ -1581,6 +1604,10 @@ bool Tokenizer::tokenize(std::istream &code,
         return false;
     }
 
+    // the code is empty, for example when a configuration removes all of it
+    if (!list.front())
+        return false;
+
     if (_settings->terminated())
         return false;
 
@@ -1758,7 +1785,7 @@ bool Tokenizer::tokenize(std::istream &code,
 
     // typedef..
     if (m_timerResults) {
-        Timer t("Tokenizer::tokenize::simplifyTypedef", _settings->_showtime, m_timerResults);
+        Timer t(timerSimplifyTypedef, _settings->_showtime, m_timerResults);
         simplifyTypedef();
     } else {
         simplifyTypedef();
@@ -1992,7 +2019,12 @@ bool Tokenizer::tokenize(std::istream &code,
             ;
 
     // Handle templates..
-    simplifyTemplates();
+    if (m_timerResults) {
+        Timer t(timerSimplifyTemplates, _settings->_showtime, m_timerResults);
+        simplifyTemplates();
+    } else {
+        simplifyTemplates();
+    }
 
     // The simplifyTemplates have inner loops
     if (_settings && _settings->terminated())
@@ -2032,7 +2064,7 @@ bool Tokenizer::tokenize(std::istream &code,
     simplifyVarDecl(false);
 
     if (m_timerResults) {
-        Timer t("Tokenizer::tokenize::setVarId", _settings->_showtime, m_timerResults);
+        Timer t(timerSetVarId, _settings->_showtime, m_timerResults);
         setVarId();
     } else {
         setVarId();
@@ -2380,8 +2412,8 @@ void Tokenizer::simplifyNull()
         else if (tok->str() == "__null" || tok->str() == "'\\0'" || tok->str() == "'\\x0'")
             tok->str("0");
         else if (tok->isNumber() &&
-                 MathLib::isInt(tok->str()) &&
-                 MathLib::toLongNumber(tok->str()) == 0)
+                 tok->number().isInt() &&
+                 tok->number().getInt() == 0)
             tok->str("0");
     }
 
@@ -2711,8 +2743,121 @@ void Tokenizer::simplifyTemplates()
 }
 //---------------------------------------------------------------------------
 
+/**
+ * Variable ids by name, used by setVarId(). Struct members are stored with
+ * the variable id of the struct variable.
+ *
+ * There is one hash table for all scopes. When a variable is declared in an
+ * inner scope the variable id it shadows is saved in an undo log, and when
+ * the scope is left the log is rolled back. Entering a scope doesn't copy
+ * anything.
+ */
+class VariableIds {
+public:
+    /** @return variable id, 0 if the name is not known */
+    unsigned int find(const std::string &name, unsigned int structVarId = 0U) const {
+        if (_table.empty())
+            return 0U;
+        const std::size_t mask = _table.size() - 1U;
+        for (std::size_t i = hash(name, structVarId) & mask; _table[i]; i = (i + 1U) & mask) {
+            if (_table[i]->structVarId == structVarId && _table[i]->name == name)
+                return _table[i]->varId;
+        }
+        return 0U;
+    }
+
+    void set(const std::string &name, unsigned int varId, unsigned int structVarId = 0U) {
+        Entry *entry = insert(name, structVarId);
+        if (!_scopes.empty())
+            _undo.push_back(std::make_pair(entry, entry->varId));
+        entry->varId = varId;
+    }
+
+    /** nothing has been set since the last clear() */
+    bool empty() const {
+        return _entries.empty();
+    }
+
+    void enterScope() {
+        _scopes.push_back(_undo.size());
+    }
+
+    /** Restore the variable ids the scope has shadowed. All names are removed if no scope has been entered. */
+    void leaveScope() {
+        if (_scopes.empty()) {
+            clear();
+            return;
+        }
+        while (_undo.size() > _scopes.back()) {
+            _undo.back().first->varId = _undo.back().second;
+            _undo.pop_back();
+        }
+        _scopes.pop_back();
+    }
+
+    void clear() {
+        _entries.clear();
+        _table.assign(_table.size(), static_cast<Entry *>(0));
+        _undo.clear();
+        _scopes.clear();
+    }
+
+private:
+    struct Entry {
+        std::string name;
+        unsigned int structVarId;
+        unsigned int varId;
+    };
+
+    static std::size_t hash(const std::string &name, unsigned int structVarId) {
+        return static_cast<std::size_t>(fnv1a(fnv1aValue(FNV1A_OFFSET_BASIS, structVarId), name));
+    }
+
+    Entry *insert(const std::string &name, unsigned int structVarId) {
+        // Keep the hash table at most half full
+        if (_entries.size() * 2U >= _table.size())
+            rehash(_table.empty() ? 64U : _table.size() * 2U);
+
+        const std::size_t mask = _table.size() - 1U;
+        std::size_t i = hash(name, structVarId) & mask;
+        for (; _table[i]; i = (i + 1U) & mask) {
+            if (_table[i]->structVarId == structVarId && _table[i]->name == name)
+                return _table[i];
+        }
+        Entry entry;
+        entry.name = name;
+        entry.structVarId = structVarId;
+        entry.varId = 0;
+        _entries.push_back(entry);
+        _table[i] = &_entries.back();
+        return _table[i];
+    }
+
+    void rehash(std::size_t size) {
+        _table.assign(size, static_cast<Entry *>(0));
+        for (std::deque<Entry>::iterator it = _entries.begin(); it != _entries.end(); ++it) {
+            std::size_t i = hash(it->name, it->structVarId) & (size - 1U);
+            while (_table[i])
+                i = (i + 1U) & (size - 1U);
+            _table[i] = &*it;
+        }
+    }
+
+    /** All names. A deque does not move its elements. */
+    std::deque<Entry> _entries;
+
+    /** Open addressing hash table of the entries */
+    std::vector<Entry *> _table;
+
+    /** Variable ids that have been shadowed, and the entries that shadow them */
+    std::vector<std::pair<Entry *, unsigned int> > _undo;
+
+    /** Size of the undo log when the scopes were entered */
+    std::vector<std::size_t> _scopes;
+};
+
 
-static bool setVarIdParseDeclaration(const Token **tok, const std::map<std::string,unsigned int> &variableId, bool executableScope)
+static bool setVarIdParseDeclaration(const Token **tok, const VariableIds &variableId, bool executableScope)
 {
     const Token *tok2 = *tok;
 
@@ -2730,7 +2875,7 @@ static bool setVarIdParseDeclaration(const Token **tok, const std::map<std::stri
                 typeCount = 0;
             } else if (tok2->str() == "const") {
                 ;  // just skip "const"
-            } else if (!hasstruct && variableId.find(tok2->str()) != variableId.end() && tok2->previous()->str() != "::") {
+            } else if (!hasstruct && variableId.find(tok2->str()) && tok2->previous()->str() != "::") {
                 ++typeCount;
                 tok2 = tok2->next();
                 if (!tok2 || tok2->str() != "::")
@@ -2780,7 +2925,7 @@ static bool setVarIdParseDeclaration(const Token **tok, const std::map<std::stri
 
 
 static void setVarIdStructMembers(Token **tok1,
-                                  std::map<unsigned int, std::map<std::string,unsigned int> > *structMembers,
+                                  VariableIds *structMembers,
                                   unsigned int *_varId)
 {
     Token *tok = *tok1;
@@ -2794,12 +2939,12 @@ static void setVarIdStructMembers(Token **tok1,
         if (TemplateSimplifier::templateParameters(tok->next()) > 0)
             break;
 
-        std::map<std::string,unsigned int>& members = (*structMembers)[struct_varid];
-        if (members.empty() || members.find(tok->str()) == members.end()) {
-            members[tok->str()] = ++(*_varId);
+        const unsigned int varId = structMembers->find(tok->str(), struct_varid);
+        if (varId == 0) {
+            structMembers->set(tok->str(), ++(*_varId), struct_varid);
             tok->varId(*_varId);
         } else {
-            tok->varId(members[tok->str()]);
+            tok->varId(varId);
         }
     }
     if (tok)
@@ -2808,9 +2953,9 @@ static void setVarIdStructMembers(Token **tok1,
 
 
 static void setVarIdClassDeclaration(Token * const startToken,
-                                     const std::map<std::string, unsigned int> &variableId,
+                                     const VariableIds &variableId,
                                      const unsigned int scopeStartVarId,
-                                     std::map<unsigned int, std::map<std::string,unsigned int> > *structMembers,
+                                     VariableIds *structMembers,
                                      unsigned int *_varId)
 {
     // end of scope
@@ -2837,9 +2982,9 @@ static void setVarIdClassDeclaration(Token * const startToken,
         } else if (tok->str() == "}")
             --indentlevel;
         else if (initList && indentlevel == 0 && Token::Match(tok->previous(), "[,:] %var% (")) {
-            const std::map<std::string, unsigned int>::const_iterator it = variableId.find(tok->str());
-            if (it != variableId.end()) {
-                tok->varId(it->second);
+            const unsigned int varId = variableId.find(tok->str());
+            if (varId != 0) {
+                tok->varId(varId);
             }
         } else if (tok->isName() && tok->varId() <= scopeStartVarId) {
             if (indentlevel > 0) {
@@ -2852,9 +2997,9 @@ static void setVarIdClassDeclaration(Token * const startToken,
                         continue;
                 }
 
-                const std::map<std::string, unsigned int>::const_iterator it = variableId.find(tok->str());
-                if (it != variableId.end()) {
-                    tok->varId(it->second);
+                const unsigned int varId = variableId.find(tok->str());
+                if (varId != 0) {
+                    tok->varId(varId);
                     setVarIdStructMembers(&tok, structMembers, _varId);
                 }
             }
@@ -2869,15 +3014,15 @@ static void setVarIdClassDeclaration(Token * const startToken,
 // Parse each function..
 static void setVarIdClassFunction(Token * const startToken,
                                   const Token * const endToken,
-                                  const std::map<std::string, unsigned int> &varlist,
-                                  std::map<unsigned int, std::map<std::string,unsigned int> > *structMembers,
+                                  const VariableIds &varlist,
+                                  VariableIds *structMembers,
                                   unsigned int *_varId)
 {
     for (Token *tok2 = startToken; tok2 && tok2 != endToken; tok2 = tok2->next()) {
         if (tok2->varId() == 0 && (tok2->previous()->str() != "." || tok2->strAt(-2) == "this")) {
-            const std::map<std::string,unsigned int>::const_iterator it = varlist.find(tok2->str());
-            if (it != varlist.end()) {
-                tok2->varId(it->second);
+            const unsigned int varId = varlist.find(tok2->str());
+            if (varId != 0) {
+                tok2->varId(varId);
                 setVarIdStructMembers(&tok2, structMembers, _varId);
             }
         }
@@ -2915,9 +3060,8 @@ void Tokenizer::setVarId()
 
     // variable id
     _varId = 0;
-    std::map<std::string, unsigned int> variableId;
-    std::map<unsigned int, std::map<std::string, unsigned int> > structMembers;
-    std::stack< std::map<std::string, unsigned int> > scopeInfo;
+    VariableIds variableId;
+    VariableIds structMembers;
     std::stack<bool> executableScope;
     executableScope.push(false);
     std::stack<unsigned int> scopestartvarid;  // varid when scope starts
@@ -2928,15 +3072,14 @@ void Tokenizer::setVarId()
         // scope info to handle shadow variables..
         if (!initlist && tok->str() == "(" &&
             (Token::simpleMatch(tok->link(), ") {") || Token::Match(tok->link(), ") %type% {") || isInitList(tok->link()))) {
-            scopeInfo.push(variableId);
+            variableId.enterScope();
             initlist = Token::simpleMatch(tok->link(), ") :");
 
             // function declarations
         } else if (!executableScope.top() && tok->str() == "(" && Token::simpleMatch(tok->link(), ") ;")) {
-            scopeInfo.push(variableId);
+            variableId.enterScope();
         } else if (!executableScope.top() && Token::simpleMatch(tok, ") ;")) {
-            variableId.swap(scopeInfo.top());
-            scopeInfo.pop();
+            variableId.leaveScope();
 
         } else if (tok->str() == "{") {
             initlist = false;
@@ -2947,7 +3090,7 @@ void Tokenizer::setVarId()
                     executableScope.push(true);
                 } else {
                     executableScope.push(executableScope.top());
-                    scopeInfo.push(variableId);
+                    variableId.enterScope();
                 }
             }
         } else if (tok->str() == "}") {
@@ -2967,12 +3110,7 @@ void Tokenizer::setVarId()
                     scopestartvarid.push(0);
                 }
 
-                if (scopeInfo.empty()) {
-                    variableId.clear();
-                } else {
-                    variableId.swap(scopeInfo.top());
-                    scopeInfo.pop();
-                }
+                variableId.leaveScope();
 
                 executableScope.pop();
                 if (executableScope.empty()) {   // should not possibly happen
@@ -3010,7 +3148,7 @@ void Tokenizer::setVarId()
             const bool decl = setVarIdParseDeclaration(&tok2, variableId, executableScope.top());
 
             if (decl && Token::Match(tok2->previous(), "%type% [;[=,)]") && tok2->previous()->str() != "const") {
-                variableId[tok2->previous()->str()] = ++_varId;
+                variableId.set(tok2->previous()->str(), ++_varId);
                 tok = tok2->previous();
             }
 
@@ -3025,7 +3163,7 @@ void Tokenizer::setVarId()
 
                 const Token *tok3 = tok2->next();
                 if (!tok3->isStandardType() && tok3->str() != "void" && !Token::Match(tok3,"struct|union|class %type%") && tok3->str() != "." && !setVarIdParseDeclaration(&tok3,variableId,executableScope.top())) {
-                    variableId[tok2->previous()->str()] = ++_varId;
+                    variableId.set(tok2->previous()->str(), ++_varId);
                     tok = tok2->previous();
                 }
             }
@@ -3043,9 +3181,9 @@ void Tokenizer::setVarId()
                     continue;
             }
 
-            const std::map<std::string, unsigned int>::const_iterator it = variableId.find(tok->str());
-            if (it != variableId.end()) {
-                tok->varId(it->second);
+            const unsigned int varId = variableId.find(tok->str());
+            if (varId != 0) {
+                tok->varId(varId);
                 setVarIdStructMembers(&tok, &structMembers, &_varId);
             }
         } else if (Token::Match(tok, "::|. %var%")) {
@@ -3065,16 +3203,16 @@ void Tokenizer::setVarId()
     // are parsed. The old info is not bad, it is just redundant.
     structMembers.clear();
 
-    // Member functions and variables in this source
-    std::list<Token *> allMemberFunctions;
-    std::list<Token *> allMemberVars;
+    // Member functions and variables in this source, by class name
+    std::map<std::string, std::list<Token *> > allMemberFunctions;
+    std::map<std::string, std::list<Token *> > allMemberVars;
     {
         for (Token *tok2 = list.front(); tok2; tok2 = tok2->next()) {
             if (Token::Match(tok2, "%var% :: %var%")) {
                 if (tok2->strAt(3) == "(")
-                    allMemberFunctions.push_back(tok2);
+                    allMemberFunctions[tok2->str()].push_back(tok2);
                 else if (tok2->tokAt(2)->varId() != 0)
-                    allMemberVars.push_back(tok2);
+                    allMemberVars[tok2->str()].push_back(tok2);
             }
         }
     }
@@ -3085,7 +3223,7 @@ void Tokenizer::setVarId()
             const std::string &classname(tok->next()->str());
 
             // What member variables are there in this class?
-            std::map<std::string, unsigned int> varlist;
+            VariableIds varlist;
             const Token* tokStart = Token::findsimplematch(tok, "{");
             if (tokStart) {
                 for (const Token *tok2 = tokStart->next(); tok2 != tokStart->link(); tok2 = tok2->next()) {
@@ -3097,7 +3235,7 @@ void Tokenizer::setVarId()
 
                     // Found a member variable..
                     else if (tok2->varId() > 0)
-                        varlist[tok2->str()] = tok2->varId();
+                        varlist.set(tok2->str(), tok2->varId());
                 }
             }
 
@@ -3106,46 +3244,42 @@ void Tokenizer::setVarId()
                 continue;
 
             // Member variables
-            for (std::list<Token *>::iterator func = allMemberVars.begin(); func != allMemberVars.end(); ++func) {
-                if (!Token::simpleMatch(*func, classname.c_str()))
-                    continue;
-
+            const std::list<Token *> &memberVars = allMemberVars[classname];
+            for (std::list<Token *>::const_iterator func = memberVars.begin(); func != memberVars.end(); ++func) {
                 Token *tok2 = *func;
                 tok2 = tok2->tokAt(2);
-                tok2->varId(varlist[tok2->str()]);
+                tok2->varId(varlist.find(tok2->str()));
             }
 
             // Set variable ids in member functions for this class..
-            const std::string funcpattern(classname + " :: %var% (");
-            for (std::list<Token *>::iterator func = allMemberFunctions.begin(); func != allMemberFunctions.end(); ++func) {
+            const std::list<Token *> &memberFunctions = allMemberFunctions[classname];
+            for (std::list<Token *>::const_iterator func = memberFunctions.begin(); func != memberFunctions.end(); ++func) {
                 Token *tok2 = *func;
 
-                // Found a class function..
-                if (Token::Match(tok2, funcpattern.c_str())) {
-                    // Goto the end parentheses..
-                    tok2 = tok2->linkAt(3);
-                    if (!tok2)
-                        break;
+                // Goto the end parentheses..
+                tok2 = tok2->linkAt(3);
+                if (!tok2)
+                    break;
 
-                    // If this is a function implementation.. add it to funclist
-                    if (Token::Match(tok2, ") const|volatile| {")) {
-                        while (tok2->str() != "{")
-                            tok2 = tok2->next();
-                        setVarIdClassFunction(tok2, tok2->link(), varlist, &structMembers, &_varId);
+                // If this is a function implementation.. add it to funclist
+                if (Token::Match(tok2, ") const|volatile| {")) {
+                    while (tok2->str() != "{")
+                        tok2 = tok2->next();
+                    setVarIdClassFunction(tok2, tok2->link(), varlist, &structMembers, &_varId);
+                }
+
+                // constructor with initializer list
+                if (Token::Match(tok2, ") : %var% (")) {
+                    Token *tok3 = tok2;
+                    while (Token::Match(tok3, ") [:,] %var% (")) {
+                        Token *vartok = tok3->tokAt(2);
+                        const unsigned int varId = varlist.find(vartok->str());
+                        if (varId != 0)
+                            vartok->varId(varId);
+                        tok3 = tok3->linkAt(3);
                     }
-
-                    // constructor with initializer list
-                    if (Token::Match(tok2, ") : %var% (")) {
-                        Token *tok3 = tok2;
-                        while (Token::Match(tok3, ") [:,] %var% (")) {
-                            Token *vartok = tok3->tokAt(2);
-                            if (varlist.find(vartok->str()) != varlist.end())
-                                vartok->varId(varlist[vartok->str()]);
-                            tok3 = tok3->linkAt(3);
-                        }
-                        if (Token::simpleMatch(tok3, ") {")) {
-                            setVarIdClassFunction(tok2, tok3->next()->link(), varlist, &structMembers, &_varId);
-                        }
+                    if (Token::simpleMatch(tok3, ") {")) {
+                        setVarIdClassFunction(tok2, tok3->next()->link(), varlist, &structMembers, &_varId);
                     }
                 }
             }
@@ -3631,30 +3765,8 @@ bool Tokenizer::simplifyTokenList()
 
     simplifyIfAndWhileAssign(); // Could be affected by simplifyIfNot
 
-    bool modified = true;
-    while (modified) {
-        if (_settings && _settings->terminated())
-            return false;
-
-        modified = false;
-        modified |= simplifyConditions();
-        modified |= simplifyFunctionReturn();
-        modified |= simplifyKnownVariables();
-
-        // replace strlen(str)
-        for (Token *tok = list.front(); tok; tok = tok->next()) {
-            if (Token::Match(tok, "strlen ( %str% )")) {
-                tok->str(MathLib::longToString(Token::getStrLength(tok->tokAt(2))));
-                tok->deleteNext(3);
-                modified = true;
-            }
-        }
-
-        modified |= removeRedundantConditions();
-        modified |= simplifyRedundantParentheses();
-        modified |= simplifyConstTernaryOp();
-        modified |= simplifyCalculations();
-    }
+    if (!simplifyUntilUnchanged())
+        return false;
 
     simplifyConditionOperator();
 
@@ -3718,6 +3830,136 @@ bool Tokenizer::simplifyTokenList()
 }
 //---------------------------------------------------------------------------
 
+static bool isFunctionBodyStart(const Token *tok)
+{
+    return tok->str() == "{" && (Token::simpleMatch(tok->previous(), ")") || Token::simpleMatch(tok->tokAt(-2), ") const"));
+}
+
+/** Get the function bodies that are in the given set, in token list order */
+static void getScopes(Token *front, const std::set<const Token *> &scopes, std::vector<Token *> &bodies)
+{
+    bodies.clear();
+    for (Token *tok = front; tok; tok = tok->next()) {
+        if (tok->str() == "{" && isFunctionBodyStart(tok)) {
+            if (scopes.find(tok) != scopes.end())
+                bodies.push_back(tok);
+            tok = tok->link();
+        }
+    }
+}
+
+bool Tokenizer::simplifyScopes(SimplifyFunction simplify, const std::set<const Token *> *scopes)
+{
+    if (!scopes)
+        return (this->*simplify)(list.front(), NULL);
+
+    // The function bodies are looked up again for each simplification
+    // since the previous one might have removed some of them.
+    bool ret = false;
+    std::vector<Token *> bodies;
+    getScopes(list.front(), *scopes, bodies);
+    for (std::vector<Token *>::const_iterator it = bodies.begin(); it != bodies.end(); ++it)
+        ret |= (this->*simplify)(*it, (*it)->link());
+    return ret;
+}
+
+bool Tokenizer::findChangedScopes(std::set<const Token *> &scopes, std::size_t &scopeTokens)
+{
+    bool changedOutside = false;
+    scopes.clear();
+    scopeTokens = 0;
+
+    const Token *scopeStart = NULL;
+    std::size_t tokens = 0;
+    bool changed = false;
+    for (Token *tok = list.front(); tok; tok = tok->next()) {
+        if (!scopeStart && tok->str() == "{" && isFunctionBodyStart(tok)) {
+            scopeStart = tok;
+            tokens = 0;
+            changed = false;
+        }
+
+        if (tok->isChanged()) {
+            tok->isChanged(false);
+            if (scopeStart)
+                changed = true;
+            else
+                changedOutside = true;
+        }
+
+        if (scopeStart) {
+            ++tokens;
+            if (tok == scopeStart->link()) {
+                if (changed) {
+                    scopes.insert(scopeStart);
+                    scopeTokens += tokens;
+                }
+                scopeStart = NULL;
+            }
+        }
+    }
+
+    return changedOutside;
+}
+
+bool Tokenizer::simplifyUntilUnchanged()
+{
+    // Clear the changed flags, the first iteration simplifies all code
+    std::set<const Token *> changedScopes;
+    std::size_t scopeTokens = 0;
+    findChangedScopes(changedScopes, scopeTokens);
+    bool all = true;
+
+    bool modified = true;
+    while (modified) {
+        if (_settings && _settings->terminated())
+            return false;
+
+        if (m_simplifyStats) {
+            std::size_t tokens = 0;
+            for (const Token *tok = list.front(); tok; tok = tok->next())
+                ++tokens;
+            ++m_simplifyStats->iterations;
+            m_simplifyStats->tokensVisited += all ? tokens : scopeTokens;
+            m_simplifyStats->tokensTotal += tokens;
+        }
+
+        const std::set<const Token *> *scopes = all ? NULL : &changedScopes;
+        modified = false;
+        modified |= simplifyScopes(&Tokenizer::simplifyConditions, scopes);
+        modified |= simplifyFunctionReturn();
+        modified |= simplifyScopes(&Tokenizer::simplifyKnownVariables, scopes);
+        modified |= simplifyScopes(&Tokenizer::simplifyStrlen, scopes);
+        modified |= simplifyScopes(&Tokenizer::removeRedundantConditions, scopes);
+        modified |= simplifyScopes(&Tokenizer::simplifyRedundantParentheses, scopes);
+        modified |= simplifyScopes(&Tokenizer::simplifyConstTernaryOp, scopes);
+        modified |= simplifyScopes(&Tokenizer::simplifyCalculations, scopes);
+
+        // Only the function bodies that are changed by this iteration
+        // can be simplified more. If there are changes outside of the
+        // function bodies, everything is simplified again.
+        all = findChangedScopes(changedScopes, scopeTokens);
+    }
+
+    return true;
+}
+
+bool Tokenizer::simplifyStrlen(Token *tokBegin, const Token *tokEnd)
+{
+    // replace strlen(str)
+    bool ret = false;
+    for (Token *tok = tokBegin; tok && tok != tokEnd; tok = tok->next()) {
+        if (Token::Match(tok, "strlen ( %str% )")) {
+            tok->str(MathLib::longToString(Token::getStrLength(tok->tokAt(2))));
+            tok->deleteNext(3);
+            ret = true;
+        }
+    }
+    return ret;
+}
+
+//---------------------------------------------------------------------------
+
 void Tokenizer::removeMacrosInGlobalScope()
 {
     for (Token *tok = list.front(); tok; tok = tok->next()) {
@@ -4009,11 +4251,16 @@ void Tokenizer::simplifyFlowControl()
 
 
 bool Tokenizer::removeRedundantConditions()
+{
+    return removeRedundantConditions(list.front(), NULL);
+}
+
+bool Tokenizer::removeRedundantConditions(Token *tokBegin, const Token *tokEnd)
 {
     // Return value for function. Set to true if there are any simplifications
     bool ret = false;
 
-    for (Token *tok = list.front(); tok; tok = tok->next()) {
+    for (Token *tok = tokBegin; tok && tok != tokEnd; tok = tok->next()) {
         if (tok->str() != "if")
             continue;
 
@@ -4093,8 +4340,8 @@ void Tokenizer::removeRedundantFor()
                 continue;
 
             // Check that the difference of the numeric values is 1
-            const MathLib::bigint num1(MathLib::toLongNumber(tok->strAt(5)));
-            const MathLib::bigint num2(MathLib::toLongNumber(tok->strAt(9)));
+            const MathLib::bigint num1(tok->tokAt(5)->number().getInt());
+            const MathLib::bigint num2(tok->tokAt(9)->number().getInt());
             if (num1 + 1 != num2)
                 continue;
 
@@ -4510,10 +4757,15 @@ void Tokenizer::simplifyConditionOperator()
 }
 
 bool Tokenizer::simplifyConditions()
+{
+    return simplifyConditions(list.front(), NULL);
+}
+
+bool Tokenizer::simplifyConditions(Token *tokBegin, const Token *tokEnd)
 {
     bool ret = false;
 
-    for (Token *tok = list.front(); tok; tok = tok->next()) {
+    for (Token *tok = tokBegin; tok && tok != tokEnd; tok = tok->next()) {
         if (Token::Match(tok, "! %bool%|%num%")) {
             tok->deleteThis();
             if (tok->str() == "0" || tok->str() == "false")
@@ -4600,8 +4852,8 @@ bool Tokenizer::simplifyConditions()
                     const std::string& op2(tok->strAt(3));
 
                     bool eq = false;
-                    if (MathLib::isInt(op1) && MathLib::isInt(op2))
-                        eq = (MathLib::toLongNumber(op1) == MathLib::toLongNumber(op2));
+                    if (tok->next()->number().isInt() && tok->tokAt(3)->number().isInt())
+                        eq = (tok->next()->number().getInt() == tok->tokAt(3)->number().getInt());
                     else
                         eq = (op1 == op2);
 
@@ -4658,9 +4910,14 @@ bool Tokenizer::simplifyConditions()
 }
 
 bool Tokenizer::simplifyConstTernaryOp()
+{
+    return simplifyConstTernaryOp(list.front(), NULL);
+}
+
+bool Tokenizer::simplifyConstTernaryOp(Token *tokBegin, const Token *tokEnd)
 {
     bool ret = false;
-    for (Token *tok = list.front(); tok; tok = tok->next()) {
+    for (Token *tok = tokBegin; tok && tok != tokEnd; tok = tok->next()) {
         if (tok->str() != "?")
             continue;
 
@@ -4780,7 +5037,7 @@ void Tokenizer::simplifyCasts()
         }
         // #4164 : ((unsigned char)1) => (1)
         if (Token::Match(tok->next(), "( unsigned| %type% ) %num%") && tok->next()->link()->previous()->isStandardType()) {
-            const MathLib::bigint value = MathLib::toLongNumber(tok->next()->link()->next()->str());
+            const MathLib::bigint value = tok->next()->link()->next()->number().getInt();
             unsigned int bits = 8 * _typeSize[tok->next()->link()->previous()->str()];
             if (!tok->tokAt(2)->isUnsigned())
                 bits--;
@@ -5151,7 +5408,7 @@ void Tokenizer::simplifyVarDecl(Token * tokBegin, Token * tokEnd, bool only_k_r_
     // Split up variable declarations..
     // "int a=4;" => "int a; a=4;"
     bool finishedwithkr = true;
-    for (Token *tok = tokBegin; tok != tokEnd; tok = tok->next()) {
+    for (Token *tok = tokBegin; tok && tok != tokEnd; tok = tok->next()) {
         if (Token::simpleMatch(tok, "= {")) {
             tok = tok->next()->link();
         }
@@ -6125,6 +6382,11 @@ Token * Tokenizer::initVar(Token * tok)
 
 
 bool Tokenizer::simplifyKnownVariables()
+{
+    return simplifyKnownVariables(list.front(), NULL);
+}
+
+bool Tokenizer::simplifyKnownVariables(Token *tokBegin, const Token *tokEnd)
 {
     // return value for function. Set to true if any simplifications are made
     bool ret = false;
@@ -6133,7 +6395,7 @@ bool Tokenizer::simplifyKnownVariables()
     {
         std::map<unsigned int, std::string> constantValues;
         bool goback = false;
-        for (Token *tok = list.front(); tok; tok = tok->next()) {
+        for (Token *tok = tokBegin; tok && tok != tokEnd; tok = tok->next()) {
             if (goback) {
                 tok = tok->previous();
                 goback = false;
@@ -6225,9 +6487,9 @@ bool Tokenizer::simplifyKnownVariables()
     std::set<unsigned int> floatvars;
 
     // auto variables..
-    for (Token *tok = list.front(); tok; tok = tok->next()) {
+    for (Token *tok = tokBegin; tok && tok != tokEnd; tok = tok->next()) {
         // Search for a block of code
-        if (! Token::Match(tok, ") const| {"))
+        if (! Token::Match(tok, ") const| {") && !(tok == tokBegin && tok->str() == "{"))
             continue;
 
         // parse the block of code..
@@ -6869,9 +7131,14 @@ void Tokenizer::elseif()
 
 
 bool Tokenizer::simplifyRedundantParentheses()
+{
+    return simplifyRedundantParentheses(list.front(), NULL);
+}
+
+bool Tokenizer::simplifyRedundantParentheses(Token *tokBegin, const Token *tokEnd)
 {
     bool ret = false;
-    for (Token *tok = list.front(); tok; tok = tok->next()) {
+    for (Token *tok = tokBegin; tok && tok != tokEnd; tok = tok->next()) {
         if (tok->str() != "(")
             continue;
 
@@ -6998,7 +7265,7 @@ void Tokenizer::simplifyCharAt()
     // Replace "string"[0] with 's'
     for (Token *tok = list.front(); tok; tok = tok->next()) {
         if (Token::Match(tok, "%str% [ %num% ]")) {
-            const MathLib::bigint index = MathLib::toLongNumber(tok->strAt(2));
+            const MathLib::bigint index = tok->tokAt(2)->number().getInt();
             // Check within range
             if (index >= 0 && index <= (MathLib::bigint)Token::getStrLength(tok)) {
                 tok->str(std::string("'" + Token::getCharAt(tok, (size_t)index) + "'"));
@@ -7047,6 +7314,11 @@ bool Tokenizer::simplifyCalculations()
     return TemplateSimplifier::simplifyCalculations(list.front());
 }
 
+bool Tokenizer::simplifyCalculations(Token *tokBegin, const Token *tokEnd)
+{
+    return TemplateSimplifier::simplifyCalculations(tokBegin, tokEnd);
+}
+
 void Tokenizer::simplifyOffsetPointerDereference()
 {
     // Replace "*(str + num)" => "str[num]" and
@@ -9545,7 +9817,7 @@ void Tokenizer::createSymbolDatabase()
         _symbolDatabase = new SymbolDatabase(this, _settings, _errorLogger);
 
         // Set scope pointers
-        for (std::list<Scope>::iterator scope = _symbolDatabase->scopeList.begin(); scope != _symbolDatabase->scopeList.end(); ++scope) {
+        for (StableVector<Scope>::iterator scope = _symbolDatabase->scopeList.begin(); scope != _symbolDatabase->scopeList.end(); ++scope) {
             Token* start = const_cast<Token*>(scope->classStart);
             Token* end = const_cast<Token*>(scope->classEnd);
             if (scope->type == Scope::eGlobal) {
@@ -9560,7 +9832,7 @@ void Tokenizer::createSymbolDatabase()
                 for (Token* tok = start->next(); tok != end; tok = tok->next()) {
                     if (tok->str() == "{") {
                         bool break2 = false;
-                        for (std::list<Scope*>::const_iterator innerScope = scope->nestedList.begin(); innerScope != scope->nestedList.end(); ++innerScope) {
+                        for (std::vector<Scope*>::const_iterator innerScope = scope->nestedList.begin(); innerScope != scope->nestedList.end(); ++innerScope) {
                             if (tok == (*innerScope)->classStart) { // Is begin of inner scope
                                 tok = tok->link();
                                 if (!tok || tok->next() == end || !tok->next()) {
@@ -29,10 +29,11 @@
 #include <string>
 #include <map>
 #include <list>
+#include <set>
 
 class Settings;
 class SymbolDatabase;
-class TimerResults;
+class TimerResultsIntf;
 
 /// @addtogroup Core
 /// @{
@@ -44,10 +45,34 @@ public:
     Tokenizer(const Settings * settings, ErrorLogger *errorLogger);
     ~Tokenizer();
 
-    void setTimerResults(TimerResults *tr) {
+    void setTimerResults(TimerResultsIntf *tr) {
         m_timerResults = tr;
     }
 
+    /** The token allocation statistics are added to the given stats when the tokenizer is destroyed */
+    void setTokenStats(TokenArena::Stats *stats) {
+        m_tokenStats = stats;
+    }
+
+    /** @brief Statistics of the simplification loop in simplifyTokenList(), shown by --showtime */
+    struct SimplifyStats {
+        SimplifyStats() : iterations(0), tokensVisited(0), tokensTotal(0) { }
+
+        /** Number of iterations of the simplification loop */
+        std::size_t iterations;
+
+        /** Tokens that each simplification visited, summed over the iterations */
+        std::size_t tokensVisited;
+
+        /** Tokens in the token list, summed over the iterations */
+        std::size_t tokensTotal;
+    };
+
+    /** The statistics of the simplification loop are added to the given stats */
+    void setSimplifyStats(SimplifyStats *stats) {
+        m_simplifyStats = stats;
+    }
+
     /** Returns the source file path. e.g. "file.cpp" */
     const std::string& getSourceFilePath() const;
 
@@ -165,6 +190,7 @@ public:
      *         false if no modifications are done.
      */
     bool simplifyCalculations();
+    bool simplifyCalculations(Token *tokBegin, const Token *tokEnd);
 
     /**
      * Simplify dereferencing a pointer offset by a number:
@@ -238,6 +264,7 @@ public:
      *         false if nothing is done.
      */
     bool simplifyConstTernaryOp();
+    bool simplifyConstTernaryOp(Token *tokBegin, const Token *tokEnd);
 
     /**
      * Simplify compound assignments
@@ -342,6 +369,12 @@ public:
      */
     bool simplifyKnownVariables();
 
+    /**
+     * Replace known variables in the tokens from tokBegin to tokEnd. If
+     * tokBegin is a "{" it is handled as the start of a function body.
+     */
+    bool simplifyKnownVariables(Token *tokBegin, const Token *tokEnd);
+
     /**
      * Utility function for simplifyKnownVariables. Get data about an
      * assigned variable.
@@ -381,6 +414,7 @@ public:
      *         false if nothing is done.
      */
     bool simplifyConditions();
+    bool simplifyConditions(Token *tokBegin, const Token *tokEnd);
 
     /** Remove redundant code, e.g. if( false ) { int a; } should be
      * removed, because it is never executed.
@@ -388,6 +422,7 @@ public:
      *         false if nothing is done.
      */
     bool removeRedundantConditions();
+    bool removeRedundantConditions(Token *tokBegin, const Token *tokEnd);
 
     /**
      * Remove redundant for:
@@ -426,6 +461,7 @@ public:
      *         false if no modifications are done.
      */
     bool simplifyRedundantParentheses();
+    bool simplifyRedundantParentheses(Token *tokBegin, const Token *tokEnd);
 
     void simplifyCharAt();
 
@@ -766,6 +802,37 @@ private:
     /** Disable assignment operator, no implementation */
     Tokenizer &operator=(const Tokenizer &);
 
+    /**
+     * Run the simplifications that enable each other until nothing
+     * changes. After the first iteration only the function bodies that
+     * contain changed tokens are simplified again.
+     * @return false if the checking is terminated
+     */
+    bool simplifyUntilUnchanged();
+
+    /**
+     * Find the function bodies that contain changed tokens and clear the
+     * changed flags of all tokens.
+     * @param scopes the "{" of the changed function bodies
+     * @param scopeTokens number of tokens in the changed function bodies
+     * @return true if there are changed tokens outside function bodies
+     */
+    bool findChangedScopes(std::set<const Token *> &scopes, std::size_t &scopeTokens);
+
+    /** A simplification of the tokens from tokBegin to tokEnd */
+    typedef bool (Tokenizer::*SimplifyFunction)(Token *tokBegin, const Token *tokEnd);
+
+    /**
+     * Run a simplification on the given function bodies
+     * @param simplify the simplification
+     * @param scopes the "{" of the function bodies, NULL for the whole token list
+     * @return true if something is modified
+     */
+    bool simplifyScopes(SimplifyFunction simplify, const std::set<const Token *> *scopes);
+
+    /** Replace strlen(str) */
+    bool simplifyStrlen(Token *tokBegin, const Token *tokEnd);
+
     /** settings */
     const Settings * _settings;
 
@@ -794,7 +861,13 @@ private:
     /**
      * TimerResults
      */
-    TimerResults *m_timerResults;
+    TimerResultsIntf *m_timerResults;
+
+    /** Token allocation statistics (--showtime) */
+    TokenArena::Stats *m_tokenStats;
+
+    /** Statistics of the simplification loop, if they are wanted */
+    SimplifyStats *m_simplifyStats;
 
 };
 
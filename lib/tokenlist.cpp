@@ -23,13 +23,134 @@
 #include "preprocessor.h"
 #include "settings.h"
 #include "errorlogger.h"
+#include "utils.h"
 
+#include <algorithm>
 #include <cstring>
 #include <sstream>
 #include <cctype>
 #include <stack>
 
 
+/** Number of tokens in the first slab. Small lists (macros etc) should not allocate much memory. */
+static const std::size_t FIRST_SLAB_SIZE = 16U;
+
+/** The slab size is doubled up to this number of tokens */
+static const std::size_t MAX_SLAB_SIZE = 1024U;
+
+TokenArena::Stats::Stats() :
+    tokens(0),
+    reused(0),
+    slabs(0),
+    strings(0),
+    bytes(0)
+{
+}
+
+TokenArena::Stats &TokenArena::Stats::operator+=(const Stats &other)
+{
+    tokens += other.tokens;
+    reused += other.reused;
+    slabs += other.slabs;
+    strings += other.strings;
+    bytes += other.bytes;
+    return *this;
+}
+
+TokenArena::TokenArena() :
+    _slabSize(0),
+    _slabUsed(0),
+    _freeList(0)
+{
+}
+
+TokenArena::~TokenArena()
+{
+    clear();
+}
+
+void *TokenArena::allocate()
+{
+    ++_stats.tokens;
+
+    if (_freeList) {
+        ++_stats.reused;
+        void *p = _freeList;
+        _freeList = *static_cast<void **>(p);
+        return p;
+    }
+
+    if (_slabUsed == _slabSize) {
+        _slabSize = (_slabSize == 0) ? FIRST_SLAB_SIZE : std::min(_slabSize * 2U, MAX_SLAB_SIZE);
+        _slabs.push_back(static_cast<char *>(::operator new(_slabSize * sizeof(Token))));
+        _slabUsed = 0;
+        ++_stats.slabs;
+        _stats.bytes += _slabSize * sizeof(Token);
+    }
+
+    return _slabs.back() + sizeof(Token) * _slabUsed++;
+}
+
+void TokenArena::deallocate(void *p)
+{
+    *static_cast<void **>(p) = _freeList;
+    _freeList = p;
+}
+
+/** FNV-1a hash of a token string */
+static std::size_t hashString(const std::string &str)
+{
+    return static_cast<std::size_t>(fnv1a(FNV1A_OFFSET_BASIS, str));
+}
+
+void TokenArena::rehash(std::size_t size)
+{
+    _table.assign(size, static_cast<const Entry *>(0));
+    for (std::deque<Entry>::const_iterator it = _strings.begin(); it != _strings.end(); ++it) {
+        std::size_t i = hashString(it->str) & (size - 1U);
+        while (_table[i])
+            i = (i + 1U) & (size - 1U);
+        _table[i] = &*it;
+    }
+}
+
+const std::string *TokenArena::intern(const std::string &str, Token::StrId &id)
+{
+    // Keep the hash table at most half full
+    if (_strings.size() * 2U >= _table.size())
+        rehash(_table.empty() ? 64U : _table.size() * 2U);
+
+    const std::size_t mask = _table.size() - 1U;
+    for (std::size_t i = hashString(str) & mask;; i = (i + 1U) & mask) {
+        if (!_table[i]) {
+            Entry entry;
+            entry.str = str;
+            entry.id = Token::getStrId(str);
+            _strings.push_back(entry);
+            _table[i] = &_strings.back();
+            ++_stats.strings;
+            _stats.bytes += str.capacity();
+        } else if (_table[i]->str != str) {
+            continue;
+        }
+        id = _table[i]->id;
+        return &_table[i]->str;
+    }
+}
+
+void TokenArena::clear()
+{
+    // Tokens in the arena don't own any memory, they are not destroyed one by one
+    for (std::vector<char *>::const_iterator it = _slabs.begin(); it != _slabs.end(); ++it)
+        ::operator delete(*it);
+    _slabs.clear();
+    _slabSize = 0;
+    _slabUsed = 0;
+    _freeList = 0;
+    _strings.clear();
+    _table.clear();
+}
+
 TokenList::TokenList(const Settings* settings) :
     _front(0),
     _back(0),
@@ -49,15 +170,16 @@ TokenList::~TokenList()
 // Deallocate lists..
 void TokenList::deallocateTokens()
 {
-    deleteTokens(_front);
     _front = 0;
     _back = 0;
 
     //ds clean up all tokens
-    deleteTokens( m_pcCustomTokenFront );
     m_pcCustomTokenFront = 0;
     m_pcCustomTokenBack = 0;
 
+    // All tokens are released together
+    _arena.clear();
+
     _files.clear();
 }
 
@@ -65,7 +187,7 @@ void TokenList::deleteTokens(Token *tok)
 {
     while (tok) {
         Token *next = tok->next();
-        delete tok;
+        Token::destroy(tok);
         tok = next;
     }
 }
@@ -108,7 +230,7 @@ void TokenList::addtoken(const char str[], const unsigned int lineno, const unsi
     if (_back) {
         _back->insertToken(str2.str());
     } else {
-        _front = new Token(&_back);
+        _front = Token::create(&_back, &_arena);
         _back = _front;
         _back->str(str2.str());
     }
@@ -125,7 +247,7 @@ void TokenList::addtoken(const Token * tok, const unsigned int lineno, const uns
     if (_back) {
         _back->insertToken(tok->str());
     } else {
-        _front = new Token(&_back);
+        _front = Token::create(&_back, &_arena);
         _back = _front;
         _back->str(tok->str());
     }
@@ -172,7 +294,7 @@ void TokenList::addCustomToken( const std::string& p_strToken, const unsigned in
     else
     {
         //ds if back is not set yet create a new token
-        m_pcCustomTokenFront = new Token( &m_pcCustomTokenBack );
+        m_pcCustomTokenFront = Token::create( &m_pcCustomTokenBack, &_arena );
 
         //ds link back to it
         m_pcCustomTokenBack = m_pcCustomTokenFront;
@@ -22,6 +22,8 @@
 #define tokenlistH
 //---------------------------------------------------------------------------
 
+#include <cstddef>
+#include <deque>
 #include <string>
 #include <vector>
 #include "config.h"
@@ -33,6 +35,88 @@ class Settings;
 /// @addtogroup Core
 /// @{
 
+/**
+ * @brief Storage for the tokens of a TokenList.
+ *
+ * Tokens are allocated from big slabs and the memory of deleted tokens is
+ * reused. All memory is released at once when the token list is
+ * deallocated. Token strings are interned so tokens with the same string
+ * share the storage.
+ */
+class CPPCHECKLIB TokenArena {
+public:
+    /** @brief Allocation statistics, shown by --showtime */
+    struct CPPCHECKLIB Stats {
+        Stats();
+        Stats &operator+=(const Stats &other);
+
+        /** Number of allocated tokens */
+        std::size_t tokens;
+        /** Number of token allocations that reused a deleted token */
+        std::size_t reused;
+        /** Number of allocated slabs */
+        std::size_t slabs;
+        /** Number of different token strings */
+        std::size_t strings;
+        /** Bytes allocated for slabs and strings */
+        std::size_t bytes;
+    };
+
+    TokenArena();
+    ~TokenArena();
+
+    /** Allocate memory for one token */
+    void *allocate();
+
+    /** Reuse the memory of a token that has been destroyed */
+    void deallocate(void *p);
+
+    /** Get the shared copy of a string and its fixed id */
+    const std::string *intern(const std::string &str, Token::StrId &id);
+
+    /** Release all tokens and strings */
+    void clear();
+
+    const Stats &stats() const {
+        return _stats;
+    }
+
+private:
+    /** Disable copy constructor, no implementation */
+    TokenArena(const TokenArena &);
+
+    /** Disable assignment operator, no implementation */
+    TokenArena &operator=(const TokenArena &);
+
+    void rehash(std::size_t size);
+
+    /** Memory blocks that tokens are allocated from */
+    std::vector<char *> _slabs;
+
+    /** Number of tokens in the last slab */
+    std::size_t _slabSize;
+
+    /** Number of tokens that are allocated from the last slab */
+    std::size_t _slabUsed;
+
+    /** Deleted tokens, linked through their first bytes */
+    void *_freeList;
+
+    /** Interned string. The fixed id is looked up once per string. */
+    struct Entry {
+        std::string str;
+        Token::StrId id;
+    };
+
+    /** Interned strings. A deque does not move its elements. */
+    std::deque<Entry> _strings;
+
+    /** Open addressing hash table of the interned strings */
+    std::vector<const Entry *> _table;
+
+    Stats _stats;
+};
+
 class CPPCHECKLIB TokenList {
 public:
     TokenList(const Settings* settings);
@@ -73,6 +157,11 @@ public:
     /** Deallocate list */
     void deallocateTokens();
 
+    /** Allocation statistics for the tokens of this list */
+    const TokenArena::Stats &arenaStats() const {
+        return _arena.stats();
+    }
+
     /** get first token of list */
     const Token *front() const {
         return _front;
@@ -130,6 +219,9 @@ private:
 public:
 
 private: /// private
+    /** Storage for the tokens. Declared first so it is destroyed last. */
+    TokenArena _arena;
+
     /** Token list */
     Token *_front, *_back;
 
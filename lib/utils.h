@@ -0,0 +1,48 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2013 Daniel Marjamäki and Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//---------------------------------------------------------------------------
+#ifndef utilsH
+#define utilsH
+//---------------------------------------------------------------------------
+
+#include <string>
+
+/** Start value of a 64 bit FNV-1a hash */
+static const unsigned long long FNV1A_OFFSET_BASIS = 14695981039346656037ULL;
+
+/** Continue the FNV-1a hash \p hash with the characters of \p str */
+inline unsigned long long fnv1a(unsigned long long hash, const std::string &str)
+{
+    for (std::string::size_type i = 0; i < str.size(); ++i) {
+        hash ^= (unsigned char)str[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/** Continue the FNV-1a hash \p hash with the number \p value as one unit */
+inline unsigned long long fnv1aValue(unsigned long long hash, unsigned long long value)
+{
+    hash ^= value;
+    hash *= 1099511628211ULL;
+    return hash;
+}
+
+//---------------------------------------------------------------------------
+#endif // utilsH
@@ -88,15 +88,21 @@ private:
         TEST_CASE(jobs);
         TEST_CASE(jobsMissingCount);
         TEST_CASE(jobsInvalid);
+        TEST_CASE(checkThreads);
+        TEST_CASE(checkThreadsInvalid);
         TEST_CASE(maxConfigs);
         TEST_CASE(maxConfigsMissingCount);
         TEST_CASE(maxConfigsInvalid);
         TEST_CASE(maxConfigsTooSmall);
+        TEST_CASE(maxExecutionPaths);
+        TEST_CASE(maxExecutionPathsInvalid);
         TEST_CASE(reportProgressTest); // "Test" suffix to avoid hiding the parent's reportProgress
         TEST_CASE(stdposix);
         TEST_CASE(stdc99);
         TEST_CASE(stdcpp11);
         TEST_CASE(platform);
+        TEST_CASE(profileOut);
+        TEST_CASE(profileOutEmpty);
         TEST_CASE(suppressionsOld); // TODO: Create and test real suppression file
         TEST_CASE(suppressions);
         TEST_CASE(suppressionsNoFile);
@@ -117,6 +123,7 @@ private:
         TEST_CASE(xmlverinvalid);
         TEST_CASE(doc);
         TEST_CASE(showtime);
+        TEST_CASE(showtimeJson);
         TEST_CASE(errorlist1);
         TEST_CASE(errorlistverbose1);
         TEST_CASE(errorlistverbose2);
@@ -640,6 +647,21 @@ private:
         ASSERT_EQUALS(false, defParser.ParseFromArgs(4, argv));
     }
 
+    void checkThreads() {
+        REDIRECT;
+        const char *argv[] = {"cppcheck", "--check-threads=4", "file.cpp"};
+        settings._checkThreads = 1;
+        ASSERT(defParser.ParseFromArgs(3, argv));
+        ASSERT_EQUALS(4, settings._checkThreads);
+    }
+
+    void checkThreadsInvalid() {
+        REDIRECT;
+        const char *argv[] = {"cppcheck", "--check-threads=0", "file.cpp"};
+        // Fails since at least one thread is needed
+        ASSERT_EQUALS(false, defParser.ParseFromArgs(3, argv));
+    }
+
     void maxConfigs() {
         REDIRECT;
         const char *argv[] = {"cppcheck", "-f", "--max-configs=12", "file.cpp"};
@@ -671,6 +693,21 @@ private:
         ASSERT_EQUALS(false, defParser.ParseFromArgs(3, argv));
     }
 
+    void maxExecutionPaths() {
+        REDIRECT;
+        const char *argv[] = {"cppcheck", "--max-execution-paths=50", "file.cpp"};
+        settings.maxExecutionPaths = 10;
+        ASSERT(defParser.ParseFromArgs(3, argv));
+        ASSERT_EQUALS(50, settings.maxExecutionPaths);
+    }
+
+    void maxExecutionPathsInvalid() {
+        REDIRECT;
+        const char *argv[] = {"cppcheck", "--max-execution-paths=0", "file.cpp"};
+        // Fails since the limit must be greater than 0
+        ASSERT_EQUALS(false, defParser.ParseFromArgs(3, argv));
+    }
+
     void reportProgressTest() {
         REDIRECT;
         const char *argv[] = {"cppcheck", "--report-progress", "file.cpp"};
@@ -711,6 +748,22 @@ private:
         ASSERT(settings.platformType == Settings::Win64);
     }
 
+    void profileOut() {
+        REDIRECT;
+        const char *argv[] = {"cppcheck", "--profile-out=profile.json", "file.cpp"};
+        settings.profileOut.clear();
+        ASSERT(defParser.ParseFromArgs(3, argv));
+        ASSERT_EQUALS("profile.json", settings.profileOut);
+        settings.profileOut.clear();
+    }
+
+    void profileOutEmpty() {
+        REDIRECT;
+        const char *argv[] = {"cppcheck", "--profile-out=", "file.cpp"};
+        // Fails since no file name is given
+        ASSERT_EQUALS(false, defParser.ParseFromArgs(3, argv));
+    }
+
     void suppressionsOld() {
         // TODO: Fails because there is no suppr.txt file!
         REDIRECT;
@@ -894,6 +947,14 @@ private:
         ASSERT(settings._showtime == SHOWTIME_SUMMARY);
     }
 
+    void showtimeJson() {
+        REDIRECT;
+        const char *argv[] = {"cppcheck", "--showtime=json"};
+        settings._showtime = SHOWTIME_NONE;
+        ASSERT(defParser.ParseFromArgs(2, argv));
+        ASSERT(settings._showtime == SHOWTIME_JSON);
+    }
+
     void errorlist1() {
         REDIRECT;
         const char *argv[] = {"cppcheck", "--errorlist"};
@@ -25,11 +25,23 @@
 #include "cppcheckexecutor.h"
 #include "testsuite.h"
 #include "path.h"
+#include "summarydatabase.h"
 
 #include <algorithm>
+#include <cstdio>
+#include <fstream>
 #include <list>
+#include <sstream>
 #include <string>
 
+#ifdef _WIN32
+#include <direct.h>
+#include <process.h>
+#else
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 extern std::ostringstream errout;
 extern std::ostringstream output;
 
@@ -56,6 +68,12 @@ private:
         TEST_CASE(instancesSorted);
         TEST_CASE(classInfoFormat);
         TEST_CASE(getErrorMessages);
+        TEST_CASE(identicalConfigurations);
+        TEST_CASE(identicalConfigurationsMaxConfigs);
+        TEST_CASE(cacheDir);
+        TEST_CASE(checkThreads);
+        TEST_CASE(summaries);
+        TEST_CASE(profile);
     }
 
     void instancesSorted() const {
@@ -98,6 +116,227 @@ private:
         }
         ASSERT_EQUALS("", duplicate);
     }
+
+    void identicalConfigurations() const {
+        // Both configurations give the same code => it is only checked once
+        ErrorLogger2 errorLogger;
+        CppCheck cppCheck(errorLogger, true);
+        cppCheck.check("test.cpp",
+                       "#ifdef A\n"
+                       "#endif\n"
+                       "void f() {\n");
+        ASSERT_EQUALS(1, (int)std::count(errorLogger.id.begin(), errorLogger.id.end(), "syntaxError"));
+    }
+
+    void identicalConfigurationsMaxConfigs() const {
+        // The configuration A gives the same code as the default configuration,
+        // it is not counted and B is checked too
+        ErrorLogger2 errorLogger;
+        CppCheck cppCheck(errorLogger, true);
+        cppCheck.settings()._maxConfigs = 2;
+        cppCheck.check("test.cpp",
+                       "#ifdef A\n"
+                       "#endif\n"
+                       "#ifdef B\n"
+                       "void f() {\n"
+                       "#endif\n");
+        ASSERT_EQUALS(1, (int)std::count(errorLogger.id.begin(), errorLogger.id.end(), "syntaxError"));
+    }
+
+    /** @brief Create an empty directory that only this test process uses */
+    static std::string createTempDir(const char name[]) {
+        std::ostringstream ostr;
+#ifdef _WIN32
+        ostr << name << '-' << _getpid();
+        _mkdir(ostr.str().c_str());
+#else
+        ostr << name << '-' << getpid();
+        mkdir(ostr.str().c_str(), 0700);
+#endif
+        return ostr.str();
+    }
+
+    /** @brief Remove the given files and the directory */
+    static void removeTempDir(const std::string &dir, const std::list<std::string> &files) {
+        for (std::list<std::string>::const_iterator it = files.begin(); it != files.end(); ++it)
+            std::remove(it->c_str());
+#ifdef _WIN32
+        _rmdir(dir.c_str());
+#else
+        rmdir(dir.c_str());
+#endif
+    }
+
+    void cacheDir() const {
+        const char code[] = "void f ( ) {\n"
+                            "char * p ; p = malloc ( 10 ) ;\n"
+                            "}\n";
+        const std::string dir = createTempDir("cachetest");
+
+        // First check writes the results to the cache
+        ErrorLogger2 errorLogger1;
+        CppCheck cppCheck1(errorLogger1, true);
+        cppCheck1.settings().cacheDir = dir;
+        cppCheck1.check("cachetest.cpp", code);
+
+        // Second check reads the results from the cache
+        ErrorLogger2 errorLogger2;
+        CppCheck cppCheck2(errorLogger2, true);
+        cppCheck2.settings().cacheDir = dir;
+        cppCheck2.check("cachetest.cpp", code);
+
+        // Other settings => the cached results are not used
+        ErrorLogger2 errorLogger3;
+        CppCheck cppCheck3(errorLogger3, true);
+        cppCheck3.settings().cacheDir = dir;
+        cppCheck3.settings().inconclusive = true;
+        cppCheck3.check("cachetest.cpp", code);
+        std::list<std::string> files;
+        files.push_back(cppCheck2.cacheFileName(code, "cachetest.cpp"));
+        files.push_back(cppCheck3.cacheFileName(code, "cachetest.cpp"));
+        const bool cacheFileExists = std::ifstream(files.front().c_str()).is_open();
+        removeTempDir(dir, files);
+
+        ASSERT_EQUALS(0U, cppCheck1.cacheHits());
+        ASSERT_EQUALS(1U, cppCheck1.cacheMisses());
+        ASSERT_EQUALS(1U, cppCheck2.cacheHits());
+        ASSERT_EQUALS(0U, cppCheck2.cacheMisses());
+        ASSERT_EQUALS(false, errorLogger2.id.empty());
+        ASSERT_EQUALS(true, errorLogger1.id == errorLogger2.id);
+        ASSERT_EQUALS(0U, cppCheck3.cacheHits());
+        ASSERT_EQUALS(true, cacheFileExists);
+    }
+
+    void checkThreads() const {
+        const char code[] = "void f() {\n"
+                            "    char a[10];\n"
+                            "    char *p = malloc(10);\n"
+                            "    int x;\n"
+                            "    a[10] = x;\n"
+                            "    int *q = 0;\n"
+                            "    *q = 0;\n"
+                            "}\n";
+
+        ErrorLogger2 errorLogger1;
+        CppCheck cppCheck1(errorLogger1, true);
+        cppCheck1.check("test.cpp", code);
+
+        // The same results in the same order when the checks run at the same time
+        ErrorLogger2 errorLogger2;
+        CppCheck cppCheck2(errorLogger2, true);
+        cppCheck2.settings()._checkThreads = 4;
+        cppCheck2.check("test.cpp", code);
+
+        ASSERT_EQUALS(true, errorLogger1.id.size() >= 3U);
+        ASSERT_EQUALS(true, errorLogger1.id == errorLogger2.id);
+    }
+
+    void summaries() const {
+        // add1 reads its argument, this is only known from the other file
+        ErrorLogger2 errorLogger1;
+        CppCheck cppCheck1(errorLogger1, true);
+        std::istringstream istr("int add1(int x) { return x + 1; }");
+        SummaryDatabase db;
+        cppCheck1.analyseFile(istr, "add1.c", db);
+        db.merge();
+        ASSERT_EQUALS(1U, db.size());
+        ASSERT_EQUALS(1U, db.data("Uninitialized variables").count("add1"));
+
+        const char code[] = "void f() {\n"
+                            "    int x;\n"
+                            "    add1(x);\n"
+                            "}\n";
+
+        ErrorLogger2 errorLogger2;
+        CppCheck cppCheck2(errorLogger2, true);
+        cppCheck2.check("f.c", code);
+        ASSERT_EQUALS(0, (int)std::count(errorLogger2.id.begin(), errorLogger2.id.end(), "uninitvar"));
+
+        ErrorLogger2 errorLogger3;
+        CppCheck cppCheck3(errorLogger3, true);
+        cppCheck3.settings().summaries = &db;
+        cppCheck3.check("f.c", code);
+        ASSERT_EQUALS(1, (int)std::count(errorLogger3.id.begin(), errorLogger3.id.end(), "uninitvar"));
+
+        // The records are saved and loaded again
+        const std::string dir = createTempDir("summarytest");
+        const std::list<std::string> files(1, dir + "/summaries");
+        const bool saved = db.save(files.front());
+        SummaryDatabase db2;
+        const bool loaded = db2.load(files.front());
+        removeTempDir(dir, files);
+        ASSERT_EQUALS(true, saved);
+        ASSERT_EQUALS(true, loaded);
+        db2.merge();
+        ASSERT_EQUALS(1U, db2.size());
+        ASSERT_EQUALS(true, db.data("Uninitialized variables") == db2.data("Uninitialized variables"));
+
+        // The data of the checked files is collected
+        ASSERT_EQUALS(true, cppCheck2.takeSummary().empty());
+        ErrorLogger2 errorLogger4;
+        CppCheck cppCheck4(errorLogger4, true);
+        cppCheck4.settings().summaries = &db2;
+        cppCheck4.check("add1.c", "int add1(int x) { return x + 1; }");
+        ASSERT_EQUALS("Uninitialized variables\tadd1\n", cppCheck4.takeSummary());
+        ASSERT_EQUALS(true, cppCheck4.takeSummary().empty());
+
+        // Only the data that the code uses is a part of the cache key
+        SummaryDatabase db3;
+        SummaryDatabase::Record record;
+        record["Uninitialized variables"].insert("add1");
+        db3.addRecord("add1.c", record);
+        record["Uninitialized variables"].insert("sub1");
+        db3.addRecord("sub1.c", record);
+        ASSERT_EQUALS("Uninitialized variables\tadd1\n", db3.usedData(code));
+        cppCheck3.settings().summaries = &db3;
+        const std::string cacheFile1 = cppCheck3.cacheFileName(code, "f.c");
+        record["Uninitialized variables"].insert("mul1");
+        db3.addRecord("mul1.c", record);
+        ASSERT_EQUALS(cacheFile1, cppCheck3.cacheFileName(code, "f.c"));
+        cppCheck3.settings().summaries = &db;
+        ASSERT_EQUALS(cacheFile1, cppCheck3.cacheFileName(code, "f.c"));
+        SummaryDatabase db4;
+        cppCheck3.settings().summaries = &db4;
+        ASSERT(cacheFile1 != cppCheck3.cacheFileName(code, "f.c"));
+    }
+
+    static std::size_t countString(const std::string &str, const std::string &sub) {
+        std::size_t count = 0;
+        for (std::string::size_type pos = str.find(sub); pos != std::string::npos; pos = str.find(sub, pos + 1))
+            ++count;
+        return count;
+    }
+
+    void profile() const {
+        const char code[] = "void f() {\n"
+                            "#ifdef A\n"
+                            "    int x = 0;\n"
+                            "#endif\n"
+                            "}\n";
+
+        ErrorLogger2 errorLogger;
+        CppCheck cppCheck(errorLogger, true);
+        cppCheck.settings().profileOut = "profile.json";
+        cppCheck.settings()._checkThreads = 2;
+        cppCheck.setProfilePid(3);
+        cppCheck.check("test.cpp", code);
+        const std::string profile = cppCheck.takeProfile();
+
+        // one event for the file and one for each configuration
+        ASSERT_EQUALS(1U, countString(profile, "\"cat\": \"file\""));
+        ASSERT_EQUALS(2U, countString(profile, "\"cat\": \"configuration\""));
+        ASSERT_EQUALS(1U, countString(profile, "\"name\": \"A\", \"cat\": \"configuration\""));
+        ASSERT_EQUALS(2U, countString(profile, "\"name\": \"Tokenizer::tokenize\""));
+        ASSERT_EQUALS(2U, countString(profile, "\"name\": \"Tokenizer::simplifyTokenList\""));
+        ASSERT_EQUALS(2U, countString(profile, "\"name\": \"Other::runChecks\""));
+        ASSERT_EQUALS(2U, countString(profile, "\"name\": \"Other::runSimplifiedChecks\""));
+
+        // the checks have their own threads, all events are in the given process
+        ASSERT_EQUALS(true, countString(profile, "\"tid\": 1,") > 0U);
+        ASSERT_EQUALS(countString(profile, "\n"), countString(profile, "\"pid\": 3,"));
+        ASSERT_EQUALS(true, profile.find("\"configuration\": \"A\", \"tokens\": ") != std::string::npos);
+        ASSERT_EQUALS(true, cppCheck.takeProfile().empty());
+    }
 };
 
 REGISTER_TEST(TestCppcheck)
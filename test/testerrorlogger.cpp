@@ -54,6 +54,8 @@ private:
         TEST_CASE(SerializeInconclusiveMessage);
 
         TEST_CASE(suppressUnmatchedSuppressions);
+
+        TEST_CASE(uniqueErrorFilter);
     }
 
     void FileLocationDefaults() const {
@@ -302,5 +304,31 @@ private:
         ASSERT_EQUALS("[a.c:10]: (information) Unmatched suppression: abc\n", errout.str());
     }
 
+
+    void uniqueErrorFilter() const {
+        std::list<ErrorLogger::ErrorMessage::FileLocation> locs(1, fooCpp5);
+        const ErrorMessage msg1(locs, Severity::error, "Programming error.\nVerbose error", "errorId", false);
+        const ErrorMessage msg2(locs, Severity::error, "Programming error.\nOther verbose error", "errorId", false);
+        const ErrorMessage msg3(locs, Severity::warning, "Programming error.\nVerbose error", "errorId", false);
+        locs.push_back(barCpp8);
+        const ErrorMessage msg4(locs, Severity::error, "Programming error.\nVerbose error", "errorId", false);
+
+        UniqueErrorFilter filter;
+        ASSERT_EQUALS(true, filter.insert(msg1, false));
+        ASSERT_EQUALS(false, filter.insert(msg1, false));
+        ASSERT_EQUALS(false, filter.insert(msg2, false));
+        ASSERT_EQUALS(true, filter.insert(msg3, false));
+        ASSERT_EQUALS(true, filter.insert(msg4, false));
+        ASSERT_EQUALS(3U, filter.size());
+        ASSERT_EQUALS(2U, filter.hits());
+
+        UniqueErrorFilter verboseFilter;
+        ASSERT_EQUALS(true, verboseFilter.insert(msg1, true));
+        ASSERT_EQUALS(true, verboseFilter.insert(msg2, true));
+
+        filter.clear();
+        ASSERT_EQUALS(0U, filter.size());
+        ASSERT_EQUALS(true, filter.insert(msg1, false));
+    }
 };
 REGISTER_TEST(TestErrorLogger)
@@ -38,6 +38,7 @@ SOURCES += $${BASEPATH}/test64bit.cpp \
            $${BASEPATH}/testsimplifytokens.cpp \
            $${BASEPATH}/testsizeof.cpp \
            $${BASEPATH}/teststl.cpp \
+           $${BASEPATH}/teststyle.cpp \
            $${BASEPATH}/testsuite.cpp \
            $${BASEPATH}/testsuppressions.cpp \
            $${BASEPATH}/testsymboldatabase.cpp \
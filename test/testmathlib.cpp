@@ -31,6 +31,7 @@ private:
     void run() {
         TEST_CASE(calculate);
         TEST_CASE(calculate1);
+        TEST_CASE(value);
         TEST_CASE(convert);
         TEST_CASE(isint);
         TEST_CASE(isnegative);
@@ -144,6 +145,45 @@ private:
         MathLib::calculate("123", "0.0", '%'); // don't throw
     }
 
+    void value() const {
+        // parsing
+        ASSERT_EQUALS(true, MathLib::Value("123").isInt());
+        ASSERT_EQUALS(123, MathLib::Value("123").getInt());
+        ASSERT_EQUALS(-123, MathLib::Value("-123").getInt());
+        ASSERT_EQUALS(255, MathLib::Value("0xff").getInt());
+        ASSERT_EQUALS(8, MathLib::Value("010").getInt());
+        ASSERT_EQUALS(1000, MathLib::Value("1E3").getInt());
+        ASSERT_EQUALS(true, MathLib::Value("1.5").isFloat());
+        ASSERT_EQUALS(1, MathLib::Value("1.5").getInt());
+        ASSERT_EQUALS("1.5", MathLib::Value("1.5").str());
+
+        // suffixes
+        ASSERT_EQUALS(true, MathLib::Value("1U").isUnsigned());
+        ASSERT_EQUALS(false, MathLib::Value("1U").isLong());
+        ASSERT_EQUALS(true, MathLib::Value("1ull").isLong());
+        ASSERT_EQUALS(true, MathLib::Value("1ull").isUnsigned());
+        ASSERT_EQUALS(1, MathLib::Value("1ull").getInt());
+        ASSERT_EQUALS("1", MathLib::Value("1ull").str());
+
+        // calculations, same results as for the strings
+        const char * const numbers[] = { "0", "1", "-1", "7", "250", "0xff", "1.", "0.0", "-2.3", "5.2", "1E3", "0.00000001", "30666.22" };
+        const char actions[] = "+-*/%&|^";
+        for (unsigned int i = 0; i < sizeof(numbers) / sizeof(*numbers); ++i) {
+            for (unsigned int j = 0; j < sizeof(numbers) / sizeof(*numbers); ++j) {
+                for (const char *action = actions; *action; ++action) {
+                    std::string expected;
+                    try {
+                        expected = MathLib::calculate(numbers[i], numbers[j], *action);
+                    } catch (const InternalError &) {
+                        ASSERT_THROW(MathLib::calculate(MathLib::Value(numbers[i]), MathLib::Value(numbers[j]), *action), InternalError);
+                        continue;
+                    }
+                    ASSERT_EQUALS(expected, MathLib::calculate(MathLib::Value(numbers[i]), MathLib::Value(numbers[j]), *action).str());
+                }
+            }
+        }
+    }
+
     void convert() const {
         // ------------------
         // tolong conversion:
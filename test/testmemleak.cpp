@@ -231,6 +231,7 @@ private:
         TEST_CASE(func25);      // Ticket #2904
         TEST_CASE(func26);
         TEST_CASE(func27);      // Ticket #2773
+        TEST_CASE(func28);      // The same function calls for many variables
 
         TEST_CASE(allocfunc1);
         TEST_CASE(allocfunc2);
@@ -2318,6 +2319,39 @@ private:
         ASSERT_EQUALS("[test.cpp:4]: (error) Memory leak: pData\n", errout.str());
     }
 
+    void func28() {
+        check("static void fatal()\n"
+              "{\n"
+              "    exit(1);\n"
+              "}\n"
+              "static void f(int x)\n"
+              "{\n"
+              "    char *a = malloc(10);\n"
+              "    char *b = malloc(10);\n"
+              "    char *c = malloc(10);\n"
+              "    dostuff(x);\n"
+              "    if (x) {\n"
+              "        fatal();\n"
+              "    }\n"
+              "    free(a);\n"
+              "    free(c);\n"
+              "}");
+        ASSERT_EQUALS("[test.cpp:16]: (error) Memory leak: b\n", errout.str());
+
+        check("static void f(int x)\n"
+              "{\n"
+              "    char *a = malloc(10);\n"
+              "    char *b = malloc(10);\n"
+              "    dostuff(a);\n"
+              "    dostuff(x);\n"
+              "    if (x) {\n"
+              "        exit(1);\n"
+              "    }\n"
+              "    free(a);\n"
+              "}");
+        ASSERT_EQUALS("[test.cpp:11]: (error) Memory leak: b\n", errout.str());
+    }
+
     void allocfunc1() {
         check("static char *a()\n"
               "{\n"
@@ -27,6 +27,8 @@
 #include "token.h"
 #include "settings.h"
 
+#include <cstdio>
+#include <fstream>
 #include <map>
 #include <string>
 #include <sstream>
@@ -186,6 +188,8 @@ private:
         TEST_CASE(macro_nopar);
         TEST_CASE(macro_switchCase);
         TEST_CASE(macro_NULL); // skip #define NULL .. it is replaced in the tokenizer
+        TEST_CASE(macro_configurations); // the parsed macros are shared by the configurations
+        TEST_CASE(macro_undef);
         TEST_CASE(string1);
         TEST_CASE(string2);
         TEST_CASE(string3);
@@ -295,6 +299,11 @@ private:
         TEST_CASE(validateCfg);
 
         TEST_CASE(if_sizeof);
+
+        TEST_CASE(lineTable);
+        TEST_CASE(getcodeSharedLines);
+        TEST_CASE(headerCache);
+        TEST_CASE(headerCacheRemovedHeader);
     }
 
 
@@ -2121,6 +2130,44 @@ private:
         ASSERT_EQUALS("\nNULL", OurPreprocessor::expandMacros("#define NULL 0\nNULL"));
     }
 
+    void macro_configurations() {
+        const char filedata[] = "#define M(x) f(x)\n"
+                                "#ifdef A\n"
+                                "#undef M\n"
+                                "#define M(x) g(x)\n"
+                                "#endif\n"
+                                "M(1);\n"
+                                "#undef M\n"
+                                "#define M(x) f(x)\n"
+                                "M(2);\n";
+
+        Preprocessor preprocessor(NULL, this);
+        ASSERT_EQUALS("\n\n\n\n\n$f(1);\n\n\n$f(2);\n", preprocessor.getcode(filedata, "", "a.cpp"));
+        ASSERT_EQUALS("\n\n\n\n\n$g(1);\n\n\n$f(2);\n", preprocessor.getcode(filedata, "A", "a.cpp"));
+        ASSERT_EQUALS("\n\n\n\n\n$f(1);\n\n\n$f(2);\n", preprocessor.getcode(filedata, "", "a.cpp"));
+    }
+
+    void macro_undef() {
+        // Define many macros and undefine every other one
+        std::ostringstream code, expected;
+        for (int i = 0; i < 100; ++i) {
+            code << "#define M" << i << " " << i << "\n";
+            expected << "\n";
+        }
+        for (int i = 0; i < 100; i += 2) {
+            code << "#undef M" << i << "\n";
+            expected << "\n";
+        }
+        for (int i = 0; i < 100; ++i) {
+            code << "M" << i << "\n";
+            if (i % 2)
+                expected << "$" << i << "\n";
+            else
+                expected << "M" << i << "\n";
+        }
+        ASSERT_EQUALS(expected.str(), OurPreprocessor::expandMacros(code.str()));
+    }
+
     void string1() {
         const char filedata[] = "int main()"
                                 "{"
@@ -3930,6 +3977,102 @@ private:
         preprocessor.preprocess(istr, actual, "file.c");
         ASSERT_EQUALS("\nFred & Wilma\n\n\n\n\n", actual[""]);
     }
+
+    void lineTable() {
+        const std::string code("#include \"a.h\"\n\nint x;\n#ifdef A\n#elif B\n#pragma once\n#foo\n#endif");
+        const PreprocessorLines lines(code);
+        ASSERT_EQUALS(8U, lines.size());
+        ASSERT_EQUALS(PreprocessorLines::Include, lines.directive(0));
+        ASSERT_EQUALS(PreprocessorLines::NoDirective, lines.directive(1));
+        ASSERT_EQUALS(PreprocessorLines::NoDirective, lines.directive(2));
+        ASSERT_EQUALS(PreprocessorLines::Ifdef, lines.directive(3));
+        ASSERT_EQUALS(PreprocessorLines::Elif, lines.directive(4));
+        ASSERT_EQUALS(PreprocessorLines::Pragma, lines.directive(5));
+        ASSERT_EQUALS(PreprocessorLines::OtherDirective, lines.directive(6));
+        ASSERT_EQUALS(PreprocessorLines::Endif, lines.directive(7));
+
+        std::string line;
+        lines.getline(2, line);
+        ASSERT_EQUALS("int x;", line);
+        lines.getline(1, line);
+        ASSERT_EQUALS("", line);
+        ASSERT_EQUALS(true, lines.terminated(6));
+        ASSERT_EQUALS(false, lines.terminated(7));
+        ASSERT_EQUALS(true, lines.startsWith(3, "#ifdef ", 7));
+        ASSERT_EQUALS(false, lines.startsWith(7, "#endif ", 7));
+
+        // Like std::getline, a trailing newline doesn't start a new line
+        ASSERT_EQUALS(2U, PreprocessorLines("a\nb\n").size());
+        ASSERT_EQUALS(0U, PreprocessorLines("").size());
+    }
+
+    void getcodeSharedLines() {
+        const std::string filedata("#ifdef A\na\n#else\nb\n#endif\n");
+        const PreprocessorLines lines(filedata);
+        Settings settings;
+        Preprocessor preprocessor(&settings, this);
+        ASSERT_EQUALS("\n\n\nb\n\n", preprocessor.getcode(lines, "", "test.c"));
+        ASSERT_EQUALS("\na\n\n\n\n", preprocessor.getcode(lines, "A", "test.c"));
+        ASSERT_EQUALS(preprocessor.getcode(filedata, "A", "test.c"), preprocessor.getcode(lines, "A", "test.c"));
+    }
+
+    void headerCache() {
+        Preprocessor::clearHeaderCache();
+
+        const char header[] = "headercache.h";
+        std::ofstream(header) << "#define HEADERCACHE 1\n";
+
+        // The header is read from disk for the first file only
+        const std::string code(std::string("#include \"") + header + "\"\n");
+        const std::list<std::string> includePaths;
+        std::map<std::string,std::string> defs1, defs2;
+        Settings settings;
+        Preprocessor preprocessor(&settings, this);
+        std::list<std::string> pragmaOnce1, pragmaOnce2;
+        const std::string actual1(preprocessor.handleIncludes(code, "test1.c", includePaths, defs1, pragmaOnce1, std::list<std::string>()));
+        const std::string actual2(preprocessor.handleIncludes(code, "test2.c", includePaths, defs2, pragmaOnce2, std::list<std::string>()));
+        const Preprocessor::HeaderCacheStats stats(Preprocessor::headerCacheStats());
+        std::remove(header);
+        Preprocessor::clearHeaderCache();
+
+        ASSERT_EQUALS(actual1, actual2);
+        ASSERT(actual1.find("#define HEADERCACHE 1") != std::string::npos);
+        ASSERT_EQUALS(1U, stats.hits);
+        ASSERT_EQUALS(1U, stats.misses);
+        ASSERT(stats.bytesSaved > 0U);
+        ASSERT_EQUALS(1U, stats.resolveHits);
+        ASSERT_EQUALS(1U, stats.resolveMisses);
+        ASSERT_EQUALS(0U, Preprocessor::headerCacheStats().hits);
+    }
+
+    void headerCacheRemovedHeader() {
+        Preprocessor::clearHeaderCache();
+
+        const char header[] = "headercachetest.h";
+        std::ofstream(header) << "int a;\n";
+
+        const std::string code(std::string("#include \"") + header + "\"\n");
+        const std::list<std::string> includePaths;
+        Settings settings;
+        Preprocessor preprocessor(&settings, this);
+        std::map<std::string,std::string> defs1, defs2;
+        std::list<std::string> pragmaOnce1, pragmaOnce2;
+        Preprocessor::missingIncludeFlag = false;
+        preprocessor.handleIncludes(code, "test1.c", includePaths, defs1, pragmaOnce1, std::list<std::string>());
+        const bool found = !Preprocessor::missingIncludeFlag;
+
+        // The cached path of a removed header is not used
+        std::remove(header);
+        preprocessor.handleIncludes(code, "test2.c", includePaths, defs2, pragmaOnce2, std::list<std::string>());
+        const bool missing = Preprocessor::missingIncludeFlag;
+        const std::size_t resolveHits = Preprocessor::headerCacheStats().resolveHits;
+        Preprocessor::missingIncludeFlag = false;
+        Preprocessor::clearHeaderCache();
+
+        ASSERT_EQUALS(true, found);
+        ASSERT_EQUALS(true, missing);
+        ASSERT_EQUALS(0U, resolveHits);
+    }
 };
 
 REGISTER_TEST(TestPreprocessor)
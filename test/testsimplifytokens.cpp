@@ -132,6 +132,7 @@ private:
         TEST_CASE(template37);  // #4544 - A<class B> a;
         TEST_CASE(template38);  // #4832 - crash on C++11 right angle brackets
         TEST_CASE(template39);  // #4742 - freeze
+        TEST_CASE(template40);  // instantiations of several templates, nested in each other
         TEST_CASE(template_unhandled);
         TEST_CASE(template_default_parameter);
         TEST_CASE(template_default_type);
@@ -2324,6 +2325,23 @@ private:
         tok(code);
     }
 
+    void template40() {
+        const char code[] = "template<class T> struct A { T a; };\n"
+                            "template<class T> struct B { A<T> b; };\n"
+                            "A<A<int> > x;\n"
+                            "B<char> y;\n"
+                            "A<int> z;\n"
+                            "B<A<char> > w;";
+        ASSERT_EQUALS("A<A<int>> x ; B<char> y ; A<int> z ; B<A<char>> w ; "
+                      "struct B<char> { A<char> b ; } "
+                      "struct B<A<char>> { A<A<char>> b ; } "
+                      "struct A<T> { T a ; } "
+                      "struct A<A<int>> { A<int> a ; } "
+                      "struct A<int> { int a ; } "
+                      "struct A<char> { char a ; } "
+                      "struct A<A<char>> { A<char> a ; }", tok(code));
+    }
+
     void template_default_parameter() {
         {
             const char code[] = "template <class T, int n=3>\n"
@@ -0,0 +1,107 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2013 Daniel Marjamäki and Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "tokenize.h"
+#include "checkstyle.h"
+#include "testsuite.h"
+#include <algorithm>
+#include <sstream>
+
+extern std::ostringstream errout;
+
+class TestStyle : public TestFixture {
+public:
+    TestStyle() : TestFixture("TestStyle") {
+    }
+
+private:
+
+
+    void run() {
+        TEST_CASE(attributePrefix);
+        TEST_CASE(checkedOnce);
+        TEST_CASE(manyFunctions);
+    }
+
+    void check(const char code[]) {
+        // Clear the error buffer..
+        errout.str("");
+
+        Settings settings;
+
+        // Tokenize..
+        Tokenizer tokenizer(&settings, this);
+        std::istringstream istr(code);
+        tokenizer.tokenize(istr, "test.cpp");
+
+        // Check...
+        CCheckStyle checkStyle(&tokenizer, &settings, this);
+        checkStyle.runChecks(&tokenizer, &settings, this);
+    }
+
+    void attributePrefix() {
+        check("class CFoo\n"
+              "{\n"
+              "private:\n"
+              "    int m_iValue;\n"
+              "    int value;\n"
+              "};\n");
+        ASSERT_EQUALS("[test.cpp:5]: (style) prefix of attribute: int value is invalid - correct prefix: m_i\n", errout.str());
+    }
+
+    void checkedOnce() {
+        // The attribute is used in the method but only reported at the declaration
+        check("class CFoo\n"
+              "{\n"
+              "public:\n"
+              "    int getValue( );\n"
+              "private:\n"
+              "    int value;\n"
+              "};\n"
+              "int CFoo::getValue( )\n"
+              "{\n"
+              "    return value;\n"
+              "}\n");
+        ASSERT_EQUALS("[test.cpp:6]: (style) prefix of attribute: int value is invalid - correct prefix: m_i\n", errout.str());
+    }
+
+    void manyFunctions() {
+        // Many methods and attributes, every attribute is used
+        // in its method. Each attribute must be reported exactly once.
+        const unsigned int count = 300;
+        std::ostringstream code;
+        code << "class CFoo\n{\npublic:\n";
+        for (unsigned int i = 0; i < count; ++i)
+            code << "    int getValue" << i << "( );\n";
+        code << "private:\n";
+        for (unsigned int i = 0; i < count; ++i)
+            code << "    int value" << i << ";\n";
+        code << "};\n";
+        for (unsigned int i = 0; i < count; ++i)
+            code << "int CFoo::getValue" << i << "( )\n{\n    return value" << i << ";\n}\n";
+        check(code.str().c_str());
+
+        const std::string errors = errout.str();
+        ASSERT_EQUALS(count, (unsigned int)std::count(errors.begin(), errors.end(), '\n'));
+        ASSERT_EQUALS(true, errors.find("int value0 is invalid") != std::string::npos);
+        ASSERT_EQUALS(true, errors.find("int value299 is invalid") != std::string::npos);
+    }
+};
+
+REGISTER_TEST(TestStyle)
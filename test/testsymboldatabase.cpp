@@ -63,7 +63,7 @@ private:
     }
 
     static const Scope *findFunctionScopeByToken(const SymbolDatabase * db, const Token *tok) {
-        std::list<Scope>::const_iterator scope;
+        StableVector<Scope>::const_iterator scope;
 
         for (scope = db->scopeList.begin(); scope != db->scopeList.end(); ++scope) {
             if (scope->type == Scope::eFunction) {
@@ -83,7 +83,7 @@ private:
                 currScope = currScope->nestedIn;
         }
         while (currScope) {
-            for (std::list<Function>::const_iterator i = currScope->functionList.begin(); i != currScope->functionList.end(); ++i) {
+            for (StableVector<Function>::const_iterator i = currScope->functionList.begin(); i != currScope->functionList.end(); ++i) {
                 if (i->tokenDef->str() == str)
                     return &*i;
             }
@@ -204,6 +204,9 @@ private:
         TEST_CASE(garbage);
 
         TEST_CASE(findFunction1);
+        TEST_CASE(findFunction2); // overloads in several namespaces
+
+        TEST_CASE(stableVector);
     }
 
     void array() const {
@@ -786,8 +789,8 @@ private:
 
         if (db) {
             bool seen_something = false;
-            for (std::list<Scope>::const_iterator scope = db->scopeList.begin(); scope != db->scopeList.end(); ++scope) {
-                for (std::list<Function>::const_iterator func = scope->functionList.begin(); func != scope->functionList.end(); ++func) {
+            for (StableVector<Scope>::const_iterator scope = db->scopeList.begin(); scope != db->scopeList.end(); ++scope) {
+                for (StableVector<Function>::const_iterator func = scope->functionList.begin(); func != scope->functionList.end(); ++func) {
                     ASSERT_EQUALS("Sub", func->token->str());
                     ASSERT_EQUALS(true, func->hasBody);
                     ASSERT_EQUALS(Function::eConstructor, func->type);
@@ -918,10 +921,10 @@ private:
 
         ASSERT(db && db->scopeList.size() == 1);
         if (db && db->scopeList.size() == 1) {
-            std::list<Scope>::const_iterator it = db->scopeList.begin();
+            StableVector<Scope>::const_iterator it = db->scopeList.begin();
             ASSERT(it->varlist.size() == 1);
             if (it->varlist.size() == 1) {
-                std::list<Variable>::const_iterator var = it->varlist.begin();
+                StableVector<Variable>::const_iterator var = it->varlist.begin();
                 ASSERT(var->name() == "i");
                 ASSERT(var->typeStartToken()->str() == "int");
             }
@@ -933,10 +936,10 @@ private:
 
         ASSERT(db && db->scopeList.size() == 1);
         if (db && db->scopeList.size() == 1) {
-            std::list<Scope>::const_iterator it = db->scopeList.begin();
+            StableVector<Scope>::const_iterator it = db->scopeList.begin();
             ASSERT(it->varlist.size() == 1);
             if (it->varlist.size() == 1) {
-                std::list<Variable>::const_iterator var = it->varlist.begin();
+                StableVector<Variable>::const_iterator var = it->varlist.begin();
                 ASSERT(var->name() == "array");
                 ASSERT(var->typeStartToken()->str() == "int");
             }
@@ -948,10 +951,10 @@ private:
 
         ASSERT(db && db->scopeList.size() == 1);
         if (db && db->scopeList.size() == 1) {
-            std::list<Scope>::const_iterator it = db->scopeList.begin();
+            StableVector<Scope>::const_iterator it = db->scopeList.begin();
             ASSERT(it->varlist.size() == 1);
             if (it->varlist.size() == 1) {
-                std::list<Variable>::const_iterator var = it->varlist.begin();
+                StableVector<Variable>::const_iterator var = it->varlist.begin();
                 ASSERT(var->name() == "array");
                 ASSERT(var->typeStartToken()->str() == "int");
             }
@@ -1078,7 +1081,7 @@ private:
 
         // Locate the scope for the class..
         const Scope *scope = NULL;
-        for (std::list<Scope>::const_iterator it = db->scopeList.begin(); it != db->scopeList.end(); ++it) {
+        for (StableVector<Scope>::const_iterator it = db->scopeList.begin(); it != db->scopeList.end(); ++it) {
             if (it->isClassOrStruct()) {
                 scope = &(*it);
                 break;
@@ -1112,7 +1115,7 @@ private:
 
         // Locate the scope for the class..
         const Scope *scope = NULL;
-        for (std::list<Scope>::const_iterator it = db->scopeList.begin(); it != db->scopeList.end(); ++it) {
+        for (StableVector<Scope>::const_iterator it = db->scopeList.begin(); it != db->scopeList.end(); ++it) {
             if (it->isClassOrStruct()) {
                 scope = &(*it);
                 break;
@@ -1417,7 +1420,7 @@ private:
 
         // Find the scope for the Fred struct..
         const Scope *fredScope = NULL;
-        for (std::list<Scope>::const_iterator scope = db->scopeList.begin(); scope != db->scopeList.end(); ++scope) {
+        for (StableVector<Scope>::const_iterator scope = db->scopeList.begin(); scope != db->scopeList.end(); ++scope) {
             if (scope->isClassOrStruct() && scope->className == "Fred")
                 fredScope = &(*scope);
         }
@@ -1431,7 +1434,7 @@ private:
         // Get linenumbers where the bodies for the constructor and destructor are..
         unsigned int constructor = 0;
         unsigned int destructor = 0;
-        for (std::list<Function>::const_iterator it = fredScope->functionList.begin(); it != fredScope->functionList.end(); ++it) {
+        for (StableVector<Function>::const_iterator it = fredScope->functionList.begin(); it != fredScope->functionList.end(); ++it) {
             if (it->type == Function::eConstructor)
                 constructor = it->token->linenr();  // line number for constructor body
             if (it->type == Function::eDestructor)
@@ -1529,7 +1532,7 @@ private:
         ASSERT(db && db->isClassOrStruct("Sub"));
         if (!db || db->typeList.size() < 5)
             return;
-        std::list<Type>::const_iterator i = db->typeList.begin();
+        StableVector<Type>::const_iterator i = db->typeList.begin();
         const Type* Foo = &(*i++);
         const Type* Bar = &(*i++);
         const Type* Sub = &(*i++);
@@ -1601,7 +1604,7 @@ private:
         ASSERT(db && db->isClassOrStruct("Barney"));
         if (!db || db->typeList.size() != 3)
             return;
-        std::list<Type>::const_iterator i = db->typeList.begin();
+        StableVector<Type>::const_iterator i = db->typeList.begin();
         const Type* Fred = &(*i++);
         const Type* Wilma = &(*i++);
         const Type* Barney = &(*i++);
@@ -1733,6 +1736,105 @@ private:
             }
         }
     }
+
+    void findFunction2() {
+        GET_SYMBOL_DB("namespace A {\n"                      /* 1 */
+                      "    struct S { void f(); void f(int x, int y); };\n" /* 2 */
+                      "    struct T { void f(int x); };\n"   /* 3 */
+                      "}\n"                                  /* 4 */
+                      "namespace B {\n"                      /* 5 */
+                      "    struct S { void f(int x); };\n"   /* 6 */
+                      "}\n"                                  /* 7 */
+                      "void A::S::f(int x, int y) { }\n"     /* 8 */
+                      "void B::S::f(int x) { }\n"            /* 9 */
+                      "void g() {\n"                         /* 10 */
+                      "    A::S::f(1, 2);\n"                 /* 11 */
+                      "    B::S::f(1);\n"                    /* 12 */
+                      "}");
+        ASSERT(db != 0);
+        if (!db)
+            return;
+
+        const Scope *a = db->scopeList.front().findRecordInNestedList("A");
+        ASSERT(a != 0);
+        const Scope *b = db->scopeList.front().findRecordInNestedList("B");
+        ASSERT(b != 0);
+        if (!a || !b)
+            return;
+
+        const Scope *as = a->findRecordInNestedList("S");
+        const Scope *bs = b->findRecordInNestedList("S");
+        ASSERT(as != 0 && bs != 0 && as != bs);
+        ASSERT(a->findType("T") != 0);
+        ASSERT(b->findType("T") == 0);
+        ASSERT(db->isClassOrStruct("T"));
+        ASSERT(!db->isClassOrStruct("U"));
+        if (!as || !bs)
+            return;
+
+        // the implementation is found for the right overload
+        ASSERT_EQUALS(2U, as->functionList.size());
+        ASSERT_EQUALS(false, as->functionList.front().hasBody);
+        ASSERT_EQUALS(true, as->functionList.back().hasBody);
+        ASSERT_EQUALS(8U, as->functionList.back().token->linenr());
+        ASSERT_EQUALS(true, bs->functionList.front().hasBody);
+        ASSERT_EQUALS(9U, bs->functionList.front().token->linenr());
+
+        // calls
+        const Token *call = Token::findsimplematch(tokenizer.tokens(), "f ( 1 , 2 )");
+        ASSERT(call != 0);
+        if (call) {
+            const Function *function = db->findFunction(call);
+            ASSERT(function != 0 && function->nestedIn == as && function->argCount() == 2U);
+        }
+        call = Token::findsimplematch(tokenizer.tokens(), "f ( 1 ) ;");
+        ASSERT(call != 0);
+        if (call) {
+            const Function *function = db->findFunction(call);
+            ASSERT(function != 0 && function->nestedIn == bs);
+        }
+    }
+
+    void stableVector() const {
+        StableVector<int> v;
+        ASSERT(v.empty());
+        ASSERT(v.begin() == v.end());
+
+        std::vector<const int *> addresses;
+        for (int i = 0; i < 200; ++i) {
+            v.push_back(i);
+            addresses.push_back(&v.back());
+        }
+        ASSERT_EQUALS(200U, v.size());
+        ASSERT_EQUALS(0, v.front());
+        ASSERT_EQUALS(199, v.back());
+
+        // elements are never moved
+        int i = 0;
+        for (StableVector<int>::const_iterator it = v.begin(); it != v.end(); ++it, ++i) {
+            ASSERT_EQUALS(i, *it);
+            ASSERT(addresses[i] == &*it);
+        }
+        ASSERT_EQUALS(200, i);
+        for (StableVector<int>::const_reverse_iterator it = v.rbegin(); it != v.rend(); ++it)
+            ASSERT_EQUALS(--i, *it);
+
+        while (v.size() > 63U)
+            v.pop_back();
+        ASSERT_EQUALS(62, v.back());
+        ASSERT(addresses[62] == &v.back());
+        ASSERT_EQUALS(63, (int)std::distance(v.begin(), v.end()));
+
+        const StableVector<int> copy(v);
+        ASSERT_EQUALS(63U, copy.size());
+        ASSERT_EQUALS(62, copy.back());
+        ASSERT(addresses[62] != &copy.back());
+
+        v.clear();
+        ASSERT(v.empty());
+        ASSERT(v.begin() == v.end());
+        ASSERT_EQUALS(63U, copy.size());
+    }
 };
 
 REGISTER_TEST(TestSymbolDatabase)
@@ -43,7 +43,7 @@ private:
      * Execute check using n jobs for y files which are have
      * identical data, given within data.
      */
-    void check(unsigned int jobs, int files, int result, const std::string &data) {
+    void check(unsigned int jobs, int files, int result, const std::string &data, bool useProcesses = false) {
         errout.str("");
         output.str("");
         if (!ThreadExecutor::isEnabled()) {
@@ -60,6 +60,7 @@ private:
 
         Settings settings;
         settings._jobs = jobs;
+        settings.useProcesses = useProcesses;
         ThreadExecutor executor(filemap, settings, *this);
         for (std::map<std::string, std::size_t>::const_iterator i = filemap.begin(); i != filemap.end(); ++i)
             executor.addFileContent(i->first, data);
@@ -74,6 +75,10 @@ private:
         TEST_CASE(no_errors_equal_amount_files);
         TEST_CASE(one_error_less_files);
         TEST_CASE(one_error_several_files);
+        TEST_CASE(one_error_several_files_processes);
+        TEST_CASE(different_file_sizes);
+        TEST_CASE(unusedFunction);
+        TEST_CASE(unusedFunction_processes);
     }
 
     void deadlock_with_many_errors() {
@@ -134,6 +139,78 @@ private:
             << "}\n";
         check(2, 20, 20, oss.str());
     }
+
+    void one_error_several_files_processes() {
+        std::ostringstream oss;
+        oss << "int main()\n"
+            << "{\n"
+            << "  {char *a = malloc(10);}\n"
+            << "  return 0;\n"
+            << "}\n";
+        check(2, 20, 20, oss.str(), true);
+    }
+
+    void different_file_sizes() {
+        errout.str("");
+        output.str("");
+        if (!ThreadExecutor::isEnabled()) {
+            // Skip this check on systems which don't use this feature
+            return;
+        }
+
+        std::map<std::string, std::size_t> filemap;
+        filemap["small.cpp"] = 10;
+        filemap["big.cpp"] = 1000;
+        filemap["medium.cpp"] = 100;
+
+        Settings settings;
+        settings._jobs = 2;
+        ThreadExecutor executor(filemap, settings, *this);
+        executor.addFileContent("small.cpp", "void f() { char *a = malloc(10); }");
+        executor.addFileContent("big.cpp", "void f() { char *a = malloc(10); }");
+        executor.addFileContent("medium.cpp", "void f() { char *a = malloc(10); }");
+
+        ASSERT_EQUALS(3, executor.check());
+    }
+
+    void unusedFunction(bool useProcesses = false) {
+        errout.str("");
+        output.str("");
+        if (!ThreadExecutor::isEnabled()) {
+            // Skip this check on systems which don't use this feature
+            return;
+        }
+
+        std::map<std::string, std::size_t> filemap;
+        filemap["a.cpp"] = 1;
+        filemap["b.cpp"] = 1;
+        filemap["c.cpp"] = 1;
+
+        Settings settings;
+        settings._jobs = 2;
+        settings.useProcesses = useProcesses;
+        settings.addEnabled("unusedFunction");
+        ThreadExecutor executor(filemap, settings, *this);
+        executor.addFileContent("a.cpp", "void f()\n{\n}\nvoid g()\n{\n}\n");
+        executor.addFileContent("b.cpp", "int main()\n{\n    f();\n}\n");
+        executor.addFileContent("c.cpp", "static void g()\n{\n}\n");
+
+        ASSERT_EQUALS(0, executor.check());
+        ASSERT_EQUALS(3U, executor.functionUsage().size());
+
+        CppCheck cppCheck(*this, true);
+        cppCheck.settings() = settings;
+        cppCheck.settings()._errorsOnly = true;
+        const std::map<std::string, std::string> &functionUsage = executor.functionUsage();
+        for (std::map<std::string, std::string>::const_iterator i = functionUsage.begin(); i != functionUsage.end(); ++i)
+            cppCheck.addFunctionUsage(i->second);
+        cppCheck.checkFunctionUsage();
+        ASSERT_EQUALS("[a.cpp:4]: (style) The function 'g' is never used.\n", errout.str());
+    }
+
+    void unusedFunction_processes() {
+        unusedFunction(true);
+    }
 };
 
 REGISTER_TEST(TestThreadExecutor)
@@ -21,6 +21,7 @@
 #include "timer.h"
 #include "testsuite.h"
 #include <cmath>
+#include <sstream>
 
 class TestTimer : public TestFixture {
 public:
@@ -31,16 +32,102 @@ private:
 
     void run() {
         TEST_CASE(result);
+        TEST_CASE(ids);
+        TEST_CASE(merge);
+        TEST_CASE(top5);
+        TEST_CASE(json);
+        TEST_CASE(csv);
+        TEST_CASE(traceEvents);
     }
 
     void result() const {
         TimerResultsData t1;
-        t1._clocks = ~(std::clock_t)0;
-        ASSERT(t1.seconds() > 100.0);
-
-        t1._clocks = CLOCKS_PER_SEC * 5 / 2;
+        t1._wall = 2.5;
         ASSERT(std::fabs(t1.seconds()-2.5) < 0.01);
     }
+
+    void ids() const {
+        const unsigned int id1 = Timer::id("TestTimer::ids1");
+        const unsigned int id2 = Timer::id("TestTimer::ids2");
+        ASSERT(id1 != id2);
+        ASSERT_EQUALS(id1, Timer::id("TestTimer::ids1"));
+        ASSERT_EQUALS("TestTimer::ids2", Timer::name(id2));
+    }
+
+    void merge() const {
+        const unsigned int id = Timer::id("TestTimer::merge");
+        TimerResults results;
+        TimerResultsLocal local;
+        local.AddResults(id, 0.0, 1.0, 0.5);
+        local.AddResults(id, 0.0, 2.0, 1.0);
+        results.AddResults(id, 0.0, 4.0, 2.0);
+        results.merge(local);
+        ASSERT(std::fabs(results.result(id)._wall - 7.0) < 0.01);
+        ASSERT(std::fabs(results.result(id)._cpu - 3.5) < 0.01);
+        ASSERT_EQUALS(3, results.result(id)._numberOfResults);
+
+        // the local results are cleared
+        results.merge(local);
+        ASSERT_EQUALS(3, results.result(id)._numberOfResults);
+    }
+
+    void top5() const {
+        TimerResults results;
+        for (int i = 0; i < 7; ++i)
+            results.AddResults(Timer::id("TestTimer::top5_" + std::string(1, char('a' + i))), 0.0, 1.0 + i, 0.0);
+        std::ostringstream out;
+        results.ShowResults(SHOWTIME_TOP5, out);
+        ASSERT_EQUALS("TestTimer::top5_g: 7s (avg. 7s - 1 result(s), cpu 0s)\n"
+                      "TestTimer::top5_f: 6s (avg. 6s - 1 result(s), cpu 0s)\n"
+                      "TestTimer::top5_e: 5s (avg. 5s - 1 result(s), cpu 0s)\n"
+                      "TestTimer::top5_d: 4s (avg. 4s - 1 result(s), cpu 0s)\n"
+                      "TestTimer::top5_c: 3s (avg. 3s - 1 result(s), cpu 0s)\n"
+                      "Overall time: 28s (cpu 0s)\n", out.str());
+    }
+
+    void json() const {
+        TimerResults results;
+        results.AddResults(Timer::id("TestTimer::json1"), 0.0, 0.5, 0.25);
+        results.AddResults(Timer::id("TestTimer::json\"2\""), 0.0, 1.5, 1.0);
+        std::ostringstream out;
+        results.ShowResults(SHOWTIME_JSON, out);
+        ASSERT_EQUALS("{\"timers\": [\n"
+                      "  {\"name\": \"TestTimer::json\\\"2\\\"\", \"count\": 1, \"wall\": 1.5, \"cpu\": 1},\n"
+                      "  {\"name\": \"TestTimer::json1\", \"count\": 1, \"wall\": 0.5, \"cpu\": 0.25}\n"
+                      "], \"wall\": 2, \"cpu\": 1.25}\n", out.str());
+    }
+
+    void csv() const {
+        TimerResults results;
+        results.AddResults(Timer::id("TestTimer::csv1"), 0.0, 0.5, 0.25);
+        results.AddResults(Timer::id("TestTimer::csv,2"), 0.0, 1.5, 1.0);
+        std::ostringstream out;
+        results.ShowResults(SHOWTIME_CSV, out);
+        ASSERT_EQUALS("name,count,wall,cpu\n"
+                      "\"TestTimer::csv,2\",1,1.5,1\n"
+                      "\"TestTimer::csv1\",1,0.5,0.25\n", out.str());
+    }
+
+    void traceEvents() const {
+        const unsigned int id = Timer::id("TestTimer::traceEvents");
+        TimerResultsLocal local;
+        local.AddResults(id, 1.0, 0.5, 0.5);
+        local.recordEvents(true);
+        local.AddResults(id, 2.0, 0.25, 0.125);
+
+        TraceEvents events;
+        events.setPid(2);
+        events.setFile("a\\b.c", "A");
+        events.addTimerEvents(local, 1);
+        events.add("A", "configuration", 0, 1.5, 1.0, "\"tokens\": 10");
+        ASSERT_EQUALS("{\"name\": \"TestTimer::traceEvents\", \"cat\": \"timer\", \"ph\": \"X\", \"pid\": 2, \"tid\": 1, \"ts\": 2000000.000, \"dur\": 250000.000, \"args\": {\"file\": \"a\\\\b.c\", \"configuration\": \"A\"}}\n"
+                      "{\"name\": \"A\", \"cat\": \"configuration\", \"ph\": \"X\", \"pid\": 2, \"tid\": 0, \"ts\": 1500000.000, \"dur\": 1000000.000, \"args\": {\"file\": \"a\\\\b.c\", \"configuration\": \"A\", \"tokens\": 10}}\n", events.take());
+        ASSERT_EQUALS("", events.take());
+
+        // the measurements are taken
+        events.addTimerEvents(local, 1);
+        ASSERT_EQUALS("", events.take());
+    }
 };
 
 REGISTER_TEST(TestTimer)
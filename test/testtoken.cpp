@@ -20,6 +20,7 @@
 #include "testutils.h"
 #include "token.h"
 #include "settings.h"
+#include "tokenlist.h"
 
 #include <vector>
 #include <string>
@@ -52,6 +53,8 @@ private:
         TEST_CASE(deleteLast);
         TEST_CASE(nextArgument);
         TEST_CASE(eraseTokens);
+        TEST_CASE(arena);
+        TEST_CASE(strId);
 
         TEST_CASE(matchAny);
         TEST_CASE(matchSingleChar);
@@ -170,6 +173,14 @@ private:
         x.str("x");
         ASSERT_EQUALS(-1, Token::multiCompare(&x, "one|%op%", "x"));
         ASSERT_EQUALS(-1, Token::multiCompare(&x, "%op%|two", "x"));
+
+        // %type% and %num% after a plain alternative
+        ASSERT_EQUALS(1, Token::multiCompare(&x, "one|%type%", "x"));
+        ASSERT_EQUALS(-1, Token::multiCompare(&x, "one|%num%", "x"));
+        Token three(0);
+        three.str("3");
+        ASSERT_EQUALS(1, Token::multiCompare(&three, "one|%num%", "3"));
+        ASSERT_EQUALS(-1, Token::multiCompare(&three, "one|%type%", "3"));
     }
 
     void multiCompare2() const { // #3294
@@ -297,6 +308,53 @@ private:
         ASSERT_EQUALS("begin ; end", code.tokens()->stringifyList(0, false));
     }
 
+    void arena() const {
+        TokenList list(0);
+        list.addtoken("x", 1, 0);
+        list.addtoken("=", 1, 0);
+        list.addtoken("x", 1, 0);
+        list.addtoken(";", 1, 0);
+        ASSERT_EQUALS(4U, list.arenaStats().tokens);
+
+        // Equal strings share storage
+        ASSERT_EQUALS(3U, list.arenaStats().strings);
+        ASSERT(&list.front()->str() == &list.front()->tokAt(2)->str());
+
+        // Memory of deleted tokens is reused
+        list.front()->deleteNext();
+        list.front()->insertToken("+=");
+        ASSERT_EQUALS(1U, list.arenaStats().reused);
+        ASSERT_EQUALS("x += x ;", list.front()->stringifyList(0, false));
+
+        list.deallocateTokens();
+        ASSERT(list.front() == 0);
+    }
+
+    void strId() const {
+        ASSERT_EQUALS(Token::idIf, Token::getStrId("if"));
+        ASSERT_EQUALS(Token::idNot, Token::getStrId("!"));
+        ASSERT_EQUALS(Token::idShrAssign, Token::getStrId(">>="));
+        ASSERT_EQUALS(Token::idWhile, Token::getStrId("while"));
+        ASSERT_EQUALS(Token::idNone, Token::getStrId("iff"));
+        ASSERT_EQUALS(Token::idNone, Token::getStrId("\"if\""));
+        ASSERT_EQUALS(Token::idNone, Token::getStrId(""));
+
+        // The id follows the string
+        Token tok(0);
+        tok.str("return");
+        ASSERT_EQUALS(Token::idReturn, tok.strId());
+        tok.str("x");
+        ASSERT_EQUALS(Token::idNone, tok.strId());
+
+        TokenList list(0);
+        list.addtoken("(", 1, 0);
+        list.addtoken("int", 1, 0);
+        list.addtoken(")", 1, 0);
+        ASSERT_EQUALS(Token::idLParen, list.front()->strId());
+        ASSERT_EQUALS(Token::idInt, list.front()->next()->strId());
+        list.front()->deleteThis();
+        ASSERT_EQUALS(Token::idInt, list.front()->strId());
+    }
 
     void matchAny() const {
         givenACodeSampleToTokenize varBitOrVar("abc|def", true);
@@ -60,6 +60,7 @@ private:
         TEST_CASE(tokenize26);  // #4245 (segmentation fault)
         TEST_CASE(tokenize27);  // #4525 (segmentation fault)
         TEST_CASE(tokenize28);  // #4725 (writing asm() around "^{}")
+        TEST_CASE(tokenize29);  // segmentation fault on empty code
 
         // don't freak out when the syntax is wrong
         TEST_CASE(wrong_syntax1);
@@ -193,6 +194,7 @@ private:
         TEST_CASE(simplifyKnownVariablesClassMember);  // #2815 - value of class member may be changed by function call
         TEST_CASE(simplifyKnownVariablesFunctionCalls); // Function calls (don't assume pass by reference)
         TEST_CASE(simplifyKnownVariablesReturn);   // 3500 - return
+        TEST_CASE(simplifyKnownVariablesChangedScopes); // only changed functions are simplified again
         TEST_CASE(simplifyExternC);
 
         TEST_CASE(varid1);
@@ -257,6 +259,7 @@ private:
         TEST_CASE(varid_functions);
         TEST_CASE(varid_sizeof);
         TEST_CASE(varid_reference_to_containers);
+        TEST_CASE(varid_shadow_nested);  // shadowed variables in nested scopes
         TEST_CASE(varid_in_class1);
         TEST_CASE(varid_in_class2);
         TEST_CASE(varid_in_class3);     // #3092 - shadow variable in member function
@@ -749,6 +752,12 @@ private:
         ASSERT_EQUALS("void f ( ) { asm ( \"x(^{});\" ) ; }", tokenizeAndStringify("void f() { x(^{}); }"));
     }
 
+    // segfault - empty code
+    void tokenize29() {
+        ASSERT_EQUALS("", tokenizeAndStringify(""));
+        ASSERT_EQUALS("", tokenizeAndStringify("\n\n"));
+    }
+
     void wrong_syntax1() {
         {
             const std::string code("TR(kvmpio, PROTO(int rw), ARGS(rw), TP_(aa->rw;))");
@@ -2977,6 +2986,31 @@ private:
         ASSERT_EQUALS("int a ( ) { return 123 ; }", tokenizeAndStringify(code,true));
     }
 
+    void simplifyKnownVariablesChangedScopes() {
+        const char code[] = "void f() {\n"
+                            "    int x = 1;\n"
+                            "    if (x == 1) { a(); }\n"
+                            "}\n"
+                            "void g(int y) {\n"
+                            "    b(y);\n"
+                            "}\n";
+
+        Settings settings;
+        Tokenizer tokenizer(&settings, this);
+        Tokenizer::SimplifyStats stats;
+        tokenizer.setSimplifyStats(&stats);
+        std::istringstream istr(code);
+        tokenizer.tokenize(istr, "test.cpp");
+        tokenizer.simplifyTokenList();
+
+        ASSERT_EQUALS("void f ( ) { a ( ) ; } void g ( int y ) { b ( y ) ; }",
+                      tokenizer.tokens()->stringifyList(0, false));
+
+        // The second iteration only visits f()
+        ASSERT_EQUALS(true, stats.iterations >= 2U);
+        ASSERT_EQUALS(true, stats.tokensVisited < stats.tokensTotal);
+    }
+
     void simplifyKnownVariablesClassMember() {
         // Ticket #2815
         {
@@ -4008,6 +4042,42 @@ private:
         ASSERT_EQUALS(expected, actual);
     }
 
+    void varid_shadow_nested() {
+        const std::string code = "int a;\n"
+                                 "void f(int a) {\n"
+                                 "    a = 0;\n"
+                                 "    {\n"
+                                 "        int a;\n"
+                                 "        {\n"
+                                 "            int a;\n"
+                                 "            a = 1;\n"
+                                 "        }\n"
+                                 "        a = 2;\n"
+                                 "    }\n"
+                                 "    a = 3;\n"
+                                 "}\n"
+                                 "void g() {\n"
+                                 "    a = 4;\n"
+                                 "}";
+        ASSERT_EQUALS("\n\n##file 0\n"
+                      "1: int a@1 ;\n"
+                      "2: void f ( int a@2 ) {\n"
+                      "3: a@2 = 0 ;\n"
+                      "4: {\n"
+                      "5: int a@3 ;\n"
+                      "6: {\n"
+                      "7: int a@4 ;\n"
+                      "8: a@4 = 1 ;\n"
+                      "9: }\n"
+                      "10: a@3 = 2 ;\n"
+                      "11: }\n"
+                      "12: a@2 = 3 ;\n"
+                      "13: }\n"
+                      "14: void g ( ) {\n"
+                      "15: a@1 = 4 ;\n"
+                      "16: }\n", tokenizeDebugListing(code));
+    }
+
     void varid_in_class1() {
         {
             const std::string actual = tokenizeDebugListing(
@@ -18,6 +18,7 @@
 
 #include "tokenize.h"
 #include "checkuninitvar.h"
+#include "summarydatabase.h"
 #include "testsuite.h"
 #include <sstream>
 
@@ -50,6 +51,7 @@ private:
         TEST_CASE(func_uninit_var);     // analyse function calls for: 'int a(int x) { return x+x; }'
         TEST_CASE(func_uninit_pointer); // analyse function calls for: 'void a(int *p) { *p = 0; }'
         TEST_CASE(uninitvar_typeof);    // typeof
+        TEST_CASE(uninitvar_budget);    // --max-execution-paths
 
         // checking for uninitialized variables without using the
         // ExecutionPath functionality
@@ -65,11 +67,13 @@ private:
         TEST_CASE(uninitvar2_4494);      // #4494
     }
 
-    void checkUninitVar(const char code[], const char filename[] = "test.cpp") {
+    void checkUninitVar(const char code[], const char filename[] = "test.cpp", unsigned int maxExecutionPaths = 10, const SummaryDatabase *summaries = 0) {
         // Clear the error buffer..
         errout.str("");
 
         Settings settings;
+        settings.maxExecutionPaths = maxExecutionPaths;
+        settings.summaries = summaries;
 
         // Tokenize..
         Tokenizer tokenizer(&settings, this);
@@ -1918,15 +1922,38 @@ private:
                         "}").c_str());
         ASSERT_EQUALS("", errout.str());
 
-        // not ok - uninitialized pointer
+        // not ok - uninitialized pointer, 'a' reads it according to the
+        // whole program analysis
+        SummaryDatabase summaries;
+        SummaryDatabase::Record record;
+        record["Uninitialized variables"].insert("a");
+        summaries.addRecord("a.c", record);
         checkUninitVar((funca +
                         "void b() {\n"
                         "    int *p;\n"
                         "    a(p);\n"
-                        "}").c_str());
+                        "}").c_str(), "test.cpp", 10, &summaries);
         ASSERT_EQUALS("[test.cpp:3]: (error) Uninitialized variable: p\n", errout.str());
     }
 
+    void uninitvar_budget() {
+        // 12 paths at the condition
+        const char code[] = "void f(int c) {\n"
+                            "    int a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11;\n"
+                            "    if (c) {\n"
+                            "        c = 0;\n"
+                            "    }\n"
+                            "    c = a1;\n"
+                            "    g(&a2, &a3, &a4, &a5, &a6, &a7, &a8, &a9, &a10, &a11);\n"
+                            "}";
+
+        checkUninitVar(code);
+        ASSERT_EQUALS("", errout.str());
+
+        checkUninitVar(code, "test.cpp", 12);
+        ASSERT_EQUALS("[test.cpp:6]: (error) Uninitialized variable: a1\n", errout.str());
+    }
+
     void uninitvar_typeof() {
         checkUninitVar("void f() {\n"
                        "    struct Fred *fred;\n"
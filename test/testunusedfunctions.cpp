@@ -50,6 +50,7 @@ private:
         TEST_CASE(returnRef);
 
         TEST_CASE(multipleFiles);   // same function name in multiple files
+        TEST_CASE(mergeSummaries);  // files checked in parallel
 
         TEST_CASE(lineNumber); // Ticket 3059
 
@@ -264,6 +265,48 @@ private:
         ASSERT_EQUALS("[test1.cpp:1]: (style) The function 'f' is never used.\n", errout.str());
     }
 
+    void mergeSummaries() {
+        const char * const code[] = {
+            "static void f() { }\n"
+            "void g() { h(); }\n"
+            "void unused1() { }",
+
+            "void h() { }\n"
+            "static void f() { }\n"
+            "int main() { g(); }\n"
+            "void unused2() { }"
+        };
+
+        CheckUnusedFunctions all;
+        CheckUnusedFunctions merged;
+        for (int i = 0; i < 2; ++i) {
+            std::ostringstream fname;
+            fname << "test dir/test" << i + 1 << ".cpp";
+
+            Settings settings;
+            Tokenizer tokenizer(&settings, this);
+            std::istringstream istr(code[i]);
+            tokenizer.tokenize(istr, fname.str().c_str());
+
+            all.parseTokens(tokenizer);
+
+            CheckUnusedFunctions file;
+            file.parseTokens(tokenizer);
+            merged.merge(file.summary());
+        }
+
+        errout.str("");
+        all.check(this);
+        const std::string expected = errout.str();
+        ASSERT_EQUALS("[test dir/test1.cpp:1]: (style) The function 'f' is never used.\n"
+                      "[test dir/test1.cpp:3]: (style) The function 'unused1' is never used.\n"
+                      "[test dir/test2.cpp:4]: (style) The function 'unused2' is never used.\n", expected);
+
+        errout.str("");
+        merged.check(this);
+        ASSERT_EQUALS(expected, errout.str());
+    }
+
     void lineNumber() {
         check("void foo() {}\n"
               "void bar() {}\n"
@@ -77,7 +77,7 @@ void getDeps(const std::string &filename, std::vector<std::string> &depfiles)
 static void compilefiles(std::ostream &fout, const std::vector<std::string> &files, const std::string &args)
 {
     for (unsigned int i = 0; i < files.size(); ++i) {
-        fout << objfile(files[i]) << ": " << files[i];
+        fout << objfile(files[i]) << ": " << builddir(files[i]);
         std::vector<std::string> depfiles;
         getDeps(files[i], depfiles);
         for (unsigned int dep = 0; dep < depfiles.size(); ++dep)
@@ -234,15 +234,38 @@ int main(int argc, char **argv)
     makeConditionalVariable(fout, "HAVE_RULES", "no");
 
     // compiled patterns..
-    fout << "# folder where lib/*.cpp files are located\n";
-    makeConditionalVariable(fout, "SRCDIR", "lib");
-    fout << "ifeq ($(SRCDIR),build)\n"
-         << "    ifdef VERIFY\n"
-         << "        matchcompiler_S := $(shell python tools/matchcompiler.py --verify)\n"
+    fout << "# The Token::Match() patterns in lib/*.cpp are compiled into C++ code by\n"
+         << "# tools/matchcompiler.py when Python is found, use 'make MATCHCOMPILER=no'\n"
+         << "# to use the interpreted patterns.\n"
+         << "ifndef PYTHON\n"
+         << "    PYTHON := $(shell sh -c 'command -v python3 || command -v python' 2>/dev/null)\n"
+         << "endif\n"
+         << "ifndef MATCHCOMPILER\n"
+         << "    ifeq ($(PYTHON),)\n"
+         << "        MATCHCOMPILER=no\n"
          << "    else\n"
-         << "        matchcompiler_S := $(shell python tools/matchcompiler.py)\n"
+         << "        MATCHCOMPILER=yes\n"
          << "    endif\n"
          << "endif\n\n";
+    fout << "# folder where lib/*.cpp files are located\n"
+         << "ifndef SRCDIR\n"
+         << "    ifeq ($(MATCHCOMPILER),yes)\n"
+         << "        SRCDIR=build\n"
+         << "    else\n"
+         << "        SRCDIR=lib\n"
+         << "    endif\n"
+         << "endif\n\n";
+    fout << "# To verify the compiled patterns against Token::Match(), use 'make VERIFY=yes'.\n"
+         << "# This is slow, a mismatch throws an InternalError.\n"
+         << "ifeq ($(SRCDIR),build)\n"
+         << "    ifeq ($(VERIFY),yes)\n"
+         << "        MATCHCOMPILER_FLAGS=--verify=always\n"
+         << "    else\n"
+         << "        MATCHCOMPILER_FLAGS=\n"
+         << "    endif\n"
+         << "    # regenerate build/*.cpp when the flags change\n"
+         << "    matchcompiler_S := $(shell mkdir -p build && (echo '$(MATCHCOMPILER_FLAGS)' | cmp -s - build/matchcompiler.flags || echo '$(MATCHCOMPILER_FLAGS)' > build/matchcompiler.flags))\n"
+         << "endif\n\n";
 
     // The _GLIBCXX_DEBUG doesn't work in cygwin or other Win32 systems.
     fout << "# Set the CPPCHK_GLIBCXX_DEBUG flag. This flag is not used in release Makefiles.\n"
@@ -278,6 +301,13 @@ int main(int argc, char **argv)
          << "        endif # !CPPCHK_GLIBCXX_DEBUG\n"
          << "    endif # GNU/kFreeBSD\n"
          << "\n"
+         << "    #### The ThreadExecutor uses POSIX threads\n"
+         << "    ifdef LIBS\n"
+         << "        LIBS += -lpthread\n"
+         << "    else\n"
+         << "        LIBS=-lpthread\n"
+         << "    endif\n"
+         << "\n"
          << "endif # COMSPEC\n"
          << "\n";
 
@@ -361,11 +391,17 @@ int main(int argc, char **argv)
     fout << "check:\tall\n";
     fout << "\t./testrunner -g -q\n\n";
     fout << "dmake:\ttools/dmake.cpp\n";
-    fout << "\t$(CXX) -o dmake tools/dmake.cpp cli/filelister.cpp lib/path.cpp -Ilib $(LDFLAGS)\n\n";
+    fout << "\t$(CXX) -o dmake tools/dmake.cpp cli/filelister.cpp lib/path.cpp lib/mutex.cpp -Ilib $(LIBS) $(LDFLAGS)\n\n";
     fout << "reduce:\ttools/reduce.cpp\n";
     fout << "\t$(CXX) -g -o reduce tools/reduce.cpp -Ilib lib/*.cpp\n\n";
+    fout << "matchbench:\ttools/matchbench.cpp build/matchbench.h $(LIBOBJ) $(EXTOBJ)\n";
+    fout << "\t$(CXX) ${INCLUDE_FOR_LIB} -Ibuild $(CPPFLAGS) $(CXXFLAGS) -o matchbench tools/matchbench.cpp $(LIBOBJ) $(EXTOBJ) $(LIBS) $(LDFLAGS)\n\n";
+    fout << "symboldbbench:\ttools/symboldbbench.cpp $(LIBOBJ) $(EXTOBJ)\n";
+    fout << "\t$(CXX) ${INCLUDE_FOR_LIB} $(CPPFLAGS) $(CXXFLAGS) -o symboldbbench tools/symboldbbench.cpp $(LIBOBJ) $(EXTOBJ) $(LIBS) $(LDFLAGS)\n\n";
+    fout << "varidbench:\ttools/varidbench.cpp $(LIBOBJ) $(EXTOBJ)\n";
+    fout << "\t$(CXX) ${INCLUDE_FOR_LIB} $(CPPFLAGS) $(CXXFLAGS) -o varidbench tools/varidbench.cpp $(LIBOBJ) $(EXTOBJ) $(LIBS) $(LDFLAGS)\n\n";
     fout << "clean:\n";
-    fout << "\trm -f build/*.o lib/*.o cli/*.o test/*.o externals/tinyxml/*.o testrunner reduce cppcheck cppcheck.1\n\n";
+    fout << "\trm -f build/*.cpp build/*.h build/*.o build/matchcompiler.flags lib/*.o cli/*.o test/*.o externals/tinyxml/*.o testrunner reduce matchbench symboldbbench varidbench cppcheck cppcheck.1\n\n";
     fout << "man:\tman/cppcheck.1\n\n";
     fout << "man/cppcheck.1:\t$(MAN_SOURCE)\n\n";
     fout << "\t$(XP) $(DB2MAN) $(MAN_SOURCE)\n\n";
@@ -377,6 +413,11 @@ int main(int argc, char **argv)
 
     fout << "\n###### Build\n\n";
 
+    fout << "build/%.cpp: lib/%.cpp tools/matchcompiler.py build/matchcompiler.flags\n";
+    fout << "\t$(PYTHON) tools/matchcompiler.py $(MATCHCOMPILER_FLAGS) $<\n\n";
+    fout << "build/matchbench.h: $(wildcard lib/*.cpp) tools/matchcompiler.py\n";
+    fout << "\t$(PYTHON) tools/matchcompiler.py --bench\n\n";
+
     compilefiles(fout, libfiles, "${INCLUDE_FOR_LIB}");
     compilefiles(fout, clifiles, "${INCLUDE_FOR_CLI}");
     compilefiles(fout, testfiles, "${INCLUDE_FOR_TEST}");
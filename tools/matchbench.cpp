@@ -0,0 +1,174 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2013 Daniel Marjamäki and Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Micro-benchmark: compiled patterns (tools/matchcompiler.py) versus
+// Token::Match(). Every pattern is matched against every token of the
+// given files both ways, the results must be the same.
+//
+// Usage:
+//   make matchbench
+//   ./matchbench test/*.cpp
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "errorlogger.h"
+#include "preprocessor.h"
+#include "settings.h"
+#include "token.h"
+#include "tokenize.h"
+
+struct MatchBenchPattern {
+    const char *pattern;
+    bool simple;
+    bool (*compiled)(const Token *tok);
+};
+
+#include "matchbench.h"
+
+class MatchBenchErrorLogger : public ErrorLogger {
+public:
+    void reportOut(const std::string &/*outmsg*/) { }
+    void reportErr(const ErrorLogger::ErrorMessage &/*msg*/) { }
+};
+
+struct MatchBenchResult {
+    const char *pattern;
+    std::clock_t interpreted;
+    std::clock_t compiled;
+
+    bool operator<(const MatchBenchResult &other) const {
+        return interpreted > other.interpreted;
+    }
+};
+
+static double seconds(std::clock_t t)
+{
+    return double(t) / CLOCKS_PER_SEC;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2) {
+        std::cout << "Syntax: matchbench [--repeat=N] files.." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    Settings settings;
+    MatchBenchErrorLogger errorLogger;
+    unsigned int repeat = 1;
+
+    // Tokenize the files, the token lists are kept until the end
+    std::vector<Tokenizer *> tokenizers;
+    std::vector<const Token *> tokens;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--repeat=", 9) == 0) {
+            repeat = std::max(1, std::atoi(argv[i] + 9));
+            continue;
+        }
+
+        std::ifstream fin(argv[i]);
+        if (!fin.is_open()) {
+            std::cerr << "Can't open " << argv[i] << std::endl;
+            continue;
+        }
+
+        try {
+            Preprocessor preprocessor(&settings, &errorLogger);
+            std::map<std::string, std::string> code;
+            preprocessor.preprocess(fin, code, argv[i]);
+            if (code.empty())
+                continue;
+
+            Tokenizer *tokenizer = new Tokenizer(&settings, &errorLogger);
+            tokenizers.push_back(tokenizer);
+            std::istringstream istr(code.begin()->second);
+            if (!tokenizer->tokenize(istr, argv[i]))
+                continue;
+            for (const Token *tok = tokenizer->tokens(); tok; tok = tok->next())
+                tokens.push_back(tok);
+        } catch (const InternalError &) {
+            std::cerr << "Can't tokenize " << argv[i] << std::endl;
+        }
+    }
+
+    const std::size_t patternCount = sizeof(matchBenchPatterns) / sizeof(*matchBenchPatterns);
+    std::cout << "Tokens: " << tokens.size() << ", patterns: " << patternCount << ", repeat: " << repeat << std::endl;
+
+    std::vector<MatchBenchResult> results;
+    std::clock_t interpreted = 0, compiled = 0;
+    unsigned int mismatches = 0;
+    for (std::size_t i = 0; i < patternCount; ++i) {
+        const MatchBenchPattern &p = matchBenchPatterns[i];
+
+        std::size_t interpretedMatches = 0;
+        const std::clock_t start = std::clock();
+        for (unsigned int r = 0; r < repeat; ++r) {
+            for (std::vector<const Token *>::const_iterator tok = tokens.begin(); tok != tokens.end(); ++tok) {
+                if (p.simple ? Token::simpleMatch(*tok, p.pattern) : Token::Match(*tok, p.pattern))
+                    ++interpretedMatches;
+            }
+        }
+        const std::clock_t middle = std::clock();
+
+        std::size_t compiledMatches = 0;
+        for (unsigned int r = 0; r < repeat; ++r) {
+            for (std::vector<const Token *>::const_iterator tok = tokens.begin(); tok != tokens.end(); ++tok) {
+                if (p.compiled(*tok))
+                    ++compiledMatches;
+            }
+        }
+        const std::clock_t end = std::clock();
+
+        if (interpretedMatches != compiledMatches) {
+            std::cerr << "Mismatch: \"" << p.pattern << "\" interpreted " << interpretedMatches
+                      << ", compiled " << compiledMatches << std::endl;
+            ++mismatches;
+        }
+
+        const MatchBenchResult result = { p.pattern, middle - start, end - middle };
+        results.push_back(result);
+        interpreted += result.interpreted;
+        compiled += result.compiled;
+    }
+
+    std::cout << "Interpreted: " << seconds(interpreted) << "s" << std::endl;
+    std::cout << "Compiled:    " << seconds(compiled) << "s" << std::endl;
+    if (compiled > 0)
+        std::cout << "Speedup:     " << double(interpreted) / double(compiled) << "x" << std::endl;
+
+    std::sort(results.begin(), results.end());
+    std::cout << std::endl << "Slowest interpreted patterns:" << std::endl;
+    for (std::size_t i = 0; i < results.size() && i < 10; ++i) {
+        std::cout << "  " << seconds(results[i].interpreted) << "s / " << seconds(results[i].compiled)
+                  << "s  \"" << results[i].pattern << "\"" << std::endl;
+    }
+
+    for (std::vector<Tokenizer *>::iterator it = tokenizers.begin(); it != tokenizers.end(); ++it)
+        delete *it;
+
+    return mismatches ? EXIT_FAILURE : EXIT_SUCCESS;
+}
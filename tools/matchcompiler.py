@@ -23,19 +23,49 @@ import glob
 import argparse
 
 
+def loadStrIds(filename=None):
+    """Read the fixed string ids (Token::StrId) from the table in lib/token.cpp"""
+    if filename is None:
+        filename = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'lib', 'token.cpp')
+    strIds = {}
+    fin = open(filename, 'rt')
+    for line in fin:
+        res = re.match(r'\s*\{ "((?:[^"\\]|\\.)*)", Token::(id\w+) \},', line)
+        if res:
+            strIds[res.group(1).replace('\\"', '"').replace('\\\\', '\\')] = res.group(2)
+    fin.close()
+    return strIds
+
+
 class MatchCompiler:
     def __init__(self, verify_mode=False):
-        self._verifyMode = verify_mode
+        # verify_mode: False/'never', True/'always' or 'debug' (only
+        # verify when NDEBUG is not defined)
+        if verify_mode is True:
+            verify_mode = 'always'
+        elif verify_mode is False:
+            verify_mode = 'never'
+        self._verifyMode = verify_mode != 'never'
+        self._verifyDebugOnly = verify_mode == 'debug'
+        self._strIds = loadStrIds()
+        # all constant patterns seen so far, used by the benchmark
+        self._benchPatterns = set()
         self._reset()
 
     def _reset(self):
         self._rawMatchFunctions = []
         self._matchStrs = {}
         self._matchFunctionCache = {}
+        # #if directives around the current line, the compiled functions
+        # for it are written inside the same directives
+        self._conditions = []
 
-    def _generateCacheSignature(self, pattern, endToken=None, varId=None, isFindMatch=False):
+    def _generateCacheSignature(self, pattern, endToken=None, varId=None, isFindMatch=False, isSimpleMatch=False):
         sig = pattern
 
+        if isSimpleMatch:
+            sig += '|SIMPLEMATCH'
+
         if endToken:
             sig += '|ENDTOKEN'
         else:
@@ -51,24 +81,32 @@ class MatchCompiler:
         else:
             sig += '|NORMALMATCH'
 
+        for condition in self._conditions:
+            sig += '|' + condition
+
         return sig
 
-    def _lookupMatchFunctionId(self, pattern, endToken=None, varId=None, isFindMatch=False):
-        signature = self._generateCacheSignature(pattern, endToken, varId, isFindMatch)
+    def _lookupMatchFunctionId(self, pattern, endToken=None, varId=None, isFindMatch=False, isSimpleMatch=False):
+        signature = self._generateCacheSignature(pattern, endToken, varId, isFindMatch, isSimpleMatch)
 
         if signature in self._matchFunctionCache:
             return self._matchFunctionCache[signature]
 
         return None
 
-    def _insertMatchFunctionId(self, id, pattern, endToken=None, varId=None, isFindMatch=False):
-        signature = self._generateCacheSignature(pattern, endToken, varId, isFindMatch)
+    def _insertMatchFunctionId(self, id, pattern, endToken=None, varId=None, isFindMatch=False, isSimpleMatch=False):
+        signature = self._generateCacheSignature(pattern, endToken, varId, isFindMatch, isSimpleMatch)
 
         # function signature should not be in the cache
-        assert(self._lookupMatchFunctionId(pattern, endToken, varId, isFindMatch) == None)
+        assert(self._lookupMatchFunctionId(pattern, endToken, varId, isFindMatch, isSimpleMatch) == None)
 
         self._matchFunctionCache[signature] = id
 
+    def _addFunction(self, function):
+        for condition in reversed(self._conditions):
+            function = condition + '\n' + function + '#endif\n'
+        self._rawMatchFunctions.append(function)
+
     def _insertMatchStr(self, look_for):
         prefix = 'matchStr'
 
@@ -79,6 +117,12 @@ class MatchCompiler:
 
         return prefix + str(self._matchStrs[look_for])
 
+    def _compileStrCompare(self, tok, op='=='):
+        # Keywords and operators have a fixed id that is faster to compare
+        if tok in self._strIds:
+            return '(tok->strId()' + op + 'Token::' + self._strIds[tok] + ')/* ' + tok + ' */'
+        return '(tok->str()' + op + self._insertMatchStr(tok) + ')/* ' + tok + ' */'
+
     def _compileCmd(self, tok):
         if tok == '%any%':
             return 'true'
@@ -95,23 +139,23 @@ class MatchCompiler:
         elif tok == '%op%':
             return 'tok->isOp()'
         elif tok == '%or%':
-            return '(tok->str()==' + self._insertMatchStr('|') + ')/* | */'
+            return self._compileStrCompare('|')
         elif tok == '%oror%':
-            return '(tok->str()==' + self._insertMatchStr('||') + ')/* || */'
+            return self._compileStrCompare('||')
         elif tok == '%str%':
             return '(tok->type()==Token::eString)'
         elif tok == '%type%':
-            return '(tok->isName() && tok->varId()==0U && tok->str() != ' + self._insertMatchStr('delete') + '/* delete */)'
+            return '(tok->isName() && tok->varId()==0U && tok->strId() != Token::idDelete/* delete */)'
         elif tok == '%var%':
             return 'tok->isName()'
         elif tok == '%varid%':
-            return '(tok->isName() && tok->varId()==varid)'
+            return '(tok->varId()==varid)'
         elif (len(tok) > 2) and (tok[0] == "%"):
             print ("unhandled:" + tok)
 
-        return '(tok->str()==' + self._insertMatchStr(tok) + ')/* ' + tok + ' */'
+        return self._compileStrCompare(tok)
 
-    def _compilePattern(self, pattern, nr, varid, isFindMatch=False, tokenType="const Token"):
+    def _compilePattern(self, pattern, nr, varid, isFindMatch=False, tokenType="const Token", isSimpleMatch=False):
         ret = ''
         returnStatement = ''
 
@@ -142,13 +186,18 @@ class MatchCompiler:
                 ret += '        throw InternalError(tok, "Internal error. Token::Match called with varid 0. Please report this to Cppcheck developers");\n'
                 checked_varid = True
 
+            # simpleMatch: every token is compared literally
+            if isSimpleMatch:
+                ret += '    if (!tok || !' + self._compileStrCompare(tok) + ')\n'
+                ret += '        ' + returnStatement
+
             # [abc]
-            if (len(tok) > 2) and (tok[0] == '[') and (tok[-1] == ']'):
+            elif (len(tok) > 2) and (tok[0] == '[') and (tok[-1] == ']'):
                 ret += '    if (!tok || tok->str().size()!=1U || !strchr("'+tok[1:-1]+'", tok->str()[0]))\n'
                 ret += '        ' + returnStatement
 
-            # a|b|c
-            elif tok.find('|') > 0:
+            # a|b|c (but not the operators "|", "||" and "|=")
+            elif tok.find('|') != -1 and (tok[0] != '|' or len(tok) > 2):
                 tokens2 = tok.split('|')
                 logicalOp = None
                 neg = None
@@ -178,8 +227,8 @@ class MatchCompiler:
                     ret += '        ' + returnStatement
 
             # !!a
-            elif tok[0:2] == "!!":
-                ret += '    if (tok && tok->str() == ' + self._insertMatchStr(tok[2:]) + ')/* ' + tok[2:] + ' */\n'
+            elif (len(tok) > 2) and tok[0:2] == "!!":
+                ret += '    if (tok && ' + self._compileStrCompare(tok[2:]) + ')\n'
                 ret += '        ' + returnStatement
                 gotoNextToken = '    tok = tok ? tok->next() : NULL;\n'
 
@@ -195,7 +244,7 @@ class MatchCompiler:
 
         return ret
 
-    def _compileFindPattern(self, pattern, findmatchnr, endToken, varId):
+    def _compileFindPattern(self, pattern, findmatchnr, endToken, varId, isSimpleMatch=False):
         more_args = ''
         endCondition = ''
         if endToken:
@@ -208,7 +257,7 @@ class MatchCompiler:
         ret += 'template<class T> static T * findmatch' + str(findmatchnr) + '(T * start_tok'+more_args+') {\n'
         ret += '    for (; start_tok' + endCondition + '; start_tok = start_tok->next()) {\n'
 
-        ret += self._compilePattern(pattern, -1, varId, True, 'T')
+        ret += self._compilePattern(pattern, -1, varId, True, 'T', isSimpleMatch)
         ret += '    }\n'
         ret += '    return NULL;\n}\n'
 
@@ -268,6 +317,18 @@ class MatchCompiler:
 
         return None
 
+    def _verifyCondition(self, ret, condition, message):
+        # Don't use assert() here, it's disabled for optimized builds.
+        # In 'always' mode we also need to verify builds in 'release' mode
+        if self._verifyDebugOnly:
+            ret += '#ifndef NDEBUG\n'
+        ret += '    if (' + condition + ') {\n'
+        ret += '        throw InternalError(tok, "Internal error. ' + message + '");\n'
+        ret += '    }\n'
+        if self._verifyDebugOnly:
+            ret += '#endif\n'
+        return ret
+
     def _compileVerifyTokenMatch(self, is_simplematch, verifyNumber, pattern, patternNumber, varId):
         more_args = ''
         if varId:
@@ -285,22 +346,14 @@ class MatchCompiler:
             ret += ', varid'
         ret += ');\n'
 
-        ret += '    bool res_parsed_match = Token::' + origMatchName + '(tok, "' + pattern + '"'
+        parsed = 'Token::' + origMatchName + '(tok, "' + pattern + '"'
         if varId:
-            ret += ', varid'
-        ret += ');\n'
+            parsed += ', varid'
+        parsed += ')'
 
         ret += '\n'
-        # Don't use assert() here, it's disabled for optimized builds.
-        # We also need to verify builds in 'release' mode
-        ret += '    if (res_parsed_match != res_compiled_match) {\n'
-#        ret += '        std::cout << "res_parsed_match' + str(verifyNumber) + ': " << res_parsed_match << ", res_compiled_match: " << res_compiled_match << "\\n";\n'
-#        ret += '        if (tok)\n'
-#        ret += '            std::cout << "tok: " << tok->str();\n'
-#        ret += '        if (tok->next())\n'
-#        ret += '            std::cout << "tok next: " << tok->next()->str();\n'
-        ret += '        throw InternalError(tok, "Internal error. compiled match returned different result than parsed match");\n'
-        ret += '    }\n'
+        ret = self._verifyCondition(ret, parsed + ' != res_compiled_match',
+                                    'compiled match returned different result than parsed match')
         ret += '    return res_compiled_match;\n'
         ret += '}\n'
 
@@ -310,19 +363,21 @@ class MatchCompiler:
         more_args = ''
         if varId:
             more_args = ',' + varId
+        else:
+            self._benchPatterns.add((pattern, is_simplematch))
 
         # Compile function or use previously compiled one
-        patternNumber = self._lookupMatchFunctionId(pattern, None, varId, False)
+        patternNumber = self._lookupMatchFunctionId(pattern, None, varId, False, is_simplematch)
 
         if patternNumber is None:
             patternNumber = len(self._rawMatchFunctions) + 1
-            self._insertMatchFunctionId(patternNumber, pattern, None, varId, False)
-            self._rawMatchFunctions.append(self._compilePattern(pattern, patternNumber, varId))
+            self._insertMatchFunctionId(patternNumber, pattern, None, varId, False, is_simplematch)
+            self._addFunction(self._compilePattern(pattern, patternNumber, varId, False, 'const Token', is_simplematch))
 
         functionName = "match"
         if self._verifyMode:
             verifyNumber = len(self._rawMatchFunctions) + 1
-            self._rawMatchFunctions.append(self._compileVerifyTokenMatch(is_simplematch, verifyNumber, pattern, patternNumber, varId))
+            self._addFunction(self._compileVerifyTokenMatch(is_simplematch, verifyNumber, pattern, patternNumber, varId))
 
             # inject verify function
             functionName = "match_verify"
@@ -330,15 +385,21 @@ class MatchCompiler:
 
         return line[:start_pos]+functionName+str(patternNumber)+'('+tok+more_args+')'+line[start_pos+end_pos:]
 
+    def _constPattern(self, raw_pattern):
+        # String literal, possibly with escaped characters
+        res = re.match(r'\s*"((?:[^"\\]|\\.)*)"\s*$', raw_pattern)
+        if res is None:
+            return None  # Non-const pattern
+        return res.group(1)
+
     def _replaceTokenMatch(self, line):
+        pos = 0
         while True:
-            is_simplematch = False
-            pos1 = line.find('Token::Match(')
-            if pos1 == -1:
-                is_simplematch = True
-                pos1 = line.find('Token::simpleMatch(')
-            if pos1 == -1:
+            match = re.compile(r'Token::(simpleMatch|Match)\(').search(line, pos)
+            if match is None:
                 break
+            pos1 = match.start()
+            is_simplematch = match.group(1) == 'simpleMatch'
 
             res = self.parseMatch(line, pos1)
             if res is None:
@@ -348,17 +409,18 @@ class MatchCompiler:
 
             end_pos = len(res[0])
             tok = res[1]
-            raw_pattern = res[2]
             varId = None
             if len(res) == 4:
                 varId = res[3]
 
-            res = re.match(r'\s*"([^"]*)"\s*$', raw_pattern)
-            if res is None:
-                break  # Non-const pattern - bailout
+            pattern = self._constPattern(res[2])
+            if pattern is None:
+                # Non-const pattern - skip this call, but compile the ones after it
+                pos = pos1 + 1
+                continue
 
-            pattern = res.group(1)
             line = self._replaceSpecificTokenMatch(is_simplematch, line, pos1, end_pos, pattern, tok, varId)
+            pos = pos1
 
         return line
 
@@ -373,7 +435,7 @@ class MatchCompiler:
 
         origFindMatchName = 'findmatch'
         if is_findsimplematch:
-            origMatchName = 'findsimplematch'
+            origFindMatchName = 'findsimplematch'
             assert(varId == None)
 
         ret += '    T * res_compiled_findmatch = findmatch'+str(patternNumber)+'(tok'
@@ -383,19 +445,16 @@ class MatchCompiler:
             ret += ', varid'
         ret += ');\n'
 
-        ret += '    T * res_parsed_findmatch = Token::' + origFindMatchName + '(tok, "' + pattern + '"'
+        parsed = 'Token::' + origFindMatchName + '(tok, "' + pattern + '"'
         if endToken:
-            ret += ', endToken'
+            parsed += ', endToken'
         if varId:
-            ret += ', varid'
-        ret += ');\n'
+            parsed += ', varid'
+        parsed += ')'
 
         ret += '\n'
-        # Don't use assert() here, it's disabled for optimized builds.
-        # We also need to verify builds in 'release' mode
-        ret += '    if (res_parsed_findmatch != res_compiled_findmatch) {\n'
-        ret += '        throw InternalError(tok, "Internal error. compiled findmatch returned different result than parsed findmatch");\n'
-        ret += '    }\n'
+        ret = self._verifyCondition(ret, parsed + ' != res_compiled_findmatch',
+                                    'compiled findmatch returned different result than parsed findmatch')
         ret += '    return res_compiled_findmatch;\n'
         ret += '}\n'
 
@@ -407,19 +466,21 @@ class MatchCompiler:
             more_args += ',' + endToken
         if varId:
             more_args += ',' + varId
+        else:
+            self._benchPatterns.add((pattern, is_findsimplematch))
 
         # Compile function or use previously compiled one
-        findMatchNumber = self._lookupMatchFunctionId(pattern, endToken, varId, True)
+        findMatchNumber = self._lookupMatchFunctionId(pattern, endToken, varId, True, is_findsimplematch)
 
         if findMatchNumber is None:
             findMatchNumber = len(self._rawMatchFunctions) + 1
-            self._insertMatchFunctionId(findMatchNumber, pattern, endToken, varId, True)
-            self._rawMatchFunctions.append(self._compileFindPattern(pattern, findMatchNumber, endToken, varId))
+            self._insertMatchFunctionId(findMatchNumber, pattern, endToken, varId, True, is_findsimplematch)
+            self._addFunction(self._compileFindPattern(pattern, findMatchNumber, endToken, varId, is_findsimplematch))
 
         functionName = "findmatch"
         if self._verifyMode:
             verifyNumber = len(self._rawMatchFunctions) + 1
-            self._rawMatchFunctions.append(self._compileVerifyTokenFindMatch(is_findsimplematch, verifyNumber, pattern, findMatchNumber, endToken, varId))
+            self._addFunction(self._compileVerifyTokenFindMatch(is_findsimplematch, verifyNumber, pattern, findMatchNumber, endToken, varId))
 
             # inject verify function
             functionName = "findmatch_verify"
@@ -428,15 +489,13 @@ class MatchCompiler:
         return line[:start_pos]+functionName+str(findMatchNumber)+'('+tok+more_args+')'+line[start_pos+end_pos:]
 
     def _replaceTokenFindMatch(self, line):
-        pos1 = 0
+        pos = 0
         while True:
-            is_findsimplematch = True
-            pos1 = line.find('Token::findsimplematch(')
-            if pos1 == -1:
-                is_findsimplematch = False
-                pos1 = line.find('Token::findmatch(')
-            if pos1 == -1:
+            match = re.compile(r'Token::(findsimplematch|findmatch)\(').search(line, pos)
+            if match is None:
                 break
+            pos1 = match.start()
+            is_findsimplematch = match.group(1) == 'findsimplematch'
 
             res = self.parseMatch(line, pos1)
             if res is None:
@@ -446,7 +505,6 @@ class MatchCompiler:
 
             g0 = res[0]
             tok = res[1]
-            pattern = res[2]
 
             # Check for varId
             varId = None
@@ -471,12 +529,14 @@ class MatchCompiler:
                 elif varId is None and len(res) == 4:
                     endToken = res[3]
 
-            res = re.match(r'\s*"([^"]*)"\s*$', pattern)
-            if res is None:
-                break  # Non-const pattern - bailout
+            pattern = self._constPattern(res[2])
+            if pattern is None:
+                # Non-const pattern - skip this call, but compile the ones after it
+                pos = pos1 + 1
+                continue
 
-            pattern = res.group(1)
             line = self._replaceSpecificFindTokenMatch(is_findsimplematch, line, pos1, len(g0), pattern, tok, endToken, varId)
+            pos = pos1
 
         return line
 
@@ -499,6 +559,59 @@ class MatchCompiler:
 
         return line
 
+    def _splitComments(self, line):
+        """Split a line into a list of (text, isCode) parts. self._inComment
+        tells if a /* comment continues from the previous line."""
+        parts = []
+        start = 0
+        pos = 0
+        inString = None
+        while pos < len(line):
+            if self._inComment:
+                if line.startswith('*/', pos):
+                    pos += 2
+                    parts.append((line[start:pos], False))
+                    start = pos
+                    self._inComment = False
+                    continue
+            elif inString:
+                if line[pos] == '\\':
+                    pos += 1
+                elif line[pos] == inString:
+                    inString = None
+            elif line[pos] == '"' or line[pos] == "'":
+                inString = line[pos]
+            elif line.startswith('//', pos):
+                break
+            elif line.startswith('/*', pos):
+                if pos > start:
+                    parts.append((line[start:pos], True))
+                start = pos
+                pos += 2
+                self._inComment = True
+                continue
+            pos += 1
+
+        # pos < len(line) when the rest of the line is a // comment
+        if pos > start:
+            parts.append((line[start:pos], not self._inComment))
+        if pos < len(line):
+            parts.append((line[pos:], False))
+        return parts
+
+    def _compiledCode(self):
+        # Compute string list
+        stringList = ''
+        for match in sorted(self._matchStrs, key=self._matchStrs.get):
+            stringList += 'static const std::string matchStr' + str(self._matchStrs[match]) + '("' + match + '");\n'
+
+        # Compute matchFunctions
+        strFunctions = ''
+        for function in self._rawMatchFunctions:
+            strFunctions += function
+
+        return stringList + strFunctions
+
     def convertFile(self, srcname, destname):
         self._reset()
 
@@ -513,60 +626,114 @@ class MatchCompiler:
         # header += '#include <iostream>\n'
         code = ''
 
+        # Patterns in comments are not compiled, and the compiled functions
+        # for patterns in #if blocks are written inside the same #if, so
+        # every function that is written is also called.
+        self._inComment = False
+        inElse = []
         for line in srclines:
-            # Compile Token::Match and Token::simpleMatch
-            line = self._replaceTokenMatch(line)
+            directive = None
+            if not self._inComment:
+                directive = re.match(r'\s*#\s*(\w+)', line)
+            if directive:
+                if directive.group(1) in ('if', 'ifdef', 'ifndef'):
+                    self._conditions.append(line.strip())
+                    inElse.append(False)
+                elif directive.group(1) in ('elif', 'else'):
+                    inElse[-1] = True
+                elif directive.group(1) == 'endif' and self._conditions:
+                    self._conditions.pop()
+                    inElse.pop()
+
+            parts = self._splitComments(line)
+            if directive or True in inElse:
+                # The compiled function can't be written inside an #else
+                code += line
+                continue
 
-            # Compile Token::findsimplematch
-            line = self._replaceTokenFindMatch(line)
+            for text, isCode in parts:
+                if isCode:
+                    # Compile Token::Match and Token::simpleMatch
+                    text = self._replaceTokenMatch(text)
 
-            # Cache plain C-strings in C++ strings
-            line = self._replaceCStrings(line)
+                    # Compile Token::findsimplematch
+                    text = self._replaceTokenFindMatch(text)
 
-            code += line
+                    # Cache plain C-strings in C++ strings
+                    text = self._replaceCStrings(text)
 
-        # Compute string list
-        stringList = ''
-        for match in sorted(self._matchStrs, key=self._matchStrs.get):
-            stringList += 'static const std::string matchStr' + str(self._matchStrs[match]) + '("' + match + '");\n'
+                code += text
 
-        # Compute matchFunctions
-        strFunctions = ''
-        for function in self._rawMatchFunctions:
-            strFunctions += function
+        fout = open(destname, 'wt')
+        fout.write(header+self._compiledCode()+code)
+        fout.close()
+
+    def writeBenchmark(self, destname):
+        """Write the compiled patterns seen so far as a table for tools/matchbench.cpp"""
+        self._reset()
+
+        table = 'static const MatchBenchPattern matchBenchPatterns[] = {\n'
+        for pattern, is_simplematch in sorted(self._benchPatterns):
+            nr = len(self._rawMatchFunctions) + 1
+            self._rawMatchFunctions.append(self._compilePattern(pattern, nr, None, False, 'const Token', is_simplematch))
+            table += '    { "' + pattern + '", ' + ('true' if is_simplematch else 'false') + ', match' + str(nr) + ' },\n'
+        table += '};\n'
 
         fout = open(destname, 'wt')
-        fout.write(header+stringList+strFunctions+code)
+        fout.write('// Generated by tools/matchcompiler.py --bench, do not edit.\n' + self._compiledCode() + table)
         fout.close()
 
 
 def main():
     # Main program
-    build_dir = 'build'
 
     # Check if we are invoked from the right place
     if not os.path.exists('lib') and not os.path.exists('samples'):
         print('Please invoke from the top level cppcheck source dir. Example: tools/matchcompiler.py')
         sys.exit(-1)
 
-    # Create build directory if needed
-    if not os.path.exists(build_dir):
-        os.makedirs(build_dir)
-    if not os.path.isdir(build_dir):
-        raise Exception(build_dir + ' is not a directory')
-
     # Argument handling
     parser = argparse.ArgumentParser(description='Compile Token::Match() calls into native C++ code')
-    parser.add_argument('--verify', action='store_true', default=False,
-                        help='verify compiled matches against on-the-fly parser. Slow!')
+    parser.add_argument('--verify', nargs='?', const='always', default='never',
+                        choices=['never', 'debug', 'always'],
+                        help='verify compiled matches against on-the-fly parser. Slow! '
+                             'With --verify=debug this is only done when NDEBUG is not defined.')
+    parser.add_argument('--bench', action='store_true', default=False,
+                        help='write the patterns of the given files to matchbench.h for tools/matchbench.cpp')
+    parser.add_argument('--build-dir', default='build',
+                        help='directory for the generated files (default: build)')
+    parser.add_argument('files', nargs='*',
+                        help='files to convert (default: lib/*.cpp)')
     args = parser.parse_args()
 
+    build_dir = args.build_dir
+    files = args.files
+    if not files:
+        files = sorted(glob.glob('lib/*.cpp'))
+
+    # Create build directory if needed, several instances may be running in parallel
+    if not os.path.exists(build_dir):
+        try:
+            os.makedirs(build_dir)
+        except OSError:
+            pass
+    if not os.path.isdir(build_dir):
+        raise Exception(build_dir + ' is not a directory')
+
     mc = MatchCompiler(verify_mode=args.verify)
 
-    # convert all lib/*.cpp files
-    for f in glob.glob('lib/*.cpp'):
-        print (f + ' => ' + build_dir + '/' + f[4:])
-        mc.convertFile(f, build_dir + '/'+f[4:])
+    for f in files:
+        dest = os.path.join(build_dir, os.path.basename(f))
+        if args.bench:
+            dest = os.devnull
+        else:
+            print (f + ' => ' + dest)
+        mc.convertFile(f, dest)
+
+    if args.bench:
+        dest = os.path.join(build_dir, 'matchbench.h')
+        print (str(len(mc._benchPatterns)) + ' patterns => ' + dest)
+        mc.writeBenchmark(dest)
 
 if __name__ == '__main__':
     main()
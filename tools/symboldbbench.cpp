@@ -0,0 +1,199 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2013 Daniel Marjamäki and Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Benchmark: SymbolDatabase construction and lookups on a generated header
+// with many classes. Each class has a base class, a few overloads, out of
+// line member functions and calls to them. Heap usage is counted by
+// replacing the global operator new and delete.
+//
+// Usage:
+//   make symboldbbench
+//   ./symboldbbench [--classes=N] [--repeat=N]
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+
+#include "errorlogger.h"
+#include "settings.h"
+#include "symboldatabase.h"
+#include "token.h"
+#include "tokenize.h"
+
+class SymbolDbBenchErrorLogger : public ErrorLogger {
+public:
+    void reportOut(const std::string &/*outmsg*/) { }
+    void reportErr(const ErrorLogger::ErrorMessage &/*msg*/) { }
+};
+
+// Heap statistics. Every block gets a header holding its size so that the
+// number of live bytes is known.
+static std::size_t heapAllocations = 0;
+static std::size_t heapLiveBytes = 0;
+
+static const std::size_t heapHeader = 16;
+
+#if __cplusplus >= 201103L
+#define HEAP_THROW_BAD_ALLOC
+#define HEAP_NOTHROW noexcept
+#else
+#define HEAP_THROW_BAD_ALLOC throw(std::bad_alloc)
+#define HEAP_NOTHROW throw()
+#endif
+
+void *operator new(std::size_t size) HEAP_THROW_BAD_ALLOC
+{
+    char *p = static_cast<char *>(std::malloc(size + heapHeader));
+    if (!p)
+        throw std::bad_alloc();
+    *reinterpret_cast<std::size_t *>(p) = size;
+    ++heapAllocations;
+    heapLiveBytes += size;
+    return p + heapHeader;
+}
+
+void operator delete(void *ptr) HEAP_NOTHROW
+{
+    if (!ptr)
+        return;
+    char *p = static_cast<char *>(ptr) - heapHeader;
+    heapLiveBytes -= *reinterpret_cast<std::size_t *>(p);
+    std::free(p);
+}
+
+void *operator new[](std::size_t size) HEAP_THROW_BAD_ALLOC
+{
+    return operator new(size);
+}
+
+void operator delete[](void *ptr) HEAP_NOTHROW
+{
+    operator delete(ptr);
+}
+
+static double seconds(std::clock_t t)
+{
+    return double(t) / CLOCKS_PER_SEC;
+}
+
+static std::string generateCode(int classes)
+{
+    std::ostringstream code;
+
+    // declarations, 100 classes per namespace
+    for (int i = 0; i < classes; ++i) {
+        if (i % 100 == 0)
+            code << "namespace ns" << i / 100 << " {\n";
+        code << "class C" << i;
+        if (i % 100 != 0)
+            code << " : public C" << i - 1;
+        code << " {\n"
+             << "public:\n"
+             << "    C" << i << "();\n"
+             << "    int f" << i << "(int a);\n"
+             << "    int g(int a);\n"
+             << "    int g(int a, int b);\n"
+             << "    int h(int a, int b = 0) { return a + b + m" << i << "; }\n"
+             << "private:\n"
+             << "    int m" << i << ";\n"
+             << "};\n";
+        if (i % 100 == 99 || i + 1 == classes)
+            code << "}\n";
+    }
+
+    // out of line definitions
+    for (int i = 0; i < classes; ++i) {
+        const std::string cls = "ns" + MathLib::longToString(i / 100) + "::C" + MathLib::longToString(i);
+        code << cls << "::C" << i << "() : m" << i << "(0) { }\n"
+             << "int " << cls << "::f" << i << "(int a) { return g(a) + g(a, m" << i << ") + h(a); }\n"
+             << "int " << cls << "::g(int a) { return a; }\n"
+             << "int " << cls << "::g(int a, int b) { return a * b; }\n";
+    }
+
+    return code.str();
+}
+
+int main(int argc, char *argv[])
+{
+    int classes = 5000;
+    unsigned int repeat = 1;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--classes=", 10) == 0)
+            classes = std::max(1, std::atoi(argv[i] + 10));
+        else if (std::strncmp(argv[i], "--repeat=", 9) == 0)
+            repeat = std::max(1, std::atoi(argv[i] + 9));
+        else {
+            std::cout << "Syntax: symboldbbench [--classes=N] [--repeat=N]" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    Settings settings;
+    SymbolDbBenchErrorLogger errorLogger;
+    Tokenizer tokenizer(&settings, &errorLogger);
+    std::istringstream istr(generateCode(classes));
+    if (!tokenizer.tokenize(istr, "classes.h")) {
+        std::cerr << "Can't tokenize the generated code" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::clock_t construction = 0, lookups = 0;
+    std::size_t scopes = 0, functions = 0, variables = 0, found = 0;
+    std::size_t allocations = 0, bytes = 0;
+    for (unsigned int r = 0; r < repeat; ++r) {
+        const std::size_t allocationsBefore = heapAllocations;
+        const std::size_t bytesBefore = heapLiveBytes;
+        const std::clock_t start = std::clock();
+        const SymbolDatabase symbolDatabase(&tokenizer, &settings, &errorLogger);
+        const std::clock_t middle = std::clock();
+        allocations = heapAllocations - allocationsBefore;
+        bytes = heapLiveBytes - bytesBefore;
+
+        // resolve all function calls
+        found = 0;
+        for (const Token *tok = tokenizer.tokens(); tok; tok = tok->next()) {
+            if (Token::Match(tok, "%var% (") && tok->scope() && symbolDatabase.findFunction(tok))
+                ++found;
+        }
+        const std::clock_t end = std::clock();
+
+        construction += middle - start;
+        lookups += end - middle;
+        scopes = symbolDatabase.scopeList.size();
+        functions = 0;
+        variables = 0;
+        for (StableVector<Scope>::const_iterator scope = symbolDatabase.scopeList.begin(); scope != symbolDatabase.scopeList.end(); ++scope) {
+            functions += scope->functionList.size();
+            variables += scope->varlist.size();
+            for (StableVector<Function>::const_iterator func = scope->functionList.begin(); func != scope->functionList.end(); ++func)
+                variables += func->argumentList.size();
+        }
+    }
+
+    std::cout << "Classes: " << classes << ", scopes: " << scopes << ", functions: " << functions << ", variables: " << variables << ", repeat: " << repeat << std::endl;
+    std::cout << "Construction: " << seconds(construction) / repeat << "s" << std::endl;
+    std::cout << "Memory: " << bytes / 1024 << " KiB in " << allocations << " allocations" << std::endl;
+    std::cout << "findFunction: " << seconds(lookups) / repeat << "s (" << found << " calls resolved)" << std::endl;
+
+    return EXIT_SUCCESS;
+}
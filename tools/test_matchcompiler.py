@@ -16,6 +16,8 @@
 # You should have received a copy of the GNU General Public License
 # along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
+import os
+import tempfile
 import unittest
 import matchcompiler
 
@@ -39,7 +41,7 @@ class MatchCompilerTest(unittest.TestCase):
         input = 'if (Token::Match(tok->next()->next(), "foobar %type% %num%")) {'
         output = self.mc._replaceTokenMatch(input)
         self.assertEqual(output, 'if (match2(tok->next()->next())) {')
-        self.assertEqual(2, len(self.mc._matchStrs))
+        self.assertEqual(1, len(self.mc._matchStrs))
 
         input = 'if (Token::Match(tok, "foo\"special\"bar %num%")) {'
         output = self.mc._replaceTokenMatch(input)
@@ -74,7 +76,7 @@ class MatchCompilerTest(unittest.TestCase):
         input = 'if (Token::Match(tok, "foobar2 %varid%", 123) || Token::Match(tok, "%type% %varid%", 123)) {'
         output = self.mc._replaceTokenMatch(input)
         self.assertEqual(output, 'if (match3(tok, 123) || match4(tok, 123)) {')
-        self.assertEqual(3, len(self.mc._matchStrs))
+        self.assertEqual(2, len(self.mc._matchStrs))
 
     def test_replaceTokenSimpleMatch(self):
         input = 'if (Token::simpleMatch(tok, "foobar")) {'
@@ -132,15 +134,95 @@ class MatchCompilerTest(unittest.TestCase):
         input = 'if (Token::findmatch(tok->next()->next(), "foobar %type%", tok->link())) {'
         output = self.mc._replaceTokenFindMatch(input)
         self.assertEqual(output, 'if (findmatch3(tok->next()->next(), tok->link())) {')
-        self.assertEqual(2, len(self.mc._matchStrs))
+        self.assertEqual(1, len(self.mc._matchStrs))
         self.assertEqual(1, self.mc._matchStrs['foobar'])
 
         # findmatch with end token and varid
         input = 'if (Token::findmatch(tok->next()->next(), "foobar %type% %varid%", tok->link(), 123)) {'
         output = self.mc._replaceTokenFindMatch(input)
         self.assertEqual(output, 'if (findmatch4(tok->next()->next(), tok->link(), 123)) {')
-        self.assertEqual(2, len(self.mc._matchStrs))
+        self.assertEqual(1, len(self.mc._matchStrs))
         self.assertEqual(1, self.mc._matchStrs['foobar'])
 
+    def test_strIds(self):
+        # keywords and operators are compared by their fixed id
+        input = 'if (Token::Match(tok, "if ( %var% )")) {'
+        output = self.mc._replaceTokenMatch(input)
+        self.assertEqual(output, 'if (match1(tok)) {')
+        self.assertEqual(0, len(self.mc._matchStrs))
+        self.assertTrue('tok->strId()==Token::idIf' in self.mc._rawMatchFunctions[0])
+        self.assertTrue('tok->strId()==Token::idRParen' in self.mc._rawMatchFunctions[0])
+
+    def test_skipNonConstPattern(self):
+        # a non-const pattern doesn't stop the compilation of the rest of the line
+        input = 'if (Token::Match(tok, pattern) && Token::simpleMatch(tok, "foobar")) {'
+        output = self.mc._replaceTokenMatch(input)
+        self.assertEqual(output, 'if (Token::Match(tok, pattern) && match1(tok)) {')
+
+        input = 'if (Token::findmatch(tok, pattern) || Token::findsimplematch(tok, "foobar")) {'
+        output = self.mc._replaceTokenFindMatch(input)
+        self.assertEqual(output, 'if (Token::findmatch(tok, pattern) || findmatch2(tok)) {')
+
+    def test_escapedQuotes(self):
+        input = 'if (Token::Match(tok, "extern \\"C\\" {")) {'
+        output = self.mc._replaceTokenMatch(input)
+        self.assertEqual(output, 'if (match1(tok)) {')
+        self.assertEqual(1, self.mc._matchStrs['\\"C\\"'])
+
+    def test_simpleMatchIsLiteral(self):
+        # "|=" and "%var%" are plain strings for simpleMatch
+        input = 'if (Token::simpleMatch(tok, "|= %var%")) {'
+        output = self.mc._replaceTokenMatch(input)
+        self.assertEqual(output, 'if (match1(tok)) {')
+        self.assertTrue('tok->isName()' not in self.mc._rawMatchFunctions[0])
+        self.assertEqual(1, self.mc._matchStrs['%var%'])
+
+        # ..but not for Match
+        input = 'if (Token::Match(tok, "|= %var%")) {'
+        output = self.mc._replaceTokenMatch(input)
+        self.assertEqual(output, 'if (match2(tok)) {')
+        self.assertTrue('tok->isName()' in self.mc._rawMatchFunctions[1])
+
+    def test_verifyDebug(self):
+        mc = matchcompiler.MatchCompiler(verify_mode='debug')
+        output = mc._replaceTokenMatch('if (Token::Match(tok, "foobar")) {')
+        self.assertEqual(output, 'if (match_verify2(tok)) {')
+        self.assertTrue('#ifndef NDEBUG' in mc._rawMatchFunctions[1])
+
+        mc = matchcompiler.MatchCompiler(verify_mode=True)
+        output = mc._replaceTokenMatch('if (Token::Match(tok, "foobar")) {')
+        self.assertEqual(output, 'if (match_verify2(tok)) {')
+        self.assertTrue('#ifndef NDEBUG' not in mc._rawMatchFunctions[1])
+
+    def test_splitComments(self):
+        self.mc._inComment = False
+        self.assertEqual(self.mc._splitComments('a; // Token::Match(tok, "x")\n'), [('a; ', True), ('// Token::Match(tok, "x")\n', False)])
+        self.assertEqual(self.mc._splitComments('f("/* //"); /* b\n'), [('f("/* //"); ', True), ('/* b\n', False)])
+        self.assertEqual(self.mc._splitComments('c */ d;\n'), [('c */', False), (' d;\n', True)])
+
+    def test_convertFile(self):
+        src = tempfile.NamedTemporaryFile(mode='wt', suffix='.cpp', delete=False)
+        src.write('/*\n'
+                  'if (Token::Match(tok, "foo")) {}\n'
+                  '*/\n'
+                  '#ifdef X\n'
+                  'if (Token::Match(tok, "bar")) {}\n'
+                  '#else\n'
+                  'if (Token::Match(tok, "baz")) {}\n'
+                  '#endif\n')
+        src.close()
+        dest = src.name + '.out'
+        self.mc.convertFile(src.name, dest)
+        output = open(dest, 'rt').read()
+        os.remove(src.name)
+        os.remove(dest)
+
+        # only the pattern in the #ifdef block is compiled, inside the same #ifdef
+        self.assertEqual(1, len(self.mc._rawMatchFunctions))
+        self.assertTrue(self.mc._rawMatchFunctions[0].startswith('#ifdef X\n'))
+        self.assertTrue('if (match1(tok)) {}' in output)
+        self.assertTrue('Token::Match(tok, "foo")' in output)
+        self.assertTrue('Token::Match(tok, "baz")' in output)
+
 if __name__ == '__main__':
     unittest.main()
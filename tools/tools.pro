@@ -10,7 +10,9 @@ include(../console_common.pri)
 
 SOURCES += dmake.cpp \
            ../cli/filelister.cpp \
-           ../lib/path.cpp
+           ../lib/path.cpp \
+           ../lib/mutex.cpp
 
 HEADERS += ../cli/filelister.h \
-           ../lib/path.h
+           ../lib/path.h \
+           ../lib/mutex.h
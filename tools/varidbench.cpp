@@ -0,0 +1,151 @@
+/*
+ * Cppcheck - A tool for static C/C++ code analysis
+ * Copyright (C) 2007-2013 Daniel Marjamäki and Cppcheck team.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Benchmark: Tokenizer::setVarId() on a generated file with many functions.
+// There are global variables, structs and classes with out of line member
+// functions. The functions have nested scopes with local variables that
+// shadow each other.
+//
+// Usage:
+//   make varidbench
+//   ./varidbench [--lines=N] [--repeat=N]
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include "errorlogger.h"
+#include "settings.h"
+#include "token.h"
+#include "tokenize.h"
+
+class VarIdBenchErrorLogger : public ErrorLogger {
+public:
+    void reportOut(const std::string &/*outmsg*/) { }
+    void reportErr(const ErrorLogger::ErrorMessage &/*msg*/) { }
+};
+
+static double seconds(std::clock_t t)
+{
+    return double(t) / CLOCKS_PER_SEC;
+}
+
+// One unit is a struct, a class with two member functions, a global
+// variable and a free function. It is 50 lines.
+static void generateUnit(std::ostream &code, int i)
+{
+    code << "struct S" << i << " {\n"
+         << "    int a;\n"
+         << "    int b;\n"
+         << "    struct S" << i << " *next;\n"
+         << "};\n"
+         << "int global" << i << " = " << i << ";\n"
+         << "class C" << i << " {\n"
+         << "public:\n"
+         << "    int get(int x) const;\n"
+         << "    void set(int x, int y);\n"
+         << "private:\n"
+         << "    int m" << i << ";\n"
+         << "    struct S" << i << " s;\n"
+         << "};\n"
+         << "int C" << i << "::get(int x) const {\n"
+         << "    return m" << i << " + s.a + s.next->b + x;\n"
+         << "}\n"
+         << "void C" << i << "::set(int x, int y) {\n"
+         << "    m" << i << " = x;\n"
+         << "    s.a = y;\n"
+         << "    s.b = global" << i << ";\n"
+         << "}\n"
+         << "int f" << i << "(int a, int b, struct S" << i << " *p) {\n"
+         << "    int sum = 0;\n"
+         << "    int i;\n"
+         << "    for (i = 0; i < a; ++i) {\n"
+         << "        int x = i * b;\n"
+         << "        if (x > global" << i << ") {\n"
+         << "            int a = x - 1;\n"
+         << "            sum += a + p->a;\n"
+         << "            while (a > 0) {\n"
+         << "                int b = a / 2;\n"
+         << "                a = b;\n"
+         << "                {\n"
+         << "                    int x = b + p->next->b;\n"
+         << "                    sum += x;\n"
+         << "                }\n"
+         << "            }\n"
+         << "        } else {\n"
+         << "            struct S" << i << " s;\n"
+         << "            s.a = x;\n"
+         << "            s.b = a;\n"
+         << "            s.next = p;\n"
+         << "            sum += s.a + s.next->a;\n"
+         << "        }\n"
+         << "    }\n"
+         << "    C" << i << " c;\n"
+         << "    c.set(a, b);\n"
+         << "    return sum + c.get(global" << i << ");\n"
+         << "}\n";
+}
+
+int main(int argc, char *argv[])
+{
+    int lines = 50000;
+    unsigned int repeat = 10;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--lines=", 8) == 0)
+            lines = std::max(1, std::atoi(argv[i] + 8));
+        else if (std::strncmp(argv[i], "--repeat=", 9) == 0)
+            repeat = std::max(1, std::atoi(argv[i] + 9));
+        else {
+            std::cout << "Syntax: varidbench [--lines=N] [--repeat=N]" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::ostringstream code;
+    const int units = std::max(1, lines / 50);
+    for (int i = 0; i < units; ++i)
+        generateUnit(code, i);
+
+    Settings settings;
+    VarIdBenchErrorLogger errorLogger;
+    Tokenizer tokenizer(&settings, &errorLogger);
+    std::istringstream istr(code.str());
+    if (!tokenizer.tokenize(istr, "functions.cpp")) {
+        std::cerr << "Can't tokenize the generated code" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::size_t tokens = 0;
+    for (const Token *tok = tokenizer.tokens(); tok; tok = tok->next())
+        ++tokens;
+
+    // setVarId() clears the old variable ids first so it can be repeated
+    const std::clock_t start = std::clock();
+    for (unsigned int r = 0; r < repeat; ++r)
+        tokenizer.setVarId();
+    const std::clock_t end = std::clock();
+
+    std::cout << "Lines: " << units * 50 << ", tokens: " << tokens << ", variables: " << tokenizer.varIdCount() << ", repeat: " << repeat << std::endl;
+    std::cout << "setVarId: " << seconds(end - start) / repeat << "s" << std::endl;
+
+    return EXIT_SUCCESS;
+}